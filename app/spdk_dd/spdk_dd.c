@@ -21,6 +21,8 @@
 
 #define TIMESPEC_TO_MS(time) ((time.tv_sec * 1000) + (time.tv_nsec / 1000000))
 #define STATUS_POLLER_PERIOD_SEC 1
+/* Upper bound of --threads, each worker is an SPDK thread of its own */
+#define DD_MAX_THREADS 1024
 
 struct spdk_dd_opts {
 	char		*input_file;
@@ -34,6 +36,7 @@ struct spdk_dd_opts {
 	int64_t		io_unit_size;
 	int64_t		io_unit_count;
 	uint32_t	queue_depth;
+	int		num_threads;
 	bool		aio;
 	bool		sparse;
 };
@@ -41,6 +44,7 @@ struct spdk_dd_opts {
 static struct spdk_dd_opts g_opts = {
 	.io_unit_size = 4096,
 	.queue_depth = 2,
+	.num_threads = 1,
 };
 
 enum dd_submit_type {
@@ -99,12 +103,52 @@ struct dd_target {
 	bool open;
 };
 
+struct dd_worker;
+
+/* I/O of a worker copying a bdev to a bdev on its own SPDK thread. */
+struct dd_worker_io {
+	struct dd_worker		*worker;
+	uint64_t			offset;
+	uint64_t			length;
+	void				*buf;
+	STAILQ_ENTRY(dd_worker_io)	link;
+	struct spdk_bdev_io_wait_entry	bdev_io_wait;
+};
+
+/* Copies the [start, end) byte range of the input on its own SPDK thread. */
+struct dd_worker {
+	struct spdk_thread		*thread;
+	struct spdk_io_channel		*input_ch;
+	struct spdk_io_channel		*output_ch;
+
+	struct dd_worker_io		*ios;
+	uint32_t			num_ios;
+
+	uint64_t			start;
+	uint64_t			end;
+
+	/* Position of next I/O and end of the data extent it belongs to, in bytes */
+	uint64_t			pos;
+	uint64_t			data_end;
+
+	uint32_t			outstanding;
+	bool				seeking;
+	bool				finished;
+	STAILQ_HEAD(, dd_worker_io)	seek_waiters;
+};
+
 struct dd_job {
 	struct dd_target	input;
 	struct dd_target	output;
 
 	struct dd_io		*ios;
 
+	/* Parallel bdev to bdev copy */
+	struct dd_worker	*workers;
+	uint32_t		num_workers;
+	uint32_t		num_workers_done;
+	bool			copy_offload;
+
 	union {
 #ifdef SPDK_CONFIG_URING
 		struct {
@@ -227,9 +271,8 @@ dd_show_progress(bool finish)
 	uint64_t milliseconds;
 	uint64_t size, tmp_size;
 
-	size = g_job.incremental_bytes;
-
-	g_job.incremental_bytes = 0;
+	/* Workers of a parallel copy account their progress from their own threads */
+	size = __atomic_exchange_n(&g_job.incremental_bytes, 0, __ATOMIC_RELAXED);
 	g_job.total_bytes += size;
 
 	if (finish) {
@@ -863,6 +906,512 @@ dd_aio_poll(void *ctx)
 	return rc;
 }
 
+static bool
+dd_worker_stopped(void)
+{
+	return __atomic_load_n(&g_error, __ATOMIC_RELAXED) != 0 ||
+	       __atomic_load_n(&g_interrupt, __ATOMIC_RELAXED);
+}
+
+static void
+dd_worker_set_error(int rc)
+{
+	int expected = 0;
+
+	/* Keep the first error reported by any of the workers */
+	__atomic_compare_exchange_n(&g_error, &expected, rc, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+static void
+dd_worker_done(void *ctx)
+{
+	g_job.num_workers_done++;
+	if (g_job.num_workers_done < g_job.num_workers) {
+		return;
+	}
+
+	if (g_error == 0) {
+		dd_show_progress(true);
+		printf("\n\n");
+	}
+	dd_exit(g_error);
+}
+
+static void
+dd_worker_check_done(struct dd_worker *worker)
+{
+	if (worker->finished || worker->outstanding > 0) {
+		return;
+	}
+
+	if (!dd_worker_stopped() && (worker->pos < worker->end || worker->seeking)) {
+		return;
+	}
+
+	worker->finished = true;
+
+	if (worker->input_ch != NULL) {
+		spdk_put_io_channel(worker->input_ch);
+	}
+	if (worker->output_ch != NULL) {
+		spdk_put_io_channel(worker->output_ch);
+	}
+
+	spdk_thread_send_msg(spdk_thread_get_app_thread(), dd_worker_done, worker);
+	spdk_thread_exit(worker->thread);
+}
+
+static void dd_worker_next(struct dd_worker_io *io);
+
+static void
+_dd_worker_write_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct dd_worker_io *io = cb_arg;
+	struct dd_worker *worker = io->worker;
+
+	spdk_bdev_free_io(bdev_io);
+
+	assert(worker->outstanding > 0);
+	worker->outstanding--;
+
+	if (!success) {
+		SPDK_ERRLOG("Failed to write %" PRIu64 " bytes at offset %" PRIu64 "\n",
+			    io->length, io->offset);
+		dd_worker_set_error(-EIO);
+	} else {
+		__atomic_fetch_add(&g_job.incremental_bytes, io->length, __ATOMIC_RELAXED);
+	}
+
+	dd_worker_next(io);
+}
+
+/* Retry a submission that failed with -ENOMEM once the channel frees a bdev_io.
+ * The I/O stays counted as outstanding while it waits, so the worker can't finish
+ * underneath it.
+ */
+static void
+dd_worker_queue_io_wait(struct dd_worker_io *io, struct spdk_bdev *bdev,
+			struct spdk_io_channel *ch, spdk_bdev_io_wait_cb cb_fn)
+{
+	int rc;
+
+	io->bdev_io_wait.bdev = bdev;
+	io->bdev_io_wait.cb_fn = cb_fn;
+	io->bdev_io_wait.cb_arg = io;
+
+	rc = spdk_bdev_queue_io_wait(bdev, ch, &io->bdev_io_wait);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to queue I/O wait: %s\n", spdk_strerror(-rc));
+		assert(io->worker->outstanding > 0);
+		io->worker->outstanding--;
+		dd_worker_set_error(rc);
+		dd_worker_check_done(io->worker);
+	}
+}
+
+static void dd_worker_write(struct dd_worker_io *io);
+
+static void
+dd_worker_write_retry(void *ctx)
+{
+	struct dd_worker_io *io = ctx;
+	struct dd_worker *worker = io->worker;
+
+	assert(worker->outstanding > 0);
+	worker->outstanding--;
+
+	if (dd_worker_stopped()) {
+		dd_worker_check_done(worker);
+		return;
+	}
+
+	dd_worker_write(io);
+}
+
+static void
+dd_worker_write(struct dd_worker_io *io)
+{
+	struct dd_worker *worker = io->worker;
+	uint64_t write_offset = g_opts.output_offset * g_opts.io_unit_size +
+				io->offset - g_opts.input_offset * g_opts.io_unit_size;
+	int rc;
+
+	worker->outstanding++;
+
+	if (g_job.copy_offload) {
+		rc = spdk_bdev_copy_blocks(g_job.output.u.bdev.desc, worker->output_ch,
+					   write_offset / g_job.output.block_size,
+					   io->offset / g_job.input.block_size,
+					   io->length / g_job.output.block_size,
+					   _dd_worker_write_done, io);
+	} else {
+		rc = spdk_bdev_write(g_job.output.u.bdev.desc, worker->output_ch, io->buf, write_offset,
+				     io->length, _dd_worker_write_done, io);
+	}
+
+	if (rc == -ENOMEM) {
+		dd_worker_queue_io_wait(io, g_job.output.u.bdev.bdev, worker->output_ch,
+					dd_worker_write_retry);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("%s\n", strerror(-rc));
+		worker->outstanding--;
+		dd_worker_set_error(rc);
+		dd_worker_check_done(worker);
+	}
+}
+
+static void
+_dd_worker_read_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct dd_worker_io *io = cb_arg;
+	struct dd_worker *worker = io->worker;
+
+	spdk_bdev_free_io(bdev_io);
+
+	assert(worker->outstanding > 0);
+	worker->outstanding--;
+
+	if (!success) {
+		SPDK_ERRLOG("Failed to read %" PRIu64 " bytes at offset %" PRIu64 "\n",
+			    io->length, io->offset);
+		dd_worker_set_error(-EIO);
+	}
+
+	if (dd_worker_stopped()) {
+		dd_worker_check_done(worker);
+		return;
+	}
+
+	dd_worker_write(io);
+}
+
+static void dd_worker_read(struct dd_worker_io *io);
+
+static void
+dd_worker_read_retry(void *ctx)
+{
+	struct dd_worker_io *io = ctx;
+	struct dd_worker *worker = io->worker;
+
+	assert(worker->outstanding > 0);
+	worker->outstanding--;
+
+	if (dd_worker_stopped()) {
+		dd_worker_check_done(worker);
+		return;
+	}
+
+	dd_worker_read(io);
+}
+
+static void
+dd_worker_read(struct dd_worker_io *io)
+{
+	struct dd_worker *worker = io->worker;
+	int rc;
+
+	worker->outstanding++;
+	rc = spdk_bdev_read(g_job.input.u.bdev.desc, worker->input_ch, io->buf, io->offset,
+			    io->length, _dd_worker_read_done, io);
+	if (rc == -ENOMEM) {
+		dd_worker_queue_io_wait(io, g_job.input.u.bdev.bdev, worker->input_ch,
+					dd_worker_read_retry);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("%s\n", strerror(-rc));
+		worker->outstanding--;
+		dd_worker_set_error(rc);
+		dd_worker_check_done(worker);
+	}
+}
+
+static void
+dd_worker_submit(struct dd_worker_io *io)
+{
+	struct dd_worker *worker = io->worker;
+
+	io->offset = worker->pos;
+	io->length = spdk_min((uint64_t)g_opts.io_unit_size, worker->data_end - worker->pos);
+	worker->pos += io->length;
+
+	if (g_job.copy_offload) {
+		dd_worker_write(io);
+		return;
+	}
+
+	dd_worker_read(io);
+}
+
+static void dd_worker_seek_data(struct dd_worker *worker);
+
+/* Hand the data extent found by the last seek to the I/Os waiting for it */
+static void
+dd_worker_resume_waiters(struct dd_worker *worker)
+{
+	struct dd_worker_io *io;
+
+	while (!worker->seeking && (io = STAILQ_FIRST(&worker->seek_waiters)) != NULL) {
+		STAILQ_REMOVE_HEAD(&worker->seek_waiters, link);
+		dd_worker_next(io);
+	}
+
+	dd_worker_check_done(worker);
+}
+
+static void
+_dd_worker_seek_hole_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct dd_worker *worker = cb_arg;
+	uint64_t next_hole_offset_blocks;
+
+	next_hole_offset_blocks = spdk_bdev_io_get_seek_offset(bdev_io);
+	spdk_bdev_free_io(bdev_io);
+
+	assert(worker->outstanding > 0);
+	worker->outstanding--;
+	worker->seeking = false;
+
+	if (!success) {
+		dd_worker_set_error(-EIO);
+	} else if (next_hole_offset_blocks == UINT64_MAX ||
+		   next_hole_offset_blocks * g_job.input.block_size >= worker->end) {
+		worker->data_end = worker->end;
+	} else {
+		worker->data_end = spdk_max(next_hole_offset_blocks * g_job.input.block_size,
+					    worker->pos + g_job.input.block_size);
+	}
+
+	dd_worker_resume_waiters(worker);
+}
+
+static void
+_dd_worker_seek_data_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct dd_worker *worker = cb_arg;
+	uint64_t next_data_offset_blocks;
+	int rc;
+
+	next_data_offset_blocks = spdk_bdev_io_get_seek_offset(bdev_io);
+	spdk_bdev_free_io(bdev_io);
+
+	assert(worker->outstanding > 0);
+	worker->outstanding--;
+
+	if (!success || dd_worker_stopped()) {
+		if (!success) {
+			dd_worker_set_error(-EIO);
+		}
+		worker->seeking = false;
+		dd_worker_resume_waiters(worker);
+		return;
+	}
+
+	/* UINT64_MAX means there are no more data in the input */
+	if (next_data_offset_blocks == UINT64_MAX ||
+	    next_data_offset_blocks * g_job.input.block_size >= worker->end) {
+		worker->pos = worker->end;
+		worker->data_end = worker->end;
+		worker->seeking = false;
+		dd_worker_resume_waiters(worker);
+		return;
+	}
+
+	worker->pos = spdk_max(worker->pos, next_data_offset_blocks * g_job.input.block_size);
+
+	worker->outstanding++;
+	rc = spdk_bdev_seek_hole(g_job.input.u.bdev.desc, worker->input_ch,
+				 worker->pos / g_job.input.block_size,
+				 _dd_worker_seek_hole_done, worker);
+	if (rc != 0) {
+		SPDK_ERRLOG("%s\n", strerror(-rc));
+		worker->outstanding--;
+		worker->seeking = false;
+		dd_worker_set_error(rc);
+		dd_worker_resume_waiters(worker);
+	}
+}
+
+static void
+dd_worker_seek_data(struct dd_worker *worker)
+{
+	int rc;
+
+	worker->seeking = true;
+	worker->outstanding++;
+	rc = spdk_bdev_seek_data(g_job.input.u.bdev.desc, worker->input_ch,
+				 worker->pos / g_job.input.block_size,
+				 _dd_worker_seek_data_done, worker);
+	if (rc != 0) {
+		SPDK_ERRLOG("%s\n", strerror(-rc));
+		worker->outstanding--;
+		worker->seeking = false;
+		dd_worker_set_error(rc);
+		dd_worker_resume_waiters(worker);
+	}
+}
+
+static void
+dd_worker_next(struct dd_worker_io *io)
+{
+	struct dd_worker *worker = io->worker;
+
+	if (dd_worker_stopped() || worker->pos >= worker->end) {
+		dd_worker_check_done(worker);
+		return;
+	}
+
+	if (worker->pos < worker->data_end) {
+		dd_worker_submit(io);
+		return;
+	}
+
+	/* Only reachable with --sparse. Each worker looks for data in its own range,
+	 * so the workers seek in parallel, but one worker issues one seek at a time.
+	 */
+	STAILQ_INSERT_TAIL(&worker->seek_waiters, io, link);
+	if (!worker->seeking) {
+		dd_worker_seek_data(worker);
+	}
+}
+
+static void
+dd_worker_start(void *ctx)
+{
+	struct dd_worker *worker = ctx;
+	uint32_t i;
+
+	worker->input_ch = spdk_bdev_get_io_channel(g_job.input.u.bdev.desc);
+	worker->output_ch = spdk_bdev_get_io_channel(g_job.output.u.bdev.desc);
+	if (worker->input_ch == NULL || worker->output_ch == NULL) {
+		SPDK_ERRLOG("Could not get I/O channel: %s\n", strerror(ENOMEM));
+		dd_worker_set_error(-ENOMEM);
+		dd_worker_check_done(worker);
+		return;
+	}
+
+	for (i = 0; i < worker->num_ios && !worker->finished; i++) {
+		dd_worker_next(&worker->ios[i]);
+	}
+}
+
+static bool
+dd_bdev_regions_overlap(void)
+{
+	uint64_t input_start = g_opts.input_offset * g_opts.io_unit_size;
+	uint64_t output_start = g_opts.output_offset * g_opts.io_unit_size;
+
+	return input_start < output_start + g_job.copy_size &&
+	       output_start < input_start + g_job.copy_size;
+}
+
+/*
+ * Split a bdev to bdev copy across worker threads. Returns 1 if the copy should
+ * be done by the single threaded path instead.
+ */
+static int
+dd_run_workers(void)
+{
+	struct dd_worker *worker;
+	uint64_t region_start, num_units, units_per_worker;
+	uint32_t num_workers, num_ios, i, j;
+	bool same_bdev;
+	char name[32];
+
+	if (!g_opts.input_bdev || !g_opts.output_bdev || g_job.copy_size == 0 ||
+	    g_job.input.block_size % g_job.output.block_size != 0) {
+		return 1;
+	}
+
+	same_bdev = g_job.input.u.bdev.bdev == g_job.output.u.bdev.bdev;
+	g_job.copy_offload = same_bdev &&
+			     spdk_bdev_io_type_supported(g_job.input.u.bdev.bdev, SPDK_BDEV_IO_TYPE_COPY);
+
+	if (g_opts.num_threads == 1 && !g_job.copy_offload) {
+		return 1;
+	}
+
+	num_units = SPDK_CEIL_DIV(g_job.copy_size, g_opts.io_unit_size);
+	num_workers = spdk_min((uint64_t)g_opts.num_threads, num_units);
+	if (same_bdev && num_workers > 1 && dd_bdev_regions_overlap()) {
+		SPDK_NOTICELOG("Input and output regions overlap, copying on a single thread\n");
+		num_workers = 1;
+	}
+
+	units_per_worker = SPDK_CEIL_DIV(num_units, num_workers);
+	num_workers = SPDK_CEIL_DIV(num_units, units_per_worker);
+	num_ios = spdk_min(g_opts.queue_depth, units_per_worker);
+
+	g_job.workers = calloc(num_workers, sizeof(struct dd_worker));
+	if (g_job.workers == NULL) {
+		return -ENOMEM;
+	}
+	g_job.num_workers = num_workers;
+
+	region_start = g_opts.input_offset * g_opts.io_unit_size;
+
+	for (i = 0; i < num_workers; i++) {
+		worker = &g_job.workers[i];
+		worker->start = region_start + i * units_per_worker * g_opts.io_unit_size;
+		worker->end = spdk_min(worker->start + units_per_worker * g_opts.io_unit_size,
+				       region_start + g_job.copy_size);
+		worker->pos = worker->start;
+		/* With --sparse, the first I/O looks for the first data extent */
+		worker->data_end = g_opts.sparse ? worker->start : worker->end;
+		STAILQ_INIT(&worker->seek_waiters);
+
+		worker->ios = calloc(num_ios, sizeof(struct dd_worker_io));
+		if (worker->ios == NULL) {
+			return -ENOMEM;
+		}
+		worker->num_ios = num_ios;
+
+		for (j = 0; j < num_ios; j++) {
+			worker->ios[j].worker = worker;
+			if (g_job.copy_offload) {
+				continue;
+			}
+
+			worker->ios[j].buf = spdk_malloc(g_opts.io_unit_size, 0x1000, NULL, 0, SPDK_MALLOC_DMA);
+			if (worker->ios[j].buf == NULL) {
+				SPDK_ERRLOG("%s - try smaller block size value\n", strerror(ENOMEM));
+				return -ENOMEM;
+			}
+		}
+	}
+
+	for (i = 0; i < num_workers; i++) {
+		worker = &g_job.workers[i];
+
+		snprintf(name, sizeof(name), "dd_worker_%u", i);
+		worker->thread = spdk_thread_create(name, NULL);
+		if (worker->thread == NULL) {
+			SPDK_ERRLOG("Could not create thread %s\n", name);
+			if (i == 0) {
+				return -ENOMEM;
+			}
+			/* The workers created so far see the error and exit right away */
+			dd_worker_set_error(-ENOMEM);
+			g_job.num_workers_done = num_workers - i;
+			break;
+		}
+	}
+
+	if (g_error == 0) {
+		printf("Copying with %u thread(s)%s\n", num_workers,
+		       g_job.copy_offload ? " using copy offload" : "");
+	}
+
+	clock_gettime(CLOCK_REALTIME, &g_job.start_time);
+
+	g_job.status_poller = SPDK_POLLER_REGISTER(dd_status_poller, NULL,
+			      STATUS_POLLER_PERIOD_SEC * SPDK_SEC_TO_USEC);
+
+	for (i = 0; i < num_workers && g_job.workers[i].thread != NULL; i++) {
+		spdk_thread_send_msg(g_job.workers[i].thread, dd_worker_start, &g_job.workers[i]);
+	}
+
+	return 0;
+}
+
 static int
 dd_open_file(struct dd_target *target, const char *fname, int flags, uint64_t skip_blocks,
 	     bool input)
@@ -1171,6 +1720,15 @@ dd_run(void *arg1)
 		return;
 	}
 
+	rc = dd_run_workers();
+	if (rc < 0) {
+		SPDK_ERRLOG("%s\n", strerror(-rc));
+		dd_exit(rc);
+		return;
+	} else if (rc == 0) {
+		return;
+	}
+
 	g_job.ios = calloc(g_opts.queue_depth, sizeof(struct dd_io));
 	if (g_job.ios == NULL) {
 		SPDK_ERRLOG("%s\n", strerror(ENOMEM));
@@ -1263,6 +1821,7 @@ enum dd_cmdline_opts {
 	DD_OPTION_COUNT,
 	DD_OPTION_AIO,
 	DD_OPTION_SPARSE,
+	DD_OPTION_THREADS,
 };
 
 static struct option g_cmdline_opts[] = {
@@ -1344,6 +1903,12 @@ static struct option g_cmdline_opts[] = {
 		.flag = NULL,
 		.val = DD_OPTION_SPARSE,
 	},
+	{
+		.name = "threads",
+		.has_arg = 1,
+		.flag = NULL,
+		.val = DD_OPTION_THREADS,
+	},
 	{
 		.name = NULL
 	}
@@ -1366,6 +1931,9 @@ usage(void)
 	printf(" --seek Skip this many I/O units at start of output. (default: 0)\n");
 	printf(" --aio Force usage of AIO. (by default io_uring is used if available)\n");
 	printf(" --sparse Enable hole skipping in input target\n");
+	printf(" --threads Number of SPDK threads to split a bdev to bdev copy across, each with\n");
+	printf("           --qd I/Os in flight. Use -m to run them on more cores.\n");
+	printf("           (default: %d, max: %d)\n", g_opts.num_threads, DD_MAX_THREADS);
 	printf(" Available iflag and oflag values:\n");
 	printf("  append - append mode\n");
 	printf("  direct - use direct I/O for data\n");
@@ -1421,6 +1989,9 @@ parse_args(int argc, char *argv)
 	case DD_OPTION_SPARSE:
 		g_opts.sparse = true;
 		break;
+	case DD_OPTION_THREADS:
+		g_opts.num_threads = spdk_strtol(optarg, 10);
+		break;
 	default:
 		usage();
 		return 1;
@@ -1431,7 +2002,7 @@ parse_args(int argc, char *argv)
 static void
 dd_free(void)
 {
-	uint32_t i;
+	uint32_t i, j;
 
 	free(g_opts.input_file);
 	free(g_opts.output_file);
@@ -1462,6 +2033,21 @@ dd_free(void)
 
 		free(g_job.ios);
 	}
+
+	if (g_job.workers) {
+		for (i = 0; i < g_job.num_workers; i++) {
+			if (g_job.workers[i].ios == NULL) {
+				continue;
+			}
+
+			for (j = 0; j < g_job.workers[i].num_ios; j++) {
+				spdk_free(g_job.workers[i].ios[j].buf);
+			}
+			free(g_job.workers[i].ios);
+		}
+
+		free(g_job.workers);
+	}
 }
 
 int
@@ -1519,6 +2105,12 @@ main(int argc, char **argv)
 		goto end;
 	}
 
+	if (g_opts.num_threads <= 0 || g_opts.num_threads > DD_MAX_THREADS) {
+		SPDK_ERRLOG("Invalid --threads value, must be between 1 and %d\n", DD_MAX_THREADS);
+		rc = EINVAL;
+		goto end;
+	}
+
 	if (g_opts.output_file == NULL && g_opts.output_file_flags != NULL) {
 		SPDK_ERRLOG("--oflags may be used only with --of\n");
 		rc = EINVAL;
@@ -5,12 +5,16 @@
 
 #include "spdk/stdinc.h"
 #include "spdk/env.h"
+#include "spdk/histogram_data.h"
 #include "spdk/json.h"
 #include "spdk/likely.h"
 #include "spdk/string.h"
 #include "spdk/util.h"
 
+#include <algorithm>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 extern "C" {
 #include "spdk/trace_parser.h"
@@ -19,6 +23,7 @@ extern "C" {
 
 enum print_format_type {
 	PRINT_FMT_JSON,
+	PRINT_FMT_CSV,
 	PRINT_FMT_DEFAULT,
 };
 
@@ -384,6 +389,462 @@ trace_print_json(void)
 	return 0;
 }
 
+/*
+ * Latency analysis.  Events are correlated by their object: an object is created by a tpoint
+ * with new_object set and followed by all later tpoints of the same object type and object_id,
+ * until the object_id gets reused by another new_object tpoint or the trace ends.  Only the
+ * objects currently in flight are kept in memory, along with the slowest ones.
+ */
+struct analyze_event {
+	uint64_t	tsc;
+	uint16_t	tpoint_id;
+	uint16_t	lcore;
+};
+
+struct analyze_object {
+	uint64_t			index;
+	uint64_t			latency;
+	std::vector<analyze_event>	events;
+};
+
+struct analyze_stats {
+	struct spdk_histogram_data	*histogram;
+	uint64_t			count;
+	uint64_t			min;
+	uint64_t			max;
+	uint64_t			total;
+};
+
+struct analyze_type {
+	/* Name of the tpoint that created the first object of this type */
+	const char					*name;
+	struct analyze_stats				latency;
+	std::unordered_map<uint64_t, analyze_object>	objects;
+	/* Min heap of the slowest objects */
+	std::vector<analyze_object>			slowest;
+};
+
+static const double g_analyze_percentiles[] = { 50, 90, 99, 99.9, 99.99 };
+
+static struct analyze_type g_analyze_types[SPDK_TRACE_MAX_OBJECT];
+static std::map<std::pair<uint16_t, uint16_t>, analyze_stats> g_analyze_pairs;
+static uint64_t g_analyze_top = 10;
+
+static bool
+analyze_slower(const analyze_object &first, const analyze_object &second)
+{
+	return first.latency > second.latency;
+}
+
+static void
+analyze_stats_tally(struct analyze_stats *stats, uint64_t value)
+{
+	if (stats->histogram == NULL) {
+		stats->histogram = spdk_histogram_data_alloc();
+		if (stats->histogram == NULL) {
+			fprintf(stderr, "Failed to allocate histogram\n");
+			abort();
+		}
+		stats->min = UINT64_MAX;
+	}
+
+	spdk_histogram_data_tally(stats->histogram, value);
+	stats->count++;
+	stats->total += value;
+	stats->min = spdk_min(stats->min, value);
+	stats->max = spdk_max(stats->max, value);
+}
+
+struct analyze_percentile_ctx {
+	const double	*percentile;
+	uint64_t	values[SPDK_COUNTOF(g_analyze_percentiles)];
+};
+
+static void
+analyze_check_percentile(void *cb_ctx, uint64_t start, uint64_t end, uint64_t count,
+			 uint64_t total, uint64_t so_far)
+{
+	struct analyze_percentile_ctx *ctx = (struct analyze_percentile_ctx *)cb_ctx;
+	const double *last = &g_analyze_percentiles[SPDK_COUNTOF(g_analyze_percentiles)];
+
+	if (count == 0) {
+		return;
+	}
+
+	while (ctx->percentile != last && so_far * 100.0 >= *ctx->percentile * total) {
+		ctx->values[ctx->percentile - g_analyze_percentiles] = end;
+		ctx->percentile++;
+	}
+}
+
+static void
+analyze_get_percentiles(const struct analyze_stats *stats, uint64_t *values)
+{
+	struct analyze_percentile_ctx ctx = {};
+	size_t i;
+
+	ctx.percentile = g_analyze_percentiles;
+	spdk_histogram_data_iterate(stats->histogram, analyze_check_percentile, &ctx);
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_percentiles); i++) {
+		/* The buckets' ends can overshoot the largest value */
+		values[i] = spdk_min(ctx.values[i], stats->max);
+	}
+}
+
+static void
+analyze_object_done(struct analyze_type *type, analyze_object &object)
+{
+	object.latency = object.events.back().tsc - object.events.front().tsc;
+	analyze_stats_tally(&type->latency, object.latency);
+
+	if (type->slowest.size() < g_analyze_top) {
+		type->slowest.push_back(std::move(object));
+		std::push_heap(type->slowest.begin(), type->slowest.end(), analyze_slower);
+	} else if (g_analyze_top > 0 && object.latency > type->slowest.front().latency) {
+		std::pop_heap(type->slowest.begin(), type->slowest.end(), analyze_slower);
+		type->slowest.back() = std::move(object);
+		std::push_heap(type->slowest.begin(), type->slowest.end(), analyze_slower);
+	}
+}
+
+static void
+analyze_entry(struct spdk_trace_parser_entry *entry)
+{
+	struct spdk_trace_entry		*e = entry->entry;
+	const struct spdk_trace_tpoint	*d = &g_file->tpoint[e->tpoint_id];
+	struct analyze_type		*type = &g_analyze_types[d->object_type];
+	struct analyze_event		event = { e->tsc, e->tpoint_id, entry->lcore };
+	uint16_t			prev_tpoint_id;
+
+	if (d->object_type == OBJECT_NONE) {
+		return;
+	}
+
+	auto it = type->objects.find(e->object_id);
+	if (d->new_object) {
+		if (type->name == NULL) {
+			type->name = d->name;
+		}
+		if (it != type->objects.end()) {
+			/* The object_id got reused, so the previous object must be done */
+			analyze_object_done(type, it->second);
+			type->objects.erase(it);
+		}
+
+		analyze_object &object = type->objects[e->object_id];
+		object.index = entry->object_index;
+		object.events.push_back(event);
+		return;
+	}
+
+	/* Skip objects created before the start of the trace */
+	if (it == type->objects.end()) {
+		return;
+	}
+
+	analyze_object &object = it->second;
+	prev_tpoint_id = object.events.back().tpoint_id;
+	analyze_stats_tally(&g_analyze_pairs[std::make_pair(prev_tpoint_id, e->tpoint_id)],
+			    e->tsc - object.events.back().tsc);
+	object.events.push_back(event);
+}
+
+static void
+analyze_print_stats(const char *name, const struct analyze_stats *stats, uint64_t tsc_rate)
+{
+	uint64_t values[SPDK_COUNTOF(g_analyze_percentiles)];
+	size_t i;
+
+	analyze_get_percentiles(stats, values);
+	printf("%-50.50s %10ju %10.3f %10.3f", name, stats->count,
+	       get_us_from_tsc(stats->min, tsc_rate),
+	       get_us_from_tsc(stats->total / stats->count, tsc_rate));
+	for (i = 0; i < SPDK_COUNTOF(values); i++) {
+		printf(" %10.3f", get_us_from_tsc(values[i], tsc_rate));
+	}
+	printf(" %10.3f\n", get_us_from_tsc(stats->max, tsc_rate));
+}
+
+static void
+analyze_print_header(const char *title)
+{
+	size_t i;
+
+	printf("\n%-50s %10s %10s %10s", title, "count", "min", "avg");
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_percentiles); i++) {
+		printf(" %9gth", g_analyze_percentiles[i]);
+	}
+	printf(" %10s\n", "max");
+}
+
+static void
+analyze_print(uint64_t tsc_rate)
+{
+	struct analyze_type *type;
+	char name[64];
+	uint64_t offset;
+	size_t i, j;
+
+	printf("TSC Rate: %ju\nLatencies in usec\n", tsc_rate);
+	analyze_print_header("Object lifetime");
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		type = &g_analyze_types[i];
+		if (type->latency.count == 0) {
+			continue;
+		}
+		snprintf(name, sizeof(name), "%c (%s)", g_file->object[i].id_prefix, type->name);
+		analyze_print_stats(name, &type->latency, tsc_rate);
+	}
+
+	analyze_print_header("Tracepoint pair");
+	for (auto &pair : g_analyze_pairs) {
+		snprintf(name, sizeof(name), "%s -> %s", g_file->tpoint[pair.first.first].name,
+			 g_file->tpoint[pair.first.second].name);
+		analyze_print_stats(name, &pair.second, tsc_rate);
+	}
+
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		type = &g_analyze_types[i];
+		if (type->slowest.empty()) {
+			continue;
+		}
+
+		printf("\nSlowest %zu objects of type %c (%s)\n", type->slowest.size(),
+		       g_file->object[i].id_prefix, type->name);
+		for (auto &object : type->slowest) {
+			printf("%c%ju: %.3f us\n", g_file->object[i].id_prefix, object.index,
+			       get_us_from_tsc(object.latency, tsc_rate));
+			for (j = 0; j < object.events.size(); j++) {
+				offset = object.events[j].tsc - object.events[0].tsc;
+				printf("    %2u: %10.3f %s\n", object.events[j].lcore,
+				       get_us_from_tsc(offset, tsc_rate),
+				       g_file->tpoint[object.events[j].tpoint_id].name);
+			}
+		}
+	}
+}
+
+static void
+analyze_print_csv_stats(const char *section, const char *from, const char *to,
+			const struct analyze_stats *stats, uint64_t tsc_rate)
+{
+	uint64_t values[SPDK_COUNTOF(g_analyze_percentiles)];
+	size_t i;
+
+	analyze_get_percentiles(stats, values);
+	printf("%s,%s,%s,%ju,%.3f,%.3f", section, from, to, stats->count,
+	       get_us_from_tsc(stats->min, tsc_rate),
+	       get_us_from_tsc(stats->total / stats->count, tsc_rate));
+	for (i = 0; i < SPDK_COUNTOF(values); i++) {
+		printf(",%.3f", get_us_from_tsc(values[i], tsc_rate));
+	}
+	printf(",%.3f\n", get_us_from_tsc(stats->max, tsc_rate));
+}
+
+static void
+analyze_print_csv(uint64_t tsc_rate)
+{
+	struct analyze_type *type;
+	char name[8];
+	uint64_t offset;
+	size_t i, j;
+
+	printf("section,from,to,count,min_us,avg_us");
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_percentiles); i++) {
+		printf(",p%g_us", g_analyze_percentiles[i]);
+	}
+	printf(",max_us\n");
+
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		type = &g_analyze_types[i];
+		if (type->latency.count != 0) {
+			snprintf(name, sizeof(name), "%c", g_file->object[i].id_prefix);
+			analyze_print_csv_stats("lifetime", name, type->name, &type->latency,
+						tsc_rate);
+		}
+	}
+
+	for (auto &pair : g_analyze_pairs) {
+		analyze_print_csv_stats("pair", g_file->tpoint[pair.first.first].name,
+					g_file->tpoint[pair.first.second].name, &pair.second,
+					tsc_rate);
+	}
+
+	/* Event chains of the slowest objects, one event per row */
+	printf("\nobject,latency_us,event,lcore,offset_us,tpoint\n");
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		for (auto &object : g_analyze_types[i].slowest) {
+			for (j = 0; j < object.events.size(); j++) {
+				offset = object.events[j].tsc - object.events[0].tsc;
+				printf("%c%ju,%.3f,%zu,%u,%.3f,%s\n", g_file->object[i].id_prefix,
+				       object.index, get_us_from_tsc(object.latency, tsc_rate), j,
+				       object.events[j].lcore, get_us_from_tsc(offset, tsc_rate),
+				       g_file->tpoint[object.events[j].tpoint_id].name);
+			}
+		}
+	}
+}
+
+static void
+analyze_write_histogram_bucket(void *ctx, uint64_t start, uint64_t end, uint64_t count,
+			       uint64_t total, uint64_t so_far)
+{
+	if (count == 0) {
+		return;
+	}
+
+	spdk_json_write_array_begin(g_json);
+	spdk_json_write_uint64(g_json, start);
+	spdk_json_write_uint64(g_json, end);
+	spdk_json_write_uint64(g_json, count);
+	spdk_json_write_array_end(g_json);
+}
+
+static void
+analyze_write_json_stats(const struct analyze_stats *stats)
+{
+	uint64_t values[SPDK_COUNTOF(g_analyze_percentiles)];
+	char name[32];
+	size_t i;
+
+	analyze_get_percentiles(stats, values);
+	spdk_json_write_named_uint64(g_json, "count", stats->count);
+	spdk_json_write_named_uint64(g_json, "min", stats->min);
+	spdk_json_write_named_uint64(g_json, "avg", stats->total / stats->count);
+	spdk_json_write_named_uint64(g_json, "max", stats->max);
+	spdk_json_write_named_object_begin(g_json, "percentiles");
+	for (i = 0; i < SPDK_COUNTOF(values); i++) {
+		snprintf(name, sizeof(name), "%g", g_analyze_percentiles[i]);
+		spdk_json_write_named_uint64(g_json, name, values[i]);
+	}
+	spdk_json_write_object_end(g_json);
+
+	/* Non-empty buckets as [start, end, count] */
+	spdk_json_write_named_array_begin(g_json, "histogram");
+	spdk_histogram_data_iterate(stats->histogram, analyze_write_histogram_bucket, NULL);
+	spdk_json_write_array_end(g_json);
+}
+
+static int
+analyze_print_json(uint64_t tsc_rate)
+{
+	struct analyze_type *type;
+	size_t i;
+
+	g_json = spdk_json_write_begin(print_json, NULL, 0);
+	if (g_json == NULL) {
+		fprintf(stderr, "Failed to allocate JSON write context\n");
+		return -1;
+	}
+
+	/* All values are in TSC ticks */
+	spdk_json_write_object_begin(g_json);
+	spdk_json_write_named_uint64(g_json, "tsc_rate", tsc_rate);
+
+	spdk_json_write_named_array_begin(g_json, "lifetimes");
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		type = &g_analyze_types[i];
+		if (type->latency.count == 0) {
+			continue;
+		}
+		spdk_json_write_object_begin(g_json);
+		spdk_json_write_named_string_fmt(g_json, "object", "%c",
+						 g_file->object[i].id_prefix);
+		spdk_json_write_named_string(g_json, "tpoint", type->name);
+		analyze_write_json_stats(&type->latency);
+		spdk_json_write_object_end(g_json);
+	}
+	spdk_json_write_array_end(g_json);
+
+	spdk_json_write_named_array_begin(g_json, "pairs");
+	for (auto &pair : g_analyze_pairs) {
+		spdk_json_write_object_begin(g_json);
+		spdk_json_write_named_string(g_json, "from", g_file->tpoint[pair.first.first].name);
+		spdk_json_write_named_string(g_json, "to", g_file->tpoint[pair.first.second].name);
+		analyze_write_json_stats(&pair.second);
+		spdk_json_write_object_end(g_json);
+	}
+	spdk_json_write_array_end(g_json);
+
+	spdk_json_write_named_array_begin(g_json, "slowest");
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		for (auto &object : g_analyze_types[i].slowest) {
+			spdk_json_write_object_begin(g_json);
+			spdk_json_write_named_string_fmt(g_json, "id", "%c%" PRIu64,
+							 g_file->object[i].id_prefix, object.index);
+			spdk_json_write_named_uint64(g_json, "latency", object.latency);
+			spdk_json_write_named_array_begin(g_json, "events");
+			for (auto &event : object.events) {
+				spdk_json_write_object_begin(g_json);
+				spdk_json_write_named_uint32(g_json, "lcore", event.lcore);
+				spdk_json_write_named_string(g_json, "tpoint",
+							     g_file->tpoint[event.tpoint_id].name);
+				spdk_json_write_named_uint64(g_json, "tsc", event.tsc);
+				spdk_json_write_object_end(g_json);
+			}
+			spdk_json_write_array_end(g_json);
+			spdk_json_write_object_end(g_json);
+		}
+	}
+	spdk_json_write_array_end(g_json);
+
+	spdk_json_write_object_end(g_json);
+	spdk_json_write_end(g_json);
+
+	return 0;
+}
+
+static int
+trace_analyze(enum print_format_type print_format)
+{
+	struct spdk_trace_parser_entry	entry;
+	struct analyze_type		*type;
+	uint64_t			tsc_offset;
+	uint64_t			tsc_rate = g_file->tsc_rate;
+	size_t				i;
+	int				rc = 0;
+
+	tsc_offset = spdk_trace_parser_get_tsc_offset(g_parser);
+	while (spdk_trace_parser_next_entry(g_parser, &entry)) {
+		if (entry.entry->tsc < tsc_offset) {
+			continue;
+		}
+		analyze_entry(&entry);
+	}
+
+	/* Objects still in flight end with their last recorded event */
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		type = &g_analyze_types[i];
+		for (auto &object : type->objects) {
+			analyze_object_done(type, object.second);
+		}
+		type->objects.clear();
+		std::sort_heap(type->slowest.begin(), type->slowest.end(), analyze_slower);
+	}
+
+	switch (print_format) {
+	case PRINT_FMT_JSON:
+		rc = analyze_print_json(tsc_rate);
+		break;
+	case PRINT_FMT_CSV:
+		analyze_print_csv(tsc_rate);
+		break;
+	case PRINT_FMT_DEFAULT:
+	default:
+		analyze_print(tsc_rate);
+		break;
+	}
+
+	for (i = 0; i < SPDK_COUNTOF(g_analyze_types); i++) {
+		spdk_histogram_data_free(g_analyze_types[i].latency.histogram);
+	}
+	for (auto &pair : g_analyze_pairs) {
+		spdk_histogram_data_free(pair.second.histogram);
+	}
+
+	return rc;
+}
+
 static void
 usage(void)
 {
@@ -404,6 +865,11 @@ usage(void)
 	fprintf(stderr, "                      newest trace file in /dev/shm\n");
 #endif
 	fprintf(stderr, "                 '-j' to use JSON to format the output\n");
+	fprintf(stderr, "                 '-a' to analyze latencies of traced objects\n");
+	fprintf(stderr, "                      instead of printing the events\n");
+	fprintf(stderr, "                 '-n' to specify the number of slowest objects of each\n");
+	fprintf(stderr, "                      type to report with -a (default: 10)\n");
+	fprintf(stderr, "                 '-C' to use CSV to format the output of -a\n");
 }
 
 #if defined(__linux__)
@@ -434,10 +900,25 @@ main(int argc, char **argv)
 	int				rc = 0;
 	char				shm_name[64];
 	int				shm_id = -1, shm_pid = -1;
+	bool				analyze = false;
 
 	g_exe_name = argv[0];
-	while ((op = getopt(argc, argv, "c:f:i:jp:s:t")) != -1) {
+	while ((op = getopt(argc, argv, "ac:f:i:jn:p:s:tC")) != -1) {
 		switch (op) {
+		case 'a':
+			analyze = true;
+			break;
+		case 'n':
+			g_analyze_top = spdk_strtoll(optarg, 10);
+			if ((int64_t)g_analyze_top < 0) {
+				fprintf(stderr, "Invalid number of slowest objects: %s\n", optarg);
+				usage();
+				exit(1);
+			}
+			break;
+		case 'C':
+			print_format = PRINT_FMT_CSV;
+			break;
 		case 'c':
 			lcore = atoi(optarg);
 			if (lcore > SPDK_TRACE_MAX_LCORE) {
@@ -471,6 +952,12 @@ main(int argc, char **argv)
 		}
 	}
 
+	if (print_format == PRINT_FMT_CSV && !analyze) {
+		fprintf(stderr, "-C can only be used with -a\n");
+		usage();
+		exit(1);
+	}
+
 	if (file_name != NULL && app_name != NULL) {
 		fprintf(stderr, "-f and -s are mutually exclusive\n");
 		usage();
@@ -514,6 +1001,12 @@ main(int argc, char **argv)
 	}
 
 	g_file = spdk_trace_parser_get_file(g_parser);
+	if (analyze) {
+		rc = trace_analyze(print_format);
+		spdk_trace_parser_cleanup(g_parser);
+		return rc;
+	}
+
 	switch (print_format) {
 	case PRINT_FMT_JSON:
 		rc = trace_print_json();
@@ -10,10 +10,20 @@
 #include "spdk/trace.h"
 #include "spdk/util.h"
 #include "spdk/barrier.h"
+#include "spdk/queue.h"
 
 #define TRACE_FILE_COPY_SIZE	(32 * 1024)
 #define TRACE_PATH_MAX		2048
 
+#define TRACE_STREAM_MAGIC		"SPDKTRS"
+#define TRACE_STREAM_VERSION		1
+#define TRACE_STREAM_SEGMENT_ENTRIES	(16 * 1024)
+/* Upper bound of a single varint encoded trace entry */
+#define TRACE_STREAM_MAX_ENTRY_SIZE	64
+/* Number of entries past next_entry that spdk_trace_record() may still be filling in */
+#define TRACE_STREAM_GUARD_ENTRIES	16
+#define TRACE_STREAM_DEFAULT_ROTATE_MB	256
+
 static char *g_exe_name;
 static int g_verbose = 1;
 static uint64_t g_tsc_rate;
@@ -21,6 +31,24 @@ static uint64_t g_utsc_rate;
 static bool g_shutdown = false;
 static uint64_t g_file_size;
 
+struct lcore_trace_record_ctx;
+
+struct trace_stream_segment {
+	struct lcore_trace_record_ctx		*lcore_port;
+	struct spdk_trace_entry			*entries;
+	uint64_t				num_entries;
+
+	/* Number of entries lost on the lcore since the previous segment */
+	uint64_t				num_dropped;
+
+	/* Local tsc of the first entry copied into this segment */
+	uint64_t				start_tsc;
+
+	/* Set while the segment is owned by the writer thread */
+	bool					busy;
+	TAILQ_ENTRY(trace_stream_segment)	link;
+};
+
 struct lcore_trace_record_ctx {
 	char lcore_file[TRACE_PATH_MAX];
 	int fd;
@@ -37,6 +65,34 @@ struct lcore_trace_record_ctx {
 
 	/* Total number of entries in lcore trace file */
 	uint64_t num_entries;
+
+	/* Streaming mode: segments are filled and handed to the writer thread in turns */
+	struct trace_stream_segment segments[2];
+	int cur_segment;
+
+	/* Streaming mode: total number of entries overwritten before they could be recorded */
+	uint64_t num_dropped;
+};
+
+struct trace_stream_ctx {
+	const char *prefix;
+	uint64_t rotate_size;
+	uint32_t max_files;
+	uint32_t seq;
+	int fd;
+	uint64_t file_size;
+	uint8_t *buf;
+	struct spdk_trace_file *trace_file;
+
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	TAILQ_HEAD(, trace_stream_segment) queue;
+	bool exit;
+	int rc;
+
+	uint64_t raw_bytes;
+	uint64_t written_bytes;
 };
 
 struct aggr_trace_record_ctx {
@@ -45,6 +101,34 @@ struct aggr_trace_record_ctx {
 	int shm_fd;
 	struct lcore_trace_record_ctx lcore_ports[SPDK_TRACE_MAX_LCORE];
 	struct spdk_trace_file *trace_file;
+	struct trace_stream_ctx stream;
+};
+
+/*
+ * Stream files start with a trace_stream_header followed by a copy of struct spdk_trace_file,
+ * which carries the tracepoint definitions.  The rest of the file is a sequence of blocks.
+ * Entry blocks hold the entries of one lcore.  Each entry is stored as a zigzag varint of its
+ * tsc delta from the previous entry, followed by varints of the remaining fields.  An owner
+ * block with the owner descriptions closes every file.
+ */
+struct trace_stream_header {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	metadata_size;
+};
+
+enum trace_stream_block_type {
+	TRACE_STREAM_BLOCK_ENTRIES = 1,
+	TRACE_STREAM_BLOCK_OWNERS = 2,
+};
+
+struct trace_stream_block {
+	uint32_t	type;
+	uint32_t	lcore;
+	uint64_t	payload_size;
+	uint64_t	num_entries;
+	uint64_t	base_tsc;
+	uint64_t	num_dropped;
 };
 
 static int
@@ -556,6 +640,700 @@ out:
 	return rc;
 }
 
+static uint8_t *
+trace_stream_put_varint(uint8_t *buf, uint64_t value)
+{
+	while (value >= 0x80) {
+		*buf++ = (uint8_t)value | 0x80;
+		value >>= 7;
+	}
+	*buf++ = (uint8_t)value;
+
+	return buf;
+}
+
+static int
+trace_stream_get_varint(const uint8_t **buf, const uint8_t *end, uint64_t *value)
+{
+	const uint8_t *p = *buf;
+	uint64_t result = 0;
+	int shift;
+
+	for (shift = 0; shift < 64 && p < end; shift += 7) {
+		result |= (uint64_t)(*p & 0x7f) << shift;
+		if ((*p++ & 0x80) == 0) {
+			*value = result;
+			*buf = p;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+static size_t
+trace_stream_encode(uint8_t *buf, const struct spdk_trace_entry *entries, uint64_t num_entries,
+		    uint64_t base_tsc)
+{
+	const struct spdk_trace_entry *e;
+	uint8_t *p = buf;
+	uint64_t prev_tsc = base_tsc, args, i;
+	int64_t delta;
+
+	for (i = 0; i < num_entries; i++) {
+		e = &entries[i];
+
+		/* Argument buffer entries carry the tsc of their record, so deltas are mostly 0 or
+		 * small.  They're zigzag encoded in case a torn entry goes backwards.
+		 */
+		delta = (int64_t)(e->tsc - prev_tsc);
+		p = trace_stream_put_varint(p, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+		p = trace_stream_put_varint(p, e->tpoint_id);
+		p = trace_stream_put_varint(p, e->owner_id);
+		p = trace_stream_put_varint(p, e->size);
+		p = trace_stream_put_varint(p, e->object_id);
+		memcpy(&args, e->args, sizeof(args));
+		p = trace_stream_put_varint(p, args);
+
+		prev_tsc = e->tsc;
+	}
+
+	return p - buf;
+}
+
+static int
+trace_stream_decode_entries(const uint8_t *buf, size_t size, struct spdk_trace_entry *entries,
+			    uint64_t num_entries, uint64_t base_tsc)
+{
+	const uint8_t *p = buf, *end = buf + size;
+	struct spdk_trace_entry *e;
+	uint64_t tsc = base_tsc, value[6], i;
+	int j;
+
+	for (i = 0; i < num_entries; i++) {
+		for (j = 0; j < (int)SPDK_COUNTOF(value); j++) {
+			if (trace_stream_get_varint(&p, end, &value[j])) {
+				return -1;
+			}
+		}
+
+		e = &entries[i];
+		tsc += (value[0] >> 1) ^ -(value[0] & 1);
+		e->tsc = tsc;
+		e->tpoint_id = value[1];
+		e->owner_id = value[2];
+		e->size = value[3];
+		e->object_id = value[4];
+		memcpy(e->args, &value[5], sizeof(e->args));
+	}
+
+	return p == end ? 0 : -1;
+}
+
+static uint64_t
+trace_stream_owner_size(struct spdk_trace_file *trace_file)
+{
+	return (uint64_t)trace_file->num_owners *
+	       (sizeof(struct spdk_trace_owner) + trace_file->owner_description_size);
+}
+
+static int
+trace_stream_write_block(struct trace_stream_ctx *stream, struct trace_stream_block *block,
+			 const void *payload)
+{
+	if (cont_write(stream->fd, block, sizeof(*block)) < 0 ||
+	    cont_write(stream->fd, payload, block->payload_size) < 0) {
+		fprintf(stderr, "Failed to write block into stream file %s.%u\n", stream->prefix,
+			stream->seq);
+		return -1;
+	}
+
+	stream->file_size += sizeof(*block) + block->payload_size;
+	stream->written_bytes += sizeof(*block) + block->payload_size;
+
+	return 0;
+}
+
+static int
+trace_stream_file_open(struct trace_stream_ctx *stream)
+{
+	struct trace_stream_header header = {};
+	char path[TRACE_PATH_MAX];
+
+	if (stream->max_files != 0 && stream->seq >= stream->max_files) {
+		snprintf(path, sizeof(path), "%s.%u", stream->prefix,
+			 stream->seq - stream->max_files);
+		if (unlink(path) != 0 && errno != ENOENT) {
+			fprintf(stderr, "Could not remove old stream file %s.\n", path);
+		}
+	}
+
+	snprintf(path, sizeof(path), "%s.%u", stream->prefix, stream->seq);
+	stream->fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+	if (stream->fd < 0) {
+		fprintf(stderr, "Could not open stream file %s.\n", path);
+		return -1;
+	}
+
+	memcpy(header.magic, TRACE_STREAM_MAGIC, sizeof(header.magic));
+	header.version = TRACE_STREAM_VERSION;
+	header.metadata_size = sizeof(struct spdk_trace_file);
+
+	/* Thread names may have changed since the last file, so take a fresh copy */
+	if (cont_write(stream->fd, &header, sizeof(header)) < 0 ||
+	    cont_write(stream->fd, stream->trace_file, sizeof(struct spdk_trace_file)) < 0) {
+		fprintf(stderr, "Failed to write metadata into stream file %s\n", path);
+		close(stream->fd);
+		stream->fd = -1;
+		return -1;
+	}
+
+	stream->file_size = sizeof(header) + sizeof(struct spdk_trace_file);
+
+	if (g_verbose) {
+		printf("Stream trace entries into %s\n", path);
+	}
+
+	return 0;
+}
+
+static int
+trace_stream_file_close(struct trace_stream_ctx *stream)
+{
+	struct trace_stream_block block = {};
+	uint8_t *owner_buf;
+	int rc;
+
+	block.type = TRACE_STREAM_BLOCK_OWNERS;
+	block.num_entries = stream->trace_file->num_owners;
+	block.payload_size = trace_stream_owner_size(stream->trace_file);
+
+	owner_buf = (uint8_t *)stream->trace_file + stream->trace_file->owner_offset;
+	rc = trace_stream_write_block(stream, &block, owner_buf);
+	close(stream->fd);
+	stream->fd = -1;
+
+	return rc;
+}
+
+static int
+trace_stream_write_segment(struct trace_stream_ctx *stream, struct trace_stream_segment *seg)
+{
+	struct trace_stream_block block = {};
+	int rc;
+
+	if (stream->fd >= 0 && stream->file_size >= stream->rotate_size) {
+		rc = trace_stream_file_close(stream);
+		stream->seq++;
+		if (rc) {
+			return rc;
+		}
+	}
+
+	if (stream->fd < 0) {
+		rc = trace_stream_file_open(stream);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	block.type = TRACE_STREAM_BLOCK_ENTRIES;
+	block.lcore = seg->lcore_port->in_history->lcore;
+	block.num_entries = seg->num_entries;
+	block.num_dropped = seg->num_dropped;
+	block.base_tsc = seg->num_entries ? seg->entries[0].tsc : 0;
+	block.payload_size = trace_stream_encode(stream->buf, seg->entries, seg->num_entries,
+			     block.base_tsc);
+	stream->raw_bytes += seg->num_entries * sizeof(struct spdk_trace_entry);
+
+	return trace_stream_write_block(stream, &block, stream->buf);
+}
+
+static void *
+trace_stream_writer(void *arg)
+{
+	struct trace_stream_ctx *stream = arg;
+	struct trace_stream_segment *seg;
+	int rc = 0;
+
+	while (true) {
+		pthread_mutex_lock(&stream->mutex);
+		while (TAILQ_EMPTY(&stream->queue) && !stream->exit) {
+			pthread_cond_wait(&stream->cond, &stream->mutex);
+		}
+
+		seg = TAILQ_FIRST(&stream->queue);
+		if (seg == NULL) {
+			pthread_mutex_unlock(&stream->mutex);
+			break;
+		}
+		TAILQ_REMOVE(&stream->queue, seg, link);
+		pthread_mutex_unlock(&stream->mutex);
+
+		/* Keep handing segments back after an error, so the capture loop never blocks */
+		if (rc == 0) {
+			rc = trace_stream_write_segment(stream, seg);
+		}
+
+		pthread_mutex_lock(&stream->mutex);
+		seg->num_entries = 0;
+		seg->num_dropped = 0;
+		seg->start_tsc = 0;
+		seg->busy = false;
+		if (rc) {
+			stream->rc = rc;
+		}
+		pthread_cond_broadcast(&stream->cond);
+		pthread_mutex_unlock(&stream->mutex);
+	}
+
+	if (rc == 0 && stream->fd >= 0) {
+		stream->rc = trace_stream_file_close(stream);
+	}
+
+	return NULL;
+}
+
+static int
+trace_stream_segment_submit(struct trace_stream_ctx *stream,
+			    struct lcore_trace_record_ctx *lcore_port, bool wait)
+{
+	struct trace_stream_segment *seg = &lcore_port->segments[lcore_port->cur_segment];
+	struct trace_stream_segment *next = &lcore_port->segments[!lcore_port->cur_segment];
+	int rc;
+
+	if (seg->num_entries == 0 && seg->num_dropped == 0) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&stream->mutex);
+	if (next->busy && !wait) {
+		pthread_mutex_unlock(&stream->mutex);
+		return 0;
+	}
+
+	while (next->busy) {
+		pthread_cond_wait(&stream->cond, &stream->mutex);
+	}
+
+	seg->busy = true;
+	TAILQ_INSERT_TAIL(&stream->queue, seg, link);
+	pthread_cond_broadcast(&stream->cond);
+	rc = stream->rc;
+	pthread_mutex_unlock(&stream->mutex);
+
+	lcore_port->cur_segment = !lcore_port->cur_segment;
+
+	return rc;
+}
+
+static int
+trace_stream_lcore_record(struct trace_stream_ctx *stream,
+			  struct lcore_trace_record_ctx *lcore_port)
+{
+	struct spdk_trace_history	*in_history = lcore_port->in_history;
+	struct trace_stream_segment	*seg;
+	uint64_t			rec_next_entry = lcore_port->rec_next_entry;
+	uint64_t			num_cir_entries = in_history->num_entries;
+	uint64_t			shm_next_entry, safe_next_entry;
+	uint64_t			count, lost, cir_idx;
+	int				rc;
+
+	shm_next_entry = in_history->next_entry;
+
+	/* Ensure all entries of spdk_trace_history are latest to next_entry */
+	spdk_smp_rmb();
+
+	seg = &lcore_port->segments[lcore_port->cur_segment];
+	if (shm_next_entry == rec_next_entry) {
+		goto out;
+	} else if (shm_next_entry < rec_next_entry) {
+		fprintf(stderr, "Trace porting error in lcore %d, trace rollback occurs.\n",
+			in_history->lcore);
+		fprintf(stderr, "shm_next_entry is %ju, record_next_entry is %ju.\n",
+			shm_next_entry, rec_next_entry);
+		return -1;
+	}
+
+	if (shm_next_entry - rec_next_entry > num_cir_entries) {
+		/* Entries overwritten before this tool attached aren't counted as dropped */
+		if (lcore_port->first_entry_tsc != 0) {
+			lost = shm_next_entry - rec_next_entry - num_cir_entries;
+			lcore_port->num_dropped += lost;
+			seg->num_dropped += lost;
+		}
+		rec_next_entry = shm_next_entry - num_cir_entries;
+	}
+
+	while (rec_next_entry < shm_next_entry) {
+		seg = &lcore_port->segments[lcore_port->cur_segment];
+		if (seg->num_entries == TRACE_STREAM_SEGMENT_ENTRIES) {
+			rc = trace_stream_segment_submit(stream, lcore_port, true);
+			if (rc) {
+				return rc;
+			}
+			continue;
+		}
+
+		cir_idx = rec_next_entry & (num_cir_entries - 1);
+		count = spdk_min(shm_next_entry - rec_next_entry, num_cir_entries - cir_idx);
+		count = spdk_min(count, TRACE_STREAM_SEGMENT_ENTRIES - seg->num_entries);
+		memcpy(&seg->entries[seg->num_entries], &in_history->entries[cir_idx],
+		       count * sizeof(struct spdk_trace_entry));
+
+		/* The lcore may have lapped us while copying, so discard whatever it could have
+		 * overwritten in the meantime.
+		 */
+		spdk_smp_rmb();
+		safe_next_entry = in_history->next_entry + TRACE_STREAM_GUARD_ENTRIES;
+		lost = 0;
+		if (safe_next_entry > rec_next_entry + num_cir_entries) {
+			lost = spdk_min(safe_next_entry - rec_next_entry - num_cir_entries, count);
+			memmove(&seg->entries[seg->num_entries],
+				&seg->entries[seg->num_entries + lost],
+				(count - lost) * sizeof(struct spdk_trace_entry));
+			lcore_port->num_dropped += lost;
+			seg->num_dropped += lost;
+		}
+
+		if (count > lost) {
+			if (seg->start_tsc == 0) {
+				seg->start_tsc = spdk_get_ticks();
+			}
+			if (lcore_port->first_entry_tsc == 0) {
+				lcore_port->first_entry_tsc = seg->entries[seg->num_entries].tsc;
+			}
+			seg->num_entries += count - lost;
+			lcore_port->num_entries += count - lost;
+			lcore_port->last_entry_tsc = seg->entries[seg->num_entries - 1].tsc;
+		}
+
+		rec_next_entry += count;
+	}
+
+	lcore_port->rec_next_entry = shm_next_entry;
+
+out:
+	/* Hand over segments at least once a second, so the files don't lag behind for long */
+	seg = &lcore_port->segments[lcore_port->cur_segment];
+	if (seg->start_tsc != 0 && spdk_get_ticks() - seg->start_tsc > g_tsc_rate) {
+		return trace_stream_segment_submit(stream, lcore_port, false);
+	}
+
+	return 0;
+}
+
+static int
+trace_stream_record(struct aggr_trace_record_ctx *ctx, const char *prefix, uint64_t rotate_mb,
+		    uint32_t max_files, uint64_t last_record_tsc)
+{
+	struct trace_stream_ctx *stream = &ctx->stream;
+	struct lcore_trace_record_ctx *lcore_port;
+	char path[TRACE_PATH_MAX];
+	uint64_t total_entries = 0, total_dropped = 0;
+	int rc = 0, i, j;
+
+	if (snprintf(path, sizeof(path), "%s.%u", prefix, UINT32_MAX) >= TRACE_PATH_MAX) {
+		fprintf(stderr, "Length of file path (%s) exceeds limitation for stream file.\n",
+			prefix);
+		return -1;
+	}
+
+	stream->prefix = prefix;
+	stream->rotate_size = rotate_mb * 1024 * 1024;
+	stream->max_files = max_files;
+	stream->fd = -1;
+	stream->trace_file = ctx->trace_file;
+	TAILQ_INIT(&stream->queue);
+	pthread_mutex_init(&stream->mutex, NULL);
+	pthread_cond_init(&stream->cond, NULL);
+
+	stream->buf = malloc(TRACE_STREAM_SEGMENT_ENTRIES * TRACE_STREAM_MAX_ENTRY_SIZE);
+	if (stream->buf == NULL) {
+		fprintf(stderr, "Failed to allocate memory for stream buffer.\n");
+		rc = -1;
+		goto out;
+	}
+
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		lcore_port = &ctx->lcore_ports[i];
+		if (!lcore_port->valid) {
+			continue;
+		}
+
+		for (j = 0; j < (int)SPDK_COUNTOF(lcore_port->segments); j++) {
+			lcore_port->segments[j].lcore_port = lcore_port;
+			lcore_port->segments[j].entries = calloc(TRACE_STREAM_SEGMENT_ENTRIES,
+							 sizeof(struct spdk_trace_entry));
+			if (lcore_port->segments[j].entries == NULL) {
+				fprintf(stderr, "Failed to allocate memory for stream segments.\n");
+				rc = -1;
+				goto out;
+			}
+		}
+	}
+
+	rc = pthread_create(&stream->thread, NULL, trace_stream_writer, stream);
+	if (rc) {
+		fprintf(stderr, "Failed to create stream writer thread.\n");
+		rc = -1;
+		goto out;
+	}
+
+	while (!g_shutdown && rc == 0 && (spdk_get_ticks() <= last_record_tsc)) {
+		for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+			lcore_port = &ctx->lcore_ports[i];
+
+			if (!lcore_port->valid) {
+				continue;
+			}
+			rc = trace_stream_lcore_record(stream, lcore_port);
+			if (rc) {
+				break;
+			}
+		}
+	}
+
+	/* Flush whatever is left in the segments being filled */
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE && rc == 0; i++) {
+		lcore_port = &ctx->lcore_ports[i];
+		if (lcore_port->valid) {
+			rc = trace_stream_segment_submit(stream, lcore_port, true);
+		}
+	}
+
+	pthread_mutex_lock(&stream->mutex);
+	stream->exit = true;
+	pthread_cond_broadcast(&stream->cond);
+	pthread_mutex_unlock(&stream->mutex);
+	pthread_join(stream->thread, NULL);
+
+	if (rc == 0) {
+		rc = stream->rc;
+	}
+
+	/* Summary report */
+	printf("TSC Rate: %ju\n", g_tsc_rate);
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		lcore_port = &ctx->lcore_ports[i];
+
+		if (lcore_port->num_entries == 0 && lcore_port->num_dropped == 0) {
+			continue;
+		}
+
+		printf("Stream %ju trace entries for lcore (%d) in %ju usec, %ju dropped\n",
+		       lcore_port->num_entries, i,
+		       (lcore_port->last_entry_tsc - lcore_port->first_entry_tsc) / g_utsc_rate,
+		       lcore_port->num_dropped);
+		total_entries += lcore_port->num_entries;
+		total_dropped += lcore_port->num_dropped;
+	}
+	printf("Streamed %ju trace entries (%ju dropped) as %ju bytes into %u file(s) %s.*\n",
+	       total_entries, total_dropped, stream->written_bytes, stream->seq + 1, prefix);
+	if (stream->raw_bytes != 0) {
+		printf("Compression ratio: %.2f\n",
+		       (double)stream->raw_bytes / stream->written_bytes);
+	}
+
+out:
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		for (j = 0; j < (int)SPDK_COUNTOF(ctx->lcore_ports[i].segments); j++) {
+			free(ctx->lcore_ports[i].segments[j].entries);
+		}
+	}
+	free(stream->buf);
+	pthread_cond_destroy(&stream->cond);
+	pthread_mutex_destroy(&stream->mutex);
+
+	return rc;
+}
+
+struct trace_stream_lcore {
+	struct spdk_trace_entry	*entries;
+	uint64_t		num_entries;
+	uint64_t		max_entries;
+	uint64_t		num_dropped;
+};
+
+static int
+trace_stream_decode(const char *stream_file, const char *out_file)
+{
+	struct trace_stream_header	header;
+	struct trace_stream_block	block;
+	struct trace_stream_lcore	*lcores = NULL, *lcore;
+	struct spdk_trace_file		*trace_file = NULL;
+	struct spdk_trace_history	*history = NULL;
+	struct spdk_trace_entry		*entries;
+	uint8_t				*payload = NULL, *owner_buf = NULL;
+	uint64_t			owner_size, max_payload_size, offset, max_entries, j;
+	int				in_fd, out_fd = -1, rc = -1, i;
+
+	in_fd = open(stream_file, O_RDONLY);
+	if (in_fd < 0) {
+		fprintf(stderr, "Could not open stream file %s.\n", stream_file);
+		return -1;
+	}
+
+	trace_file = malloc(sizeof(*trace_file));
+	lcores = calloc(SPDK_TRACE_MAX_LCORE, sizeof(*lcores));
+	history = calloc(1, sizeof(*history));
+	if (trace_file == NULL || lcores == NULL || history == NULL) {
+		fprintf(stderr, "Failed to allocate memory for decoding.\n");
+		goto out;
+	}
+
+	if (cont_read(in_fd, &header, sizeof(header)) != sizeof(header) ||
+	    memcmp(header.magic, TRACE_STREAM_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != TRACE_STREAM_VERSION ||
+	    header.metadata_size != sizeof(*trace_file) ||
+	    cont_read(in_fd, trace_file, sizeof(*trace_file)) != sizeof(*trace_file)) {
+		fprintf(stderr, "%s is not a valid trace stream file.\n", stream_file);
+		goto out;
+	}
+
+	owner_size = trace_stream_owner_size(trace_file);
+	max_payload_size = spdk_max(owner_size,
+				    TRACE_STREAM_SEGMENT_ENTRIES * TRACE_STREAM_MAX_ENTRY_SIZE);
+	payload = malloc(max_payload_size);
+	owner_buf = calloc(1, owner_size + 1);
+	if (payload == NULL || owner_buf == NULL) {
+		fprintf(stderr, "Failed to allocate memory for decoding.\n");
+		goto out;
+	}
+
+	while (cont_read(in_fd, &block, sizeof(block)) == sizeof(block)) {
+		if (block.payload_size > max_payload_size) {
+			fprintf(stderr, "Stream file %s is corrupted.\n", stream_file);
+			goto out;
+		}
+
+		/* The last block of a file that is still being written may be incomplete */
+		if (cont_read(in_fd, payload, block.payload_size) != (int)block.payload_size) {
+			fprintf(stderr, "Stream file %s is truncated, skipping its last block.\n",
+				stream_file);
+			break;
+		}
+
+		switch (block.type) {
+		case TRACE_STREAM_BLOCK_ENTRIES:
+			if (block.lcore >= SPDK_TRACE_MAX_LCORE ||
+			    block.num_entries > TRACE_STREAM_SEGMENT_ENTRIES) {
+				fprintf(stderr, "Stream file %s is corrupted.\n", stream_file);
+				goto out;
+			}
+
+			lcore = &lcores[block.lcore];
+			if (lcore->num_entries + block.num_entries > lcore->max_entries) {
+				max_entries = spdk_max(lcore->max_entries * 2,
+						       lcore->num_entries + block.num_entries);
+				entries = realloc(lcore->entries, max_entries * sizeof(*entries));
+				if (entries == NULL) {
+					fprintf(stderr, "Failed to allocate memory for entries.\n");
+					goto out;
+				}
+				lcore->entries = entries;
+				lcore->max_entries = max_entries;
+			}
+
+			if (trace_stream_decode_entries(payload, block.payload_size,
+							&lcore->entries[lcore->num_entries],
+							block.num_entries, block.base_tsc)) {
+				fprintf(stderr, "Stream file %s is corrupted.\n", stream_file);
+				goto out;
+			}
+			lcore->num_entries += block.num_entries;
+			lcore->num_dropped += block.num_dropped;
+			break;
+		case TRACE_STREAM_BLOCK_OWNERS:
+			if (block.payload_size != owner_size) {
+				fprintf(stderr, "Stream file %s is corrupted.\n", stream_file);
+				goto out;
+			}
+			memcpy(owner_buf, payload, owner_size);
+			break;
+		default:
+			fprintf(stderr, "Stream file %s is corrupted.\n", stream_file);
+			goto out;
+		}
+	}
+
+	out_fd = open(out_file, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+	if (out_fd < 0) {
+		fprintf(stderr, "Could not open trace file %s.\n", out_file);
+		goto out;
+	}
+
+	/* Lay out the decoded entries of each lcore as a linear trace history */
+	offset = sizeof(*trace_file);
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		if (lcores[i].num_entries == 0) {
+			trace_file->lcore_history_offsets[i] = 0;
+			continue;
+		}
+		trace_file->lcore_history_offsets[i] = offset;
+		offset += spdk_get_trace_history_size(lcores[i].num_entries);
+	}
+	trace_file->owner_offset = offset;
+	trace_file->file_size = offset + owner_size;
+
+	if (cont_write(out_fd, trace_file, sizeof(*trace_file)) < 0) {
+		fprintf(stderr, "Failed to write metadata into trace file\n");
+		goto out;
+	}
+
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		lcore = &lcores[i];
+		if (lcore->num_entries == 0) {
+			continue;
+		}
+
+		memset(history, 0, sizeof(*history));
+		history->lcore = i;
+		history->num_entries = lcore->num_entries;
+		history->next_entry = lcore->num_entries;
+		for (j = 0; j < lcore->num_entries; j++) {
+			if (lcore->entries[j].tpoint_id < SPDK_TRACE_MAX_TPOINT_ID) {
+				history->tpoint_count[lcore->entries[j].tpoint_id]++;
+			}
+		}
+
+		if (cont_write(out_fd, history, sizeof(*history)) < 0 ||
+		    cont_write(out_fd, lcore->entries,
+			       lcore->num_entries * sizeof(*lcore->entries)) < 0) {
+			fprintf(stderr, "Failed to write lcore trace entries into trace file\n");
+			goto out;
+		}
+
+		printf("Decoded %ju trace entries for lcore (%d), %ju dropped\n",
+		       lcore->num_entries, i, lcore->num_dropped);
+	}
+
+	if (cont_write(out_fd, owner_buf, owner_size) < 0) {
+		fprintf(stderr, "Failed to write owner_data into trace file\n");
+		goto out;
+	}
+
+	printf("Trace stream %s is decoded into trace file %s\n", stream_file, out_file);
+	rc = 0;
+out:
+	if (out_fd >= 0) {
+		close(out_fd);
+	}
+	close(in_fd);
+	if (lcores != NULL) {
+		for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+			free(lcores[i].entries);
+		}
+	}
+	free(lcores);
+	free(history);
+	free(trace_file);
+	free(payload);
+	free(owner_buf);
+
+	return rc;
+}
+
 static void
 __shutdown_signal(int signo)
 {
@@ -603,6 +1381,13 @@ usage(void)
 	printf("                      (one of -i or -p must be specified)\n");
 	printf("                 '-f' to specify output trace file name\n");
 	printf("                 '-t' to specify the duration of the trace record in seconds\n");
+	printf("                 '-z' to continuously stream compressed trace entries into\n");
+	printf("                      rotating files <file>.<n> instead of a single trace file\n");
+	printf("                 '-r' to specify the size in MiB at which stream files are\n");
+	printf("                      rotated (default: %d)\n", TRACE_STREAM_DEFAULT_ROTATE_MB);
+	printf("                 '-n' to specify the number of most recent stream files to keep\n");
+	printf("                      (default: 0, keep all of them)\n");
+	printf("                 '-d' to decode a stream file into the trace file given by -f\n");
 	printf("                 '-h' to print usage information\n");
 }
 
@@ -620,10 +1405,26 @@ main(int argc, char **argv)
 	int				i;
 	struct aggr_trace_record_ctx	ctx = {};
 	struct lcore_trace_record_ctx	*lcore_port;
+	const char			*stream_file = NULL;
+	bool				stream = false;
+	long int			rotate_mb = TRACE_STREAM_DEFAULT_ROTATE_MB;
+	long int			max_files = 0;
 
 	g_exe_name = argv[0];
-	while ((op = getopt(argc, argv, "f:i:p:qs:t:h")) != -1) {
+	while ((op = getopt(argc, argv, "d:f:i:n:p:qr:s:t:zh")) != -1) {
 		switch (op) {
+		case 'd':
+			stream_file = optarg;
+			break;
+		case 'n':
+			max_files = spdk_strtol(optarg, 10);
+			break;
+		case 'r':
+			rotate_mb = spdk_strtol(optarg, 10);
+			break;
+		case 'z':
+			stream = true;
+			break;
 		case 'i':
 			shm_id = spdk_strtol(optarg, 10);
 			break;
@@ -657,6 +1458,11 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (stream_file != NULL) {
+		rc = trace_stream_decode(stream_file, file_name);
+		return rc ? 1 : 0;
+	}
+
 	if (app_name == NULL) {
 		fprintf(stderr, "-s must be specified\n");
 		usage();
@@ -675,6 +1481,18 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (rotate_mb <= 0) {
+		fprintf(stderr, "-r must be a positive integer\n");
+		usage();
+		exit(1);
+	}
+
+	if (max_files < 0 || max_files > UINT32_MAX) {
+		fprintf(stderr, "-n must be a non-negative integer\n");
+		usage();
+		exit(1);
+	}
+
 	if (shm_id >= 0) {
 		snprintf(shm_name, sizeof(shm_name), "/%s_trace.%d", app_name, shm_id);
 	} else {
@@ -691,15 +1509,25 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (record_duration_in_sec > 0) {
+		last_record_tsc = spdk_get_ticks() + record_duration_in_sec * g_tsc_rate;
+	}
+
+	if (stream) {
+		printf("Start to stream trace shm file %s\n", shm_name);
+		rc = trace_stream_record(&ctx, file_name, rotate_mb, max_files, last_record_tsc);
+
+		munmap(ctx.trace_file, g_file_size);
+		close(ctx.shm_fd);
+
+		return rc ? 1 : 0;
+	}
+
 	rc = output_trace_files_prepare(&ctx, file_name);
 	if (rc) {
 		exit(1);
 	}
 
-	if (record_duration_in_sec > 0) {
-		last_record_tsc = spdk_get_ticks() + record_duration_in_sec * g_tsc_rate;
-	}
-
 	printf("Start to poll trace shm file %s\n", shm_name);
 	while (!g_shutdown && rc == 0 && (spdk_get_ticks() <= last_record_tsc)) {
 		for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
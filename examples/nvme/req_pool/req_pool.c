@@ -0,0 +1,644 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 agent <agent@local>.
+ *   All rights reserved.
+ */
+
+/*
+ * Measures the per-I/O cost of the NVMe driver request layer with and without a
+ *  request pool shared by all qpairs in a poll group.  A single core drives random
+ *  reads on many qpairs through one poll group and reports IOPS together with the
+ *  number of last level cache misses and instructions per I/O, as reported by the
+ *  kernel perf events interface.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/env.h"
+#include "spdk/log.h"
+#include "spdk/nvme.h"
+#include "spdk/queue.h"
+#include "spdk/string.h"
+#include "spdk/util.h"
+#include "spdk/likely.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+struct ctrlr_entry {
+	struct spdk_nvme_ctrlr		*ctrlr;
+	TAILQ_ENTRY(ctrlr_entry)	link;
+};
+
+struct ns_entry {
+	struct spdk_nvme_ctrlr		*ctrlr;
+	struct spdk_nvme_ns		*ns;
+	uint64_t			size_in_ios;
+	uint32_t			io_size_blocks;
+	TAILQ_ENTRY(ns_entry)		link;
+};
+
+struct qpair_ctx {
+	struct ns_entry			*entry;
+	struct spdk_nvme_qpair		*qpair;
+	uint64_t			current_queue_depth;
+	unsigned int			seed;
+	TAILQ_HEAD(, req_task)		pending;
+	TAILQ_ENTRY(qpair_ctx)		link;
+};
+
+struct req_task {
+	struct qpair_ctx		*ctx;
+	void				*buf;
+	TAILQ_ENTRY(req_task)		link;
+};
+
+static TAILQ_HEAD(, ctrlr_entry) g_controllers = TAILQ_HEAD_INITIALIZER(g_controllers);
+static TAILQ_HEAD(, ns_entry) g_namespaces = TAILQ_HEAD_INITIALIZER(g_namespaces);
+static TAILQ_HEAD(, qpair_ctx) g_qpairs = TAILQ_HEAD_INITIALIZER(g_qpairs);
+static struct spdk_nvme_transport_id g_trid = {};
+static struct spdk_nvme_poll_group *g_group;
+
+static uint32_t g_io_size_bytes = 4096;
+static uint32_t g_queue_depth = 32;
+static uint32_t g_qpairs_per_ns = 16;
+static uint32_t g_io_queue_requests;
+static uint32_t g_pool_size;
+static int g_time_in_sec = 5;
+
+static uint32_t g_num_qpairs;
+static uint64_t g_io_completed;
+static uint64_t g_io_failed;
+static uint64_t g_io_nomem;
+static bool g_is_draining;
+
+enum {
+	COUNTER_CACHE_MISSES,
+	COUNTER_INSTRUCTIONS,
+	COUNTER_COUNT,
+};
+
+static int g_counter_fd[COUNTER_COUNT] = { -1, -1 };
+
+#ifdef __linux__
+static int
+counter_open(uint64_t config)
+{
+	struct perf_event_attr attr = {};
+
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void
+counters_start(void)
+{
+	int i;
+
+	g_counter_fd[COUNTER_CACHE_MISSES] = counter_open(PERF_COUNT_HW_CACHE_MISSES);
+	g_counter_fd[COUNTER_INSTRUCTIONS] = counter_open(PERF_COUNT_HW_INSTRUCTIONS);
+
+	for (i = 0; i < COUNTER_COUNT; i++) {
+		if (g_counter_fd[i] >= 0) {
+			ioctl(g_counter_fd[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(g_counter_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+static void
+counters_stop(uint64_t *values)
+{
+	int i;
+
+	for (i = 0; i < COUNTER_COUNT; i++) {
+		values[i] = UINT64_MAX;
+		if (g_counter_fd[i] < 0) {
+			continue;
+		}
+
+		ioctl(g_counter_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+		if (read(g_counter_fd[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+			values[i] = UINT64_MAX;
+		}
+		close(g_counter_fd[i]);
+		g_counter_fd[i] = -1;
+	}
+}
+#else
+static void
+counters_start(void)
+{
+}
+
+static void
+counters_stop(uint64_t *values)
+{
+	int i;
+
+	for (i = 0; i < COUNTER_COUNT; i++) {
+		values[i] = UINT64_MAX;
+	}
+}
+#endif
+
+static void io_complete(void *arg, const struct spdk_nvme_cpl *cpl);
+
+static void
+submit_single_io(struct req_task *task)
+{
+	struct qpair_ctx *ctx = task->ctx;
+	struct ns_entry *entry = ctx->entry;
+	uint64_t offset_in_ios;
+	int rc;
+
+	offset_in_ios = rand_r(&ctx->seed) % entry->size_in_ios;
+
+	rc = spdk_nvme_ns_cmd_read(entry->ns, ctx->qpair, task->buf,
+				   offset_in_ios * entry->io_size_blocks,
+				   entry->io_size_blocks, io_complete, task, 0);
+	if (spdk_unlikely(rc == -ENOMEM)) {
+		/* Out of requests - retry once some of the outstanding I/O completes. */
+		g_io_nomem++;
+		TAILQ_INSERT_TAIL(&ctx->pending, task, link);
+		return;
+	} else if (spdk_unlikely(rc != 0)) {
+		fprintf(stderr, "starting I/O failed: %s\n", spdk_strerror(-rc));
+		g_io_failed++;
+		return;
+	}
+
+	ctx->current_queue_depth++;
+}
+
+static void
+io_complete(void *arg, const struct spdk_nvme_cpl *cpl)
+{
+	struct req_task *task = arg;
+	struct qpair_ctx *ctx = task->ctx;
+
+	ctx->current_queue_depth--;
+
+	if (spdk_unlikely(spdk_nvme_cpl_is_error(cpl))) {
+		g_io_failed++;
+	} else {
+		g_io_completed++;
+	}
+
+	if (g_is_draining) {
+		spdk_dma_free(task->buf);
+		free(task);
+		return;
+	}
+
+	submit_single_io(task);
+}
+
+static void
+resubmit_pending(void)
+{
+	TAILQ_HEAD(, req_task) pending;
+	struct qpair_ctx *ctx;
+	struct req_task *task;
+
+	TAILQ_FOREACH(ctx, &g_qpairs, link) {
+		if (TAILQ_EMPTY(&ctx->pending)) {
+			continue;
+		}
+
+		/* Tasks that still can't get a request are put back on ctx->pending. */
+		TAILQ_INIT(&pending);
+		TAILQ_SWAP(&pending, &ctx->pending, req_task, link);
+		while ((task = TAILQ_FIRST(&pending)) != NULL) {
+			TAILQ_REMOVE(&pending, task, link);
+			submit_single_io(task);
+		}
+	}
+}
+
+static void
+disconnected_qpair_cb(struct spdk_nvme_qpair *qpair, void *poll_group_ctx)
+{
+	fprintf(stderr, "qpair %p disconnected\n", qpair);
+}
+
+static int
+create_qpairs(void)
+{
+	struct spdk_nvme_io_qpair_opts opts;
+	struct ns_entry *entry;
+	struct qpair_ctx *ctx;
+	uint32_t i;
+	int rc;
+
+	g_group = spdk_nvme_poll_group_create(NULL, NULL);
+	if (g_group == NULL) {
+		fprintf(stderr, "spdk_nvme_poll_group_create() failed\n");
+		return -ENOMEM;
+	}
+
+	rc = spdk_nvme_poll_group_set_req_pool_size(g_group, g_pool_size);
+	if (rc != 0) {
+		fprintf(stderr, "Unable to create request pool: %s\n", spdk_strerror(-rc));
+		return rc;
+	}
+
+	TAILQ_FOREACH(entry, &g_namespaces, link) {
+		spdk_nvme_ctrlr_get_default_io_qpair_opts(entry->ctrlr, &opts, sizeof(opts));
+		opts.create_only = true;
+		if (g_io_queue_requests != 0) {
+			opts.io_queue_requests = g_io_queue_requests;
+		}
+
+		for (i = 0; i < g_qpairs_per_ns; i++) {
+			ctx = calloc(1, sizeof(*ctx));
+			if (ctx == NULL) {
+				return -ENOMEM;
+			}
+
+			ctx->entry = entry;
+			ctx->seed = g_num_qpairs++;
+			TAILQ_INIT(&ctx->pending);
+			TAILQ_INSERT_TAIL(&g_qpairs, ctx, link);
+
+			ctx->qpair = spdk_nvme_ctrlr_alloc_io_qpair(entry->ctrlr, &opts, sizeof(opts));
+			if (ctx->qpair == NULL) {
+				fprintf(stderr, "spdk_nvme_ctrlr_alloc_io_qpair() failed\n");
+				return -ENOMEM;
+			}
+
+			rc = spdk_nvme_poll_group_add(g_group, ctx->qpair);
+			if (rc != 0) {
+				fprintf(stderr, "spdk_nvme_poll_group_add() failed\n");
+				return rc;
+			}
+
+			rc = spdk_nvme_ctrlr_connect_io_qpair(entry->ctrlr, ctx->qpair);
+			if (rc != 0) {
+				fprintf(stderr, "spdk_nvme_ctrlr_connect_io_qpair() failed\n");
+				return rc;
+			}
+		}
+	}
+
+	do {
+		spdk_nvme_poll_group_process_completions(g_group, 0, disconnected_qpair_cb);
+		rc = spdk_nvme_poll_group_all_connected(g_group);
+	} while (rc == -EAGAIN);
+
+	return rc;
+}
+
+static void
+destroy_qpairs(void)
+{
+	struct qpair_ctx *ctx, *tmp;
+
+	TAILQ_FOREACH_SAFE(ctx, &g_qpairs, link, tmp) {
+		TAILQ_REMOVE(&g_qpairs, ctx, link);
+		if (ctx->qpair != NULL) {
+			spdk_nvme_ctrlr_free_io_qpair(ctx->qpair);
+		}
+		free(ctx);
+	}
+
+	if (g_group != NULL) {
+		spdk_nvme_poll_group_destroy(g_group);
+	}
+}
+
+static int
+run_workload(void)
+{
+	struct qpair_ctx *ctx;
+	struct req_task *task;
+	uint64_t tsc_start, tsc_end, tsc_rate, counters[COUNTER_COUNT];
+	uint64_t num_outstanding;
+	double seconds;
+	uint32_t i;
+
+	TAILQ_FOREACH(ctx, &g_qpairs, link) {
+		for (i = 0; i < g_queue_depth; i++) {
+			task = calloc(1, sizeof(*task));
+			if (task == NULL) {
+				return -ENOMEM;
+			}
+
+			task->buf = spdk_dma_zmalloc(g_io_size_bytes, 0x200, NULL);
+			if (task->buf == NULL) {
+				free(task);
+				return -ENOMEM;
+			}
+
+			task->ctx = ctx;
+			TAILQ_INSERT_TAIL(&ctx->pending, task, link);
+		}
+	}
+
+	tsc_rate = spdk_get_ticks_hz();
+	counters_start();
+	tsc_start = spdk_get_ticks();
+	tsc_end = tsc_start + g_time_in_sec * tsc_rate;
+
+	resubmit_pending();
+	while (spdk_get_ticks() < tsc_end) {
+		spdk_nvme_poll_group_process_completions(g_group, 0, disconnected_qpair_cb);
+		resubmit_pending();
+	}
+
+	counters_stop(counters);
+	seconds = (double)(spdk_get_ticks() - tsc_start) / tsc_rate;
+
+	printf("qpairs: %u queue depth: %u io_queue_requests: %u pool size: %u\n",
+	       g_num_qpairs, g_queue_depth, g_io_queue_requests, g_pool_size);
+	printf("IOPS: %10.2f failed: %" PRIu64 " out of requests: %" PRIu64 "\n",
+	       g_io_completed / seconds, g_io_failed, g_io_nomem);
+	if (g_io_completed != 0 && counters[COUNTER_CACHE_MISSES] != UINT64_MAX) {
+		printf("cache misses per I/O: %10.2f\n",
+		       (double)counters[COUNTER_CACHE_MISSES] / g_io_completed);
+	} else {
+		printf("cache misses per I/O: n/a\n");
+	}
+	if (g_io_completed != 0 && counters[COUNTER_INSTRUCTIONS] != UINT64_MAX) {
+		printf("instructions per I/O: %10.2f\n",
+		       (double)counters[COUNTER_INSTRUCTIONS] / g_io_completed);
+	} else {
+		printf("instructions per I/O: n/a\n");
+	}
+
+	/* Drain the outstanding I/O and free the tasks still waiting for a request. */
+	g_is_draining = true;
+	TAILQ_FOREACH(ctx, &g_qpairs, link) {
+		while ((task = TAILQ_FIRST(&ctx->pending)) != NULL) {
+			TAILQ_REMOVE(&ctx->pending, task, link);
+			spdk_dma_free(task->buf);
+			free(task);
+		}
+	}
+
+	do {
+		spdk_nvme_poll_group_process_completions(g_group, 0, disconnected_qpair_cb);
+		num_outstanding = 0;
+		TAILQ_FOREACH(ctx, &g_qpairs, link) {
+			num_outstanding += ctx->current_queue_depth;
+		}
+	} while (num_outstanding != 0);
+
+	return 0;
+}
+
+static void
+register_ns(struct spdk_nvme_ctrlr *ctrlr, struct spdk_nvme_ns *ns)
+{
+	struct ns_entry *entry;
+	uint32_t sector_size;
+
+	if (!spdk_nvme_ns_is_active(ns)) {
+		return;
+	}
+
+	sector_size = spdk_nvme_ns_get_sector_size(ns);
+	if (g_io_size_bytes % sector_size != 0 ||
+	    spdk_nvme_ns_get_size(ns) < g_io_size_bytes) {
+		printf("WARNING: skipping namespace %u, incompatible I/O size\n", spdk_nvme_ns_get_id(ns));
+		return;
+	}
+
+	entry = calloc(1, sizeof(*entry));
+	if (entry == NULL) {
+		perror("ns_entry calloc");
+		exit(1);
+	}
+
+	entry->ctrlr = ctrlr;
+	entry->ns = ns;
+	entry->io_size_blocks = g_io_size_bytes / sector_size;
+	entry->size_in_ios = spdk_nvme_ns_get_size(ns) / g_io_size_bytes;
+	TAILQ_INSERT_TAIL(&g_namespaces, entry, link);
+}
+
+static bool
+probe_cb(void *cb_ctx, const struct spdk_nvme_transport_id *trid,
+	 struct spdk_nvme_ctrlr_opts *opts)
+{
+	printf("Attaching to %s\n", trid->traddr);
+
+	return true;
+}
+
+static void
+attach_cb(void *cb_ctx, const struct spdk_nvme_transport_id *trid,
+	  struct spdk_nvme_ctrlr *ctrlr, const struct spdk_nvme_ctrlr_opts *opts)
+{
+	struct ctrlr_entry *entry;
+	uint32_t nsid;
+
+	entry = calloc(1, sizeof(*entry));
+	if (entry == NULL) {
+		perror("ctrlr_entry calloc");
+		exit(1);
+	}
+
+	printf("Attached to %s\n", trid->traddr);
+
+	entry->ctrlr = ctrlr;
+	TAILQ_INSERT_TAIL(&g_controllers, entry, link);
+
+	for (nsid = spdk_nvme_ctrlr_get_first_active_ns(ctrlr); nsid != 0;
+	     nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, nsid)) {
+		register_ns(ctrlr, spdk_nvme_ctrlr_get_ns(ctrlr, nsid));
+	}
+}
+
+static void
+cleanup(void)
+{
+	struct ns_entry *ns_entry, *tmp_ns_entry;
+	struct ctrlr_entry *ctrlr_entry, *tmp_ctrlr_entry;
+	struct spdk_nvme_detach_ctx *detach_ctx = NULL;
+
+	destroy_qpairs();
+
+	TAILQ_FOREACH_SAFE(ns_entry, &g_namespaces, link, tmp_ns_entry) {
+		TAILQ_REMOVE(&g_namespaces, ns_entry, link);
+		free(ns_entry);
+	}
+
+	TAILQ_FOREACH_SAFE(ctrlr_entry, &g_controllers, link, tmp_ctrlr_entry) {
+		TAILQ_REMOVE(&g_controllers, ctrlr_entry, link);
+		spdk_nvme_detach_async(ctrlr_entry->ctrlr, &detach_ctx);
+		free(ctrlr_entry);
+	}
+
+	if (detach_ctx) {
+		spdk_nvme_detach_poll(detach_ctx);
+	}
+}
+
+static void
+usage(const char *program_name)
+{
+	printf("%s [options]", program_name);
+	printf("\t\n");
+	printf("options:\n");
+	printf("\t[-d DPDK huge memory size in MB]\n");
+	printf("\t[-i shared memory group ID]\n");
+	printf("\t[-n number of qpairs per namespace (default: %u)]\n", g_qpairs_per_ns);
+	printf("\t[-o I/O size in bytes (default: %u)]\n", g_io_size_bytes);
+	printf("\t[-P size of the poll group request pool, 0 disables the pool (default: %u)]\n",
+	       g_pool_size);
+	printf("\t[-q queue depth per qpair (default: %u)]\n", g_queue_depth);
+	printf("\t[-r remote NVMe over Fabrics target address]\n");
+	printf("\t[-R number of requests allocated per qpair (default: transport default)]\n");
+	printf("\t[-t time in seconds (default: %d)]\n", g_time_in_sec);
+}
+
+static int
+parse_uint32(const char *str, uint32_t *val)
+{
+	uint64_t tmp;
+
+	if (spdk_parse_capacity(str, &tmp, NULL) != 0 || tmp > UINT32_MAX) {
+		return -EINVAL;
+	}
+
+	*val = (uint32_t)tmp;
+	return 0;
+}
+
+static int
+parse_args(int argc, char **argv, struct spdk_env_opts *env_opts)
+{
+	int op;
+
+	spdk_nvme_trid_populate_transport(&g_trid, SPDK_NVME_TRANSPORT_PCIE);
+	snprintf(g_trid.subnqn, sizeof(g_trid.subnqn), "%s", SPDK_NVMF_DISCOVERY_NQN);
+
+	while ((op = getopt(argc, argv, "d:hi:n:o:P:q:r:R:t:")) != -1) {
+		switch (op) {
+		case 'd':
+			env_opts->mem_size = spdk_strtol(optarg, 10);
+			if (env_opts->mem_size < 0) {
+				fprintf(stderr, "Invalid DPDK memory size\n");
+				return env_opts->mem_size;
+			}
+			break;
+		case 'i':
+			env_opts->shm_id = spdk_strtol(optarg, 10);
+			if (env_opts->shm_id < 0) {
+				fprintf(stderr, "Invalid shared memory ID\n");
+				return env_opts->shm_id;
+			}
+			break;
+		case 'n':
+			if (parse_uint32(optarg, &g_qpairs_per_ns) != 0 || g_qpairs_per_ns == 0) {
+				fprintf(stderr, "Invalid number of qpairs\n");
+				return 1;
+			}
+			break;
+		case 'o':
+			if (parse_uint32(optarg, &g_io_size_bytes) != 0 || g_io_size_bytes == 0) {
+				fprintf(stderr, "Invalid I/O size\n");
+				return 1;
+			}
+			break;
+		case 'P':
+			if (parse_uint32(optarg, &g_pool_size) != 0) {
+				fprintf(stderr, "Invalid request pool size\n");
+				return 1;
+			}
+			break;
+		case 'q':
+			if (parse_uint32(optarg, &g_queue_depth) != 0 || g_queue_depth == 0) {
+				fprintf(stderr, "Invalid queue depth\n");
+				return 1;
+			}
+			break;
+		case 'r':
+			if (spdk_nvme_transport_id_parse(&g_trid, optarg) != 0) {
+				fprintf(stderr, "Error parsing transport address\n");
+				return 1;
+			}
+			break;
+		case 'R':
+			if (parse_uint32(optarg, &g_io_queue_requests) != 0) {
+				fprintf(stderr, "Invalid number of requests\n");
+				return 1;
+			}
+			break;
+		case 't':
+			g_time_in_sec = spdk_strtol(optarg, 10);
+			if (g_time_in_sec <= 0) {
+				fprintf(stderr, "Invalid run time\n");
+				return 1;
+			}
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+	struct spdk_env_opts opts;
+	int rc;
+
+	opts.opts_size = sizeof(opts);
+	spdk_env_opts_init(&opts);
+	rc = parse_args(argc, argv, &opts);
+	if (rc != 0) {
+		return rc;
+	}
+
+	opts.name = "req_pool";
+	if (spdk_env_init(&opts) < 0) {
+		fprintf(stderr, "Unable to initialize SPDK env\n");
+		return 1;
+	}
+
+	rc = spdk_nvme_probe(&g_trid, NULL, probe_cb, attach_cb, NULL);
+	if (rc != 0) {
+		fprintf(stderr, "spdk_nvme_probe() failed\n");
+		rc = 1;
+		goto exit;
+	}
+
+	if (TAILQ_EMPTY(&g_namespaces)) {
+		fprintf(stderr, "no NVMe namespaces found\n");
+		rc = 1;
+		goto exit;
+	}
+
+	rc = create_qpairs();
+	if (rc != 0) {
+		rc = 1;
+		goto exit;
+	}
+
+	rc = run_workload();
+	if (rc != 0) {
+		fprintf(stderr, "workload failed: %s\n", spdk_strerror(-rc));
+		rc = 1;
+	}
+
+exit:
+	fflush(stdout);
+	cleanup();
+	spdk_env_fini();
+	return rc;
+}
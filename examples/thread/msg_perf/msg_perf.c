@@ -0,0 +1,249 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 agent <agent@local>.
+ *   All rights reserved.
+ */
+
+/*
+ * Message passing benchmark. One SPDK thread is created on each core and the
+ * threads are linked into a ring. Every thread keeps queue depth messages in
+ * flight to its successor, which forwards each message it receives to its own
+ * successor. Run with and without -c to compare the shared per thread ring
+ * with the per thread pair message channels.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/env.h"
+#include "spdk/event.h"
+#include "spdk/string.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+struct msg_perf_thread {
+	struct spdk_thread	*thread;
+	struct msg_perf_thread	*next;
+	uint64_t		count;
+};
+
+static struct spdk_app_opts g_opts;
+static struct msg_perf_thread *g_threads;
+static uint32_t g_num_threads;
+static int g_queue_depth = 32;
+static uint32_t g_msg_channel_size = 0;
+static int g_time_in_sec = 0;
+static bool g_stop;
+static uint64_t g_outstanding;
+static uint64_t g_start_tsc;
+static struct spdk_thread *g_main_thread;
+static struct spdk_poller *g_test_end_poller;
+
+static void
+thread_exit(void *ctx)
+{
+	spdk_thread_exit(spdk_get_thread());
+}
+
+static void
+test_done(void *arg)
+{
+	uint64_t elapsed_tsc, total = 0;
+	double elapsed_sec;
+	uint32_t i;
+
+	elapsed_tsc = spdk_get_ticks() - g_start_tsc;
+	elapsed_sec = (double)elapsed_tsc / spdk_get_ticks_hz();
+
+	printf("Message channel size: %" PRIu32 "%s\n", g_msg_channel_size,
+	       g_msg_channel_size == 0 ? " (disabled)" : "");
+	for (i = 0; i < g_num_threads; i++) {
+		printf("%-16s %12" PRIu64 " msgs %14.2f msgs/s\n",
+		       spdk_thread_get_name(g_threads[i].thread), g_threads[i].count,
+		       g_threads[i].count / elapsed_sec);
+		total += g_threads[i].count;
+	}
+	printf("%-16s %12" PRIu64 " msgs %14.2f msgs/s\n", "Total", total, total / elapsed_sec);
+
+	for (i = 0; i < g_num_threads; i++) {
+		spdk_thread_send_msg(g_threads[i].thread, thread_exit, NULL);
+	}
+
+	spdk_app_stop(0);
+}
+
+static void
+msg_done(void)
+{
+	if (__atomic_sub_fetch(&g_outstanding, 1, __ATOMIC_SEQ_CST) == 0) {
+		spdk_thread_send_msg(g_main_thread, test_done, NULL);
+	}
+}
+
+static void
+msg_fn(void *ctx)
+{
+	struct msg_perf_thread *t = ctx;
+	int rc;
+
+	t->count++;
+
+	if (__atomic_load_n(&g_stop, __ATOMIC_RELAXED)) {
+		msg_done();
+		return;
+	}
+
+	rc = spdk_thread_send_msg(t->next->thread, msg_fn, t->next);
+	if (rc != 0) {
+		fprintf(stderr, "Unable to send message: %s\n", spdk_strerror(-rc));
+		__atomic_store_n(&g_stop, true, __ATOMIC_RELAXED);
+		msg_done();
+	}
+}
+
+static void
+thread_start(void *ctx)
+{
+	struct msg_perf_thread *t = ctx;
+	int i, rc;
+
+	for (i = 0; i < g_queue_depth; i++) {
+		rc = spdk_thread_send_msg(t->next->thread, msg_fn, t->next);
+		if (rc != 0) {
+			fprintf(stderr, "Unable to send message: %s\n", spdk_strerror(-rc));
+			__atomic_store_n(&g_stop, true, __ATOMIC_RELAXED);
+			msg_done();
+		}
+	}
+}
+
+static int
+test_end(void *arg)
+{
+	spdk_poller_unregister(&g_test_end_poller);
+	__atomic_store_n(&g_stop, true, __ATOMIC_RELAXED);
+
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+test_start(void *arg)
+{
+	struct spdk_cpuset cpumask;
+	char name[32];
+	uint32_t core, i = 0;
+
+	g_main_thread = spdk_get_thread();
+	g_num_threads = spdk_env_get_core_count();
+	g_threads = calloc(g_num_threads, sizeof(*g_threads));
+	if (g_threads == NULL) {
+		fprintf(stderr, "Unable to allocate threads\n");
+		spdk_app_stop(-ENOMEM);
+		return;
+	}
+
+	SPDK_ENV_FOREACH_CORE(core) {
+		spdk_cpuset_zero(&cpumask);
+		spdk_cpuset_set_cpu(&cpumask, core, true);
+		snprintf(name, sizeof(name), "msg_perf_%" PRIu32, core);
+
+		g_threads[i].thread = spdk_thread_create(name, &cpumask);
+		if (g_threads[i].thread == NULL) {
+			fprintf(stderr, "Unable to create thread %s\n", name);
+			spdk_app_stop(-ENOMEM);
+			return;
+		}
+		g_threads[i].next = &g_threads[(i + 1) % g_num_threads];
+		i++;
+	}
+
+	printf("Running %" PRIu32 " threads with queue depth %d for %d seconds\n",
+	       g_num_threads, g_queue_depth, g_time_in_sec);
+
+	g_outstanding = (uint64_t)g_num_threads * g_queue_depth;
+	g_test_end_poller = SPDK_POLLER_REGISTER(test_end, NULL, g_time_in_sec * 1000000ULL);
+	g_start_tsc = spdk_get_ticks();
+
+	for (i = 0; i < g_num_threads; i++) {
+		spdk_thread_send_msg(g_threads[i].thread, thread_start, &g_threads[i]);
+	}
+}
+
+static void
+test_shutdown(void)
+{
+	test_end(NULL);
+}
+
+static void
+usage(void)
+{
+	printf(" -c <size>                 per thread pair message channel size, power of 2\n");
+	printf("                           (default: 0 - disabled)\n");
+	printf(" -q <depth>                messages in flight per thread (default: 32)\n");
+	printf(" -t <sec>                  time in seconds\n");
+}
+
+static int
+parse_arg(int ch, char *arg)
+{
+	long int val;
+
+	val = spdk_strtol(arg, 10);
+	if (val <= 0 || val > INT_MAX) {
+		fprintf(stderr, "Invalid value %s for -%c\n", arg, ch);
+		return -EINVAL;
+	}
+
+	switch (ch) {
+	case 'c':
+		if (!spdk_u32_is_pow2((uint32_t)val)) {
+			fprintf(stderr, "Invalid message channel size %s\n", arg);
+			return -EINVAL;
+		}
+		g_msg_channel_size = val;
+		break;
+	case 'q':
+		g_queue_depth = val;
+		break;
+	case 't':
+		g_time_in_sec = val;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+	int rc;
+
+	spdk_app_opts_init(&g_opts, sizeof(g_opts));
+	g_opts.name = "msg_perf";
+	g_opts.rpc_addr = NULL;
+	g_opts.shutdown_cb = test_shutdown;
+
+	rc = spdk_app_parse_args(argc, argv, &g_opts, "c:q:t:", NULL, parse_arg, usage);
+	if (rc != SPDK_APP_PARSE_ARGS_SUCCESS) {
+		return rc == SPDK_APP_PARSE_ARGS_HELP ? 0 : 1;
+	}
+
+	if (g_time_in_sec == 0) {
+		fprintf(stderr, "Time (-t) must be specified\n");
+		usage();
+		return 1;
+	}
+
+	rc = spdk_thread_lib_set_msg_channel_size(g_msg_channel_size);
+	if (rc != 0) {
+		return 1;
+	}
+
+	rc = spdk_app_start(&g_opts, test_start, NULL);
+
+	spdk_app_fini();
+	free(g_threads);
+
+	return rc;
+}
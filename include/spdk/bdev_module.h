@@ -965,7 +965,10 @@ struct spdk_bdev_io_internal_fields {
 			/** Whether we are currently inside the submit request call */
 			uint8_t in_submit_request		: 1;
 
-			uint8_t reserved			: 2;
+			/** Whether the buffer is (being) allocated as several iobuf buffers */
+			uint8_t sg_buf				: 1;
+
+			uint8_t reserved			: 1;
 		};
 		uint8_t raw;
 	} f;
@@ -1036,8 +1039,13 @@ struct spdk_bdev_io_internal_fields {
 	} split;
 
 	struct {
-		/** bdev allocated memory associated with this request */
-		void *ptr;
+		union {
+			/** bdev allocated memory associated with this request */
+			void *ptr;
+
+			/** state of the buffer if it's made of several iobuf buffers */
+			struct spdk_bdev_io_sg_buf *sg;
+		};
 
 		/** requested size of the buffer associated with this I/O */
 		uint64_t len;
@@ -158,6 +158,16 @@ typedef int (*spdk_bs_esnap_dev_create)(void *bs_ctx, void *blob_ctx, struct spd
  */
 typedef void (*spdk_blob_shallow_copy_status)(uint64_t copied_clusters, void *cb_arg);
 
+/**
+ * Blob inflate status callback.
+ *
+ * \param copied_clusters Number of clusters copied so far by the inflate operation.
+ * \param total_clusters Number of clusters the inflate operation has to copy.
+ * \param cb_arg Callback argument.
+ */
+typedef void (*spdk_blob_inflate_status)(uint64_t copied_clusters, uint64_t total_clusters,
+		void *cb_arg);
+
 struct spdk_bs_dev_cb_args {
 	spdk_bs_dev_cpl		cb_fn;
 	struct spdk_io_channel	*channel;
@@ -791,6 +801,77 @@ void spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *ch
 void spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 				  spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg);
 
+struct spdk_bs_inflate_opts {
+	/**
+	 * The size of spdk_bs_inflate_opts according to the caller of this library is used for ABI
+	 * compatibility. The library uses this field to know how many fields in this
+	 * structure are valid. And the library will populate any remaining fields with default values.
+	 * New added fields should be put at the end of the struct.
+	 */
+	size_t opts_size;
+
+	/** Maximum number of clusters copied concurrently. Default is 1. */
+	uint32_t queue_depth;
+
+	uint8_t reserved[4];
+
+	/** Maximum number of clusters copied per second. 0 (default) means no limit. */
+	uint64_t clusters_per_sec;
+
+	/** Called each time a cluster was copied. Optional. */
+	spdk_blob_inflate_status status_cb_fn;
+
+	/** Argument passed to status_cb_fn. */
+	void *status_cb_arg;
+};
+SPDK_STATIC_ASSERT(sizeof(struct spdk_bs_inflate_opts) == 40, "Incorrect size");
+
+/**
+ * Initialize a spdk_bs_inflate_opts structure to the default option values.
+ *
+ * \param opts spdk_bs_inflate_opts structure to initialize.
+ * \param opts_size It must be the size of struct spdk_bs_inflate_opts.
+ */
+void spdk_bs_inflate_opts_init(struct spdk_bs_inflate_opts *opts, size_t opts_size);
+
+/**
+ * Allocate all clusters in this blob, with additional options.
+ *
+ * Same as spdk_bs_inflate_blob(), but up to opts->queue_depth clusters are copied
+ * concurrently, at no more than opts->clusters_per_sec clusters per second.
+ *
+ * Clusters that were already copied are allocated to the blob, so if the operation is
+ * interrupted, e.g. by an application restart, calling it again only copies the clusters
+ * that are still missing.
+ *
+ * \param bs blobstore.
+ * \param channel IO channel used to inflate blob.
+ * \param blobid The id of the blob to inflate.
+ * \param opts The inflate options. NULL means default options.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_bs_inflate_blob_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+			      spdk_blob_id blobid, const struct spdk_bs_inflate_opts *opts,
+			      spdk_blob_op_complete cb_fn, void *cb_arg);
+
+/**
+ * Remove dependency on parent blob, with additional options.
+ *
+ * Same as spdk_bs_blob_decouple_parent(), but clusters are copied as described in
+ * spdk_bs_inflate_blob_ext().
+ *
+ * \param bs blobstore.
+ * \param channel IO channel used to inflate blob.
+ * \param blobid The id of the blob.
+ * \param opts The inflate options. NULL means default options.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_bs_blob_decouple_parent_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+				      spdk_blob_id blobid, const struct spdk_bs_inflate_opts *opts,
+				      spdk_blob_op_complete cb_fn, void *cb_arg);
+
 /**
  * Perform a shallow copy of a blob to a blobstore device.
  *
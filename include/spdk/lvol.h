@@ -386,6 +386,28 @@ void spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void
  */
 void spdk_lvol_decouple_parent(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Inflate lvol with additional options
+ *
+ * \param lvol Handle to lvol
+ * \param opts Inflate options, see spdk_bs_inflate_blob_ext(). NULL means default options.
+ * \param cb_fn Completion callback
+ * \param cb_arg Completion callback custom arguments
+ */
+void spdk_lvol_inflate_ext(struct spdk_lvol *lvol, const struct spdk_bs_inflate_opts *opts,
+			   spdk_lvol_op_complete cb_fn, void *cb_arg);
+
+/**
+ * Decouple parent of lvol with additional options
+ *
+ * \param lvol Handle to lvol
+ * \param opts Inflate options, see spdk_bs_inflate_blob_ext(). NULL means default options.
+ * \param cb_fn Completion callback
+ * \param cb_arg Completion callback custom arguments
+ */
+void spdk_lvol_decouple_parent_ext(struct spdk_lvol *lvol, const struct spdk_bs_inflate_opts *opts,
+				   spdk_lvol_op_complete cb_fn, void *cb_arg);
+
 /**
  * Determine if an lvol is degraded. A degraded lvol cannot perform IO.
  *
@@ -100,8 +100,12 @@ struct spdk_bdev_nvme_opts {
 	uint8_t reserved110[2];
 	uint32_t dhchap_digests;
 	uint32_t dhchap_dhgroups;
+	/* Size of the request pool shared by all qpairs of a poll group. 0 disables the pool. */
+	uint32_t poll_group_requests;
+	/* Hole at bytes 124-127. */
+	uint8_t reserved124[4];
 };
-SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_nvme_opts) == 120, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_nvme_opts) == 128, "Incorrect size");
 
 /**
  * Connect to the NVMe controller and populate namespaces as bdevs.
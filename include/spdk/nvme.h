@@ -1752,6 +1752,11 @@ struct spdk_nvme_io_qpair_opts {
 	 *
 	 * This only applies to PCIe and RDMA transports.
 	 *
+	 * For PCIe qpairs that are part of a poll group, the queued commands of all qpairs
+	 * in the group are submitted together once per call to
+	 * spdk_nvme_poll_group_process_completions(), after all qpairs were polled. This
+	 * results in at most one doorbell write per qpair per poll group iteration.
+	 *
 	 * The flag was originally named delay_pcie_doorbell. To allow backward compatibility
 	 * both names are kept in unnamed union.
 	 */
@@ -2992,6 +2997,28 @@ typedef void (*spdk_nvme_disconnected_qpair_cb)(struct spdk_nvme_qpair *qpair,
 struct spdk_nvme_poll_group *spdk_nvme_poll_group_create(void *ctx,
 		struct spdk_nvme_accel_fn_table *table);
 
+/**
+ * Set the size of the request pool shared by all qpairs in a poll group.
+ *
+ * Each qpair allocates its requests from its own, preallocated set first (see
+ * spdk_nvme_io_qpair_opts::io_queue_requests). If that set is exhausted, requests
+ * are taken from the shared pool of the poll group the qpair belongs to. This
+ * allows a poll group with many qpairs to create them with a small number of
+ * requests each and size the shared pool for the I/O actually outstanding across
+ * the whole group, reducing the memory footprint and the number of cache lines
+ * touched per I/O.
+ *
+ * This function must be called before any qpair is added to the poll group.
+ *
+ * \param group The poll group.
+ * \param num_requests Number of requests in the shared pool. 0 releases the pool.
+ *
+ * \return 0 on success, -EBUSY if qpairs were already added to the poll group, or
+ * -ENOMEM if the pool could not be allocated.
+ */
+int spdk_nvme_poll_group_set_req_pool_size(struct spdk_nvme_poll_group *group,
+		uint32_t num_requests);
+
 /**
  * Get a optimal poll group.
  *
@@ -3060,7 +3087,8 @@ int spdk_nvme_poll_group_get_fd(struct spdk_nvme_poll_group *group);
  *
  * \param group The group to destroy.
  *
- * return 0 on success, -EBUSY if the poll group is not empty.
+ * return 0 on success, -EBUSY if the poll group is not empty or requests from its
+ * shared request pool are still outstanding.
  */
 int spdk_nvme_poll_group_destroy(struct spdk_nvme_poll_group *group);
 
@@ -3072,7 +3100,10 @@ int spdk_nvme_poll_group_destroy(struct spdk_nvme_poll_group *group);
  * The user is responsible for trying to reconnect or destroy those qpairs.
  *
  * \param group The group on which to poll for completions.
- * \param completions_per_qpair The maximum number of completions per qpair.
+ * \param completions_per_qpair The maximum number of completions per qpair. For PCIe
+ * qpairs, the budget left unused by idle qpairs is redistributed to the qpairs that
+ * reached this limit, so the total number of completions is bounded by
+ * completions_per_qpair times the number of qpairs in the group.
  * \param disconnected_qpair_cb A callback function of type spdk_nvme_disconnected_qpair_cb. Must be non-NULL.
  *
  * return The number of completions across all qpairs, -EINVAL if no disconnected_qpair_cb is passed, or
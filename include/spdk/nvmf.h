@@ -712,6 +712,56 @@ int spdk_nvmf_subsystem_set_allow_any_host(struct spdk_nvmf_subsystem *subsystem
  */
 bool spdk_nvmf_subsystem_get_allow_any_host(const struct spdk_nvmf_subsystem *subsystem);
 
+/**
+ * Enable weighted fair queuing of I/O between the hosts connected to a subsystem.
+ *
+ * The number of I/O submitted to each namespace is limited to queue_depth on every
+ * poll group. Once the limit is reached, further I/O is queued per host and dispatched
+ * in proportion to the weights set with spdk_nvmf_subsystem_set_host_fairness().
+ *
+ * \param subsystem Subsystem to modify.
+ * \param queue_depth Max number of I/O submitted per namespace per poll group, or 0 to
+ * disable fair queuing.
+ *
+ * \return 0 on success, or negated errno value on failure.
+ */
+int spdk_nvmf_subsystem_set_fair_queuing(struct spdk_nvmf_subsystem *subsystem,
+		uint32_t queue_depth);
+
+/**
+ * Get the fair queuing depth of a subsystem.
+ *
+ * \param subsystem Subsystem to query.
+ *
+ * \return queue depth set with spdk_nvmf_subsystem_set_fair_queuing(), 0 if disabled.
+ */
+uint32_t spdk_nvmf_subsystem_get_fair_queuing(const struct spdk_nvmf_subsystem *subsystem);
+
+/* Largest fair queuing weight of a host */
+#define SPDK_NVMF_FQ_MAX_WEIGHT		65536
+
+/**
+ * Set the fair queuing weight and reserved IOPS of a host.
+ *
+ * Hosts without settings have a weight of 1 and no reserved IOPS. Setting these
+ * defaults removes the host's entry. The settings also apply to the controllers
+ * that are already connected.
+ *
+ * \param subsystem Subsystem to modify.
+ * \param hostnqn The NQN of the host.
+ * \param cntlid Controller ID the settings apply to, or 0 to apply them to all
+ * controllers of the host. A controller specific entry gets its own queue.
+ * \param weight Relative share of the namespace bandwidth, between 1 and
+ * SPDK_NVMF_FQ_MAX_WEIGHT.
+ * \param min_iops Number of I/O per second, per namespace and poll group, that are
+ * dispatched ahead of other hosts, or 0 for none.
+ *
+ * \return 0 on success, or negated errno value on failure.
+ */
+int spdk_nvmf_subsystem_set_host_fairness(struct spdk_nvmf_subsystem *subsystem,
+		const char *hostnqn, uint16_t cntlid,
+		uint32_t weight, uint32_t min_iops);
+
 /**
  * Check if the given host is allowed to connect to the subsystem.
  *
@@ -120,16 +120,17 @@ struct spdk_nvmf_request {
 	struct spdk_bdev_io		*zcopy_bdev_io; /* Contains the bdev_io when using ZCOPY */
 
 	/* Internal state that keeps track of the iobuf allocation progress */
-	struct {
-		struct spdk_iobuf_entry	entry;
-		uint32_t		remaining_length;
-	} iobuf;
+	struct spdk_iobuf_iov_entry	iobuf;
 
 	/* Timeout tracked for connect and abort flows. */
 	uint64_t timeout_tsc;
 	uint32_t			orig_nsid;
+
+	/* Fair queuing state, only used when the subsystem has fair queuing enabled */
+	struct spdk_nvmf_subsystem_pg_ns_info	*fq_ns_info;
+	STAILQ_ENTRY(spdk_nvmf_request)		fq_link;
 };
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_request) == 816, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_request) == 864, "Incorrect size");
 
 enum spdk_nvmf_qpair_state {
 	SPDK_NVMF_QPAIR_UNINITIALIZED = 0,
@@ -97,6 +97,25 @@ typedef void (*spdk_rpc_method_handler)(struct spdk_jsonrpc_request *request,
 void spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func,
 			      uint32_t state_mask);
 
+/**
+ * Register an RPC method whose calls only depend on each other through a single
+ * named parameter.
+ *
+ * Two calls to methods registered with the same \c concurrency_key are independent
+ * if the values of that parameter differ, e.g. two bdev_nvme_attach_controller
+ * calls creating differently named controllers. The JSON configuration loader uses
+ * this to replay such calls concurrently. Calls with equal values, or calls to
+ * methods registered without a key, are always executed in order.
+ *
+ * \param method Name for the registered method.
+ * \param func Function registered for this method to handle the RPC request.
+ * \param state_mask State mask of the registered method.
+ * \param concurrency_key Name of the string parameter that identifies the object
+ * the method operates on.
+ */
+void spdk_rpc_register_method_concurrent(const char *method, spdk_rpc_method_handler func,
+		uint32_t state_mask, const char *concurrency_key);
+
 /**
  * Register a deprecated alias for an RPC method.
  *
@@ -126,6 +145,18 @@ int spdk_rpc_is_method_allowed(const char *method, uint32_t state_mask);
  */
 int spdk_rpc_get_method_state_mask(const char *method, uint32_t *state_mask);
 
+/**
+ * Return concurrency key of the method
+ *
+ * \param method Method name
+ * \param[out] concurrency_key Name of the parameter set by
+ * spdk_rpc_register_method_concurrent() or NULL if calls to the method must be
+ * executed in order.
+ * \retval 0 if method is found and \b concurrency_key is filled
+ * \retval -ENOENT if method is not found
+ */
+int spdk_rpc_get_method_concurrency_key(const char *method, const char **concurrency_key);
+
 #define SPDK_RPC_STARTUP	0x1
 #define SPDK_RPC_RUNTIME	0x2
 
@@ -141,6 +172,12 @@ static void __attribute__((constructor(1000))) rpc_register_##func(void) \
 	spdk_rpc_register_method(method, func, state_mask); \
 }
 
+#define SPDK_RPC_REGISTER_CONCURRENT(method, func, state_mask, concurrency_key) \
+static void __attribute__((constructor(1000))) rpc_register_##func(void) \
+{ \
+	spdk_rpc_register_method_concurrent(method, func, state_mask, concurrency_key); \
+}
+
 #define SPDK_RPC_REGISTER_ALIAS_DEPRECATED(method, alias) \
 static void __attribute__((constructor(1001))) rpc_register_##alias(void) \
 { \
@@ -66,16 +66,21 @@ enum spdk_scsi_asc {
 	SPDK_SCSI_ASC_PERIPHERAL_DEVICE_WRITE_FAULT = 0x03,
 	SPDK_SCSI_ASC_LOGICAL_UNIT_NOT_READY = 0x04,
 	SPDK_SCSI_ASC_WARNING = 0x0b,
+	SPDK_SCSI_ASC_THIRD_PARTY_DEVICE_FAILURE = 0x0d,
+	SPDK_SCSI_ASC_COPY_TARGET_DEVICE_NOT_REACHABLE = 0x0d,
 	SPDK_SCSI_ASC_LOGICAL_BLOCK_GUARD_CHECK_FAILED = 0x10,
 	SPDK_SCSI_ASC_LOGICAL_BLOCK_APP_TAG_CHECK_FAILED = 0x10,
 	SPDK_SCSI_ASC_LOGICAL_BLOCK_REF_TAG_CHECK_FAILED = 0x10,
 	SPDK_SCSI_ASC_UNRECOVERED_READ_ERROR = 0x11,
+	SPDK_SCSI_ASC_PARAMETER_LIST_LENGTH_ERROR = 0x1a,
 	SPDK_SCSI_ASC_MISCOMPARE_DURING_VERIFY_OPERATION = 0x1d,
 	SPDK_SCSI_ASC_INVALID_COMMAND_OPERATION_CODE = 0x20,
 	SPDK_SCSI_ASC_ACCESS_DENIED = 0x20,
 	SPDK_SCSI_ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE = 0x21,
+	SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION = 0x23,
 	SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB = 0x24,
 	SPDK_SCSI_ASC_LOGICAL_UNIT_NOT_SUPPORTED = 0x25,
+	SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST = 0x26,
 	SPDK_SCSI_ASC_WRITE_PROTECTED = 0x27,
 	SPDK_SCSI_ASC_CAPACITY_DATA_HAS_CHANGED = 0x2a,
 	SPDK_SCSI_ASC_FORMAT_COMMAND_FAILED = 0x31,
@@ -94,6 +99,16 @@ enum spdk_scsi_ascq {
 	SPDK_SCSI_ASCQ_POWER_LOSS_EXPECTED = 0x08,
 	SPDK_SCSI_ASCQ_INVALID_LU_IDENTIFIER = 0x09,
 	SPDK_SCSI_ASCQ_CAPACITY_DATA_HAS_CHANGED = 0x09,
+	SPDK_SCSI_ASCQ_THIRD_PARTY_DEVICE_FAILURE = 0x01,
+	SPDK_SCSI_ASCQ_COPY_TARGET_DEVICE_NOT_REACHABLE = 0x02,
+	SPDK_SCSI_ASCQ_UNSUPPORTED_TOKEN_TYPE = 0x01,
+	SPDK_SCSI_ASCQ_TOKEN_UNKNOWN = 0x04,
+	SPDK_SCSI_ASCQ_TOKEN_EXPIRED = 0x07,
+	SPDK_SCSI_ASCQ_TOKEN_CANCELLED = 0x08,
+	SPDK_SCSI_ASCQ_TOO_MANY_TARGET_DESCRIPTORS = 0x06,
+	SPDK_SCSI_ASCQ_UNSUPPORTED_TARGET_DESCRIPTOR_TYPE_CODE = 0x07,
+	SPDK_SCSI_ASCQ_TOO_MANY_SEGMENT_DESCRIPTORS = 0x08,
+	SPDK_SCSI_ASCQ_UNSUPPORTED_SEGMENT_DESCRIPTOR_TYPE_CODE = 0x09,
 };
 
 enum spdk_spc_opcode {
@@ -300,6 +315,7 @@ enum spdk_spc_vpd {
 	SPDK_SPC_VPD_MANAGEMENT_NETWORK_ADDRESSES = 0x85,
 	SPDK_SPC_VPD_MODE_PAGE_POLICY = 0x87,
 	SPDK_SPC_VPD_SCSI_PORTS = 0x88,
+	SPDK_SPC_VPD_THIRD_PARTY_COPY = 0x8f,
 	SPDK_SPC_VPD_SOFTWARE_INTERFACE_IDENTIFICATION = 0x84,
 	SPDK_SPC_VPD_SUPPORTED_VPD_PAGES = 0x00,
 	SPDK_SPC_VPD_UNIT_SERIAL_NUMBER = 0x80,
@@ -420,6 +436,33 @@ struct spdk_scsi_vpd_ext_inquiry {
 
 #define SPDK_SPC_VPD_DESIG_PIV	0x80
 
+/* Third-party copy (SPC-4 EXTENDED COPY and RECEIVE COPY RESULTS) service actions */
+enum spdk_spc_copy_service_action {
+	/* EXTENDED COPY (LID1) */
+	SPDK_SPC_SA_EXTENDED_COPY_LID1			= 0x00,
+	/* Create a ROD token for a set of LBA ranges (SBC-3) */
+	SPDK_SPC_SA_POPULATE_TOKEN			= 0x10,
+	/* Copy the data represented by a ROD token (SBC-3) */
+	SPDK_SPC_SA_WRITE_USING_TOKEN			= 0x11,
+	/* RECEIVE COPY RESULTS OPERATING PARAMETERS */
+	SPDK_SPC_SA_RECEIVE_COPY_OPERATING_PARAMETERS	= 0x03,
+	/* Retrieve the result, and the ROD token, of a copy operation */
+	SPDK_SPC_SA_RECEIVE_ROD_TOKEN_INFORMATION	= 0x07,
+};
+
+/* EXTENDED COPY descriptor type codes */
+#define SPDK_SPC_XCOPY_SEG_DESC_BLOCK_TO_BLOCK	0x02
+#define SPDK_SPC_XCOPY_TGT_DESC_IDENTIFICATION	0xe4
+
+/* ROD token types */
+#define SPDK_SPC_ROD_TYPE_PIT_COPY_DEFAULT	0x00800000
+#define SPDK_SPC_ROD_TYPE_BLOCK_ZERO		0xffff0001
+#define SPDK_SPC_ROD_TOKEN_LENGTH		512
+
+/* Third-party copy VPD page descriptor types */
+#define SPDK_SPC_TPC_DESC_BLOCK_ROD_LIMITS	0x0000
+#define SPDK_SPC_TPC_DESC_SUPPORTED_COMMANDS	0x0001
+
 /* designation descriptor */
 struct spdk_scsi_desig_desc {
 	uint8_t code_set	: 4;
@@ -210,6 +210,28 @@ int spdk_thread_lib_init_ext(spdk_thread_op_fn thread_op_fn,
 			     spdk_thread_op_supported_fn thread_op_supported_fn,
 			     size_t ctx_sz, size_t msg_mempool_size);
 
+/**
+ * Enable per thread pair message channels.
+ *
+ * When enabled, messages sent from an SPDK thread are carried over a dedicated
+ * single-producer/single-consumer ring for each (sender, receiver) pair instead of
+ * the receiver's shared multi-producer ring, and do not consume an element of the
+ * global message memory pool. The shared ring is still used while the receiver has
+ * messages pending on it, or if the pair's ring is full. Messages are executed in the
+ * order they were sent, also when that order comes from messages passed between other
+ * threads in the meantime. Messages sent from outside of an SPDK thread always use the
+ * shared ring.
+ *
+ * Must be called before any thread is created. The setting is reset by
+ * spdk_thread_lib_fini().
+ *
+ * \param size Number of entries in each per pair ring. Must be a power of 2,
+ * or 0 to disable the message channels.
+ *
+ * \return 0 on success, -EBUSY if threads already exist, -EINVAL if size is invalid.
+ */
+int spdk_thread_lib_set_msg_channel_size(uint32_t size);
+
 /**
  * Release all resources associated with this library.
  */
@@ -781,6 +803,27 @@ struct spdk_thread *spdk_io_channel_get_thread(struct spdk_io_channel *ch);
 void spdk_for_each_channel(void *io_device, spdk_channel_msg fn, void *ctx,
 			   spdk_channel_for_each_cpl cpl);
 
+/**
+ * Call 'fn' on each channel associated with io_device, visiting all channels at once.
+ *
+ * Unlike spdk_for_each_channel(), the messages to all threads holding a channel
+ * are sent immediately, so 'fn' may run on several threads concurrently and in
+ * any order. Any state reachable through 'ctx' must be safe for that. After 'fn'
+ * has been called, call spdk_for_each_channel_continue() as usual. A non-zero
+ * status doesn't stop the iteration, the first one reported is passed to 'cpl'.
+ *
+ * Channels created after this call are not visited.
+ *
+ * \param io_device 'fn' will be called on each channel associated with this io_device.
+ * \param fn Called on the appropriate thread for each channel associated with io_device.
+ * \param ctx Context buffer registered to spdk_io_channel_iter that can be obtained
+ * form the function spdk_io_channel_iter_get_ctx().
+ * \param cpl Called on the thread that spdk_for_each_channel_parallel was initially
+ * called from when 'fn' has been called on each channel.
+ */
+void spdk_for_each_channel_parallel(void *io_device, spdk_channel_msg fn, void *ctx,
+				    spdk_channel_for_each_cpl cpl);
+
 /**
  * Get io_device from the I/O channel iterator.
  *
@@ -1086,6 +1129,12 @@ struct spdk_iobuf_pool_stats {
 	uint64_t	main;
 	/** Buffer missed and request to get buffer was queued */
 	uint64_t	retry;
+	/** Buffer released to the main pool for a request waiting on another thread */
+	uint64_t	handoff;
+	/** Highest number of buffers held at the same time */
+	uint64_t	high_watermark;
+	/** Lowest number of buffers seen left in the main pool */
+	uint64_t	low_watermark;
 };
 
 struct spdk_iobuf_module_stats {
@@ -1105,6 +1154,29 @@ struct spdk_iobuf_entry {
 	STAILQ_ENTRY(spdk_iobuf_entry)	stailq;
 };
 
+struct spdk_iobuf_channel;
+struct spdk_iobuf_iov_entry;
+
+typedef void (*spdk_iobuf_get_iov_cb)(struct spdk_iobuf_iov_entry *entry, int iovcnt);
+
+/** iobuf scatter-gather request, see spdk_iobuf_get_iov() */
+struct spdk_iobuf_iov_entry {
+	/** Wait queue entry of the buffer currently being waited for */
+	struct spdk_iobuf_entry		iobuf;
+	/** Callback executed once all the buffers are acquired */
+	spdk_iobuf_get_iov_cb		cb_fn;
+	/** iobuf channel the buffers are acquired from */
+	struct spdk_iobuf_channel	*ch;
+	/** Array of iovecs filled in with the buffers */
+	struct iovec			*iovs;
+	/** Number of iovecs filled in so far */
+	int				iovcnt;
+	/** Maximum length of each buffer */
+	uint32_t			bufsize;
+	/** Length that still needs to be acquired */
+	uint64_t			remaining;
+};
+
 struct spdk_iobuf_buffer {
 	STAILQ_ENTRY(spdk_iobuf_buffer)	stailq;
 };
@@ -1127,6 +1199,10 @@ struct spdk_iobuf_pool_cache {
 	uint32_t			bufsize;
 	/** Pool usage statistics */
 	struct spdk_iobuf_pool_stats	stats;
+	/** Number of requests waiting for a buffer from the pool on all threads */
+	uint32_t			*waiters;
+	/** Number of buffers currently held */
+	uint64_t			in_use;
 };
 
 struct spdk_iobuf_node_cache {
@@ -1271,7 +1347,10 @@ void *spdk_iobuf_get(struct spdk_iobuf_channel *ch, uint64_t len, struct spdk_io
 
 /**
  * Release a buffer back to the iobuf pool.  If there are outstanding requests waiting for a buffer,
- * this buffer will be passed to one of them.
+ * this buffer will be passed to one of them.  Requests waiting on the calling thread are served
+ * directly.  If there are none, but requests are waiting on other threads of the same NUMA node,
+ * the buffer is returned to the main pool instead of the local cache, so that those threads can
+ * pick it up.
  *
  * \param ch iobuf channel.
  * \param buf Buffer to release
@@ -1279,6 +1358,51 @@ void *spdk_iobuf_get(struct spdk_iobuf_channel *ch, uint64_t len, struct spdk_io
  */
 void spdk_iobuf_put(struct spdk_iobuf_channel *ch, void *buf, uint64_t len);
 
+/**
+ * Get a buffer of a given length made of several iobuf buffers.  The length is split into chunks
+ * of at most `bufsize` bytes, each backed by a separate buffer and described by one iovec.  This
+ * allows for requests larger than large_bufsize without needing a contiguous buffer.
+ *
+ * If not all of the buffers are available and cb_fn is provided, the buffers acquired so far are
+ * kept, the request is queued and cb_fn is executed once the rest of them become available.
+ * Otherwise, the buffers acquired so far are released.  A queued request can be aborted with
+ * `spdk_iobuf_iov_entry_abort()`.  The entry is queued through its `iobuf` member, so that's what
+ * `spdk_iobuf_for_each_entry()` will report.
+ *
+ * \param ch iobuf channel.
+ * \param len Total length of the buffers.
+ * \param bufsize Maximum length of each buffer.  If 0, large_bufsize is used.
+ * \param iovs Array of iovecs to fill in.
+ * \param iovcnt Size of the iovs array.
+ * \param entry Request state (optional).  Mandatory if cb_fn is provided, in which case it must
+ *              stay valid until cb_fn is executed or the request is aborted.
+ * \param cb_fn Callback to be executed once all buffers are acquired (optional).  If the buffers
+ *              are available immediately, it is NOT executed.
+ *
+ * \return number of iovecs filled in on success, -EINVAL if the iovs array is too small,
+ * -ENOMEM if the buffers aren't currently available.
+ */
+int spdk_iobuf_get_iov(struct spdk_iobuf_channel *ch, uint64_t len, uint32_t bufsize,
+		       struct iovec *iovs, int iovcnt, struct spdk_iobuf_iov_entry *entry,
+		       spdk_iobuf_get_iov_cb cb_fn);
+
+/**
+ * Release buffers acquired with `spdk_iobuf_get_iov()`.
+ *
+ * \param ch iobuf channel.
+ * \param iovs Array of iovecs describing the buffers.
+ * \param iovcnt Number of iovecs.
+ */
+void spdk_iobuf_put_iov(struct spdk_iobuf_channel *ch, struct iovec *iovs, int iovcnt);
+
+/**
+ * Abort a queued scatter-gather request and release the buffers it has acquired so far.
+ *
+ * \param ch iobuf channel on which the entry is waiting.
+ * \param entry Request to abort.
+ */
+void spdk_iobuf_iov_entry_abort(struct spdk_iobuf_channel *ch, struct spdk_iobuf_iov_entry *entry);
+
 typedef void (*spdk_iobuf_get_stats_cb)(struct spdk_iobuf_module_stats *modules,
 					uint32_t num_modules, void *cb_arg);
 
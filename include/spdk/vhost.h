@@ -205,6 +205,37 @@ int spdk_vhost_set_coalescing(struct spdk_vhost_dev *vdev, uint32_t delay_base_u
 void spdk_vhost_get_coalescing(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
 			       uint32_t *iops_threshold);
 
+/**
+ * Set coalescing parameters, including a count threshold.
+ *
+ * Same as spdk_vhost_set_coalescing(), but while an event is being delayed
+ * it is still sent as soon as \c max_coalesced_reqs completions are pending
+ * on a virtqueue. The delay itself is adapted separately for each virtqueue.
+ *
+ * \param vdev vhost device.
+ * \param delay_base_us Base delay time in microseconds. If 0, coalescing is disabled.
+ * \param iops_threshold IOPS threshold when coalescing is activated.
+ * \param max_coalesced_reqs Maximum number of completions covered by a single
+ * event. If 0, only the delay time limits coalescing.
+ *
+ * \return 0 on success, negative errno on failure.
+ */
+int spdk_vhost_set_coalescing_ext(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
+				  uint32_t iops_threshold, uint32_t max_coalesced_reqs);
+
+/**
+ * Get coalescing parameters, including the count threshold.
+ *
+ * \see spdk_vhost_set_coalescing_ext
+ *
+ * \param vdev vhost device.
+ * \param delay_base_us Optional pointer to store base delay time.
+ * \param iops_threshold Optional pointer to store IOPS threshold.
+ * \param max_coalesced_reqs Optional pointer to store the count threshold.
+ */
+void spdk_vhost_get_coalescing_ext(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
+				   uint32_t *iops_threshold, uint32_t *max_coalesced_reqs);
+
 /**
  * Construct an empty vhost SCSI device.  This will create a
  * Unix domain socket together with a vhost-user slave server waiting
@@ -78,6 +78,20 @@ struct spdk_reactor {
 	struct spdk_fd_group				*fgrp;
 	int						resched_fd;
 	uint16_t					trace_id;
+
+	/* Work stealing, only used if a work stealing threshold is set. */
+	int32_t						numa_id;
+	/* Core of an idle reactor asking this reactor for a thread. */
+	uint32_t					steal_lcore;
+	/* Last time any thread on this reactor was busy. */
+	uint64_t					last_busy_tsc;
+	/* Last time fewer than two threads on this reactor were busy. */
+	uint64_t					last_unloaded_tsc;
+	uint64_t					last_steal_tsc;
+	/* Threads this reactor took from other reactors. */
+	uint64_t					steal_count;
+	/* Threads other reactors took from this reactor. */
+	uint64_t					stolen_count;
 } __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
 
 int spdk_reactors_init(size_t msg_mempool_size);
@@ -201,11 +201,27 @@ nvme_tcp_pdu_calc_header_digest(struct nvme_tcp_pdu *pdu)
 	return crc32c;
 }
 
+static inline uint32_t
+nvme_tcp_pdu_pad_data_digest(struct nvme_tcp_pdu *pdu, uint32_t crc32c)
+{
+	uint32_t mod;
+
+	mod = pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT;
+	if (mod != 0) {
+		uint32_t pad_length = SPDK_NVME_TCP_DIGEST_ALIGNMENT - mod;
+		uint8_t pad[3] = {0, 0, 0};
+
+		assert(pad_length > 0);
+		assert(pad_length <= sizeof(pad));
+		crc32c = spdk_crc32c_update(pad, pad_length, crc32c);
+	}
+	return crc32c;
+}
+
 static uint32_t
 nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
 {
 	uint32_t crc32c = SPDK_CRC32C_XOR;
-	uint32_t mod;
 
 	assert(pdu->data_len != 0);
 
@@ -216,15 +232,36 @@ nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
 					      0, pdu->data_len, &crc32c, pdu->dif_ctx);
 	}
 
-	mod = pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT;
-	if (mod != 0) {
-		uint32_t pad_length = SPDK_NVME_TCP_DIGEST_ALIGNMENT - mod;
-		uint8_t pad[3] = {0, 0, 0};
+	return nvme_tcp_pdu_pad_data_digest(pdu, crc32c);
+}
 
-		assert(pad_length > 0);
-		assert(pad_length <= sizeof(pad));
-		crc32c = spdk_crc32c_update(pad, pad_length, crc32c);
+/*
+ * Update a running data digest with len bytes of the PDU's data starting at offset,
+ * so that the payload can be digested piece by piece as it is received.  Once all of
+ * the data was digested, nvme_tcp_pdu_pad_data_digest() gives the same value as
+ * nvme_tcp_pdu_calc_data_digest().  PDUs with DIF are not supported.
+ */
+static inline uint32_t
+nvme_tcp_pdu_update_data_digest(struct nvme_tcp_pdu *pdu, uint32_t offset, uint32_t len,
+				uint32_t crc32c)
+{
+	uint32_t i, iov_len;
+
+	assert(pdu->dif_ctx == NULL);
+
+	for (i = 0; i < pdu->data_iovcnt && len > 0; i++) {
+		iov_len = pdu->data_iov[i].iov_len;
+		if (offset >= iov_len) {
+			offset -= iov_len;
+			continue;
+		}
+
+		iov_len = spdk_min(iov_len - offset, len);
+		crc32c = spdk_crc32c_update((uint8_t *)pdu->data_iov[i].iov_base + offset, iov_len, crc32c);
+		len -= iov_len;
+		offset = 0;
 	}
+
 	return crc32c;
 }
 
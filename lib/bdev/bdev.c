@@ -41,6 +41,8 @@ int __itt_init_ittlib(const char *, __itt_group_id);
 #define BUF_SMALL_CACHE_SIZE			128
 #define BUF_LARGE_CACHE_SIZE			16
 #define NOMEM_THRESHOLD_COUNT			8
+/* Enough for 1MiB in 128KiB iobuf buffers, plus one for a partial buffer */
+#define BDEV_IO_NUM_SG_BUF_IOV			9
 
 #define SPDK_BDEV_QOS_TIMESLICE_IN_USEC		1000
 #define SPDK_BDEV_QOS_MIN_IO_PER_TIMESLICE	1
@@ -221,10 +223,24 @@ struct spdk_bdev_mgmt_channel {
 
 	struct spdk_iobuf_channel iobuf;
 
+	/* Free scatter-gather buffer states, allocated on first use */
+	STAILQ_HEAD(, spdk_bdev_io_sg_buf)	sg_bufs;
+
 	TAILQ_HEAD(, spdk_bdev_shared_resource)	shared_resources;
 	TAILQ_HEAD(, spdk_bdev_io_wait_entry)	io_wait_queue;
 };
 
+/*
+ * State of a data buffer made of several iobuf buffers.  Only I/Os larger than large_bufsize
+ * need it, so it's kept out of spdk_bdev_io.
+ */
+struct spdk_bdev_io_sg_buf {
+	struct spdk_iobuf_iov_entry		iobuf;
+	struct iovec				iovs[BDEV_IO_NUM_SG_BUF_IOV];
+	struct spdk_bdev_io			*bdev_io;
+	STAILQ_ENTRY(spdk_bdev_io_sg_buf)	link;
+};
+
 /*
  * Per-module (or per-io_device) data. Multiple bdevs built on the same io_device
  * will queue here their IO that awaits retry. It makes it possible to retry sending
@@ -375,6 +391,8 @@ struct spdk_bdev_channel_iter {
 	spdk_bdev_for_each_channel_done cpl;
 	struct spdk_io_channel_iter *i;
 	void *ctx;
+	/* Per-channel copy made by bdev_for_each_channel_parallel() */
+	bool parallel;
 };
 
 struct spdk_bdev_io_error_stat {
@@ -408,6 +426,9 @@ static int bdev_write_zero_buffer(struct spdk_bdev_io *bdev_io);
 static void bdev_enable_qos_msg(struct spdk_bdev_channel_iter *i, struct spdk_bdev *bdev,
 				struct spdk_io_channel *ch, void *_ctx);
 static void bdev_enable_qos_done(struct spdk_bdev *bdev, void *_ctx, int status);
+static void bdev_for_each_channel_parallel(struct spdk_bdev *bdev,
+					   spdk_bdev_for_each_channel_msg fn, void *ctx,
+					   spdk_bdev_for_each_channel_done cpl);
 
 static int bdev_readv_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 				     struct iovec *iov, int iovcnt, void *md_buf, uint64_t offset_blocks,
@@ -1556,9 +1577,18 @@ _bdev_io_put_buf(struct spdk_bdev_io *bdev_io, void *buf, uint64_t buf_len)
 static void
 bdev_io_put_buf(struct spdk_bdev_io *bdev_io)
 {
+	struct spdk_bdev_mgmt_channel *ch;
+	struct spdk_bdev_io_sg_buf *sg;
+
 	assert(bdev_io->internal.f.has_buf);
 
-	if (bdev_io->u.bdev.memory_domain == spdk_accel_get_memory_domain()) {
+	if (spdk_unlikely(bdev_io->internal.f.sg_buf)) {
+		ch = bdev_io->internal.ch->shared_resource->mgmt_ch;
+		sg = bdev_io->internal.buf.sg;
+		spdk_iobuf_put_iov(&ch->iobuf, sg->iovs, sg->iobuf.iovcnt);
+		STAILQ_INSERT_HEAD(&ch->sg_bufs, sg, link);
+		bdev_io->internal.f.sg_buf = false;
+	} else if (bdev_io->u.bdev.memory_domain == spdk_accel_get_memory_domain()) {
 		bdev_io_put_accel_buf(bdev_io);
 	} else {
 		assert(bdev_io->u.bdev.memory_domain == NULL);
@@ -1932,6 +1962,85 @@ bdev_io_get_iobuf_cb(struct spdk_iobuf_entry *iobuf, void *buf)
 	_bdev_io_set_buf(bdev_io, buf, bdev_io->internal.buf.len);
 }
 
+static void
+bdev_io_set_sg_buf(struct spdk_bdev_io *bdev_io, int iovcnt)
+{
+	bdev_io->internal.f.has_buf = true;
+	bdev_io->u.bdev.iovs = bdev_io->internal.buf.sg->iovs;
+	bdev_io->u.bdev.iovcnt = iovcnt;
+
+	bdev_io_get_buf_complete(bdev_io, true);
+}
+
+static void
+bdev_io_get_iobuf_iov_cb(struct spdk_iobuf_iov_entry *iobuf, int iovcnt)
+{
+	struct spdk_bdev_io_sg_buf *sg;
+
+	sg = SPDK_CONTAINEROF(iobuf, struct spdk_bdev_io_sg_buf, iobuf);
+	bdev_io_set_sg_buf(sg->bdev_io, iovcnt);
+}
+
+/*
+ * Buffers larger than large_bufsize can be made of several iobuf buffers, as long as the bdev_io
+ * doesn't need a single contiguous buffer (e.g. for separate metadata or as a bounce buffer) and
+ * the bdev accepts segments of that size.
+ */
+static bool
+bdev_io_get_sg_buf(struct spdk_bdev_io *bdev_io, uint64_t len)
+{
+	struct spdk_bdev *bdev = bdev_io->bdev;
+	struct spdk_bdev_mgmt_channel *mgmt_ch;
+	struct spdk_bdev_io_sg_buf *sg;
+	uint32_t bufsize;
+	int rc;
+
+	if (spdk_bdev_is_md_separate(bdev) || spdk_bdev_get_buf_align(bdev) > 1 ||
+	    bdev_io->internal.get_aux_buf_cb != NULL || _is_buf_allocated(bdev_io->u.bdev.iovs)) {
+		return false;
+	}
+
+	mgmt_ch = bdev_io->internal.ch->shared_resource->mgmt_ch;
+	/* Don't let the blocks straddle buffers */
+	bufsize = mgmt_ch->iobuf.cache[0].large.bufsize / bdev->blocklen * bdev->blocklen;
+
+	if ((bdev->max_segment_size != 0 && bdev->max_segment_size < bufsize) ||
+	    (bdev->max_num_segments != 0 && bdev->max_num_segments < SPDK_CEIL_DIV(len, bufsize))) {
+		return false;
+	}
+
+	if (spdk_unlikely(SPDK_CEIL_DIV(len, bufsize) > BDEV_IO_NUM_SG_BUF_IOV)) {
+		return false;
+	}
+
+	sg = STAILQ_FIRST(&mgmt_ch->sg_bufs);
+	if (sg != NULL) {
+		STAILQ_REMOVE_HEAD(&mgmt_ch->sg_bufs, link);
+	} else {
+		sg = calloc(1, sizeof(*sg));
+		if (sg == NULL) {
+			SPDK_ERRLOG("Unable to allocate scatter-gather buffer state\n");
+			bdev_io_get_buf_complete(bdev_io, false);
+			return true;
+		}
+	}
+
+	sg->bdev_io = bdev_io;
+	bdev_io->internal.buf.sg = sg;
+	bdev_io->internal.buf.len = len;
+	bdev_io->internal.f.sg_buf = true;
+
+	rc = spdk_iobuf_get_iov(&mgmt_ch->iobuf, len, bufsize, sg->iovs, BDEV_IO_NUM_SG_BUF_IOV,
+				&sg->iobuf, bdev_io_get_iobuf_iov_cb);
+	assert(rc != -EINVAL);
+
+	if (rc > 0) {
+		bdev_io_set_sg_buf(bdev_io, rc);
+	}
+
+	return true;
+}
+
 static void
 bdev_io_get_buf(struct spdk_bdev_io *bdev_io, uint64_t len)
 {
@@ -1944,6 +2053,10 @@ bdev_io_get_buf(struct spdk_bdev_io *bdev_io, uint64_t len)
 	max_len = bdev_io_get_max_buf_len(bdev_io, len);
 
 	if (spdk_unlikely(max_len > mgmt_ch->iobuf.cache[0].large.bufsize)) {
+		if (bdev_io_get_sg_buf(bdev_io, len)) {
+			return;
+		}
+
 		SPDK_ERRLOG("Length %" PRIu64 " is larger than allowed\n", max_len);
 		bdev_io_get_buf_complete(bdev_io, false);
 		return;
@@ -2157,10 +2270,16 @@ static void
 bdev_mgmt_channel_destroy(void *io_device, void *ctx_buf)
 {
 	struct spdk_bdev_mgmt_channel *ch = ctx_buf;
+	struct spdk_bdev_io_sg_buf *sg;
 	struct spdk_bdev_io *bdev_io;
 
 	spdk_iobuf_channel_fini(&ch->iobuf);
 
+	while ((sg = STAILQ_FIRST(&ch->sg_bufs)) != NULL) {
+		STAILQ_REMOVE_HEAD(&ch->sg_bufs, link);
+		free(sg);
+	}
+
 	while (!STAILQ_EMPTY(&ch->per_thread_cache)) {
 		bdev_io = STAILQ_FIRST(&ch->per_thread_cache);
 		STAILQ_REMOVE_HEAD(&ch->per_thread_cache, internal.buf_link);
@@ -2188,6 +2307,7 @@ bdev_mgmt_channel_create(void *io_device, void *ctx_buf)
 	}
 
 	STAILQ_INIT(&ch->per_thread_cache);
+	STAILQ_INIT(&ch->sg_bufs);
 	ch->bdev_io_cache_size = g_bdev_opts.bdev_io_cache_size;
 
 	/* Pre-populate bdev_io cache to ensure this thread cannot be starved. */
@@ -4539,18 +4659,52 @@ bdev_channel_create(void *io_device, void *ctx_buf)
 	return 0;
 }
 
+/*
+ * A bdev_io waiting for a scatter-gather buffer is queued through the entry of its
+ * spdk_bdev_io_sg_buf, which doesn't use bdev_io_get_iobuf_cb().
+ */
+static struct spdk_bdev_io *
+bdev_io_from_iobuf_entry(struct spdk_iobuf_entry *entry)
+{
+	struct spdk_bdev_io_sg_buf *sg;
+
+	if (spdk_unlikely(entry->cb_fn != bdev_io_get_iobuf_cb)) {
+		sg = SPDK_CONTAINEROF(entry, struct spdk_bdev_io_sg_buf, iobuf.iobuf);
+		return sg->bdev_io;
+	}
+
+	return SPDK_CONTAINEROF(entry, struct spdk_bdev_io, internal.iobuf);
+}
+
+static void
+bdev_io_abort_get_buf(struct spdk_iobuf_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	struct spdk_bdev_mgmt_channel *mgmt_ch;
+	struct spdk_bdev_io_sg_buf *sg;
+	uint64_t buf_len;
+
+	if (bdev_io->internal.f.sg_buf) {
+		mgmt_ch = SPDK_CONTAINEROF(ch, struct spdk_bdev_mgmt_channel, iobuf);
+		sg = bdev_io->internal.buf.sg;
+		spdk_iobuf_iov_entry_abort(ch, &sg->iobuf);
+		STAILQ_INSERT_HEAD(&mgmt_ch->sg_bufs, sg, link);
+		bdev_io->internal.f.sg_buf = false;
+	} else {
+		buf_len = bdev_io_get_max_buf_len(bdev_io, bdev_io->internal.buf.len);
+		spdk_iobuf_entry_abort(ch, &bdev_io->internal.iobuf, buf_len);
+	}
+}
+
 static int
 bdev_abort_all_buf_io_cb(struct spdk_iobuf_channel *ch, struct spdk_iobuf_entry *entry,
 			 void *cb_ctx)
 {
 	struct spdk_bdev_channel *bdev_ch = cb_ctx;
 	struct spdk_bdev_io *bdev_io;
-	uint64_t buf_len;
 
-	bdev_io = SPDK_CONTAINEROF(entry, struct spdk_bdev_io, internal.iobuf);
+	bdev_io = bdev_io_from_iobuf_entry(entry);
 	if (bdev_io->internal.ch == bdev_ch) {
-		buf_len = bdev_io_get_max_buf_len(bdev_io, bdev_io->internal.buf.len);
-		spdk_iobuf_entry_abort(ch, entry, buf_len);
+		bdev_io_abort_get_buf(ch, bdev_io);
 		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_ABORTED);
 	}
 
@@ -4612,12 +4766,10 @@ static int
 bdev_abort_buf_io_cb(struct spdk_iobuf_channel *ch, struct spdk_iobuf_entry *entry, void *cb_ctx)
 {
 	struct spdk_bdev_io *bdev_io, *bio_to_abort = cb_ctx;
-	uint64_t buf_len;
 
-	bdev_io = SPDK_CONTAINEROF(entry, struct spdk_bdev_io, internal.iobuf);
+	bdev_io = bdev_io_from_iobuf_entry(entry);
 	if (bdev_io == bio_to_abort) {
-		buf_len = bdev_io_get_max_buf_len(bdev_io, bdev_io->internal.buf.len);
-		spdk_iobuf_entry_abort(ch, entry, buf_len);
+		bdev_io_abort_get_buf(ch, bdev_io);
 		spdk_bdev_io_complete(bio_to_abort, SPDK_BDEV_IO_STATUS_ABORTED);
 		return 1;
 	}
@@ -6884,8 +7036,8 @@ bdev_reset_poll_for_outstanding_io(void *ctx)
 	struct spdk_bdev_io *bdev_io = ctx;
 
 	spdk_poller_unregister(&bdev_io->u.reset.wait_poller.poller);
-	spdk_bdev_for_each_channel(bdev_io->bdev, bdev_reset_check_outstanding_io, bdev_io,
-				   bdev_reset_check_outstanding_io_done);
+	bdev_for_each_channel_parallel(bdev_io->bdev, bdev_reset_check_outstanding_io, bdev_io,
+				       bdev_reset_check_outstanding_io_done);
 
 	return SPDK_POLLER_BUSY;
 }
@@ -6906,8 +7058,8 @@ bdev_reset_freeze_channel_done(struct spdk_bdev *bdev, void *_ctx, int status)
 	/* In case bdev->reset_io_drain_timeout is not equal to zero,
 	 * submit the reset to the underlying module only if outstanding I/O
 	 * remain after reset_io_drain_timeout seconds have passed. */
-	spdk_bdev_for_each_channel(bdev, bdev_reset_check_outstanding_io, bdev_io,
-				   bdev_reset_check_outstanding_io_done);
+	bdev_for_each_channel_parallel(bdev, bdev_reset_check_outstanding_io, bdev_io,
+				       bdev_reset_check_outstanding_io_done);
 }
 
 static void
@@ -6964,8 +7116,8 @@ bdev_start_reset(struct spdk_bdev_io *bdev_io)
 	spdk_spin_unlock(&bdev->internal.spinlock);
 
 	if (freeze_channel) {
-		spdk_bdev_for_each_channel(bdev, bdev_reset_freeze_channel, bdev_io,
-					   bdev_reset_freeze_channel_done);
+		bdev_for_each_channel_parallel(bdev, bdev_reset_freeze_channel, bdev_io,
+					       bdev_reset_freeze_channel_done);
 	}
 }
 
@@ -7830,8 +7982,8 @@ spdk_bdev_io_complete(struct spdk_bdev_io *bdev_io, enum spdk_bdev_io_status sta
 
 	if (spdk_unlikely(bdev_io->type == SPDK_BDEV_IO_TYPE_RESET)) {
 		assert(bdev_io == bdev->internal.reset_in_progress);
-		spdk_bdev_for_each_channel(bdev, bdev_unfreeze_channel, bdev_io,
-					   bdev_reset_complete);
+		bdev_for_each_channel_parallel(bdev, bdev_unfreeze_channel, bdev_io,
+					       bdev_reset_complete);
 		return;
 	} else {
 		bdev_io_decrement_outstanding(bdev_ch, shared_resource);
@@ -8394,8 +8546,8 @@ spdk_bdev_unregister(struct spdk_bdev *bdev, spdk_bdev_unregister_cb cb_fn, void
 
 	spdk_bdev_set_qd_sampling_period(bdev, 0);
 
-	spdk_bdev_for_each_channel(bdev, bdev_unregister_abort_channel, bdev,
-				   bdev_unregister);
+	bdev_for_each_channel_parallel(bdev, bdev_unregister_abort_channel, bdev,
+				       bdev_unregister);
 }
 
 int
@@ -8441,7 +8593,8 @@ bdev_start_qos(struct spdk_bdev *bdev)
 			return -ENOMEM;
 		}
 		ctx->bdev = bdev;
-		spdk_bdev_for_each_channel(bdev, bdev_enable_qos_msg, ctx, bdev_enable_qos_done);
+		bdev_for_each_channel_parallel(bdev, bdev_enable_qos_msg, ctx,
+					       bdev_enable_qos_done);
 	}
 
 	return 0;
@@ -9915,8 +10068,8 @@ spdk_bdev_set_qos_rate_limits(struct spdk_bdev *bdev, uint64_t *limits,
 			/* Enabling */
 			bdev_set_qos_rate_limits(bdev, limits);
 
-			spdk_bdev_for_each_channel(bdev, bdev_enable_qos_msg, ctx,
-						   bdev_enable_qos_done);
+			bdev_for_each_channel_parallel(bdev, bdev_enable_qos_msg, ctx,
+						       bdev_enable_qos_done);
 		} else {
 			/* Updating */
 			bdev_set_qos_rate_limits(bdev, limits);
@@ -9929,8 +10082,8 @@ spdk_bdev_set_qos_rate_limits(struct spdk_bdev *bdev, uint64_t *limits,
 			bdev_set_qos_rate_limits(bdev, limits);
 
 			/* Disabling */
-			spdk_bdev_for_each_channel(bdev, bdev_disable_qos_msg, ctx,
-						   bdev_disable_qos_msg_done);
+			bdev_for_each_channel_parallel(bdev, bdev_disable_qos_msg, ctx,
+						       bdev_disable_qos_msg_done);
 		} else {
 			spdk_spin_unlock(&bdev->internal.spinlock);
 			bdev_set_qos_limit_done(ctx, 0);
@@ -9981,8 +10134,8 @@ bdev_histogram_enable_channel_cb(struct spdk_bdev *bdev, void *_ctx, int status)
 	if (status != 0) {
 		ctx->status = status;
 		ctx->bdev->internal.histogram_enabled = false;
-		spdk_bdev_for_each_channel(ctx->bdev, bdev_histogram_disable_channel, ctx,
-					   bdev_histogram_disable_channel_cb);
+		bdev_for_each_channel_parallel(ctx->bdev, bdev_histogram_disable_channel, ctx,
+					       bdev_histogram_disable_channel_cb);
 	} else {
 		spdk_spin_lock(&ctx->bdev->internal.spinlock);
 		ctx->bdev->internal.histogram_in_progress = false;
@@ -10042,11 +10195,11 @@ spdk_bdev_histogram_enable_ext(struct spdk_bdev *bdev, spdk_bdev_histogram_statu
 
 	if (enable) {
 		/* Allocate histogram for each channel */
-		spdk_bdev_for_each_channel(bdev, bdev_histogram_enable_channel, ctx,
-					   bdev_histogram_enable_channel_cb);
+		bdev_for_each_channel_parallel(bdev, bdev_histogram_enable_channel, ctx,
+					       bdev_histogram_enable_channel_cb);
 	} else {
-		spdk_bdev_for_each_channel(bdev, bdev_histogram_disable_channel, ctx,
-					   bdev_histogram_disable_channel_cb);
+		bdev_for_each_channel_parallel(bdev, bdev_histogram_disable_channel, ctx,
+					       bdev_histogram_disable_channel_cb);
 	}
 }
 
@@ -10818,7 +10971,13 @@ spdk_bdev_for_each_bdev_io(struct spdk_bdev *bdev, void *_ctx, spdk_bdev_io_fn f
 void
 spdk_bdev_for_each_channel_continue(struct spdk_bdev_channel_iter *iter, int status)
 {
-	spdk_for_each_channel_continue(iter->i, status);
+	struct spdk_io_channel_iter *i = iter->i;
+
+	if (iter->parallel) {
+		free(iter);
+	}
+
+	spdk_for_each_channel_continue(i, status);
 }
 
 static struct spdk_bdev *
@@ -10875,6 +11034,56 @@ spdk_bdev_for_each_channel(struct spdk_bdev *bdev, spdk_bdev_for_each_channel_ms
 			      iter, bdev_each_channel_cpl);
 }
 
+static void
+bdev_each_channel_parallel_msg(struct spdk_io_channel_iter *i)
+{
+	struct spdk_bdev_channel_iter *iter = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_bdev *bdev = io_channel_iter_get_bdev(i);
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct spdk_bdev_channel_iter *ch_iter;
+
+	/* The channels are visited concurrently, so each of them needs its own iterator */
+	ch_iter = calloc(1, sizeof(*ch_iter));
+	if (ch_iter == NULL) {
+		spdk_for_each_channel_continue(i, -ENOMEM);
+		return;
+	}
+
+	ch_iter->fn = iter->fn;
+	ch_iter->ctx = iter->ctx;
+	ch_iter->i = i;
+	ch_iter->parallel = true;
+
+	ch_iter->fn(ch_iter, bdev, ch, ch_iter->ctx);
+}
+
+/* Same as spdk_bdev_for_each_channel(), but all the channels are visited at once.  Only
+ * for callers whose fn touches nothing but the channel and doesn't depend on the order
+ * the channels are visited in.
+ */
+static void
+bdev_for_each_channel_parallel(struct spdk_bdev *bdev, spdk_bdev_for_each_channel_msg fn,
+			       void *ctx, spdk_bdev_for_each_channel_done cpl)
+{
+	struct spdk_bdev_channel_iter *iter;
+
+	assert(bdev != NULL && fn != NULL && ctx != NULL);
+
+	iter = calloc(1, sizeof(struct spdk_bdev_channel_iter));
+	if (iter == NULL) {
+		SPDK_ERRLOG("Unable to allocate iterator\n");
+		assert(false);
+		return;
+	}
+
+	iter->fn = fn;
+	iter->cpl = cpl;
+	iter->ctx = ctx;
+
+	spdk_for_each_channel_parallel(__bdev_to_io_dev(bdev), bdev_each_channel_parallel_msg,
+				       iter, bdev_each_channel_cpl);
+}
+
 static void
 bdev_copy_do_write_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 {
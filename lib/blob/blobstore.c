@@ -2628,6 +2628,8 @@ struct spdk_blob_copy_cluster_ctx {
 	uint32_t new_extent_page;
 	spdk_bs_sequence_t *seq;
 	struct spdk_blob_md_page *new_cluster_page;
+	/* Set if the cluster is allocated independently of the channel's other allocations */
+	spdk_bs_user_op_t *op;
 };
 
 struct spdk_blob_free_cluster_ctx {
@@ -2648,7 +2650,12 @@ blob_allocate_and_copy_cluster_cpl(void *cb_arg, int bserrno)
 	spdk_bs_user_op_t *op;
 
 	TAILQ_INIT(&requests);
-	TAILQ_SWAP(&set->channel->need_cluster_alloc, &requests, spdk_bs_request_set, link);
+	if (ctx->op != NULL) {
+		TAILQ_INSERT_TAIL(&requests, ctx->op, link);
+		spdk_free(ctx->new_cluster_page);
+	} else {
+		TAILQ_SWAP(&set->channel->need_cluster_alloc, &requests, spdk_bs_request_set, link);
+	}
 
 	while (!TAILQ_EMPTY(&requests)) {
 		op = TAILQ_FIRST(&requests);
@@ -2807,10 +2814,17 @@ blob_copy(struct spdk_blob_copy_cluster_ctx *ctx, spdk_bs_user_op_t *op, uint64_
 			     blob_write_copy_cpl, ctx);
 }
 
+/*
+ * Allocate the cluster containing io_unit and copy its data from the backing device, then
+ * execute op.  Unless independent is set, any further allocation on this channel waits for
+ * this one to complete.  Independent allocations use their own metadata page and don't block
+ * (nor wait for) other allocations on the channel.  Racing with another allocation of the
+ * same cluster is handled when the cluster gets inserted on the metadata thread.
+ */
 static void
-bs_allocate_and_copy_cluster(struct spdk_blob *blob,
-			     struct spdk_io_channel *_ch,
-			     uint64_t io_unit, spdk_bs_user_op_t *op)
+_bs_allocate_and_copy_cluster(struct spdk_blob *blob,
+			      struct spdk_io_channel *_ch,
+			      uint64_t io_unit, spdk_bs_user_op_t *op, bool independent)
 {
 	struct spdk_bs_cpl cpl;
 	struct spdk_bs_channel *ch;
@@ -2825,7 +2839,7 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 
 	ch = spdk_io_channel_get_ctx(_ch);
 
-	if (!TAILQ_EMPTY(&ch->need_cluster_alloc)) {
+	if (!independent && !TAILQ_EMPTY(&ch->need_cluster_alloc)) {
 		/* There are already operations pending. Queue this user op
 		 * and return because it will be re-executed when the outstanding
 		 * cluster allocation completes. */
@@ -2850,8 +2864,19 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 
 	ctx->blob = blob;
 	ctx->io_unit = cluster_start_io_unit;
-	ctx->new_cluster_page = ch->new_cluster_page;
-	memset(ctx->new_cluster_page, 0, blob->bs->md_page_size);
+	if (independent) {
+		ctx->op = op;
+		ctx->new_cluster_page = spdk_zmalloc(blob->bs->md_page_size, 0, NULL,
+						     SPDK_ENV_NUMA_ID_ANY, SPDK_MALLOC_DMA);
+		if (!ctx->new_cluster_page) {
+			free(ctx);
+			bs_user_op_abort(op, -ENOMEM);
+			return;
+		}
+	} else {
+		ctx->new_cluster_page = ch->new_cluster_page;
+		memset(ctx->new_cluster_page, 0, blob->bs->md_page_size);
+	}
 
 	/* Check if the cluster that we intend to do CoW for is valid for
 	 * the backing dev. For zeroes backing dev, it'll be always valid.
@@ -2872,6 +2897,9 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 		if (!ctx->buf) {
 			SPDK_ERRLOG("DMA allocation for cluster of size = %" PRIu32 " failed.\n",
 				    blob->bs->cluster_sz);
+			if (independent) {
+				spdk_free(ctx->new_cluster_page);
+			}
 			free(ctx);
 			bs_user_op_abort(op, -ENOMEM);
 			return;
@@ -2884,6 +2912,9 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 	spdk_spin_unlock(&blob->bs->used_lock);
 	if (rc != 0) {
 		spdk_free(ctx->buf);
+		if (independent) {
+			spdk_free(ctx->new_cluster_page);
+		}
 		free(ctx);
 		bs_user_op_abort(op, rc);
 		return;
@@ -2899,13 +2930,18 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 		bs_release_cluster(blob->bs, ctx->new_cluster);
 		spdk_spin_unlock(&blob->bs->used_lock);
 		spdk_free(ctx->buf);
+		if (independent) {
+			spdk_free(ctx->new_cluster_page);
+		}
 		free(ctx);
 		bs_user_op_abort(op, -ENOMEM);
 		return;
 	}
 
-	/* Queue the user op to block other incoming operations */
-	TAILQ_INSERT_TAIL(&ch->need_cluster_alloc, op, link);
+	if (!independent) {
+		/* Queue the user op to block other incoming operations */
+		TAILQ_INSERT_TAIL(&ch->need_cluster_alloc, op, link);
+	}
 
 	if (blob->parent_id != SPDK_BLOBID_INVALID && !is_zeroes) {
 		if (can_copy) {
@@ -2924,6 +2960,14 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 	}
 }
 
+static void
+bs_allocate_and_copy_cluster(struct spdk_blob *blob,
+			     struct spdk_io_channel *_ch,
+			     uint64_t io_unit, spdk_bs_user_op_t *op)
+{
+	_bs_allocate_and_copy_cluster(blob, _ch, io_unit, op, false);
+}
+
 static inline bool
 blob_calculate_lba_and_lba_count(struct spdk_blob *blob, uint64_t io_unit, uint64_t length,
 				 uint64_t *lba,	uint64_t *lba_count)
@@ -6393,6 +6437,17 @@ struct spdk_clone_snapshot_ctx {
 	 * thin-provisioning. Otherwise only decouple parent and keep clone thin. */
 	bool allocate_all;
 
+	/* Inflate cluster copies in progress, limits and progress tracking */
+	struct spdk_bs_inflate_opts inflate_opts;
+	uint32_t inflate_outstanding;
+	bool inflate_submitting;
+	uint64_t copied_clusters;
+	uint64_t total_clusters;
+	/* Rate limit credit, in clusters scaled by ticks_hz */
+	uint64_t rate_credit;
+	uint64_t rate_last_tsc;
+	struct spdk_poller *rate_poller;
+
 	struct {
 		spdk_blob_id id;
 		struct spdk_blob *blob;
@@ -7059,27 +7114,130 @@ bs_cluster_needs_allocation(struct spdk_blob *blob, uint64_t cluster, bool alloc
 	return (allocate_all || b->blob->active.clusters[cluster] != 0);
 }
 
+static void bs_inflate_blob_submit(struct spdk_clone_snapshot_ctx *ctx);
+
+static int
+bs_inflate_blob_rate_poller(void *arg)
+{
+	struct spdk_clone_snapshot_ctx *ctx = arg;
+
+	spdk_poller_unregister(&ctx->rate_poller);
+	bs_inflate_blob_submit(ctx);
+
+	return SPDK_POLLER_BUSY;
+}
+
+/* Maximum credit that can be accumulated: 100ms worth of clusters, at least one cluster */
+static uint64_t
+bs_inflate_blob_rate_max_credit(struct spdk_clone_snapshot_ctx *ctx)
+{
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+
+	return spdk_max(ticks_hz, ticks_hz / 10 * ctx->inflate_opts.clusters_per_sec);
+}
+
+static void
+bs_inflate_blob_rate_init(struct spdk_clone_snapshot_ctx *ctx)
+{
+	ctx->rate_credit = bs_inflate_blob_rate_max_credit(ctx);
+	ctx->rate_last_tsc = spdk_get_ticks();
+}
+
+/*
+ * Returns true if another cluster may be copied now, without exceeding the rate limit.
+ * Credit accrues at clusters_per_sec and each cluster costs ticks_hz of it, so that the
+ * remainder carries over and any rate, including ones below 10 clusters/s, is honored.
+ */
+static bool
+bs_inflate_blob_rate_check(struct spdk_clone_snapshot_ctx *ctx)
+{
+	uint64_t now, elapsed, wait_ticks, wait_us, rate, ticks_hz, max_credit;
+
+	rate = ctx->inflate_opts.clusters_per_sec;
+	ticks_hz = spdk_get_ticks_hz();
+	/* More than one cluster per tick can't be limited anyway */
+	if (rate == 0 || rate >= ticks_hz || rate > UINT32_MAX) {
+		return true;
+	}
+
+	now = spdk_get_ticks();
+	elapsed = now - ctx->rate_last_tsc;
+	ctx->rate_last_tsc = now;
+
+	max_credit = bs_inflate_blob_rate_max_credit(ctx);
+	if (elapsed >= (max_credit - ctx->rate_credit) / rate) {
+		ctx->rate_credit = max_credit;
+	} else {
+		ctx->rate_credit += elapsed * rate;
+	}
+
+	if (ctx->rate_credit < ticks_hz) {
+		wait_ticks = spdk_divide_round_up(ticks_hz - ctx->rate_credit, rate);
+		wait_us = spdk_divide_round_up(wait_ticks * SPDK_SEC_TO_USEC, ticks_hz);
+		ctx->rate_poller = SPDK_POLLER_REGISTER(bs_inflate_blob_rate_poller, ctx, wait_us);
+		return false;
+	}
+
+	ctx->rate_credit -= ticks_hz;
+	return true;
+}
+
 static void
-bs_inflate_blob_touch_next(void *cb_arg, int bserrno)
+bs_inflate_blob_touch_done(void *cb_arg, int bserrno)
 {
 	struct spdk_clone_snapshot_ctx *ctx = (struct spdk_clone_snapshot_ctx *)cb_arg;
+
+	assert(ctx->inflate_outstanding > 0);
+	ctx->inflate_outstanding--;
+
+	if (bserrno != 0) {
+		if (ctx->bserrno == 0) {
+			ctx->bserrno = bserrno;
+		}
+	} else {
+		ctx->copied_clusters++;
+		if (ctx->inflate_opts.status_cb_fn != NULL) {
+			ctx->inflate_opts.status_cb_fn(ctx->copied_clusters, ctx->total_clusters,
+						       ctx->inflate_opts.status_cb_arg);
+		}
+	}
+
+	/* Completed inline from bs_inflate_blob_submit(), which will keep going on its own */
+	if (ctx->inflate_submitting) {
+		return;
+	}
+
+	bs_inflate_blob_submit(ctx);
+}
+
+/*
+ * Keep up to queue_depth cluster copies in flight.  Each one is driven by a dummy 0B read
+ * through an independent cluster allocation, so the copies are not serialized behind each
+ * other on the channel.
+ */
+static void
+bs_inflate_blob_submit(struct spdk_clone_snapshot_ctx *ctx)
+{
 	struct spdk_blob *_blob = ctx->original.blob;
 	struct spdk_bs_cpl cpl;
 	spdk_bs_user_op_t *op;
 	uint64_t offset;
 
-	if (bserrno != 0) {
-		bs_clone_snapshot_origblob_cleanup(ctx, bserrno);
-		return;
-	}
+	ctx->inflate_submitting = true;
+
+	while (ctx->bserrno == 0 && ctx->rate_poller == NULL &&
+	       ctx->inflate_outstanding < ctx->inflate_opts.queue_depth) {
+		for (; ctx->cluster < _blob->active.num_clusters; ctx->cluster++) {
+			if (bs_cluster_needs_allocation(_blob, ctx->cluster, ctx->allocate_all)) {
+				break;
+			}
+		}
 
-	for (; ctx->cluster < _blob->active.num_clusters; ctx->cluster++) {
-		if (bs_cluster_needs_allocation(_blob, ctx->cluster, ctx->allocate_all)) {
+		if (ctx->cluster == _blob->active.num_clusters ||
+		    !bs_inflate_blob_rate_check(ctx)) {
 			break;
 		}
-	}
 
-	if (ctx->cluster < _blob->active.num_clusters) {
 		offset = bs_cluster_to_lba(_blob->bs, ctx->cluster);
 
 		/* We may safely increment a cluster before copying */
@@ -7087,18 +7245,30 @@ bs_inflate_blob_touch_next(void *cb_arg, int bserrno)
 
 		/* Use a dummy 0B read as a context for cluster copy */
 		cpl.type = SPDK_BS_CPL_TYPE_BLOB_BASIC;
-		cpl.u.blob_basic.cb_fn = bs_inflate_blob_touch_next;
+		cpl.u.blob_basic.cb_fn = bs_inflate_blob_touch_done;
 		cpl.u.blob_basic.cb_arg = ctx;
 
 		op = bs_user_op_alloc(ctx->channel, &cpl, SPDK_BLOB_READ, _blob,
 				      NULL, 0, offset, 0);
 		if (!op) {
-			bs_clone_snapshot_origblob_cleanup(ctx, -ENOMEM);
-			return;
+			ctx->bserrno = -ENOMEM;
+			break;
 		}
 
-		bs_allocate_and_copy_cluster(_blob, ctx->channel, offset, op);
-	} else {
+		ctx->inflate_outstanding++;
+		_bs_allocate_and_copy_cluster(_blob, ctx->channel, offset, op, true);
+	}
+
+	ctx->inflate_submitting = false;
+
+	if (ctx->inflate_outstanding > 0) {
+		return;
+	}
+
+	if (ctx->bserrno != 0) {
+		spdk_poller_unregister(&ctx->rate_poller);
+		bs_clone_snapshot_origblob_cleanup(ctx, 0);
+	} else if (ctx->cluster == _blob->active.num_clusters) {
 		bs_inflate_blob_done(ctx);
 	}
 }
@@ -7172,15 +7342,82 @@ bs_inflate_blob_open_cpl(void *cb_arg, struct spdk_blob *_blob, int bserrno)
 	}
 
 	ctx->cluster = 0;
-	bs_inflate_blob_touch_next(ctx, 0);
+	ctx->total_clusters = clusters_needed;
+	bs_inflate_blob_rate_init(ctx);
+	bs_inflate_blob_submit(ctx);
+}
+
+void
+spdk_bs_inflate_opts_init(struct spdk_bs_inflate_opts *opts, size_t opts_size)
+{
+	if (!opts) {
+		SPDK_ERRLOG("opts should not be NULL\n");
+		return;
+	}
+
+	if (!opts_size) {
+		SPDK_ERRLOG("opts_size should not be zero value\n");
+		return;
+	}
+
+	memset(opts, 0, opts_size);
+	opts->opts_size = opts_size;
+
+#define FIELD_OK(field) \
+        offsetof(struct spdk_bs_inflate_opts, field) + sizeof(opts->field) <= opts_size
+
+#define SET_FIELD(field, value) \
+        if (FIELD_OK(field)) { \
+                opts->field = value; \
+        } \
+
+	SET_FIELD(queue_depth, 1);
+	SET_FIELD(clusters_per_sec, 0);
+
+#undef FIELD_OK
+#undef SET_FIELD
+}
+
+static void
+bs_inflate_opts_copy(const struct spdk_bs_inflate_opts *src, struct spdk_bs_inflate_opts *dst)
+{
+#define FIELD_OK(field) \
+        offsetof(struct spdk_bs_inflate_opts, field) + sizeof(src->field) <= src->opts_size
+
+#define SET_FIELD(field) \
+        if (FIELD_OK(field)) { \
+                dst->field = src->field; \
+        } \
+
+	SET_FIELD(queue_depth);
+	SET_FIELD(clusters_per_sec);
+	SET_FIELD(status_cb_fn);
+	SET_FIELD(status_cb_arg);
+
+	dst->opts_size = src->opts_size;
+
+	/* You should not remove this statement, but need to update the assert statement
+	 * if you add a new field, and also add a corresponding SET_FIELD statement */
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_bs_inflate_opts) == 40, "Incorrect size");
+
+#undef FIELD_OK
+#undef SET_FIELD
 }
 
 static void
 bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
-		spdk_blob_id blobid, bool allocate_all, spdk_blob_op_complete cb_fn, void *cb_arg)
+		spdk_blob_id blobid, bool allocate_all, const struct spdk_bs_inflate_opts *opts,
+		spdk_blob_op_complete cb_fn, void *cb_arg)
 {
-	struct spdk_clone_snapshot_ctx *ctx = calloc(1, sizeof(*ctx));
+	struct spdk_clone_snapshot_ctx *ctx;
 
+	if (opts != NULL && opts->opts_size == 0) {
+		SPDK_ERRLOG("opts_size should not be zero value\n");
+		cb_fn(cb_arg, -EINVAL);
+		return;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
 	if (!ctx) {
 		cb_fn(cb_arg, -ENOMEM);
 		return;
@@ -7193,6 +7430,14 @@ bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 	ctx->channel = channel;
 	ctx->allocate_all = allocate_all;
 
+	spdk_bs_inflate_opts_init(&ctx->inflate_opts, sizeof(ctx->inflate_opts));
+	if (opts != NULL) {
+		bs_inflate_opts_copy(opts, &ctx->inflate_opts);
+	}
+	if (ctx->inflate_opts.queue_depth == 0) {
+		ctx->inflate_opts.queue_depth = 1;
+	}
+
 	spdk_bs_open_blob(bs, ctx->original.id, bs_inflate_blob_open_cpl, ctx);
 }
 
@@ -7200,14 +7445,30 @@ void
 spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 		     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
 {
-	bs_inflate_blob(bs, channel, blobid, true, cb_fn, cb_arg);
+	bs_inflate_blob(bs, channel, blobid, true, NULL, cb_fn, cb_arg);
+}
+
+void
+spdk_bs_inflate_blob_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+			 spdk_blob_id blobid, const struct spdk_bs_inflate_opts *opts,
+			 spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	bs_inflate_blob(bs, channel, blobid, true, opts, cb_fn, cb_arg);
 }
 
 void
 spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 			     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
 {
-	bs_inflate_blob(bs, channel, blobid, false, cb_fn, cb_arg);
+	bs_inflate_blob(bs, channel, blobid, false, NULL, cb_fn, cb_arg);
+}
+
+void
+spdk_bs_blob_decouple_parent_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+				 spdk_blob_id blobid, const struct spdk_bs_inflate_opts *opts,
+				 spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	bs_inflate_blob(bs, channel, blobid, false, opts, cb_fn, cb_arg);
 }
 /* END spdk_bs_inflate_blob */
 
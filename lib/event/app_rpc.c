@@ -375,6 +375,9 @@ _rpc_framework_get_reactors(void *arg1, void *arg2)
 	spdk_json_write_named_uint64(ctx->w, "busy", reactor->busy_tsc);
 	spdk_json_write_named_uint64(ctx->w, "idle", reactor->idle_tsc);
 	spdk_json_write_named_bool(ctx->w, "in_interrupt", reactor->in_interrupt);
+	spdk_json_write_named_uint64(ctx->w, "steal_count",
+				     __atomic_load_n(&reactor->steal_count, __ATOMIC_RELAXED));
+	spdk_json_write_named_uint64(ctx->w, "stolen_count", reactor->stolen_count);
 
 	if (app_get_proc_stat(current_core, &usr, &sys, &irq) != 0) {
 		irq = sys = usr = 0;
@@ -543,6 +546,8 @@ rpc_framework_get_scheduler(struct spdk_jsonrpc_request *request,
 	spdk_json_write_named_uint64(w, "scheduler_period", scheduler_period);
 	spdk_json_write_named_string(w, "isolated_core_mask", scheduler_get_isolated_core_mask());
 	spdk_json_write_named_uint32(w, "scheduling_core", scheduling_core);
+	spdk_json_write_named_uint64(w, "work_stealing_threshold",
+				     scheduler_get_work_stealing_threshold());
 	if (governor != NULL) {
 		spdk_json_write_named_string(w, "governor_name", governor->name);
 	}
@@ -616,11 +621,13 @@ SPDK_RPC_REGISTER("framework_get_governor", rpc_framework_get_governor, SPDK_RPC
 struct rpc_set_scheduler_opts_ctx {
 	char *isolated_core_mask;
 	uint32_t scheduling_core;
+	uint64_t work_stealing_threshold;
 };
 
 static const struct spdk_json_object_decoder rpc_set_scheduler_opts_decoders[] = {
 	{"isolated_core_mask", offsetof(struct rpc_set_scheduler_opts_ctx, isolated_core_mask), spdk_json_decode_string, true},
 	{"scheduling_core", offsetof(struct rpc_set_scheduler_opts_ctx, scheduling_core), spdk_json_decode_uint32, true},
+	{"work_stealing_threshold", offsetof(struct rpc_set_scheduler_opts_ctx, work_stealing_threshold), spdk_json_decode_uint64, true},
 };
 
 static void
@@ -637,6 +644,7 @@ rpc_scheduler_set_options(struct spdk_jsonrpc_request *request,
 	struct spdk_cpuset core_mask;
 
 	req.scheduling_core = spdk_scheduler_get_scheduling_lcore();
+	req.work_stealing_threshold = scheduler_get_work_stealing_threshold();
 
 	if (spdk_json_decode_object(params, rpc_set_scheduler_opts_decoders,
 				    SPDK_COUNTOF(rpc_set_scheduler_opts_decoders), &req)) {
@@ -665,6 +673,8 @@ rpc_scheduler_set_options(struct spdk_jsonrpc_request *request,
 		goto end;
 	}
 
+	scheduler_set_work_stealing_threshold(req.work_stealing_threshold);
+
 	spdk_jsonrpc_send_bool_response(request, true);
 end:
 	free_rpc_scheduler_set_options(&req);
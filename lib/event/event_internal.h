@@ -20,6 +20,8 @@ struct spdk_lw_thread {
 	uint32_t                        lcore;
 	uint32_t			initial_lcore;
 	bool				resched;
+	/* thread did work during its last poll */
+	bool				busy;
 	/* stats over a lifetime of a thread */
 	struct spdk_thread_stats	total_stats;
 	/* stats during the last scheduling period */
@@ -48,6 +50,22 @@ const char *scheduler_get_isolated_core_mask(void);
  */
 bool scheduler_set_isolated_core_mask(struct spdk_cpuset isolated_core_mask);
 
+/**
+ * Set work stealing threshold.
+ *
+ * A reactor that has been idle for this long asks a reactor on the same NUMA node,
+ * which has been running at least two busy threads for this long, to hand over one
+ * of them without waiting for the next scheduling period.
+ *
+ * \param threshold_us Threshold in microseconds, 0 disables work stealing.
+ */
+void scheduler_set_work_stealing_threshold(uint64_t threshold_us);
+
+/**
+ * Get work stealing threshold in microseconds.
+ */
+uint64_t scheduler_get_work_stealing_threshold(void);
+
 #ifdef __cplusplus
 }
 #endif
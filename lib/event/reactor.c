@@ -52,6 +52,8 @@ static uint64_t g_scheduler_period_in_us;
 static uint32_t g_scheduler_core_number;
 static struct spdk_scheduler_core_info *g_core_infos = NULL;
 static struct spdk_cpuset g_scheduler_isolated_core_mask;
+static uint64_t g_work_stealing_threshold_us;
+static uint64_t g_work_stealing_threshold_tsc;
 
 TAILQ_HEAD(, spdk_governor) g_governor_list
 	= TAILQ_HEAD_INITIALIZER(g_governor_list);
@@ -203,6 +205,19 @@ scheduler_is_isolated_core(uint32_t core)
 	return spdk_cpuset_get_cpu(&g_scheduler_isolated_core_mask, core);
 }
 
+void
+scheduler_set_work_stealing_threshold(uint64_t threshold_us)
+{
+	g_work_stealing_threshold_us = threshold_us;
+	g_work_stealing_threshold_tsc = threshold_us * spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
+}
+
+uint64_t
+scheduler_get_work_stealing_threshold(void)
+{
+	return g_work_stealing_threshold_us;
+}
+
 static void
 reactor_construct(struct spdk_reactor *reactor, uint32_t lcore)
 {
@@ -212,6 +227,8 @@ reactor_construct(struct spdk_reactor *reactor, uint32_t lcore)
 	TAILQ_INIT(&reactor->threads);
 	reactor->thread_count = 0;
 	spdk_cpuset_zero(&reactor->notify_cpuset);
+	reactor->numa_id = spdk_env_get_numa_id(lcore);
+	reactor->steal_lcore = SPDK_ENV_LCORE_ID_ANY;
 
 	reactor->events = spdk_ring_create(SPDK_RING_TYPE_MP_SC, 65536, SPDK_ENV_NUMA_ID_ANY);
 	if (reactor->events == NULL) {
@@ -949,6 +966,119 @@ reactor_post_process_lw_thread(struct spdk_reactor *reactor, struct spdk_lw_thre
 	return false;
 }
 
+/* Hand over one busy thread to the idle reactor that asked for it. */
+static void
+reactor_give_thread(struct spdk_reactor *reactor, uint32_t thief_lcore)
+{
+	struct spdk_reactor *thief = spdk_reactor_get(thief_lcore);
+	struct spdk_lw_thread *lw_thread, *victim = NULL;
+	struct spdk_thread *thread;
+	uint32_t busy_threads = 0;
+
+	if (thief == NULL || thief->in_interrupt || reactor->in_interrupt) {
+		return;
+	}
+
+	TAILQ_FOREACH(lw_thread, &reactor->threads, link) {
+		if (!lw_thread->busy) {
+			continue;
+		}
+		busy_threads++;
+
+		thread = spdk_thread_get_from_ctx(lw_thread);
+		if (lw_thread->resched || spdk_thread_is_bound(thread) ||
+		    spdk_thread_is_app_thread(thread) || !spdk_thread_is_running(thread) ||
+		    !spdk_cpuset_get_cpu(spdk_thread_get_cpumask(thread), thief_lcore)) {
+			continue;
+		}
+		victim = lw_thread;
+	}
+
+	/* Moving the only busy thread would just move the burst to the other core. */
+	if (victim == NULL || busy_threads < 2) {
+		return;
+	}
+
+	thread = spdk_thread_get_from_ctx(victim);
+	SPDK_DEBUGLOG(reactor, "Reactor %u gives thread %s to reactor %u\n",
+		      reactor->lcore, spdk_thread_get_name(thread), thief_lcore);
+
+	_reactor_remove_lw_thread(reactor, victim);
+	victim->lcore = thief_lcore;
+	_reactor_schedule_thread(thread);
+
+	reactor->stolen_count++;
+	__atomic_fetch_add(&thief->steal_count, 1, __ATOMIC_RELAXED);
+}
+
+/* Ask the most persistently overloaded reactor on the same NUMA node for a thread. */
+static void
+reactor_request_steal(struct spdk_reactor *reactor, uint64_t now)
+{
+	struct spdk_reactor *peer, *victim = NULL;
+	uint64_t unloaded_tsc, victim_unloaded_tsc = UINT64_MAX;
+	uint32_t i, expected;
+
+	SPDK_ENV_FOREACH_CORE(i) {
+		peer = spdk_reactor_get(i);
+		if (peer == NULL || peer == reactor || peer->numa_id != reactor->numa_id ||
+		    peer->in_interrupt || scheduler_is_isolated_core(i)) {
+			continue;
+		}
+
+		unloaded_tsc = __atomic_load_n(&peer->last_unloaded_tsc, __ATOMIC_RELAXED);
+		if (unloaded_tsc >= now || now - unloaded_tsc < g_work_stealing_threshold_tsc) {
+			continue;
+		}
+
+		if (unloaded_tsc < victim_unloaded_tsc) {
+			victim = peer;
+			victim_unloaded_tsc = unloaded_tsc;
+		}
+	}
+
+	if (victim == NULL) {
+		return;
+	}
+
+	expected = SPDK_ENV_LCORE_ID_ANY;
+	__atomic_compare_exchange_n(&victim->steal_lcore, &expected, reactor->lcore, false,
+				    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+static void
+reactor_work_steal(struct spdk_reactor *reactor, uint32_t busy_threads)
+{
+	uint64_t now = reactor->tsc_last;
+	uint32_t thief_lcore;
+
+	if (busy_threads > 0) {
+		__atomic_store_n(&reactor->last_busy_tsc, now, __ATOMIC_RELAXED);
+	}
+	if (busy_threads < 2) {
+		__atomic_store_n(&reactor->last_unloaded_tsc, now, __ATOMIC_RELAXED);
+	}
+
+	/* Threads must not move behind the back of the scheduler. */
+	if (g_scheduling_in_progress || scheduler_is_isolated_core(reactor->lcore)) {
+		return;
+	}
+
+	thief_lcore = __atomic_load_n(&reactor->steal_lcore, __ATOMIC_RELAXED);
+	if (spdk_unlikely(thief_lcore != SPDK_ENV_LCORE_ID_ANY)) {
+		__atomic_store_n(&reactor->steal_lcore, SPDK_ENV_LCORE_ID_ANY, __ATOMIC_RELAXED);
+		reactor_give_thread(reactor, thief_lcore);
+		return;
+	}
+
+	if (busy_threads == 0 &&
+	    now - reactor->last_busy_tsc >= g_work_stealing_threshold_tsc &&
+	    now - reactor->last_steal_tsc >= g_work_stealing_threshold_tsc) {
+		reactor->last_steal_tsc = now;
+		reactor_request_steal(reactor, now);
+	}
+}
+
 static void
 reactor_interrupt_run(struct spdk_reactor *reactor)
 {
@@ -963,6 +1093,7 @@ _reactor_run(struct spdk_reactor *reactor)
 	struct spdk_thread	*thread;
 	struct spdk_lw_thread	*lw_thread, *tmp;
 	uint64_t		now;
+	uint32_t		busy_threads = 0;
 	int			rc;
 
 	event_queue_run_batch(reactor);
@@ -974,6 +1105,9 @@ _reactor_run(struct spdk_reactor *reactor)
 		now = spdk_get_ticks();
 		reactor->idle_tsc += now - reactor->tsc_last;
 		reactor->tsc_last = now;
+		if (spdk_unlikely(g_work_stealing_threshold_tsc != 0)) {
+			reactor_work_steal(reactor, 0);
+		}
 		return;
 	}
 
@@ -986,11 +1120,17 @@ _reactor_run(struct spdk_reactor *reactor)
 			reactor->idle_tsc += now - reactor->tsc_last;
 		} else if (rc > 0) {
 			reactor->busy_tsc += now - reactor->tsc_last;
+			busy_threads++;
 		}
 		reactor->tsc_last = now;
+		lw_thread->busy = rc > 0;
 
 		reactor_post_process_lw_thread(reactor, lw_thread);
 	}
+
+	if (spdk_unlikely(g_work_stealing_threshold_tsc != 0)) {
+		reactor_work_steal(reactor, busy_threads);
+	}
 }
 
 static int
@@ -27,7 +27,7 @@
  *    {                                       <<== *subsystems_it array entry pointer (iterator)
  *      "subsystem": "<< SUBSYSTEM NAME >>",
  *      "config": [                           <<== *config JSON array
- *         {                                  <<== *config_it array entry pointer (iterator)
+ *         {                                  <<== *entries[] array entry
  *           "method": "<< METHOD NAME >>",   <<== *method
  *           "params": { << PARAMS >> }       <<== *params
  *         },
@@ -42,10 +42,6 @@
  *
  */
 
-struct load_json_config_ctx;
-typedef void (*client_resp_handler)(struct load_json_config_ctx *,
-				    struct spdk_jsonrpc_client_response *);
-
 #define RPC_SOCKET_PATH_MAX SPDK_SIZEOF_MEMBER(struct sockaddr_un, sun_path)
 
 /* 1s connections timeout */
@@ -57,6 +53,66 @@ typedef void (*client_resp_handler)(struct load_json_config_ctx *,
  * So just print WARNLOG every 10s. */
 #define RPC_CLIENT_REQUEST_TIMEOUT_US (10U * 1000 * 1000)
 
+/*
+ * Each RPC client connection carries a single request at a time, so this is the
+ * maximum number of independent "config" entries being executed concurrently.
+ */
+#define RPC_CLIENT_MAX_CONNS 16
+
+/*
+ * How far past the first unfinished "config" entry we look for entries that
+ * don't depend on any of the ones before them.
+ */
+#define CONFIG_ENTRY_LOOKAHEAD 64
+
+struct config_entry {
+	char *method;
+	struct spdk_json_val *params;
+};
+
+enum load_json_config_entry_state {
+	CONFIG_ENTRY_NEW,
+	CONFIG_ENTRY_READY,
+	CONFIG_ENTRY_SENT,
+	CONFIG_ENTRY_DONE,
+};
+
+struct load_json_config_entry {
+	struct spdk_json_val *val;
+	struct config_entry cfg;
+	enum load_json_config_entry_state state;
+
+	/* Error to fail the configuration with once this entry is reached. */
+	int rc;
+
+	/*
+	 * Concurrency key of the method and its value in "params". Entries without
+	 * a key value have to be executed alone, after all the preceding entries.
+	 */
+	const char *key;
+	struct spdk_json_val *key_val;
+
+	uint64_t start_tsc;
+};
+
+struct load_json_config_client {
+	struct spdk_jsonrpc_client *conn;
+	bool connected;
+
+	/* Entry being executed on this connection. */
+	struct load_json_config_entry *entry;
+
+	/* Timeout for current RPC client action. */
+	uint64_t timeout;
+};
+
+struct load_json_config_method_stats {
+	char *method;
+	uint32_t count;
+	uint64_t total_tsc;
+	uint64_t max_tsc;
+};
+
 struct load_json_config_ctx {
 	/* Thread used during configuration. */
 	struct spdk_thread *thread;
@@ -71,12 +127,21 @@ struct load_json_config_ctx {
 	struct spdk_json_val *subsystem_name; /* current subsystem name */
 	char subsystem_name_str[128];
 
-	/* Current "config" entry we are processing */
-	struct spdk_json_val *config; /* "config" array */
-	struct spdk_json_val *config_it; /* current config position in "config" array */
+	/* "config" array of the current subsystem */
+	struct spdk_json_val *config;
+
+	/* "config" entries of the current subsystem */
+	struct load_json_config_entry *entries;
+	size_t entries_cnt;
+	/* First entry that has not completed yet. */
+	size_t entries_done;
 
-	/* Current request id we are sending. */
-	uint32_t rpc_request_id;
+	/* Number of requests being executed and whether one of them is an entry without key. */
+	uint32_t inflight;
+	bool barrier_inflight;
+
+	/* Error to finish with once all requests being executed complete. */
+	int rc;
 
 	/* Whole configuration file read and parsed. */
 	size_t json_data_size;
@@ -87,48 +152,96 @@ struct load_json_config_ctx {
 
 	char rpc_socket_path_temp[RPC_SOCKET_PATH_MAX + 1];
 
-	struct spdk_jsonrpc_client *client_conn;
+	struct load_json_config_client clients[RPC_CLIENT_MAX_CONNS];
 	struct spdk_poller *client_conn_poller;
 
-	client_resp_handler client_resp_cb;
-
-	/* Timeout for current RPC client action. */
+	/* Timeout for establishing client connections. */
 	uint64_t timeout;
 
+	/* Per-method execution time of the current subsystem. */
+	struct load_json_config_method_stats *stats;
+	size_t stats_cnt;
+
+	uint64_t start_tsc;
+	uint64_t subsystem_start_tsc;
+	uint32_t rpc_count;
+	uint32_t max_inflight;
+
 	/* Signals that the code should follow deprecated path of execution. */
 	bool initalize_subsystems;
 };
 
 static void app_json_config_load_subsystem(void *_ctx);
 
+static double
+ticks_to_ms(uint64_t ticks)
+{
+	return (double)ticks * 1000 / spdk_get_ticks_hz();
+}
+
+static void
+app_json_config_free_entries(struct load_json_config_ctx *ctx)
+{
+	size_t i;
+
+	for (i = 0; i < ctx->entries_cnt; i++) {
+		free(ctx->entries[i].cfg.method);
+	}
+
+	free(ctx->entries);
+	ctx->entries = NULL;
+	ctx->entries_cnt = 0;
+	ctx->entries_done = 0;
+
+	for (i = 0; i < ctx->stats_cnt; i++) {
+		free(ctx->stats[i].method);
+	}
+
+	free(ctx->stats);
+	ctx->stats = NULL;
+	ctx->stats_cnt = 0;
+}
+
 static void
 app_json_config_load_done(struct load_json_config_ctx *ctx, int rc)
 {
+	size_t i;
+
 	spdk_poller_unregister(&ctx->client_conn_poller);
-	if (ctx->client_conn != NULL) {
-		spdk_jsonrpc_client_close(ctx->client_conn);
+	for (i = 0; i < SPDK_COUNTOF(ctx->clients); i++) {
+		if (ctx->clients[i].conn != NULL) {
+			spdk_jsonrpc_client_close(ctx->clients[i].conn);
+		}
 	}
 
 	spdk_rpc_server_finish(ctx->rpc_socket_path_temp);
 
+	if (rc == 0 && ctx->rpc_count > 0) {
+		SPDK_NOTICELOG("JSON configuration loaded in %.3f ms (%" PRIu32 " RPCs, "
+			       "up to %" PRIu32 " concurrently)\n",
+			       ticks_to_ms(spdk_get_ticks() - ctx->start_tsc), ctx->rpc_count,
+			       ctx->max_inflight);
+	}
+
 	SPDK_DEBUG_APP_CFG("Config load finished with rc %d\n", rc);
 	ctx->cb_fn(rc, ctx->cb_arg);
 
+	app_json_config_free_entries(ctx);
 	free(ctx->json_data);
 	free(ctx->values);
 	free(ctx);
 }
 
-static void
-rpc_client_set_timeout(struct load_json_config_ctx *ctx, uint64_t timeout_us)
+static uint64_t
+rpc_client_get_timeout(uint64_t timeout_us)
 {
-	ctx->timeout = spdk_get_ticks() + timeout_us * spdk_get_ticks_hz() / (1000 * 1000);
+	return spdk_get_ticks() + timeout_us * spdk_get_ticks_hz() / (1000 * 1000);
 }
 
 static int
-rpc_client_check_timeout(struct load_json_config_ctx *ctx)
+rpc_client_check_timeout(uint64_t timeout)
 {
-	if (ctx->timeout < spdk_get_ticks()) {
+	if (timeout < spdk_get_ticks()) {
 		SPDK_WARNLOG("RPC client command timeout.\n");
 		return -ETIMEDOUT;
 	}
@@ -155,35 +268,79 @@ json_write_stdout(void *cb_ctx, const void *data, size_t size)
 	return rc == size ? 0 : -1;
 }
 
-static int
-rpc_client_poller(void *arg)
+static void
+app_json_config_update_stats(struct load_json_config_ctx *ctx, const char *method, uint64_t tsc)
 {
-	struct load_json_config_ctx *ctx = arg;
-	struct spdk_jsonrpc_client_response *resp;
-	client_resp_handler cb;
-	int rc;
+	struct load_json_config_method_stats *stats, *tmp;
+	size_t i;
 
-	assert(spdk_get_thread() == ctx->thread);
+	for (i = 0; i < ctx->stats_cnt; i++) {
+		if (strcmp(ctx->stats[i].method, method) == 0) {
+			break;
+		}
+	}
 
-	rc = spdk_jsonrpc_client_poll(ctx->client_conn, 0);
-	if (rc == 0) {
-		rc = rpc_client_check_timeout(ctx);
-		if (rc == -ETIMEDOUT) {
-			rpc_client_set_timeout(ctx, RPC_CLIENT_REQUEST_TIMEOUT_US);
-			rc = 0;
+	if (i == ctx->stats_cnt) {
+		tmp = realloc(ctx->stats, (ctx->stats_cnt + 1) * sizeof(*tmp));
+		if (tmp == NULL) {
+			return;
 		}
+
+		ctx->stats = tmp;
+		stats = &ctx->stats[ctx->stats_cnt];
+		memset(stats, 0, sizeof(*stats));
+		stats->method = strdup(method);
+		if (stats->method == NULL) {
+			return;
+		}
+
+		ctx->stats_cnt++;
 	}
 
-	if (rc == 0) {
-		/* No response yet */
-		return SPDK_POLLER_BUSY;
-	} else if (rc < 0) {
-		app_json_config_load_done(ctx, rc);
-		return SPDK_POLLER_BUSY;
+	stats = &ctx->stats[i];
+	stats->count++;
+	stats->total_tsc += tsc;
+	stats->max_tsc = spdk_max(stats->max_tsc, tsc);
+}
+
+static void
+app_json_config_print_stats(struct load_json_config_ctx *ctx)
+{
+	struct load_json_config_method_stats *stats;
+	size_t i;
+
+	if (ctx->stats_cnt == 0) {
+		return;
+	}
+
+	SPDK_INFOLOG(app_config, "Subsystem '%s' configured in %.3f ms\n", ctx->subsystem_name_str,
+		     ticks_to_ms(spdk_get_ticks() - ctx->subsystem_start_tsc));
+
+	for (i = 0; i < ctx->stats_cnt; i++) {
+		stats = &ctx->stats[i];
+		SPDK_INFOLOG(app_config, "\t%s: %" PRIu32 " calls, total %.3f ms, max %.3f ms\n",
+			     stats->method, stats->count, ticks_to_ms(stats->total_tsc),
+			     ticks_to_ms(stats->max_tsc));
 	}
+}
 
-	resp = spdk_jsonrpc_client_get_response(ctx->client_conn);
-	assert(resp);
+static void
+rpc_client_complete_entry(struct load_json_config_ctx *ctx, struct load_json_config_client *client,
+			  struct spdk_jsonrpc_client_response *resp)
+{
+	struct load_json_config_entry *entry = client->entry;
+
+	assert(entry != NULL);
+	assert(ctx->inflight > 0);
+
+	client->entry = NULL;
+	ctx->inflight--;
+	if (entry->key_val == NULL) {
+		ctx->barrier_inflight = false;
+	}
+
+	entry->state = CONFIG_ENTRY_DONE;
+	app_json_config_update_stats(ctx, entry->cfg.method, spdk_get_ticks() - entry->start_tsc);
 
 	if (resp->error) {
 		struct json_write_buf buf = {};
@@ -197,21 +354,62 @@ rpc_client_poller(void *arg)
 			spdk_json_write_end(w);
 			SPDK_ERRLOG("error response: \n%s\n", buf.data);
 		}
+
+		if (ctx->stop_on_error && ctx->rc == 0) {
+			/* Don't issue anything else, but let the requests already being
+			 * executed finish before tearing down the RPC server. */
+			ctx->rc = -EINVAL;
+		}
 	}
 
-	if (resp->error && ctx->stop_on_error) {
-		spdk_jsonrpc_client_free_response(resp);
-		app_json_config_load_done(ctx, -EINVAL);
-	} else {
-		/* We have response so we must have callback for it. */
-		cb = ctx->client_resp_cb;
-		assert(cb != NULL);
+	spdk_jsonrpc_client_free_response(resp);
+}
+
+static void app_json_config_load_subsystem_config_entry(void *_ctx);
+
+static int
+rpc_client_poller(void *arg)
+{
+	struct load_json_config_ctx *ctx = arg;
+	struct load_json_config_client *client;
+	struct spdk_jsonrpc_client_response *resp;
+	bool completed = false;
+	size_t i;
+	int rc;
+
+	assert(spdk_get_thread() == ctx->thread);
+
+	for (i = 0; i < SPDK_COUNTOF(ctx->clients); i++) {
+		client = &ctx->clients[i];
+		if (client->entry == NULL) {
+			continue;
+		}
 
-		/* Mark we are done with this handler. */
-		ctx->client_resp_cb = NULL;
-		cb(ctx, resp);
+		rc = spdk_jsonrpc_client_poll(client->conn, 0);
+		if (rc == 0) {
+			/* No response yet */
+			if (rpc_client_check_timeout(client->timeout) == -ETIMEDOUT) {
+				SPDK_WARNLOG("Still waiting for method '%s'\n",
+					     client->entry->cfg.method);
+				client->timeout =
+					rpc_client_get_timeout(RPC_CLIENT_REQUEST_TIMEOUT_US);
+			}
+			continue;
+		} else if (rc < 0) {
+			app_json_config_load_done(ctx, rc);
+			return SPDK_POLLER_BUSY;
+		}
+
+		resp = spdk_jsonrpc_client_get_response(client->conn);
+		assert(resp);
+
+		rpc_client_complete_entry(ctx, client, resp);
+		completed = true;
 	}
 
+	if (completed) {
+		app_json_config_load_subsystem_config_entry(ctx);
+	}
 
 	return SPDK_POLLER_BUSY;
 }
@@ -220,16 +418,32 @@ static int
 rpc_client_connect_poller(void *_ctx)
 {
 	struct load_json_config_ctx *ctx = _ctx;
+	struct load_json_config_client *client;
+	bool connected = true;
+	size_t i;
 	int rc;
 
-	rc = spdk_jsonrpc_client_poll(ctx->client_conn, 0);
-	if (rc != -ENOTCONN) {
-		/* We are connected. Start regular poller and issue first request */
+	for (i = 0; i < SPDK_COUNTOF(ctx->clients); i++) {
+		client = &ctx->clients[i];
+		if (client->connected) {
+			continue;
+		}
+
+		rc = spdk_jsonrpc_client_poll(client->conn, 0);
+		if (rc != -ENOTCONN) {
+			client->connected = true;
+		} else {
+			connected = false;
+		}
+	}
+
+	if (connected) {
+		/* We are connected. Start regular poller and issue first requests */
 		spdk_poller_unregister(&ctx->client_conn_poller);
 		ctx->client_conn_poller = SPDK_POLLER_REGISTER(rpc_client_poller, ctx, 100);
 		app_json_config_load_subsystem(ctx);
 	} else {
-		rc = rpc_client_check_timeout(ctx);
+		rc = rpc_client_check_timeout(ctx->timeout);
 		if (rc) {
 			app_json_config_load_done(ctx, rc);
 		}
@@ -241,22 +455,44 @@ rpc_client_connect_poller(void *_ctx)
 }
 
 static int
-client_send_request(struct load_json_config_ctx *ctx, struct spdk_jsonrpc_client_request *request,
-		    client_resp_handler client_resp_cb)
+client_send_request(struct load_json_config_ctx *ctx, struct load_json_config_entry *entry,
+		    struct spdk_jsonrpc_client_request *request)
 {
+	struct load_json_config_client *client = NULL;
+	size_t i;
 	int rc;
 
 	assert(spdk_get_thread() == ctx->thread);
 
-	ctx->client_resp_cb = client_resp_cb;
-	rpc_client_set_timeout(ctx, RPC_CLIENT_REQUEST_TIMEOUT_US);
-	rc = spdk_jsonrpc_client_send_request(ctx->client_conn, request);
+	for (i = 0; i < SPDK_COUNTOF(ctx->clients); i++) {
+		if (ctx->clients[i].entry == NULL) {
+			client = &ctx->clients[i];
+			break;
+		}
+	}
+
+	assert(client != NULL);
 
+	rc = spdk_jsonrpc_client_send_request(client->conn, request);
 	if (rc) {
 		SPDK_DEBUG_APP_CFG("Sending request to client failed (%d)\n", rc);
+		return rc;
 	}
 
-	return rc;
+	client->entry = entry;
+	client->timeout = rpc_client_get_timeout(RPC_CLIENT_REQUEST_TIMEOUT_US);
+
+	entry->state = CONFIG_ENTRY_SENT;
+	entry->start_tsc = spdk_get_ticks();
+
+	ctx->inflight++;
+	ctx->max_inflight = spdk_max(ctx->max_inflight, ctx->inflight);
+	ctx->rpc_count++;
+	if (entry->key_val == NULL) {
+		ctx->barrier_inflight = true;
+	}
+
+	return 0;
 }
 
 static int
@@ -299,64 +535,34 @@ cap_array_or_null(const struct spdk_json_val *val, void *out)
 	return 0;
 }
 
-struct config_entry {
-	char *method;
-	struct spdk_json_val *params;
-};
-
 static struct spdk_json_object_decoder jsonrpc_cmd_decoders[] = {
 	{"method", offsetof(struct config_entry, method), spdk_json_decode_string},
 	{"params", offsetof(struct config_entry, params), cap_object, true}
 };
 
-static void app_json_config_load_subsystem_config_entry(void *_ctx);
-
-static void
-app_json_config_load_subsystem_config_entry_next(struct load_json_config_ctx *ctx,
-		struct spdk_jsonrpc_client_response *resp)
-{
-	/* Don't care about the response */
-	spdk_jsonrpc_client_free_response(resp);
-
-	ctx->config_it = spdk_json_next(ctx->config_it);
-	app_json_config_load_subsystem_config_entry(ctx);
-}
-
-/* Load "config" entry */
+/* Decode "config" entry and decide whether, and how, it is going to be executed */
 static void
-app_json_config_load_subsystem_config_entry(void *_ctx)
+app_json_config_check_entry(struct load_json_config_ctx *ctx, struct load_json_config_entry *entry)
 {
-	struct load_json_config_ctx *ctx = _ctx;
-	struct spdk_jsonrpc_client_request *rpc_request;
-	struct spdk_json_write_ctx *w;
-	struct config_entry cfg = {};
-	struct spdk_json_val *params_end;
-	size_t params_len = 0;
+	struct config_entry *cfg = &entry->cfg;
 	uint32_t state_mask = 0, cur_state_mask, startup_runtime = SPDK_RPC_STARTUP | SPDK_RPC_RUNTIME;
+	const char *key = NULL;
 	int rc;
 
-	if (ctx->config_it == NULL) {
-		SPDK_DEBUG_APP_CFG("Subsystem '%.*s': configuration done.\n", ctx->subsystem_name->len,
-				   (char *)ctx->subsystem_name->start);
-		ctx->subsystems_it = spdk_json_next(ctx->subsystems_it);
-		/* Invoke later to avoid recursion */
-		spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem, ctx);
-		return;
-	}
+	assert(entry->state == CONFIG_ENTRY_NEW);
+	entry->state = CONFIG_ENTRY_READY;
 
-	if (spdk_json_decode_object(ctx->config_it, jsonrpc_cmd_decoders,
-				    SPDK_COUNTOF(jsonrpc_cmd_decoders), &cfg)) {
+	if (spdk_json_decode_object(entry->val, jsonrpc_cmd_decoders,
+				    SPDK_COUNTOF(jsonrpc_cmd_decoders), cfg)) {
 		SPDK_ERRLOG("Failed to decode config entry\n");
-		app_json_config_load_done(ctx, -EINVAL);
-		goto out;
+		entry->rc = -EINVAL;
+		return;
 	}
 
-	rc = spdk_rpc_get_method_state_mask(cfg.method, &state_mask);
+	rc = spdk_rpc_get_method_state_mask(cfg->method, &state_mask);
 	if (rc == -ENOENT) {
 		if (!ctx->stop_on_error) {
-			/* Invoke later to avoid recursion */
-			ctx->config_it = spdk_json_next(ctx->config_it);
-			spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem_config_entry, ctx);
+			entry->state = CONFIG_ENTRY_DONE;
 		} else if (!spdk_subsystem_exists(ctx->subsystem_name_str)) {
 			/* If the subsystem does not exist, just skip it, even
 			 * if we are supposed to stop_on_error. Users may generate
@@ -370,77 +576,215 @@ app_json_config_load_subsystem_config_entry(void *_ctx)
 			 */
 			SPDK_NOTICELOG("Skipping method '%s' because its subsystem '%s' "
 				       "is not linked into this application.\n",
-				       cfg.method, ctx->subsystem_name_str);
-			/* Invoke later to avoid recursion */
-			ctx->config_it = spdk_json_next(ctx->config_it);
-			spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem_config_entry, ctx);
+				       cfg->method, ctx->subsystem_name_str);
+			entry->state = CONFIG_ENTRY_DONE;
 		} else {
-			SPDK_ERRLOG("Method '%s' was not found\n", cfg.method);
-			app_json_config_load_done(ctx, rc);
+			SPDK_ERRLOG("Method '%s' was not found\n", cfg->method);
+			entry->rc = rc;
 		}
-		goto out;
+		return;
 	}
 	cur_state_mask = spdk_rpc_get_state();
 	if ((state_mask & cur_state_mask) != cur_state_mask) {
-		SPDK_DEBUG_APP_CFG("Method '%s' not allowed -> skipping\n", cfg.method);
-		/* Invoke later to avoid recursion */
-		ctx->config_it = spdk_json_next(ctx->config_it);
-		spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem_config_entry, ctx);
-		goto out;
+		SPDK_DEBUG_APP_CFG("Method '%s' not allowed -> skipping\n", cfg->method);
+		entry->state = CONFIG_ENTRY_DONE;
+		return;
 	}
 	if ((state_mask & startup_runtime) == startup_runtime && cur_state_mask == SPDK_RPC_RUNTIME) {
 		/* Some methods are allowed to be run in both STARTUP and RUNTIME states.
 		 * We should not call such methods twice, so ignore the second attempt in RUNTIME state */
-		SPDK_DEBUG_APP_CFG("Method '%s' has already been run in STARTUP state\n", cfg.method);
-		/* Invoke later to avoid recursion */
-		ctx->config_it = spdk_json_next(ctx->config_it);
-		spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem_config_entry, ctx);
-		goto out;
+		SPDK_DEBUG_APP_CFG("Method '%s' has already been run in STARTUP state\n",
+				   cfg->method);
+		entry->state = CONFIG_ENTRY_DONE;
+		return;
+	}
+
+	spdk_rpc_get_method_concurrency_key(cfg->method, &key);
+	if (key != NULL && cfg->params != NULL &&
+	    spdk_json_find_string(cfg->params, key, NULL, &entry->key_val) == 0) {
+		entry->key = key;
+	} else {
+		entry->key_val = NULL;
 	}
+}
+
+/*
+ * Check whether "config" entry at idx may be executed before all of the unfinished
+ * entries preceding it. This is only the case if all of them are calls to methods
+ * with the same concurrency key, with a different key value.
+ */
+static bool
+app_json_config_entry_depends(struct load_json_config_ctx *ctx, size_t idx)
+{
+	struct load_json_config_entry *entry = &ctx->entries[idx], *prev;
+	size_t i;
+
+	assert(entry->key_val != NULL);
+
+	for (i = ctx->entries_done; i < idx; i++) {
+		prev = &ctx->entries[i];
+		if (prev->state == CONFIG_ENTRY_DONE) {
+			continue;
+		}
 
-	SPDK_DEBUG_APP_CFG("\tmethod: %s\n", cfg.method);
+		assert(prev->key_val != NULL);
+		if (strcmp(prev->key, entry->key) != 0) {
+			return true;
+		}
 
-	if (cfg.params) {
+		if (prev->key_val->len == entry->key_val->len &&
+		    memcmp(prev->key_val->start, entry->key_val->start, entry->key_val->len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int
+app_json_config_send_entry(struct load_json_config_ctx *ctx, struct load_json_config_entry *entry)
+{
+	struct spdk_jsonrpc_client_request *rpc_request;
+	struct spdk_json_write_ctx *w;
+	struct config_entry *cfg = &entry->cfg;
+	struct spdk_json_val *params_end;
+	size_t params_len = 0;
+	int rc;
+
+	SPDK_DEBUG_APP_CFG("\tmethod: %s\n", cfg->method);
+
+	if (cfg->params) {
 		/* Get _END by skipping params and going back by one element. */
-		params_end = cfg.params + spdk_json_val_len(cfg.params) - 1;
+		params_end = cfg->params + spdk_json_val_len(cfg->params) - 1;
 
 		/* Need to add one character to include '}' */
-		params_len = params_end->start - cfg.params->start + 1;
+		params_len = params_end->start - cfg->params->start + 1;
 
-		SPDK_DEBUG_APP_CFG("\tparams: %.*s\n", (int)params_len, (char *)cfg.params->start);
+		SPDK_DEBUG_APP_CFG("\tparams: %.*s\n", (int)params_len, (char *)cfg->params->start);
 	}
 
 	rpc_request = spdk_jsonrpc_client_create_request();
 	if (!rpc_request) {
-		app_json_config_load_done(ctx, -errno);
-		goto out;
+		return -errno;
 	}
 
-	w = spdk_jsonrpc_begin_request(rpc_request, ctx->rpc_request_id, NULL);
+	w = spdk_jsonrpc_begin_request(rpc_request, entry - ctx->entries, NULL);
 	if (!w) {
 		spdk_jsonrpc_client_free_request(rpc_request);
-		app_json_config_load_done(ctx, -ENOMEM);
-		goto out;
+		return -ENOMEM;
 	}
 
-	spdk_json_write_named_string(w, "method", cfg.method);
+	spdk_json_write_named_string(w, "method", cfg->method);
 
-	if (cfg.params) {
+	if (cfg->params) {
 		/* No need to parse "params". Just dump the whole content of "params"
 		 * directly into the request and let the remote side verify it. */
 		spdk_json_write_name(w, "params");
-		spdk_json_write_val_raw(w, cfg.params->start, params_len);
+		spdk_json_write_val_raw(w, cfg->params->start, params_len);
 	}
 
 	spdk_jsonrpc_end_request(rpc_request, w);
 
-	rc = client_send_request(ctx, rpc_request, app_json_config_load_subsystem_config_entry_next);
+	rc = client_send_request(ctx, entry, rpc_request);
 	if (rc != 0) {
-		app_json_config_load_done(ctx, -rc);
-		goto out;
+		spdk_jsonrpc_client_free_request(rpc_request);
+	}
+
+	return rc;
+}
+
+/*
+ * Issue as many of the current subsystem "config" entries as possible. Entries
+ * are walked in order, starting from the first one that has not completed. An
+ * entry without a concurrency key is only sent once everything before it has
+ * completed, and nothing after it is sent until it completes. Entries with a
+ * key are sent as soon as they don't depend on any unfinished entry before them.
+ */
+static void
+app_json_config_load_subsystem_config_entry(void *_ctx)
+{
+	struct load_json_config_ctx *ctx = _ctx;
+	struct load_json_config_entry *entry;
+	bool pending = false;
+	size_t i, end;
+	int rc;
+
+	while (ctx->entries_done < ctx->entries_cnt &&
+	       ctx->entries[ctx->entries_done].state == CONFIG_ENTRY_DONE) {
+		ctx->entries_done++;
+	}
+
+	if (ctx->rc != 0) {
+		if (ctx->inflight == 0) {
+			app_json_config_load_done(ctx, ctx->rc);
+		}
+		return;
+	}
+
+	if (ctx->entries_done == ctx->entries_cnt) {
+		assert(ctx->inflight == 0);
+		SPDK_DEBUG_APP_CFG("Subsystem '%.*s': configuration done.\n", ctx->subsystem_name->len,
+				   (char *)ctx->subsystem_name->start);
+		app_json_config_print_stats(ctx);
+		app_json_config_free_entries(ctx);
+		ctx->subsystems_it = spdk_json_next(ctx->subsystems_it);
+		/* Invoke later to avoid recursion */
+		spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem, ctx);
+		return;
+	}
+
+	if (ctx->barrier_inflight) {
+		return;
+	}
+
+	end = spdk_min(ctx->entries_cnt, ctx->entries_done + CONFIG_ENTRY_LOOKAHEAD);
+	for (i = ctx->entries_done; i < end && ctx->inflight < RPC_CLIENT_MAX_CONNS; i++) {
+		entry = &ctx->entries[i];
+		if (entry->state == CONFIG_ENTRY_NEW) {
+			app_json_config_check_entry(ctx, entry);
+		}
+
+		if (entry->state == CONFIG_ENTRY_DONE) {
+			continue;
+		} else if (entry->state == CONFIG_ENTRY_SENT) {
+			pending = true;
+			continue;
+		}
+
+		if (entry->key_val == NULL) {
+			if (pending) {
+				break;
+			}
+
+			assert(ctx->inflight == 0);
+			if (entry->rc != 0) {
+				app_json_config_load_done(ctx, entry->rc);
+				return;
+			}
+
+			rc = app_json_config_send_entry(ctx, entry);
+			if (rc != 0) {
+				app_json_config_load_done(ctx, rc);
+				return;
+			}
+			break;
+		}
+
+		if (!app_json_config_entry_depends(ctx, i)) {
+			rc = app_json_config_send_entry(ctx, entry);
+			if (rc != 0) {
+				ctx->rc = rc;
+				break;
+			}
+		}
+
+		pending = true;
+	}
+
+	if (ctx->inflight == 0) {
+		/* Everything we looked at was skipped. Invoke later to avoid recursion */
+		spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem_config_entry, ctx);
 	}
-out:
-	free(cfg.method);
 }
 
 static void
@@ -470,6 +814,33 @@ static struct spdk_json_object_decoder subsystem_decoders[] = {
 	{"config", offsetof(struct load_json_config_ctx, config), cap_array_or_null}
 };
 
+static int
+app_json_config_alloc_entries(struct load_json_config_ctx *ctx)
+{
+	struct spdk_json_val *it;
+	size_t cnt = 0;
+
+	for (it = spdk_json_array_first(ctx->config); it != NULL; it = spdk_json_next(it)) {
+		cnt++;
+	}
+
+	if (cnt == 0) {
+		return 0;
+	}
+
+	ctx->entries = calloc(cnt, sizeof(*ctx->entries));
+	if (ctx->entries == NULL) {
+		SPDK_ERRLOG("Out of memory\n");
+		return -ENOMEM;
+	}
+
+	for (it = spdk_json_array_first(ctx->config); it != NULL; it = spdk_json_next(it)) {
+		ctx->entries[ctx->entries_cnt++].val = it;
+	}
+
+	return 0;
+}
+
 /*
  * Start loading subsystem pointed by ctx->subsystems_it. This must point to the
  * beginning of the "subsystem" object in "subsystems" array or be NULL. If it is
@@ -494,6 +865,7 @@ static void
 app_json_config_load_subsystem(void *_ctx)
 {
 	struct load_json_config_ctx *ctx = _ctx;
+	int rc;
 
 	if (ctx->subsystems_it == NULL) {
 		if (ctx->initalize_subsystems && spdk_rpc_get_state() == SPDK_RPC_STARTUP) {
@@ -520,8 +892,13 @@ app_json_config_load_subsystem(void *_ctx)
 
 	SPDK_DEBUG_APP_CFG("Loading subsystem '%s' configuration\n", ctx->subsystem_name_str);
 
-	/* Get 'config' array first configuration entry */
-	ctx->config_it = spdk_json_array_first(ctx->config);
+	rc = app_json_config_alloc_entries(ctx);
+	if (rc) {
+		app_json_config_load_done(ctx, rc);
+		return;
+	}
+
+	ctx->subsystem_start_tsc = spdk_get_ticks();
 	app_json_config_load_subsystem_config_entry(ctx);
 }
 
@@ -576,6 +953,8 @@ json_config_prepare_ctx(spdk_subsystem_init_fn cb_fn, void *cb_arg, bool stop_on
 			ssize_t json_size, bool initalize_subsystems)
 {
 	struct load_json_config_ctx *ctx = calloc(1, sizeof(*ctx));
+	struct load_json_config_client *client;
+	size_t i;
 	int rc;
 
 	if (!ctx) {
@@ -588,6 +967,7 @@ json_config_prepare_ctx(spdk_subsystem_init_fn cb_fn, void *cb_arg, bool stop_on
 	ctx->stop_on_error = stop_on_error;
 	ctx->thread = spdk_get_thread();
 	ctx->initalize_subsystems = initalize_subsystems;
+	ctx->start_tsc = spdk_get_ticks();
 
 	rc = parse_json(json, json_size, ctx);
 	if (rc < 0) {
@@ -631,13 +1011,16 @@ json_config_prepare_ctx(spdk_subsystem_init_fn cb_fn, void *cb_arg, bool stop_on
 		goto fail;
 	}
 
-	ctx->client_conn = spdk_jsonrpc_client_connect(ctx->rpc_socket_path_temp, AF_UNIX);
-	if (ctx->client_conn == NULL) {
-		SPDK_ERRLOG("Failed to connect to '%s'\n", ctx->rpc_socket_path_temp);
-		goto fail;
+	for (i = 0; i < SPDK_COUNTOF(ctx->clients); i++) {
+		client = &ctx->clients[i];
+		client->conn = spdk_jsonrpc_client_connect(ctx->rpc_socket_path_temp, AF_UNIX);
+		if (client->conn == NULL) {
+			SPDK_ERRLOG("Failed to connect to '%s'\n", ctx->rpc_socket_path_temp);
+			goto fail;
+		}
 	}
 
-	rpc_client_set_timeout(ctx, RPC_CLIENT_CONNECT_TIMEOUT_US);
+	ctx->timeout = rpc_client_get_timeout(RPC_CLIENT_CONNECT_TIMEOUT_US);
 	ctx->client_conn_poller = SPDK_POLLER_REGISTER(rpc_client_connect_poller, ctx, 100);
 	return;
 
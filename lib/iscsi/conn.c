@@ -218,6 +218,7 @@ iscsi_conn_construct(struct spdk_iscsi_portal *portal,
 
 	TAILQ_INIT(&conn->write_pdu_list);
 	TAILQ_INIT(&conn->snack_pdu_list);
+	STAILQ_INIT(&conn->send_pdu_list);
 	TAILQ_INIT(&conn->queued_r2t_tasks);
 	TAILQ_INIT(&conn->active_r2t_tasks);
 	TAILQ_INIT(&conn->queued_datain_tasks);
@@ -289,12 +290,49 @@ iscsi_conn_free_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu)
 	cb_fn(cb_arg);
 }
 
+static void
+iscsi_conn_put_pdu_in_progress(struct spdk_iscsi_conn *conn)
+{
+	struct spdk_iscsi_pdu *pdu = conn->pdu_in_progress;
+	struct spdk_iscsi_task *task;
+	int opcode;
+
+	if (pdu == NULL) {
+		return;
+	}
+
+	/* remove the task left in the PDU too. */
+	task = pdu->task;
+	if (task) {
+		opcode = pdu->bhs.opcode;
+		switch (opcode) {
+		case ISCSI_OP_SCSI:
+		case ISCSI_OP_SCSI_DATAOUT:
+			spdk_scsi_task_process_abort(&task->scsi);
+			iscsi_task_cpl(&task->scsi);
+			break;
+		default:
+			SPDK_ERRLOG("unexpected opcode %x\n", opcode);
+			iscsi_task_put(task);
+			break;
+		}
+	}
+	iscsi_put_pdu(pdu);
+	conn->pdu_in_progress = NULL;
+}
+
 static int
 iscsi_conn_free_tasks(struct spdk_iscsi_conn *conn)
 {
 	struct spdk_iscsi_pdu *pdu, *tmp_pdu;
 	struct spdk_iscsi_task *iscsi_task, *tmp_iscsi_task;
 
+	/* PDUs whose data digest is being computed by accel are freed once it completes. */
+	if (conn->pdu_in_progress != NULL && !conn->pdu_in_progress->digest_pending) {
+		iscsi_conn_put_pdu_in_progress(conn);
+	}
+	STAILQ_INIT(&conn->send_pdu_list);
+
 	TAILQ_FOREACH_SAFE(pdu, &conn->snack_pdu_list, tailq, tmp_pdu) {
 		TAILQ_REMOVE(&conn->snack_pdu_list, pdu, tailq);
 		iscsi_conn_free_pdu(conn, pdu);
@@ -314,11 +352,14 @@ iscsi_conn_free_tasks(struct spdk_iscsi_conn *conn)
 	 *  have to ensure there is no associated task in conn->queued_datain_tasks.
 	 */
 	TAILQ_FOREACH_SAFE(pdu, &conn->write_pdu_list, tailq, tmp_pdu) {
+		if (pdu->digest_pending) {
+			continue;
+		}
 		TAILQ_REMOVE(&conn->write_pdu_list, pdu, tailq);
 		iscsi_conn_free_pdu(conn, pdu);
 	}
 
-	if (conn->pending_task_cnt) {
+	if (conn->pending_task_cnt || conn->pending_digest_cnt) {
 		return -1;
 	}
 
@@ -662,10 +703,6 @@ _iscsi_conn_check_pending_tasks(void *arg)
 void
 iscsi_conn_destruct(struct spdk_iscsi_conn *conn)
 {
-	struct spdk_iscsi_pdu *pdu;
-	struct spdk_iscsi_task *task;
-	int opcode;
-
 	/* If a connection is already in exited status, just return */
 	if (conn->state >= ISCSI_CONN_STATE_EXITED) {
 		return;
@@ -675,28 +712,10 @@ iscsi_conn_destruct(struct spdk_iscsi_conn *conn)
 
 	/*
 	 * Each connection pre-allocates its next PDU - make sure these get
-	 *  freed here.
+	 *  freed here, unless accel still verifies its data digest.
 	 */
-	pdu = conn->pdu_in_progress;
-	if (pdu) {
-		/* remove the task left in the PDU too. */
-		task = pdu->task;
-		if (task) {
-			opcode = pdu->bhs.opcode;
-			switch (opcode) {
-			case ISCSI_OP_SCSI:
-			case ISCSI_OP_SCSI_DATAOUT:
-				spdk_scsi_task_process_abort(&task->scsi);
-				iscsi_task_cpl(&task->scsi);
-				break;
-			default:
-				SPDK_ERRLOG("unexpected opcode %x\n", opcode);
-				iscsi_task_put(task);
-				break;
-			}
-		}
-		iscsi_put_pdu(pdu);
-		conn->pdu_in_progress = NULL;
+	if (conn->pdu_in_progress != NULL && !conn->pdu_in_progress->digest_pending) {
+		iscsi_conn_put_pdu_in_progress(conn);
 	}
 
 	if (conn->sess != NULL && conn->pending_task_cnt > 0) {
@@ -1438,12 +1457,78 @@ iscsi_conn_pdu_generic_complete(void *cb_arg)
 {
 }
 
+struct spdk_io_channel *
+iscsi_conn_get_accel_channel(struct spdk_iscsi_conn *conn)
+{
+	struct spdk_iscsi_poll_group *pg = conn->pg;
+
+	/* The connection may be in the middle of moving to another poll group. */
+	if (pg == NULL || pg->accel_channel == NULL ||
+	    spdk_io_channel_get_thread(pg->accel_channel) != spdk_get_thread()) {
+		return NULL;
+	}
+
+	return pg->accel_channel;
+}
+
+static void
+_iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu)
+{
+	pdu->sock_req.iovcnt = iscsi_build_iovs(conn, pdu->iov, SPDK_COUNTOF(pdu->iov), pdu,
+						&pdu->mapped_length);
+	pdu->sock_req.cb_fn = _iscsi_conn_pdu_write_done;
+	pdu->sock_req.cb_arg = pdu;
+
+	spdk_sock_writev_async(conn->sock, &pdu->sock_req);
+}
+
+/* Send the held back PDUs up to the first one still waiting for its data digest. */
+static void
+iscsi_conn_send_pdus(struct spdk_iscsi_conn *conn)
+{
+	struct spdk_iscsi_pdu *pdu;
+
+	while ((pdu = STAILQ_FIRST(&conn->send_pdu_list)) != NULL && !pdu->digest_pending) {
+		STAILQ_REMOVE_HEAD(&conn->send_pdu_list, send_link);
+		_iscsi_conn_write_pdu(conn, pdu);
+	}
+}
+
+static void
+iscsi_conn_data_digest_done(void *cb_arg, int status)
+{
+	struct spdk_iscsi_pdu *pdu = cb_arg;
+	struct spdk_iscsi_conn *conn = pdu->conn;
+	uint32_t crc32c;
+
+	assert(conn->pending_digest_cnt > 0);
+	conn->pending_digest_cnt--;
+	pdu->digest_pending = false;
+
+	if (spdk_unlikely(conn->state >= ISCSI_CONN_STATE_EXITING)) {
+		/* The PDU is released together with the rest of write_pdu_list. */
+		return;
+	}
+
+	if (spdk_unlikely(status != 0)) {
+		SPDK_ERRLOG("Failed to compute data digest (%s): %d\n", conn->initiator_name, status);
+		conn->state = ISCSI_CONN_STATE_EXITING;
+		return;
+	}
+
+	crc32c = iscsi_data_digest_finish(pdu->crc32c, DGET24(pdu->bhs.data_segment_len));
+	MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+
+	iscsi_conn_send_pdus(conn);
+}
+
 void
 iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu,
 		     iscsi_conn_xfer_complete_cb cb_fn,
 		     void *cb_arg)
 {
-	uint32_t crc32c;
+	struct spdk_io_channel *accel_ch = NULL;
+	uint32_t crc32c, data_len;
 	ssize_t rc;
 
 	if (spdk_unlikely(pdu->dif_insert_or_strip)) {
@@ -1463,9 +1548,15 @@ iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu,
 		}
 
 		/* Data Digest */
-		if (conn->data_digest && DGET24(pdu->bhs.data_segment_len) != 0) {
-			crc32c = iscsi_pdu_calc_data_digest(pdu);
-			MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+		data_len = DGET24(pdu->bhs.data_segment_len);
+		if (conn->data_digest && data_len != 0) {
+			if (spdk_likely(!pdu->dif_insert_or_strip)) {
+				accel_ch = iscsi_conn_get_accel_channel(conn);
+			}
+			if (accel_ch == NULL) {
+				crc32c = iscsi_pdu_calc_data_digest(pdu);
+				MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+			}
 		}
 	}
 
@@ -1476,12 +1567,32 @@ iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu,
 	if (spdk_unlikely(conn->state >= ISCSI_CONN_STATE_EXITING)) {
 		return;
 	}
-	pdu->sock_req.iovcnt = iscsi_build_iovs(conn, pdu->iov, SPDK_COUNTOF(pdu->iov), pdu,
-						&pdu->mapped_length);
-	pdu->sock_req.cb_fn = _iscsi_conn_pdu_write_done;
-	pdu->sock_req.cb_arg = pdu;
 
-	spdk_sock_writev_async(conn->sock, &pdu->sock_req);
+	if (accel_ch != NULL) {
+		/* Hold the PDU back until its digest is ready, later PDUs queue up behind it
+		 * to keep the order on the wire.
+		 */
+		pdu->digest_pending = true;
+		conn->pending_digest_cnt++;
+		STAILQ_INSERT_TAIL(&conn->send_pdu_list, pdu, send_link);
+
+		rc = iscsi_pdu_submit_data_digest(accel_ch, pdu, data_len, iscsi_conn_data_digest_done);
+		if (spdk_unlikely(rc != 0)) {
+			pdu->digest_pending = false;
+			conn->pending_digest_cnt--;
+			crc32c = iscsi_pdu_calc_data_digest(pdu);
+			MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+			iscsi_conn_send_pdus(conn);
+		}
+		return;
+	}
+
+	if (spdk_unlikely(!STAILQ_EMPTY(&conn->send_pdu_list))) {
+		STAILQ_INSERT_TAIL(&conn->send_pdu_list, pdu, send_link);
+		return;
+	}
+
+	_iscsi_conn_write_pdu(conn, pdu);
 }
 
 static void
@@ -1532,16 +1643,28 @@ iscsi_conn_full_feature_migrate(void *arg)
 	iscsi_poll_group_add_conn(conn->pg, conn);
 }
 
+/* Poll groups whose load differs by less than this (per mille) are considered
+ * equally busy and the number of active targets decides between them.
+ */
+#define ISCSI_POLL_GROUP_LOAD_GRANULARITY	50
+
+/* Load charged to a poll group when a target is placed on it, so that a burst
+ * of logins does not pile up on the same group before its next load sample.
+ */
+#define ISCSI_POLL_GROUP_TARGET_LOAD		100
+
 static struct spdk_iscsi_poll_group *
 iscsi_get_idlest_poll_group(void)
 {
 	struct spdk_iscsi_poll_group *pg, *idle_pg = NULL;
+	uint32_t load, min_load = UINT32_MAX;
 	uint32_t min_num_targets = UINT32_MAX;
 
 	TAILQ_FOREACH(pg, &g_iscsi.poll_group_head, link) {
-		if (pg->num_active_targets == 0) {
-			return pg;
-		} else if (pg->num_active_targets < min_num_targets) {
+		load = __atomic_load_n(&pg->load, __ATOMIC_RELAXED) / ISCSI_POLL_GROUP_LOAD_GRANULARITY;
+		if (load < min_load ||
+		    (load == min_load && pg->num_active_targets < min_num_targets)) {
+			min_load = load;
 			min_num_targets = pg->num_active_targets;
 			idle_pg = pg;
 		}
@@ -1575,6 +1698,7 @@ iscsi_conn_schedule(struct spdk_iscsi_conn *conn)
 		assert(pg != NULL);
 
 		pg->num_active_targets++;
+		__atomic_fetch_add(&pg->load, ISCSI_POLL_GROUP_TARGET_LOAD, __ATOMIC_RELAXED);
 
 		/* Save the pg in the target node so it can be used for any other connections to this target node. */
 		target->pg = pg;
@@ -37,6 +37,9 @@ enum iscsi_pdu_recv_state {
 	/* Active connection waiting for payload */
 	ISCSI_PDU_RECV_STATE_AWAIT_PDU_PAYLOAD,
 
+	/* Active connection waiting for the data digest of the payload to be verified */
+	ISCSI_PDU_RECV_STATE_AWAIT_DATA_DIGEST,
+
 	/* Active connection does not wait for payload */
 	ISCSI_PDU_RECV_STATE_ERROR,
 };
@@ -104,6 +107,10 @@ struct spdk_iscsi_conn {
 	TAILQ_HEAD(, spdk_iscsi_pdu) write_pdu_list;
 	TAILQ_HEAD(, spdk_iscsi_pdu) snack_pdu_list;
 
+	/* PDUs held back to keep the send order while data digests are computed by accel */
+	STAILQ_HEAD(, spdk_iscsi_pdu) send_pdu_list;
+	uint32_t pending_digest_cnt;
+
 	uint32_t pending_r2t;
 
 	uint16_t cid;
@@ -195,6 +202,8 @@ int iscsi_conn_abort_queued_datain_tasks(struct spdk_iscsi_conn *conn,
 		struct spdk_scsi_lun *lun,
 		struct spdk_iscsi_pdu *pdu);
 
+struct spdk_io_channel *iscsi_conn_get_accel_channel(struct spdk_iscsi_conn *conn);
+
 int iscsi_conn_read_data(struct spdk_iscsi_conn *conn, int len, void *buf);
 int iscsi_conn_readv_data(struct spdk_iscsi_conn *conn,
 			  struct iovec *iov, int iovcnt);
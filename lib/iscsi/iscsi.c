@@ -295,14 +295,13 @@ iscsi_pdu_calc_partial_data_digest(struct spdk_iscsi_pdu *pdu)
 	}
 }
 
-static uint32_t
-iscsi_pdu_calc_partial_data_digest_done(struct spdk_iscsi_pdu *pdu)
+uint32_t
+iscsi_data_digest_finish(uint32_t crc32c, uint32_t data_len)
 {
-	uint32_t crc32c = pdu->crc32c;
 	uint32_t mod;
 
 	/* Include padding bytes into CRC if any. */
-	mod = pdu->data_valid_bytes % ISCSI_ALIGNMENT;
+	mod = data_len % ISCSI_ALIGNMENT;
 	if (mod != 0) {
 		uint32_t pad_length = ISCSI_ALIGNMENT - mod;
 		uint8_t pad[3] = {0, 0, 0};
@@ -316,12 +315,17 @@ iscsi_pdu_calc_partial_data_digest_done(struct spdk_iscsi_pdu *pdu)
 	return crc32c ^ SPDK_CRC32C_XOR;
 }
 
+static uint32_t
+iscsi_pdu_calc_partial_data_digest_done(struct spdk_iscsi_pdu *pdu)
+{
+	return iscsi_data_digest_finish(pdu->crc32c, pdu->data_valid_bytes);
+}
+
 uint32_t
 iscsi_pdu_calc_data_digest(struct spdk_iscsi_pdu *pdu)
 {
 	uint32_t data_len = DGET24(pdu->bhs.data_segment_len);
 	uint32_t crc32c;
-	uint32_t mod;
 	struct iovec iov;
 	uint32_t num_blocks;
 
@@ -339,18 +343,24 @@ iscsi_pdu_calc_data_digest(struct spdk_iscsi_pdu *pdu)
 		spdk_dif_update_crc32c(&iov, 1, num_blocks, &crc32c, &pdu->dif_ctx);
 	}
 
-	/* Include padding bytes into CRC if any. */
-	mod = data_len % ISCSI_ALIGNMENT;
-	if (mod != 0) {
-		uint32_t pad_length = ISCSI_ALIGNMENT - mod;
-		uint8_t pad[3] = {0, 0, 0};
-		assert(pad_length > 0);
-		assert(pad_length <= sizeof(pad));
-		crc32c = spdk_crc32c_update(pad, pad_length, crc32c);
-	}
+	return iscsi_data_digest_finish(crc32c, data_len);
+}
 
-	/* Finalize CRC by inverting all bits. */
-	return crc32c ^ SPDK_CRC32C_XOR;
+/* Compute the CRC of the first data_len bytes of the data segment by the accel framework.
+ * The result is stored in pdu->crc32c and has to be finished by iscsi_data_digest_finish().
+ */
+int
+iscsi_pdu_submit_data_digest(struct spdk_io_channel *accel_ch, struct spdk_iscsi_pdu *pdu,
+			     uint32_t data_len, spdk_accel_completion_cb cb_fn)
+{
+	assert(!pdu->dif_insert_or_strip);
+
+	pdu->digest_iov.iov_base = pdu->data;
+	pdu->digest_iov.iov_len = data_len;
+
+	/* The seed is inverted by accel, so 0 starts from SPDK_CRC32C_INITIAL. */
+	return spdk_accel_submit_crc32cv(accel_ch, &pdu->crc32c, &pdu->digest_iov, 1, 0,
+					 cb_fn, pdu);
 }
 
 static int
@@ -4622,9 +4632,56 @@ iscsi_pdu_payload_handle(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pd
 /* Return zero if completed to read payload, positive number if still in progress,
  * or negative number if any error.
  */
+static void
+iscsi_pdu_data_digest_verify_done(void *cb_arg, int status)
+{
+	struct spdk_iscsi_pdu *pdu = cb_arg;
+	struct spdk_iscsi_conn *conn = pdu->conn;
+	uint32_t crc32c;
+	int rc;
+
+	assert(conn->pending_digest_cnt > 0);
+	assert(pdu == conn->pdu_in_progress);
+	conn->pending_digest_cnt--;
+	pdu->digest_pending = false;
+
+	if (spdk_unlikely(conn->state >= ISCSI_CONN_STATE_EXITING)) {
+		/* The PDU is released by the connection cleanup. */
+		return;
+	}
+
+	assert(conn->pdu_recv_state == ISCSI_PDU_RECV_STATE_AWAIT_DATA_DIGEST);
+
+	if (spdk_unlikely(status != 0)) {
+		SPDK_ERRLOG("Failed to compute data digest (%s): %d\n", conn->initiator_name, status);
+		goto error;
+	}
+
+	crc32c = iscsi_data_digest_finish(pdu->crc32c, pdu->data_valid_bytes);
+	rc = MATCH_DIGEST_WORD(pdu->data_digest, crc32c);
+	if (rc == 0) {
+		SPDK_ERRLOG("data digest error (%s)\n", conn->initiator_name);
+		goto error;
+	}
+
+	/* Resume the receive state machine with this PDU, and then the following ones. */
+	pdu->data_digest_verified = true;
+	conn->pdu_recv_state = ISCSI_PDU_RECV_STATE_AWAIT_PDU_PAYLOAD;
+	rc = iscsi_handle_incoming_pdus(conn);
+	if (rc < 0) {
+		conn->state = ISCSI_CONN_STATE_EXITING;
+	}
+	return;
+
+error:
+	conn->pdu_recv_state = ISCSI_PDU_RECV_STATE_ERROR;
+	conn->state = ISCSI_CONN_STATE_EXITING;
+}
+
 static int
 iscsi_pdu_payload_read(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu)
 {
+	struct spdk_io_channel *accel_ch;
 	struct spdk_mempool *pool;
 	struct spdk_mobj *mobj;
 	uint32_t data_len;
@@ -4719,7 +4776,27 @@ iscsi_pdu_payload_read(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu)
 	}
 
 	/* check data digest */
-	if (conn->data_digest) {
+	if (conn->data_digest && !pdu->data_digest_verified) {
+		accel_ch = iscsi_conn_get_accel_channel(conn);
+		if (accel_ch != NULL && !pdu->dif_insert_or_strip && pdu->mobj[1] == NULL) {
+			/* The whole data segment is in a single buffer, verify it asynchronously
+			 * and stop reading from the socket until it is done.
+			 */
+			pdu->digest_pending = true;
+			conn->pending_digest_cnt++;
+			conn->pdu_recv_state = ISCSI_PDU_RECV_STATE_AWAIT_DATA_DIGEST;
+			rc = iscsi_pdu_submit_data_digest(accel_ch, pdu, pdu->data_valid_bytes,
+							  iscsi_pdu_data_digest_verify_done);
+			if (spdk_likely(rc == 0)) {
+				return 1;
+			}
+
+			pdu->digest_pending = false;
+			conn->pending_digest_cnt--;
+			conn->pdu_recv_state = ISCSI_PDU_RECV_STATE_AWAIT_PDU_PAYLOAD;
+			pdu->crc32c = SPDK_CRC32C_INITIAL;
+		}
+
 		iscsi_pdu_calc_partial_data_digest(pdu);
 		crc32c = iscsi_pdu_calc_partial_data_digest_done(pdu);
 
@@ -4874,6 +4951,9 @@ iscsi_read_pdu(struct spdk_iscsi_conn *conn)
 				conn->pdu_recv_state = ISCSI_PDU_RECV_STATE_ERROR;
 			}
 			break;
+		case ISCSI_PDU_RECV_STATE_AWAIT_DATA_DIGEST:
+			/* Nothing is read until the data digest of the current PDU is verified. */
+			return 0;
 		case ISCSI_PDU_RECV_STATE_ERROR:
 			return SPDK_ISCSI_CONNECTION_FATAL;
 		default:
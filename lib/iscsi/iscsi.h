@@ -9,6 +9,7 @@
 
 #include "spdk/stdinc.h"
 #include "spdk/env.h"
+#include "spdk/accel.h"
 #include "spdk/bdev.h"
 #include "spdk/iscsi_spec.h"
 #include "spdk/thread.h"
@@ -163,6 +164,10 @@ struct spdk_iscsi_pdu {
 	uint32_t data_buf_len;
 	uint32_t data_offset;
 	uint32_t crc32c;
+	/* Data segment handed to the accel framework to compute the data digest */
+	struct iovec digest_iov;
+	bool digest_pending;
+	bool data_digest_verified;
 	bool dif_insert_or_strip;
 	struct spdk_dif_ctx dif_ctx;
 	struct spdk_iscsi_conn *conn;
@@ -177,6 +182,7 @@ struct spdk_iscsi_pdu {
 	struct spdk_sock_request			sock_req;
 	struct iovec					iov[SPDK_ISCSI_MAX_SGL_DESCRIPTORS];
 	TAILQ_ENTRY(spdk_iscsi_pdu)	tailq;
+	STAILQ_ENTRY(spdk_iscsi_pdu)	send_link;
 
 
 	/*
@@ -285,10 +291,19 @@ struct spdk_iscsi_sess {
 struct spdk_iscsi_poll_group {
 	struct spdk_poller				*poller;
 	struct spdk_poller				*nop_poller;
+	struct spdk_poller				*load_poller;
 	STAILQ_HEAD(connections, spdk_iscsi_conn)	connections;
 	struct spdk_sock_group				*sock_group;
+	struct spdk_io_channel				*accel_channel;
 	TAILQ_ENTRY(spdk_iscsi_poll_group)		link;
 	uint32_t					num_active_targets;
+
+	/* Busy time of the poll group thread in the last sampling period, in per mille.
+	 * Written by the poll group thread, read when scheduling new target nodes.
+	 */
+	uint32_t					load;
+	uint64_t					last_busy_tsc;
+	uint64_t					last_idle_tsc;
 };
 
 struct spdk_iscsi_opts {
@@ -436,6 +451,9 @@ bool iscsi_del_transfer_task(struct spdk_iscsi_conn *conn, uint32_t CmdSN);
 
 uint32_t iscsi_pdu_calc_header_digest(struct spdk_iscsi_pdu *pdu);
 uint32_t iscsi_pdu_calc_data_digest(struct spdk_iscsi_pdu *pdu);
+int iscsi_pdu_submit_data_digest(struct spdk_io_channel *accel_ch, struct spdk_iscsi_pdu *pdu,
+				 uint32_t data_len, spdk_accel_completion_cb cb_fn);
+uint32_t iscsi_data_digest_finish(uint32_t crc32c, uint32_t data_len);
 
 /* Memory management */
 void iscsi_put_pdu(struct spdk_iscsi_pdu *pdu);
@@ -987,6 +987,29 @@ iscsi_poll_group_handle_nop(void *ctx)
 	return SPDK_POLLER_BUSY;
 }
 
+static int
+iscsi_poll_group_update_load(void *ctx)
+{
+	struct spdk_iscsi_poll_group *group = ctx;
+	struct spdk_thread_stats stats;
+	uint64_t busy, total;
+
+	if (spdk_thread_get_stats(&stats) != 0) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	busy = stats.busy_tsc - group->last_busy_tsc;
+	total = busy + (stats.idle_tsc - group->last_idle_tsc);
+	group->last_busy_tsc = stats.busy_tsc;
+	group->last_idle_tsc = stats.idle_tsc;
+
+	if (total != 0) {
+		__atomic_store_n(&group->load, (uint32_t)(busy * 1000 / total), __ATOMIC_RELAXED);
+	}
+
+	return SPDK_POLLER_IDLE;
+}
+
 static int
 iscsi_poll_group_create(void *io_device, void *ctx_buf)
 {
@@ -996,9 +1019,17 @@ iscsi_poll_group_create(void *io_device, void *ctx_buf)
 	pg->sock_group = spdk_sock_group_create(NULL);
 	assert(pg->sock_group != NULL);
 
+	/* Digests are computed inline if accel is not available. */
+	pg->accel_channel = spdk_accel_get_io_channel();
+	if (pg->accel_channel == NULL) {
+		SPDK_ERRLOG("Failed to get accel channel, digests will be computed inline\n");
+	}
+
 	pg->poller = SPDK_POLLER_REGISTER(iscsi_poll_group_poll, pg, 0);
 	/* set the period to 1 sec */
 	pg->nop_poller = SPDK_POLLER_REGISTER(iscsi_poll_group_handle_nop, pg, 1000000);
+	/* sample the thread load every 100 msec */
+	pg->load_poller = SPDK_POLLER_REGISTER(iscsi_poll_group_update_load, pg, 100000);
 
 	return 0;
 }
@@ -1016,6 +1047,10 @@ iscsi_poll_group_destroy(void *io_device, void *ctx_buf)
 	spdk_sock_group_close(&pg->sock_group);
 	spdk_poller_unregister(&pg->poller);
 	spdk_poller_unregister(&pg->nop_poller);
+	spdk_poller_unregister(&pg->load_poller);
+	if (pg->accel_channel != NULL) {
+		spdk_put_io_channel(pg->accel_channel);
+	}
 
 	ch = spdk_io_channel_from_ctx(pg);
 	thread = spdk_io_channel_get_thread(ch);
@@ -7,8 +7,176 @@
 
 #include "spdk_internal/utf.h"
 
+#if defined(__x86_64__) && (defined(__AVX2__) || defined(__SSE2__))
+#include <x86intrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #define SPDK_JSON_MAX_NESTING_DEPTH	64
 
+/*
+ * Most of the input consists of runs of bytes that don't need to be looked at one by one:
+ *  plain ASCII characters inside of strings and whitespace (indentation) between tokens.
+ *  These are skipped a block at a time.  The block helpers return a mask with the bits
+ *  (JSON_SCAN_BITS_PER_BYTE per byte) of the bytes ending the run set.
+ */
+#if defined(__x86_64__) && defined(__AVX2__)
+#define JSON_SCAN_BLOCK_SIZE	32
+#define JSON_SCAN_BITS_PER_BYTE	1
+
+static inline uint64_t
+json_scan_string_block(const uint8_t *p)
+{
+	__m256i v = _mm256_loadu_si256((const __m256i *)p);
+	__m256i m;
+
+	/* The signed comparison catches both control characters and non-ASCII bytes */
+	m = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v);
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+
+	return (uint32_t)_mm256_movemask_epi8(m);
+}
+
+static inline uint64_t
+json_scan_ws_block(const uint8_t *p)
+{
+	__m256i v = _mm256_loadu_si256((const __m256i *)p);
+	__m256i m;
+
+	m = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+
+	return (uint32_t)~_mm256_movemask_epi8(m);
+}
+#elif defined(__x86_64__) && defined(__SSE2__)
+#define JSON_SCAN_BLOCK_SIZE	16
+#define JSON_SCAN_BITS_PER_BYTE	1
+
+static inline uint64_t
+json_scan_string_block(const uint8_t *p)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)p);
+	__m128i m;
+
+	/* The signed comparison catches both control characters and non-ASCII bytes */
+	m = _mm_cmplt_epi8(v, _mm_set1_epi8(0x20));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+
+	return (uint32_t)_mm_movemask_epi8(m);
+}
+
+static inline uint64_t
+json_scan_ws_block(const uint8_t *p)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)p);
+	__m128i m;
+
+	m = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+
+	return ~_mm_movemask_epi8(m) & 0xffff;
+}
+#elif defined(__aarch64__)
+#define JSON_SCAN_BLOCK_SIZE	16
+#define JSON_SCAN_BITS_PER_BYTE	4
+
+static inline uint64_t
+json_scan_neon_mask(uint8x16_t m)
+{
+	/* Narrow each byte of the comparison result down to a nibble */
+	return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+static inline uint64_t
+json_scan_string_block(const uint8_t *p)
+{
+	uint8x16_t v = vld1q_u8(p);
+	uint8x16_t m;
+
+	m = vorrq_u8(vcltq_u8(v, vdupq_n_u8(0x20)), vcgeq_u8(v, vdupq_n_u8(0x80)));
+	m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('"')));
+	m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\\')));
+
+	return json_scan_neon_mask(m);
+}
+
+static inline uint64_t
+json_scan_ws_block(const uint8_t *p)
+{
+	uint8x16_t v = vld1q_u8(p);
+	uint8x16_t m;
+
+	m = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t')));
+	m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\r')));
+	m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\n')));
+
+	return json_scan_neon_mask(vmvnq_u8(m));
+}
+#endif
+
+static inline bool
+json_string_plain(uint8_t c)
+{
+	return c >= 0x20 && c < 0x80 && c != '"' && c != '\\';
+}
+
+static inline bool
+json_whitespace(uint8_t c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/* Return a pointer to the first byte at or after p that isn't a plain ASCII string character */
+static inline uint8_t *
+json_scan_string(uint8_t *p, uint8_t *end)
+{
+#ifdef JSON_SCAN_BLOCK_SIZE
+	uint64_t mask;
+
+	while (end - p >= JSON_SCAN_BLOCK_SIZE) {
+		mask = json_scan_string_block(p);
+		if (mask != 0) {
+			return p + __builtin_ctzll(mask) / JSON_SCAN_BITS_PER_BYTE;
+		}
+		p += JSON_SCAN_BLOCK_SIZE;
+	}
+#endif
+	while (p < end && json_string_plain(*p)) {
+		p++;
+	}
+
+	return p;
+}
+
+/* Return a pointer to the first byte at or after p that isn't whitespace */
+static inline uint8_t *
+json_skip_whitespace(uint8_t *p, uint8_t *end)
+{
+#ifdef JSON_SCAN_BLOCK_SIZE
+	uint64_t mask;
+
+	while (end - p >= JSON_SCAN_BLOCK_SIZE) {
+		mask = json_scan_ws_block(p);
+		if (mask != 0) {
+			return p + __builtin_ctzll(mask) / JSON_SCAN_BITS_PER_BYTE;
+		}
+		p += JSON_SCAN_BLOCK_SIZE;
+	}
+#endif
+	while (p < end && json_whitespace(*p)) {
+		p++;
+	}
+
+	return p;
+}
+
 static int
 hex_value(uint8_t c)
 {
@@ -171,6 +339,7 @@ json_decode_string(uint8_t *str_start, uint8_t *buf_end, uint8_t **str_end, uint
 {
 	uint8_t *str = str_start;
 	uint8_t *out = str_start + 1; /* Decode string in place (skip the initial quote) */
+	uint8_t *plain;
 	int rc;
 
 	if (buf_end - str_start < 2) {
@@ -188,6 +357,19 @@ json_decode_string(uint8_t *str_start, uint8_t *buf_end, uint8_t **str_end, uint
 	}
 
 	while (str < buf_end) {
+		/* Copy (or just skip over) the characters that don't need any decoding */
+		plain = json_scan_string(str, buf_end);
+		if (plain != str) {
+			if (out != str && (flags & SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE)) {
+				memmove(out, str, plain - str);
+			}
+			out += plain - str;
+			str = plain;
+			if (str == buf_end) {
+				break;
+			}
+		}
+
 		if (str[0] == '"') {
 			/*
 			 * End of string.
@@ -452,7 +634,7 @@ spdk_json_parse(void *json, size_t size, struct spdk_json_val *values, size_t nu
 		case '\r':
 		case '\n':
 			/* Whitespace is allowed between any tokens. */
-			data++;
+			data = json_skip_whitespace(data + 1, json_end);
 			break;
 
 		case 't':
@@ -601,15 +783,7 @@ spdk_json_parse(void *json, size_t size, struct spdk_json_val *values, size_t nu
 
 	if (state == STATE_END) {
 		/* Skip trailing whitespace */
-		while (data < json_end) {
-			uint8_t c = *data;
-
-			if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
-				data++;
-			} else {
-				break;
-			}
-		}
+		data = json_skip_whitespace(data, json_end);
 
 		/*
 		 * These asserts are just for sanity checking - they are guaranteed by the allowed
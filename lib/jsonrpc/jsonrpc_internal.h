@@ -13,11 +13,14 @@
 #include "spdk/log.h"
 
 #define SPDK_JSONRPC_RECV_BUF_SIZE	(32 * 1024)
+#define SPDK_JSONRPC_RECV_BUF_SIZE_MAX	(32 * 1024 * 1024)
 #define SPDK_JSONRPC_SEND_BUF_SIZE_INIT	(32 * 1024)
 #define SPDK_JSONRPC_SEND_BUF_SIZE_MAX	(32 * 1024 * 1024)
+#define SPDK_JSONRPC_BATCH_SEND_BUF_SIZE_INIT	1024
 #define SPDK_JSONRPC_ID_MAX_LEN		128
 #define SPDK_JSONRPC_MAX_CONNS		64
 #define SPDK_JSONRPC_MAX_VALUES		1024
+#define SPDK_JSONRPC_MAX_BATCH_VALUES	(1024 * 1024)
 #define SPDK_JSONRPC_CLIENT_MAX_VALUES		8192
 
 struct spdk_jsonrpc_request {
@@ -42,6 +45,15 @@ struct spdk_jsonrpc_request {
 
 	struct spdk_json_write_ctx *response;
 
+	/* Batch request this request is a part of (NULL for standalone requests) */
+	struct spdk_jsonrpc_request *batch;
+
+	/* Requests of a batch, in the order they were received */
+	STAILQ_HEAD(, spdk_jsonrpc_request) batch_reqs;
+
+	/* Number of requests of a batch that haven't completed yet */
+	uint32_t batch_pending;
+
 	STAILQ_ENTRY(spdk_jsonrpc_request) link;
 };
 
@@ -50,7 +62,8 @@ struct spdk_jsonrpc_server_conn {
 	int sockfd;
 	bool closed;
 	size_t recv_len;
-	uint8_t recv_buf[SPDK_JSONRPC_RECV_BUF_SIZE];
+	size_t recv_buf_size;
+	uint8_t *recv_buf;
 	uint32_t outstanding_requests;
 
 	pthread_spinlock_t queue_lock;
@@ -167,12 +167,150 @@ jsonrpc_server_write_cb(void *cb_ctx, const void *data, size_t size)
 	return 0;
 }
 
+static int
+jsonrpc_alloc_response(struct spdk_jsonrpc_request *request, size_t size)
+{
+	request->send_offset = 0;
+	request->send_len = 0;
+	request->send_buf_size = size;
+	/* Add extra byte for the null terminator. */
+	request->send_buf = malloc(request->send_buf_size + 1);
+	if (request->send_buf == NULL) {
+		SPDK_ERRLOG("Failed to allocate send_buf (%zu bytes)\n", request->send_buf_size);
+		return -1;
+	}
+
+	request->response = spdk_json_write_begin(jsonrpc_server_write_cb, request, 0);
+	if (request->response == NULL) {
+		SPDK_ERRLOG("Failed to allocate response JSON write context.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+jsonrpc_batch_complete(struct spdk_jsonrpc_request *batch)
+{
+	struct spdk_jsonrpc_request *request;
+	bool first = true;
+	int rc = 0;
+
+	/* Requests without an ID (notifications) don't have a response.  If none of the requests
+	 * has one, the batch doesn't get any response either. */
+	while ((request = STAILQ_FIRST(&batch->batch_reqs)) != NULL) {
+		STAILQ_REMOVE_HEAD(&batch->batch_reqs, link);
+		if (request->send_len > 0 && rc == 0) {
+			/* Skip the newline terminating each response */
+			assert(request->send_buf[request->send_len - 1] == '\n');
+			rc = jsonrpc_server_write_cb(batch, first ? "[" : ",", 1);
+			rc = rc ? rc : jsonrpc_server_write_cb(batch, request->send_buf,
+							       request->send_len - 1);
+			first = false;
+		}
+
+		jsonrpc_free_request(request);
+	}
+
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to build batch response, dropping it\n");
+		batch->send_len = 0;
+	} else if (!first) {
+		jsonrpc_server_write_cb(batch, "]\n", 2);
+	}
+
+	jsonrpc_server_send_response(batch);
+}
+
+static void
+jsonrpc_batch_put(struct spdk_jsonrpc_request *batch)
+{
+	/* Requests of a batch might be completed on any thread, so the last one to finish sends
+	 * the response. */
+	if (__atomic_sub_fetch(&batch->batch_pending, 1, __ATOMIC_ACQ_REL) == 0) {
+		jsonrpc_batch_complete(batch);
+	}
+}
+
+static int
+parse_batch_request(struct spdk_jsonrpc_request *batch, struct spdk_json_val *values)
+{
+	struct spdk_jsonrpc_request *request;
+	struct spdk_json_val *val, *end;
+	int rc = 0;
+
+	if (values[0].len == 0) {
+		SPDK_DEBUGLOG(rpc, "Got empty batch array\n");
+		jsonrpc_server_handle_error(batch, SPDK_JSONRPC_ERROR_INVALID_REQUEST);
+		return 0;
+	}
+
+	/* The response of a batch is assembled from the responses of its requests. */
+	spdk_json_write_end(batch->response);
+	batch->response = NULL;
+
+	STAILQ_INIT(&batch->batch_reqs);
+	/* Hold an extra reference, so that the batch isn't completed before all of its requests
+	 * are submitted. */
+	batch->batch_pending = 1;
+
+	end = &values[values[0].len + 1];
+	for (val = &values[1]; val < end; val += spdk_json_val_len(val)) {
+		request = calloc(1, sizeof(*request));
+		if (request == NULL ||
+		    jsonrpc_alloc_response(request, SPDK_JSONRPC_BATCH_SEND_BUF_SIZE_INIT) != 0) {
+			SPDK_ERRLOG("Failed to allocate request, dropping the rest of the batch\n");
+			jsonrpc_free_request(request);
+			rc = -1;
+			break;
+		}
+
+		request->batch = batch;
+		STAILQ_INSERT_TAIL(&batch->batch_reqs, request, link);
+		__atomic_add_fetch(&batch->batch_pending, 1, __ATOMIC_RELAXED);
+
+		if (val->type == SPDK_JSON_VAL_OBJECT_BEGIN) {
+			parse_single_request(request, val);
+		} else {
+			SPDK_DEBUGLOG(rpc, "batch array element was not an object\n");
+			jsonrpc_server_handle_error(request, SPDK_JSONRPC_ERROR_INVALID_REQUEST);
+		}
+	}
+
+	jsonrpc_batch_put(batch);
+
+	return rc;
+}
+
+static size_t
+jsonrpc_max_values(const uint8_t *json, size_t size)
+{
+	size_t i;
+
+	/* Batch requests carry many calls at once, so they're allowed to be much larger. */
+	for (i = 0; i < size; i++) {
+		switch (json[i]) {
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+			continue;
+		case '[':
+			return SPDK_JSONRPC_MAX_BATCH_VALUES;
+		default:
+			return SPDK_JSONRPC_MAX_VALUES;
+		}
+	}
+
+	return SPDK_JSONRPC_MAX_VALUES;
+}
+
 int
 jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, size_t size)
 {
 	struct spdk_jsonrpc_request *request;
 	ssize_t rc;
-	size_t len;
+	size_t len, max_values;
 	void *end = NULL;
 
 	/* Check to see if we have received a full JSON value. It is safe to cast away const
@@ -182,6 +320,8 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 		return 0;
 	}
 
+	max_values = jsonrpc_max_values(json, size);
+
 	request = calloc(1, sizeof(*request));
 	if (request == NULL) {
 		SPDK_DEBUGLOG(rpc, "Out of memory allocating request\n");
@@ -208,7 +348,7 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 
 	jsonrpc_log(request->recv_buffer, "request: ");
 
-	if (rc > 0 && rc <= SPDK_JSONRPC_MAX_VALUES) {
+	if (rc > 0 && (size_t)rc <= max_values) {
 		request->values_cnt = rc;
 		request->values = malloc(request->values_cnt * sizeof(request->values[0]));
 		if (request->values == NULL) {
@@ -219,25 +359,12 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 		}
 	}
 
-	request->send_offset = 0;
-	request->send_len = 0;
-	request->send_buf_size = SPDK_JSONRPC_SEND_BUF_SIZE_INIT;
-	/* Add extra byte for the null terminator. */
-	request->send_buf = malloc(request->send_buf_size + 1);
-	if (request->send_buf == NULL) {
-		SPDK_ERRLOG("Failed to allocate send_buf (%zu bytes)\n", request->send_buf_size);
-		jsonrpc_free_request(request);
-		return -1;
-	}
-
-	request->response = spdk_json_write_begin(jsonrpc_server_write_cb, request, 0);
-	if (request->response == NULL) {
-		SPDK_ERRLOG("Failed to allocate response JSON write context.\n");
+	if (jsonrpc_alloc_response(request, SPDK_JSONRPC_SEND_BUF_SIZE_INIT) != 0) {
 		jsonrpc_free_request(request);
 		return -1;
 	}
 
-	if (rc <= 0 || rc > SPDK_JSONRPC_MAX_VALUES) {
+	if (rc <= 0 || (size_t)rc > max_values) {
 		SPDK_DEBUGLOG(rpc, "JSON parse error\n");
 		jsonrpc_server_handle_error(request, SPDK_JSONRPC_ERROR_PARSE_ERROR);
 
@@ -248,10 +375,11 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 		return -1;
 	}
 
-	/* Decode a second time now that there is a full JSON value available. */
-	rc = spdk_json_parse(request->recv_buffer, size, request->values, request->values_cnt, &end,
+	/* Decode a second time now that there is a full JSON value available.  Only the value was
+	 * copied to recv_buffer, so don't let the parser look past it. */
+	rc = spdk_json_parse(request->recv_buffer, len, request->values, request->values_cnt, &end,
 			     SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE);
-	if (rc < 0 || rc > SPDK_JSONRPC_MAX_VALUES) {
+	if (rc < 0 || (size_t)rc > max_values) {
 		SPDK_DEBUGLOG(rpc, "JSON parse error on second pass\n");
 		jsonrpc_server_handle_error(request, SPDK_JSONRPC_ERROR_PARSE_ERROR);
 		return -1;
@@ -262,8 +390,9 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 	if (request->values[0].type == SPDK_JSON_VAL_OBJECT_BEGIN) {
 		parse_single_request(request, request->values);
 	} else if (request->values[0].type == SPDK_JSON_VAL_ARRAY_BEGIN) {
-		SPDK_DEBUGLOG(rpc, "Got batch array (not currently supported)\n");
-		jsonrpc_server_handle_error(request, SPDK_JSONRPC_ERROR_INVALID_REQUEST);
+		if (parse_batch_request(request, request->values) != 0) {
+			return -1;
+		}
 	} else {
 		SPDK_DEBUGLOG(rpc, "top-level JSON value was not array or object\n");
 		jsonrpc_server_handle_error(request, SPDK_JSONRPC_ERROR_INVALID_REQUEST);
@@ -275,7 +404,7 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 struct spdk_jsonrpc_server_conn *
 spdk_jsonrpc_get_conn(struct spdk_jsonrpc_request *request)
 {
-	return request->conn;
+	return request->batch != NULL ? request->batch->conn : request->conn;
 }
 
 /* Never return NULL */
@@ -297,13 +426,24 @@ begin_response(struct spdk_jsonrpc_request *request)
 	return w;
 }
 
+static void
+send_response(struct spdk_jsonrpc_request *request)
+{
+	if (request->batch != NULL) {
+		jsonrpc_batch_put(request->batch);
+	} else {
+		jsonrpc_server_send_response(request);
+	}
+}
+
 static void
 skip_response(struct spdk_jsonrpc_request *request)
 {
-	request->send_len = 0;
+	/* Drop the response only after the write context has flushed it */
 	spdk_json_write_end(request->response);
 	request->response = NULL;
-	jsonrpc_server_send_response(request);
+	request->send_len = 0;
+	send_response(request);
 }
 
 static void
@@ -314,7 +454,7 @@ end_response(struct spdk_jsonrpc_request *request)
 	request->response = NULL;
 
 	jsonrpc_server_write_cb(request, "\n", 1);
-	jsonrpc_server_send_response(request);
+	send_response(request);
 }
 
 void
@@ -124,6 +124,8 @@ spdk_jsonrpc_server_shutdown(struct spdk_jsonrpc_server *server)
 
 	TAILQ_FOREACH(conn, &server->conns, link) {
 		jsonrpc_server_conn_close(conn);
+		free(conn->recv_buf);
+		conn->recv_buf = NULL;
 	}
 
 	free(server);
@@ -139,6 +141,9 @@ jsonrpc_server_conn_remove(struct spdk_jsonrpc_server_conn *conn)
 	pthread_spin_destroy(&conn->queue_lock);
 	assert(STAILQ_EMPTY(&conn->send_queue));
 
+	free(conn->recv_buf);
+	conn->recv_buf = NULL;
+
 	TAILQ_REMOVE(&server->conns, conn, link);
 	TAILQ_INSERT_HEAD(&server->free_conns, conn, link);
 }
@@ -193,14 +198,25 @@ jsonrpc_server_accept(struct spdk_jsonrpc_server *server)
 		conn->sockfd = rc;
 		conn->closed = false;
 		conn->recv_len = 0;
+		conn->recv_buf_size = SPDK_JSONRPC_RECV_BUF_SIZE;
 		conn->outstanding_requests = 0;
 		STAILQ_INIT(&conn->send_queue);
 		STAILQ_INIT(&conn->outstanding_queue);
 		conn->send_request = NULL;
 
+		conn->recv_buf = malloc(conn->recv_buf_size);
+		if (conn->recv_buf == NULL) {
+			SPDK_ERRLOG("Unable to allocate receive buffer for socket: %d\n",
+				    conn->sockfd);
+			close(conn->sockfd);
+			return -1;
+		}
+
 		if (pthread_spin_init(&conn->queue_lock, PTHREAD_PROCESS_PRIVATE)) {
 			SPDK_ERRLOG("Unable to create queue lock for socket: %d", conn->sockfd);
 			close(conn->sockfd);
+			free(conn->recv_buf);
+			conn->recv_buf = NULL;
 			return -1;
 		}
 
@@ -210,6 +226,8 @@ jsonrpc_server_accept(struct spdk_jsonrpc_server *server)
 				    conn->sockfd, spdk_strerror(errno));
 			close(conn->sockfd);
 			pthread_spin_destroy(&conn->queue_lock);
+			free(conn->recv_buf);
+			conn->recv_buf = NULL;
 			return -1;
 		}
 
@@ -229,7 +247,7 @@ void
 jsonrpc_server_handle_request(struct spdk_jsonrpc_request *request,
 			      const struct spdk_json_val *method, const struct spdk_json_val *params)
 {
-	request->conn->server->handle_request(request, method, params);
+	spdk_jsonrpc_get_conn(request)->server->handle_request(request, method, params);
 }
 
 void
@@ -267,27 +285,33 @@ jsonrpc_server_handle_error(struct spdk_jsonrpc_request *request, int error)
 }
 
 static int
-jsonrpc_server_conn_recv(struct spdk_jsonrpc_server_conn *conn)
+jsonrpc_server_conn_recv_buf_expand(struct spdk_jsonrpc_server_conn *conn)
 {
-	ssize_t rc, offset;
-	size_t recv_avail = SPDK_JSONRPC_RECV_BUF_SIZE - conn->recv_len;
+	uint8_t *new_buf;
 
-	rc = recv(conn->sockfd, conn->recv_buf + conn->recv_len, recv_avail, 0);
-	if (rc == -1) {
-		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
-			return 0;
-		}
-		SPDK_DEBUGLOG(rpc, "recv() failed: %s\n", spdk_strerror(errno));
+	if (conn->recv_buf_size * 2 > SPDK_JSONRPC_RECV_BUF_SIZE_MAX) {
+		SPDK_ERRLOG("Request exceeded maximum size (%zu)\n",
+			    (size_t)SPDK_JSONRPC_RECV_BUF_SIZE_MAX);
 		return -1;
 	}
 
-	if (rc == 0) {
-		SPDK_DEBUGLOG(rpc, "remote closed connection\n");
-		conn->closed = true;
-		return 0;
+	new_buf = realloc(conn->recv_buf, conn->recv_buf_size * 2);
+	if (new_buf == NULL) {
+		SPDK_ERRLOG("Resizing recv_buf failed (current size %zu, new size %zu)\n",
+			    conn->recv_buf_size, conn->recv_buf_size * 2);
+		return -1;
 	}
 
-	conn->recv_len += rc;
+	conn->recv_buf = new_buf;
+	conn->recv_buf_size *= 2;
+
+	return 0;
+}
+
+static int
+jsonrpc_server_conn_parse(struct spdk_jsonrpc_server_conn *conn)
+{
+	ssize_t rc, offset;
 
 	offset = 0;
 	do {
@@ -313,6 +337,54 @@ jsonrpc_server_conn_recv(struct spdk_jsonrpc_server_conn *conn)
 	return 0;
 }
 
+static int
+jsonrpc_server_conn_recv(struct spdk_jsonrpc_server_conn *conn)
+{
+	ssize_t rc;
+	size_t recv_avail;
+	bool more;
+
+	/*
+	 * Keep receiving as long as the buffer gets filled up, so that requests pipelined by the
+	 * client don't have to wait for subsequent polls.
+	 */
+	do {
+		if (conn->recv_len == conn->recv_buf_size) {
+			/* Nothing could be parsed from a full buffer, so a single request
+			 * (e.g. a large batch) doesn't fit into it. */
+			if (jsonrpc_server_conn_recv_buf_expand(conn) != 0) {
+				return -1;
+			}
+		}
+
+		recv_avail = conn->recv_buf_size - conn->recv_len;
+		rc = recv(conn->sockfd, conn->recv_buf + conn->recv_len, recv_avail, 0);
+		if (rc == -1) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				return 0;
+			}
+			SPDK_DEBUGLOG(rpc, "recv() failed: %s\n", spdk_strerror(errno));
+			return -1;
+		}
+
+		if (rc == 0) {
+			SPDK_DEBUGLOG(rpc, "remote closed connection\n");
+			conn->closed = true;
+			return 0;
+		}
+
+		conn->recv_len += rc;
+		more = (size_t)rc == recv_avail;
+
+		rc = jsonrpc_server_conn_parse(conn);
+		if (rc != 0) {
+			return rc;
+		}
+	} while (more);
+
+	return 0;
+}
+
 void
 jsonrpc_server_send_response(struct spdk_jsonrpc_request *request)
 {
@@ -1664,8 +1664,9 @@ lvol_inflate_cb(void *cb_arg, int lvolerrno)
 	free(req);
 }
 
-void
-spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
+static void
+lvol_inflate_or_decouple(struct spdk_lvol *lvol, bool allocate_all, const struct spdk_bs_inflate_opts *opts,
+			 spdk_lvol_op_complete cb_fn, void *cb_arg)
 {
 	struct spdk_lvol_req *req;
 	spdk_blob_id blob_id;
@@ -1696,44 +1697,39 @@ spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_
 	}
 
 	blob_id = spdk_blob_get_id(lvol->blob);
-	spdk_bs_inflate_blob(lvol->lvol_store->blobstore, req->channel, blob_id, lvol_inflate_cb,
-			     req);
+	if (allocate_all) {
+		spdk_bs_inflate_blob_ext(lvol->lvol_store->blobstore, req->channel, blob_id, opts,
+					 lvol_inflate_cb, req);
+	} else {
+		spdk_bs_blob_decouple_parent_ext(lvol->lvol_store->blobstore, req->channel, blob_id, opts,
+						 lvol_inflate_cb, req);
+	}
 }
 
 void
-spdk_lvol_decouple_parent(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
+spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
 {
-	struct spdk_lvol_req *req;
-	spdk_blob_id blob_id;
-
-	assert(cb_fn != NULL);
-
-	if (lvol == NULL) {
-		SPDK_ERRLOG("Lvol does not exist\n");
-		cb_fn(cb_arg, -ENODEV);
-		return;
-	}
+	lvol_inflate_or_decouple(lvol, true, NULL, cb_fn, cb_arg);
+}
 
-	req = calloc(1, sizeof(*req));
-	if (!req) {
-		SPDK_ERRLOG("Cannot alloc memory for lvol request pointer\n");
-		cb_fn(cb_arg, -ENOMEM);
-		return;
-	}
+void
+spdk_lvol_inflate_ext(struct spdk_lvol *lvol, const struct spdk_bs_inflate_opts *opts,
+		      spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	lvol_inflate_or_decouple(lvol, true, opts, cb_fn, cb_arg);
+}
 
-	req->cb_fn = cb_fn;
-	req->cb_arg = cb_arg;
-	req->channel = spdk_bs_alloc_io_channel(lvol->lvol_store->blobstore);
-	if (req->channel == NULL) {
-		SPDK_ERRLOG("Cannot alloc io channel for lvol inflate request\n");
-		free(req);
-		cb_fn(cb_arg, -ENOMEM);
-		return;
-	}
+void
+spdk_lvol_decouple_parent(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	lvol_inflate_or_decouple(lvol, false, NULL, cb_fn, cb_arg);
+}
 
-	blob_id = spdk_blob_get_id(lvol->blob);
-	spdk_bs_blob_decouple_parent(lvol->lvol_store->blobstore, req->channel, blob_id,
-				     lvol_inflate_cb, req);
+void
+spdk_lvol_decouple_parent_ext(struct spdk_lvol *lvol, const struct spdk_bs_inflate_opts *opts,
+			      spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	lvol_inflate_or_decouple(lvol, false, opts, cb_fn, cb_arg);
 }
 
 static void
@@ -25,6 +25,11 @@
 #define NBD_STOP_BUSY_WAITING_MS	10000
 #define NBD_BUSY_POLLING_INTERVAL_US	20000
 #define NBD_IO_TIMEOUT_S		60
+#define NBD_MAX_CONNECTIONS		64
+/* Staging buffer used to pick up several request headers with a single read */
+#define NBD_RECV_BUF_SIZE		4096
+/* Max number of iovecs handed to a single writev() when transmitting responses */
+#define NBD_XMIT_IOVCNT			64
 
 enum nbd_io_state_t {
 	/* Receiving or ready to receive nbd request header */
@@ -37,8 +42,10 @@ enum nbd_io_state_t {
 	NBD_IO_XMIT_PAYLOAD,
 };
 
+struct nbd_conn;
+
 struct nbd_io {
-	struct spdk_nbd_disk	*nbd;
+	struct nbd_conn		*conn;
 	enum nbd_io_state_t	state;
 
 	void			*payload;
@@ -59,33 +66,66 @@ struct nbd_io {
 	TAILQ_ENTRY(nbd_io)	tailq;
 };
 
-struct spdk_nbd_disk {
-	struct spdk_bdev	*bdev;
-	struct spdk_bdev_desc	*bdev_desc;
+/*
+ * One socket handed to the kernel with NBD_SET_SOCK.  Everything below is
+ * only touched from the SPDK thread the connection is polled on, except for
+ * the fields explicitly marked as owned by the nbd disk thread.
+ */
+struct nbd_conn {
+	struct spdk_nbd_disk	*nbd;
+	uint32_t		idx;
+	struct spdk_thread	*thread;
 	struct spdk_io_channel	*ch;
-	int			dev_fd;
-	char			*nbd_path;
 	int			kernel_sp_fd;
 	int			spdk_sp_fd;
-	struct spdk_poller	*nbd_poller;
+	struct spdk_poller	*poller;
 	struct spdk_interrupt	*intr;
 	bool			interrupt_mode;
-	uint32_t		buf_align;
 
-	struct spdk_poller	*retry_poller;
-	int			retry_count;
-	/* Synchronize nbd_start_kernel pthread and nbd_stop */
-	bool			has_nbd_pthread;
+	/* No new requests are accepted from the socket */
+	bool			is_closing;
+	/* Socket returned an error, responses are dropped */
+	bool			is_failed;
+	/* Disk thread asked this connection to shut down */
+	bool			close_received;
+	bool			stop_requested;
+	bool			is_stopped;
 
 	struct nbd_io		*io_in_recv;
 	TAILQ_HEAD(, nbd_io)	received_io_list;
 	TAILQ_HEAD(, nbd_io)	executed_io_list;
 	TAILQ_HEAD(, nbd_io)	processing_io_list;
+	/* count of nbd_io in this connection */
+	int			io_count;
+
+	/* Request headers (and write payload) read ahead of io_in_recv */
+	uint32_t		rbuf_off;
+	uint32_t		rbuf_len;
+	uint8_t			rbuf[NBD_RECV_BUF_SIZE];
+};
+
+struct spdk_nbd_disk {
+	struct spdk_bdev	*bdev;
+	struct spdk_bdev_desc	*bdev_desc;
+	int			dev_fd;
+	char			*nbd_path;
+	uint32_t		buf_align;
+	/* Thread that started the disk, owns the bdev descriptor */
+	struct spdk_thread	*thread;
+
+	struct nbd_conn		*conns;
+	uint32_t		num_conns;
+	/* Connections that have not reported back from shutdown yet */
+	uint32_t		num_active_conns;
+
+	struct spdk_poller	*retry_poller;
+	int			retry_count;
+	/* Synchronize nbd_start_kernel pthread and nbd_stop */
+	bool			has_nbd_pthread;
 
 	bool			is_started;
 	bool			is_closing;
-	/* count of nbd_io in spdk_nbd_disk */
-	int			io_count;
+	bool			conns_closing;
 
 	TAILQ_ENTRY(spdk_nbd_disk)	tailq;
 };
@@ -100,8 +140,8 @@ static void *g_fini_cb_arg;
 
 static void _nbd_fini(void *arg1);
 
-static int nbd_submit_bdev_io(struct spdk_nbd_disk *nbd, struct nbd_io *io);
-static int nbd_io_recv_internal(struct spdk_nbd_disk *nbd);
+static int nbd_submit_bdev_io(struct nbd_conn *conn, struct nbd_io *io);
+static int nbd_io_recv_internal(struct nbd_conn *conn);
 
 int
 spdk_nbd_init(void)
@@ -210,6 +250,12 @@ nbd_disk_get_bdev_name(struct spdk_nbd_disk *nbd)
 	return spdk_bdev_get_name(nbd->bdev);
 }
 
+uint32_t
+nbd_disk_get_num_connections(struct spdk_nbd_disk *nbd)
+{
+	return nbd->num_conns;
+}
+
 void
 spdk_nbd_write_config_json(struct spdk_json_write_ctx *w)
 {
@@ -225,6 +271,7 @@ spdk_nbd_write_config_json(struct spdk_json_write_ctx *w)
 		spdk_json_write_named_object_begin(w, "params");
 		spdk_json_write_named_string(w, "nbd_device",  nbd_disk_get_nbd_path(nbd));
 		spdk_json_write_named_string(w, "bdev_name", nbd_disk_get_bdev_name(nbd));
+		spdk_json_write_named_uint32(w, "num_connections", nbd->num_conns);
 		spdk_json_write_object_end(w);
 
 		spdk_json_write_object_end(w);
@@ -245,7 +292,7 @@ nbd_disconnect(struct spdk_nbd_disk *nbd)
 }
 
 static struct nbd_io *
-nbd_get_io(struct spdk_nbd_disk *nbd)
+nbd_get_io(struct nbd_conn *conn)
 {
 	struct nbd_io *io;
 
@@ -254,23 +301,51 @@ nbd_get_io(struct spdk_nbd_disk *nbd)
 		return NULL;
 	}
 
-	io->nbd = nbd;
+	io->conn = conn;
 	to_be32(&io->resp.magic, NBD_REPLY_MAGIC);
 
-	nbd->io_count++;
+	conn->io_count++;
 
 	return io;
 }
 
 static void
-nbd_put_io(struct spdk_nbd_disk *nbd, struct nbd_io *io)
+nbd_put_io(struct nbd_conn *conn, struct nbd_io *io)
 {
 	if (io->payload) {
 		spdk_free(io->payload);
 	}
 	free(io);
 
-	nbd->io_count--;
+	conn->io_count--;
+}
+
+static void nbd_conn_stopped(void *arg);
+
+static void
+nbd_stop_msg(void *arg)
+{
+	struct spdk_nbd_disk *nbd = arg;
+
+	if (!nbd->is_closing) {
+		spdk_nbd_stop(nbd);
+	}
+}
+
+/*
+ * A connection cannot tear down the whole disk by itself, as the other
+ * connections are polled on different threads.  Ask the disk thread to
+ * close all of them instead.
+ */
+static void
+nbd_conn_request_stop(struct nbd_conn *conn)
+{
+	if (conn->stop_requested) {
+		return;
+	}
+
+	conn->stop_requested = true;
+	spdk_thread_send_msg(conn->nbd->thread, nbd_stop_msg, conn->nbd);
 }
 
 /*
@@ -281,49 +356,105 @@ nbd_put_io(struct spdk_nbd_disk *nbd, struct nbd_io *io)
  *         0 all nbd_io gotten are freed.
  */
 static int
-nbd_cleanup_io(struct spdk_nbd_disk *nbd)
+nbd_cleanup_io(struct nbd_conn *conn)
 {
 	/* Try to read the remaining nbd commands in the socket */
-	while (nbd_io_recv_internal(nbd) > 0);
+	if (!conn->is_failed) {
+		while (nbd_io_recv_internal(conn) > 0);
+	}
 
 	/* free io_in_recv */
-	if (nbd->io_in_recv != NULL) {
-		nbd_put_io(nbd, nbd->io_in_recv);
-		nbd->io_in_recv = NULL;
+	if (conn->io_in_recv != NULL) {
+		nbd_put_io(conn, conn->io_in_recv);
+		conn->io_in_recv = NULL;
 	}
 
 	/*
 	 * Some nbd_io may be under executing in bdev.
 	 * Wait for their done operation.
 	 */
-	if (nbd->io_count != 0) {
+	if (conn->io_count != 0) {
 		return 1;
 	}
 
 	return 0;
 }
 
-static int
-_nbd_stop(void *arg)
+static void
+nbd_conn_stop(struct nbd_conn *conn)
 {
-	struct spdk_nbd_disk *nbd = arg;
+	if (conn->is_stopped) {
+		return;
+	}
+
+	conn->is_stopped = true;
+
+	if (conn->poller) {
+		spdk_poller_unregister(&conn->poller);
+	}
 
-	if (nbd->nbd_poller) {
-		spdk_poller_unregister(&nbd->nbd_poller);
+	if (conn->intr) {
+		spdk_interrupt_unregister(&conn->intr);
 	}
 
-	if (nbd->intr) {
-		spdk_interrupt_unregister(&nbd->intr);
+	if (conn->spdk_sp_fd >= 0) {
+		close(conn->spdk_sp_fd);
+		conn->spdk_sp_fd = -1;
 	}
 
-	if (nbd->spdk_sp_fd >= 0) {
-		close(nbd->spdk_sp_fd);
-		nbd->spdk_sp_fd = -1;
+	if (conn->kernel_sp_fd >= 0) {
+		close(conn->kernel_sp_fd);
+		conn->kernel_sp_fd = -1;
 	}
 
-	if (nbd->kernel_sp_fd >= 0) {
-		close(nbd->kernel_sp_fd);
-		nbd->kernel_sp_fd = -1;
+	if (conn->ch) {
+		spdk_put_io_channel(conn->ch);
+		conn->ch = NULL;
+	}
+
+	spdk_thread_send_msg(conn->nbd->thread, nbd_conn_stopped, conn);
+}
+
+static void
+nbd_conn_close(void *arg)
+{
+	struct nbd_conn *conn = arg;
+
+	conn->close_received = true;
+	conn->is_closing = true;
+
+	/* Stop action should be called only after all nbd_io are executed. */
+	if (!nbd_cleanup_io(conn)) {
+		nbd_conn_stop(conn);
+	}
+}
+
+static void
+nbd_conn_thread_exit(void *arg)
+{
+	spdk_thread_exit(spdk_get_thread());
+}
+
+static int
+_nbd_stop(void *arg)
+{
+	struct spdk_nbd_disk *nbd = arg;
+	struct nbd_conn *conn;
+	uint32_t i;
+
+	/* Connections that were never started still own their sockets */
+	for (i = 0; i < nbd->num_conns; i++) {
+		conn = &nbd->conns[i];
+
+		if (conn->spdk_sp_fd >= 0) {
+			close(conn->spdk_sp_fd);
+			conn->spdk_sp_fd = -1;
+		}
+
+		if (conn->kernel_sp_fd >= 0) {
+			close(conn->kernel_sp_fd);
+			conn->kernel_sp_fd = -1;
+		}
 	}
 
 	/* Continue the stop procedure after the exit of nbd_start_kernel pthread */
@@ -359,11 +490,17 @@ _nbd_stop(void *arg)
 		free(nbd->nbd_path);
 	}
 
-	if (nbd->ch) {
-		spdk_put_io_channel(nbd->ch);
-		nbd->ch = NULL;
+	/* All connections have reported back, nothing references their threads anymore */
+	for (i = 0; i < nbd->num_conns; i++) {
+		conn = &nbd->conns[i];
+
+		if (conn->thread != NULL && conn->thread != nbd->thread) {
+			spdk_thread_send_msg(conn->thread, nbd_conn_thread_exit, NULL);
+		}
 	}
 
+	free(nbd->conns);
+
 	if (nbd->bdev_desc) {
 		spdk_bdev_close(nbd->bdev_desc);
 		nbd->bdev_desc = NULL;
@@ -376,13 +513,25 @@ _nbd_stop(void *arg)
 	return 0;
 }
 
+static void
+nbd_conn_stopped(void *arg)
+{
+	struct nbd_conn *conn = arg;
+	struct spdk_nbd_disk *nbd = conn->nbd;
+
+	assert(nbd->num_active_conns > 0);
+	if (--nbd->num_active_conns == 0) {
+		_nbd_stop(nbd);
+	}
+}
+
 int
 spdk_nbd_stop(struct spdk_nbd_disk *nbd)
 {
-	int rc = 0;
+	uint32_t i;
 
 	if (nbd == NULL) {
-		return rc;
+		return 0;
 	}
 
 	nbd->is_closing = true;
@@ -393,26 +542,28 @@ spdk_nbd_stop(struct spdk_nbd_disk *nbd)
 	}
 
 	/*
-	 * Stop action should be called only after all nbd_io are executed.
+	 * Each connection stops after all of its nbd_io are executed and reports
+	 * back to this thread. The disk is freed once the last one is gone.
 	 */
-
-	rc = nbd_cleanup_io(nbd);
-	if (!rc) {
-		_nbd_stop(nbd);
+	if (!nbd->conns_closing) {
+		nbd->conns_closing = true;
+		for (i = 0; i < nbd->num_conns; i++) {
+			spdk_thread_send_msg(nbd->conns[i].thread, nbd_conn_close, &nbd->conns[i]);
+		}
 	}
 
-	return rc;
+	return 1;
 }
 
 static int64_t
-nbd_socket_rw(int fd, void *buf, size_t length, bool read_op)
+nbd_socket_rwv(int fd, struct iovec *iov, int iovcnt, bool read_op)
 {
 	ssize_t rc;
 
 	if (read_op) {
-		rc = read(fd, buf, length);
+		rc = readv(fd, iov, iovcnt);
 	} else {
-		rc = write(fd, buf, length);
+		rc = writev(fd, iov, iovcnt);
 	}
 
 	if (rc == 0) {
@@ -431,7 +582,7 @@ static void
 nbd_io_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 {
 	struct nbd_io	*io = cb_arg;
-	struct spdk_nbd_disk *nbd = io->nbd;
+	struct nbd_conn *conn = io->conn;
 
 	if (success) {
 		io->resp.error = 0;
@@ -444,12 +595,12 @@ nbd_io_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	/* When there begins to have executed_io, enable socket writable notice in order to
 	 * get it processed in nbd_io_xmit
 	 */
-	if (nbd->interrupt_mode && TAILQ_EMPTY(&nbd->executed_io_list)) {
-		spdk_interrupt_set_event_types(nbd->intr, SPDK_INTERRUPT_EVENT_IN | SPDK_INTERRUPT_EVENT_OUT);
+	if (conn->interrupt_mode && TAILQ_EMPTY(&conn->executed_io_list)) {
+		spdk_interrupt_set_event_types(conn->intr, SPDK_INTERRUPT_EVENT_IN | SPDK_INTERRUPT_EVENT_OUT);
 	}
 
-	TAILQ_REMOVE(&nbd->processing_io_list, io, tailq);
-	TAILQ_INSERT_TAIL(&nbd->executed_io_list, io, tailq);
+	TAILQ_REMOVE(&conn->processing_io_list, io, tailq);
+	TAILQ_INSERT_TAIL(&conn->executed_io_list, io, tailq);
 
 	if (bdev_io != NULL) {
 		spdk_bdev_free_io(bdev_io);
@@ -460,13 +611,13 @@ static void
 nbd_resubmit_io(void *arg)
 {
 	struct nbd_io *io = (struct nbd_io *)arg;
-	struct spdk_nbd_disk *nbd = io->nbd;
+	struct nbd_conn *conn = io->conn;
 	int rc = 0;
 
-	rc = nbd_submit_bdev_io(nbd, io);
+	rc = nbd_submit_bdev_io(conn, io);
 	if (rc) {
 		SPDK_INFOLOG(nbd, "nbd: io resubmit for dev %s , io_type %d, returned %d.\n",
-			     nbd_disk_get_bdev_name(nbd), from_be32(&io->req.type), rc);
+			     nbd_disk_get_bdev_name(conn->nbd), from_be32(&io->req.type), rc);
 	}
 }
 
@@ -474,13 +625,13 @@ static void
 nbd_queue_io(struct nbd_io *io)
 {
 	int rc;
-	struct spdk_bdev *bdev = io->nbd->bdev;
+	struct spdk_bdev *bdev = io->conn->nbd->bdev;
 
 	io->bdev_io_wait.bdev = bdev;
 	io->bdev_io_wait.cb_fn = nbd_resubmit_io;
 	io->bdev_io_wait.cb_arg = io;
 
-	rc = spdk_bdev_queue_io_wait(bdev, io->nbd->ch, &io->bdev_io_wait);
+	rc = spdk_bdev_queue_io_wait(bdev, io->conn->ch, &io->bdev_io_wait);
 	if (rc != 0) {
 		SPDK_ERRLOG("Queue io failed in nbd_queue_io, rc=%d.\n", rc);
 		nbd_io_done(NULL, false, io);
@@ -488,10 +639,11 @@ nbd_queue_io(struct nbd_io *io)
 }
 
 static int
-nbd_submit_bdev_io(struct spdk_nbd_disk *nbd, struct nbd_io *io)
+nbd_submit_bdev_io(struct nbd_conn *conn, struct nbd_io *io)
 {
+	struct spdk_nbd_disk *nbd = conn->nbd;
 	struct spdk_bdev_desc *desc = nbd->bdev_desc;
-	struct spdk_io_channel *ch = nbd->ch;
+	struct spdk_io_channel *ch = conn->ch;
 	int rc = 0;
 
 	switch (from_be32(&io->req.type)) {
@@ -534,16 +686,16 @@ nbd_submit_bdev_io(struct spdk_nbd_disk *nbd, struct nbd_io *io)
 }
 
 static int
-nbd_io_exec(struct spdk_nbd_disk *nbd)
+nbd_io_exec(struct nbd_conn *conn)
 {
 	struct nbd_io *io, *io_tmp;
 	int io_count = 0;
 	int ret = 0;
 
-	TAILQ_FOREACH_SAFE(io, &nbd->received_io_list, tailq, io_tmp) {
-		TAILQ_REMOVE(&nbd->received_io_list, io, tailq);
-		TAILQ_INSERT_TAIL(&nbd->processing_io_list, io, tailq);
-		ret = nbd_submit_bdev_io(nbd, io);
+	TAILQ_FOREACH_SAFE(io, &conn->received_io_list, tailq, io_tmp) {
+		TAILQ_REMOVE(&conn->received_io_list, io, tailq);
+		TAILQ_INSERT_TAIL(&conn->processing_io_list, io, tailq);
+		ret = nbd_submit_bdev_io(conn, io);
 		if (ret < 0) {
 			return ret;
 		}
@@ -554,143 +706,201 @@ nbd_io_exec(struct spdk_nbd_disk *nbd)
 	return io_count;
 }
 
+/* Request (and its payload, if any) is fully received */
+static void
+nbd_io_received(struct nbd_conn *conn, struct nbd_io *io)
+{
+	io->offset = 0;
+	io->state = NBD_IO_XMIT_RESP;
+	if (spdk_likely(!conn->is_closing)) {
+		TAILQ_INSERT_TAIL(&conn->received_io_list, io, tailq);
+	} else {
+		TAILQ_INSERT_TAIL(&conn->processing_io_list, io, tailq);
+		nbd_io_done(NULL, false, io);
+	}
+	conn->io_in_recv = NULL;
+}
+
 static int
-nbd_io_recv_internal(struct spdk_nbd_disk *nbd)
+nbd_io_recv_req_done(struct nbd_conn *conn, struct nbd_io *io)
 {
-	struct nbd_io *io;
-	int ret = 0;
-	int received = 0;
+	io->offset = 0;
 
-	if (nbd->io_in_recv == NULL) {
-		nbd->io_in_recv = nbd_get_io(nbd);
-		if (!nbd->io_in_recv) {
-			return -ENOMEM;
+	/* req magic check */
+	if (from_be32(&io->req.magic) != NBD_REQUEST_MAGIC) {
+		SPDK_ERRLOG("invalid request magic\n");
+		nbd_put_io(conn, io);
+		conn->io_in_recv = NULL;
+		return -EINVAL;
+	}
+
+	if (from_be32(&io->req.type) == NBD_CMD_DISC) {
+		conn->is_closing = true;
+		conn->io_in_recv = NULL;
+		if (conn->interrupt_mode && TAILQ_EMPTY(&conn->executed_io_list)) {
+			spdk_interrupt_set_event_types(conn->intr, SPDK_INTERRUPT_EVENT_IN | SPDK_INTERRUPT_EVENT_OUT);
 		}
+		nbd_put_io(conn, io);
+		nbd_conn_request_stop(conn);
+		/* After receiving NBD_CMD_DISC, nbd will not receive any new commands */
+		conn->rbuf_off = conn->rbuf_len;
+		return 0;
 	}
 
-	io = nbd->io_in_recv;
+	/* io except read/write should ignore payload */
+	if (from_be32(&io->req.type) == NBD_CMD_WRITE ||
+	    from_be32(&io->req.type) == NBD_CMD_READ) {
+		io->payload_size = from_be32(&io->req.len);
+	} else {
+		io->payload_size = 0;
+	}
 
-	if (io->state == NBD_IO_RECV_REQ) {
-		ret = nbd_socket_rw(nbd->spdk_sp_fd, (char *)&io->req + io->offset,
-				    sizeof(io->req) - io->offset, true);
-		if (ret < 0) {
-			nbd_put_io(nbd, io);
-			nbd->io_in_recv = NULL;
-			return ret;
+	/* io payload allocate */
+	if (io->payload_size) {
+		io->payload = spdk_malloc(io->payload_size, conn->nbd->buf_align, NULL,
+					  SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
+		if (io->payload == NULL) {
+			SPDK_ERRLOG("could not allocate io->payload of size %d\n", io->payload_size);
+			nbd_put_io(conn, io);
+			conn->io_in_recv = NULL;
+			return -ENOMEM;
 		}
+	} else {
+		io->payload = NULL;
+	}
 
-		io->offset += ret;
-		received = ret;
+	/* next io step */
+	if (from_be32(&io->req.type) == NBD_CMD_WRITE) {
+		io->state = NBD_IO_RECV_PAYLOAD;
+	} else {
+		nbd_io_received(conn, io);
+	}
 
-		/* request is fully received */
-		if (io->offset == sizeof(io->req)) {
-			io->offset = 0;
+	return 0;
+}
 
-			/* req magic check */
-			if (from_be32(&io->req.magic) != NBD_REQUEST_MAGIC) {
-				SPDK_ERRLOG("invalid request magic\n");
-				nbd_put_io(nbd, io);
-				nbd->io_in_recv = NULL;
-				return -EINVAL;
-			}
+/*
+ * Hand out the bytes picked up in the receive buffer to the requests they
+ * belong to: request headers are copied into nbd_io, the beginning of a
+ * write payload is copied into its data buffer.
+ */
+static int
+nbd_io_recv_parse(struct nbd_conn *conn)
+{
+	struct nbd_io *io;
+	uint32_t len;
+	int rc;
 
-			if (from_be32(&io->req.type) == NBD_CMD_DISC) {
-				nbd->is_closing = true;
-				nbd->io_in_recv = NULL;
-				if (nbd->interrupt_mode && TAILQ_EMPTY(&nbd->executed_io_list)) {
-					spdk_interrupt_set_event_types(nbd->intr, SPDK_INTERRUPT_EVENT_IN | SPDK_INTERRUPT_EVENT_OUT);
-				}
-				nbd_put_io(nbd, io);
-				/* After receiving NBD_CMD_DISC, nbd will not receive any new commands */
-				return received;
+	while (conn->rbuf_off < conn->rbuf_len) {
+		if (conn->io_in_recv == NULL) {
+			conn->io_in_recv = nbd_get_io(conn);
+			if (!conn->io_in_recv) {
+				return -ENOMEM;
 			}
+		}
 
-			/* io except read/write should ignore payload */
-			if (from_be32(&io->req.type) == NBD_CMD_WRITE ||
-			    from_be32(&io->req.type) == NBD_CMD_READ) {
-				io->payload_size = from_be32(&io->req.len);
-			} else {
-				io->payload_size = 0;
-			}
+		io = conn->io_in_recv;
 
-			/* io payload allocate */
-			if (io->payload_size) {
-				io->payload = spdk_malloc(io->payload_size, nbd->buf_align, NULL,
-							  SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
-				if (io->payload == NULL) {
-					SPDK_ERRLOG("could not allocate io->payload of size %d\n", io->payload_size);
-					nbd_put_io(nbd, io);
-					nbd->io_in_recv = NULL;
-					return -ENOMEM;
-				}
-			} else {
-				io->payload = NULL;
-			}
+		if (io->state == NBD_IO_RECV_REQ) {
+			len = spdk_min(conn->rbuf_len - conn->rbuf_off, sizeof(io->req) - io->offset);
+			memcpy((char *)&io->req + io->offset, &conn->rbuf[conn->rbuf_off], len);
+			conn->rbuf_off += len;
+			io->offset += len;
 
-			/* next io step */
-			if (from_be32(&io->req.type) == NBD_CMD_WRITE) {
-				io->state = NBD_IO_RECV_PAYLOAD;
-			} else {
-				io->state = NBD_IO_XMIT_RESP;
-				if (spdk_likely((!nbd->is_closing) && nbd->is_started)) {
-					TAILQ_INSERT_TAIL(&nbd->received_io_list, io, tailq);
-				} else {
-					TAILQ_INSERT_TAIL(&nbd->processing_io_list, io, tailq);
-					nbd_io_done(NULL, false, io);
+			if (io->offset == sizeof(io->req)) {
+				rc = nbd_io_recv_req_done(conn, io);
+				if (rc < 0) {
+					return rc;
 				}
-				nbd->io_in_recv = NULL;
+			}
+		} else {
+			assert(io->state == NBD_IO_RECV_PAYLOAD);
+			len = spdk_min(conn->rbuf_len - conn->rbuf_off, io->payload_size - io->offset);
+			memcpy((char *)io->payload + io->offset, &conn->rbuf[conn->rbuf_off], len);
+			conn->rbuf_off += len;
+			io->offset += len;
+
+			if (io->offset == io->payload_size) {
+				nbd_io_received(conn, io);
 			}
 		}
 	}
 
-	if (io->state == NBD_IO_RECV_PAYLOAD) {
-		ret = nbd_socket_rw(nbd->spdk_sp_fd, io->payload + io->offset, io->payload_size - io->offset, true);
-		if (ret < 0) {
-			nbd_put_io(nbd, io);
-			nbd->io_in_recv = NULL;
-			return ret;
-		}
+	return 0;
+}
 
-		io->offset += ret;
-		received += ret;
+static int
+nbd_io_recv_internal(struct nbd_conn *conn)
+{
+	struct nbd_io *io = conn->io_in_recv;
+	struct iovec iov[2];
+	int iovcnt = 0;
+	int64_t ret;
+	uint32_t len;
+	int rc;
 
-		/* request payload is fully received */
+	/*
+	 * Remaining write payload is read in place, whatever follows it lands in
+	 * the receive buffer so that a batch of small requests costs one syscall.
+	 */
+	if (io != NULL && io->state == NBD_IO_RECV_PAYLOAD) {
+		iov[iovcnt].iov_base = (char *)io->payload + io->offset;
+		iov[iovcnt].iov_len = io->payload_size - io->offset;
+		iovcnt++;
+	}
+	iov[iovcnt].iov_base = conn->rbuf;
+	iov[iovcnt].iov_len = sizeof(conn->rbuf);
+	iovcnt++;
+
+	ret = nbd_socket_rwv(conn->spdk_sp_fd, iov, iovcnt, true);
+	if (ret < 0) {
+		if (io != NULL) {
+			nbd_put_io(conn, io);
+			conn->io_in_recv = NULL;
+		}
+		return ret;
+	}
+
+	len = ret;
+	if (iovcnt == 2) {
+		len = spdk_min(len, iov[0].iov_len);
+		io->offset += len;
 		if (io->offset == io->payload_size) {
-			io->offset = 0;
-			io->state = NBD_IO_XMIT_RESP;
-			if (spdk_likely((!nbd->is_closing) && nbd->is_started)) {
-				TAILQ_INSERT_TAIL(&nbd->received_io_list, io, tailq);
-			} else {
-				TAILQ_INSERT_TAIL(&nbd->processing_io_list, io, tailq);
-				nbd_io_done(NULL, false, io);
-			}
-			nbd->io_in_recv = NULL;
+			nbd_io_received(conn, io);
 		}
+		len = ret - len;
+	}
+
+	conn->rbuf_off = 0;
+	conn->rbuf_len = len;
 
+	rc = nbd_io_recv_parse(conn);
+	if (rc < 0) {
+		return rc;
 	}
 
-	return received;
+	return ret;
 }
 
 static int
-nbd_io_recv(struct spdk_nbd_disk *nbd)
+nbd_io_recv(struct nbd_conn *conn)
 {
 	int i, rc, ret = 0;
 
 	/*
 	 * nbd server should not accept request after closing command
 	 */
-	if (nbd->is_closing) {
+	if (conn->is_closing) {
 		return 0;
 	}
 
 	for (i = 0; i < GET_IO_LOOP_COUNT; i++) {
-		rc = nbd_io_recv_internal(nbd);
+		rc = nbd_io_recv_internal(conn);
 		if (rc < 0) {
 			return rc;
 		}
 		ret += rc;
-		if (nbd->is_closing) {
+		if (rc == 0 || conn->is_closing) {
 			break;
 		}
 	}
@@ -698,117 +908,158 @@ nbd_io_recv(struct spdk_nbd_disk *nbd)
 	return ret;
 }
 
+/*
+ * Transmit responses of executed nbd_io, gathering the response headers and
+ * read payloads of as many of them as possible into a single writev().
+ */
 static int
-nbd_io_xmit_internal(struct spdk_nbd_disk *nbd)
+nbd_io_xmit_internal(struct nbd_conn *conn)
 {
+	struct iovec iov[NBD_XMIT_IOVCNT];
 	struct nbd_io *io;
-	int ret = 0;
-	int sent = 0;
+	int iovcnt = 0;
+	int64_t ret;
+	uint64_t sent, len;
+
+	TAILQ_FOREACH(io, &conn->executed_io_list, tailq) {
+		/* resp error and handler are already set in io_done */
+		if (io->state == NBD_IO_XMIT_RESP) {
+			if (iovcnt == NBD_XMIT_IOVCNT) {
+				break;
+			}
+			iov[iovcnt].iov_base = (char *)&io->resp + io->offset;
+			iov[iovcnt].iov_len = sizeof(io->resp) - io->offset;
+			iovcnt++;
+
+			/* transmit payload only when NBD_CMD_READ with no resp error */
+			if (from_be32(&io->req.type) != NBD_CMD_READ || io->resp.error != 0) {
+				continue;
+			}
+			if (iovcnt == NBD_XMIT_IOVCNT) {
+				break;
+			}
+			iov[iovcnt].iov_base = io->payload;
+			iov[iovcnt].iov_len = io->payload_size;
+			iovcnt++;
+		} else {
+			assert(io->state == NBD_IO_XMIT_PAYLOAD);
+			if (iovcnt == NBD_XMIT_IOVCNT) {
+				break;
+			}
+			iov[iovcnt].iov_base = (char *)io->payload + io->offset;
+			iov[iovcnt].iov_len = io->payload_size - io->offset;
+			iovcnt++;
+		}
+	}
 
-	io = TAILQ_FIRST(&nbd->executed_io_list);
-	if (io == NULL) {
+	if (iovcnt == 0) {
 		return 0;
 	}
 
-	/* Remove IO from list now assuming it will be completed.  It will be inserted
-	 *  back to the head if it cannot be completed.  This approach is specifically
-	 *  taken to work around a scan-build use-after-free mischaracterization.
-	 */
-	TAILQ_REMOVE(&nbd->executed_io_list, io, tailq);
+	ret = nbd_socket_rwv(conn->spdk_sp_fd, iov, iovcnt, false);
+	if (ret <= 0) {
+		return ret;
+	}
 
-	/* resp error and handler are already set in io_done */
+	/* Walk the list again and account the transmitted bytes */
+	sent = ret;
+	while (sent > 0) {
+		io = TAILQ_FIRST(&conn->executed_io_list);
+		assert(io != NULL);
 
-	if (io->state == NBD_IO_XMIT_RESP) {
-		ret = nbd_socket_rw(nbd->spdk_sp_fd, (char *)&io->resp + io->offset,
-				    sizeof(io->resp) - io->offset, false);
-		if (ret <= 0) {
-			goto reinsert;
-		}
+		if (io->state == NBD_IO_XMIT_RESP) {
+			len = spdk_min(sent, sizeof(io->resp) - io->offset);
+			io->offset += len;
+			sent -= len;
 
-		io->offset += ret;
-		sent = ret;
+			/* response is not fully transmitted */
+			if (io->offset < sizeof(io->resp)) {
+				break;
+			}
 
-		/* response is fully transmitted */
-		if (io->offset == sizeof(io->resp)) {
 			io->offset = 0;
-
-			/* transmit payload only when NBD_CMD_READ with no resp error */
 			if (from_be32(&io->req.type) != NBD_CMD_READ || io->resp.error != 0) {
-				nbd_put_io(nbd, io);
-				return 0;
-			} else {
-				io->state = NBD_IO_XMIT_PAYLOAD;
+				TAILQ_REMOVE(&conn->executed_io_list, io, tailq);
+				nbd_put_io(conn, io);
+				continue;
 			}
+			io->state = NBD_IO_XMIT_PAYLOAD;
 		}
-	}
 
-	if (io->state == NBD_IO_XMIT_PAYLOAD) {
-		ret = nbd_socket_rw(nbd->spdk_sp_fd, io->payload + io->offset, io->payload_size - io->offset,
-				    false);
-		if (ret <= 0) {
-			goto reinsert;
-		}
-
-		io->offset += ret;
-		sent += ret;
+		len = spdk_min(sent, io->payload_size - io->offset);
+		io->offset += len;
+		sent -= len;
 
 		/* read payload is fully transmitted */
 		if (io->offset == io->payload_size) {
-			nbd_put_io(nbd, io);
-			return sent;
+			TAILQ_REMOVE(&conn->executed_io_list, io, tailq);
+			nbd_put_io(conn, io);
 		}
 	}
 
-reinsert:
-	TAILQ_INSERT_HEAD(&nbd->executed_io_list, io, tailq);
-	return ret < 0 ? ret : sent;
+	return ret;
 }
 
 static int
-nbd_io_xmit(struct spdk_nbd_disk *nbd)
+nbd_io_xmit(struct nbd_conn *conn)
 {
 	int ret = 0;
 	int rc;
 
-	while (!TAILQ_EMPTY(&nbd->executed_io_list)) {
-		rc = nbd_io_xmit_internal(nbd);
+	while (!TAILQ_EMPTY(&conn->executed_io_list)) {
+		rc = nbd_io_xmit_internal(conn);
 		if (rc < 0) {
 			return rc;
 		}
+		if (rc == 0) {
+			break;
+		}
 
 		ret += rc;
 	}
 
 	/* When there begins to have no executed_io, disable socket writable notice */
-	if (nbd->interrupt_mode) {
-		spdk_interrupt_set_event_types(nbd->intr, SPDK_INTERRUPT_EVENT_IN);
+	if (conn->interrupt_mode && TAILQ_EMPTY(&conn->executed_io_list)) {
+		spdk_interrupt_set_event_types(conn->intr, SPDK_INTERRUPT_EVENT_IN);
 	}
 
 	return ret;
 }
 
+/* Socket is gone, responses for nbd_io still in bdev are simply dropped */
+static void
+nbd_io_drop_executed(struct nbd_conn *conn)
+{
+	struct nbd_io *io, *io_tmp;
+
+	TAILQ_FOREACH_SAFE(io, &conn->executed_io_list, tailq, io_tmp) {
+		TAILQ_REMOVE(&conn->executed_io_list, io, tailq);
+		nbd_put_io(conn, io);
+	}
+}
+
 /**
- * Poll an NBD instance.
+ * Poll an NBD connection.
  *
  * \return 0 on success or negated errno values on error (e.g. connection closed).
  */
 static int
-_nbd_poll(struct spdk_nbd_disk *nbd)
+_nbd_poll(struct nbd_conn *conn)
 {
 	int received, sent, executed;
 
 	/* transmit executed io first */
-	sent = nbd_io_xmit(nbd);
+	sent = nbd_io_xmit(conn);
 	if (sent < 0) {
 		return sent;
 	}
 
-	received = nbd_io_recv(nbd);
+	received = nbd_io_recv(conn);
 	if (received < 0) {
 		return received;
 	}
 
-	executed = nbd_io_exec(nbd);
+	executed = nbd_io_exec(conn);
 	if (executed < 0) {
 		return executed;
 	}
@@ -819,18 +1070,27 @@ _nbd_poll(struct spdk_nbd_disk *nbd)
 static int
 nbd_poll(void *arg)
 {
-	struct spdk_nbd_disk *nbd = arg;
+	struct nbd_conn *conn = arg;
 	int rc;
 
-	rc = _nbd_poll(nbd);
-	if (rc < 0) {
-		SPDK_INFOLOG(nbd, "nbd_poll() returned %s (%d); closing connection\n",
-			     spdk_strerror(-rc), rc);
-		_nbd_stop(nbd);
-		return SPDK_POLLER_IDLE;
+	if (spdk_unlikely(conn->is_failed)) {
+		nbd_io_drop_executed(conn);
+		rc = 0;
+	} else {
+		rc = _nbd_poll(conn);
+		if (rc < 0) {
+			SPDK_INFOLOG(nbd, "nbd_poll() returned %s (%d); closing connection %u of %s\n",
+				     spdk_strerror(-rc), rc, conn->idx, conn->nbd->nbd_path);
+			conn->is_failed = true;
+			conn->is_closing = true;
+			nbd_io_drop_executed(conn);
+			nbd_conn_request_stop(conn);
+			rc = 0;
+		}
 	}
-	if (nbd->is_closing && nbd->io_count == 0) {
-		spdk_nbd_stop(nbd);
+
+	if (conn->close_received && conn->io_count == 0) {
+		nbd_conn_stop(conn);
 	}
 
 	return rc == 0 ? SPDK_POLLER_IDLE : SPDK_POLLER_BUSY;
@@ -841,19 +1101,63 @@ struct spdk_nbd_start_ctx {
 	spdk_nbd_start_cb	cb_fn;
 	void			*cb_arg;
 	struct spdk_thread	*thread;
+	/* Next connection to hand to the kernel with NBD_SET_SOCK */
+	uint32_t		next_sock;
 };
 
+static void
+nbd_poller_set_interrupt_mode(struct spdk_poller *poller, void *cb_arg, bool interrupt_mode)
+{
+	struct nbd_conn *conn = cb_arg;
+
+	conn->interrupt_mode = interrupt_mode;
+}
+
+static void
+nbd_conn_start(void *arg)
+{
+	struct nbd_conn *conn = arg;
+
+	conn->ch = spdk_bdev_get_io_channel(conn->nbd->bdev_desc);
+	if (conn->ch == NULL) {
+		SPDK_ERRLOG("could not get io channel for connection %u of %s\n",
+			    conn->idx, conn->nbd->nbd_path);
+		conn->is_failed = true;
+		conn->is_closing = true;
+		nbd_conn_request_stop(conn);
+		return;
+	}
+
+	if (spdk_interrupt_mode_is_enabled()) {
+		conn->intr = SPDK_INTERRUPT_REGISTER(conn->spdk_sp_fd, nbd_poll, conn);
+	}
+
+	conn->poller = SPDK_POLLER_REGISTER(nbd_poll, conn, 0);
+	spdk_poller_register_interrupt(conn->poller, nbd_poller_set_interrupt_mode, conn);
+}
+
 static void
 nbd_start_complete(void *arg)
 {
 	struct spdk_nbd_start_ctx *ctx = arg;
+	struct spdk_nbd_disk *nbd = ctx->nbd;
+	uint32_t i;
+
+	/* Connections start polling only now, so no request is seen before the disk is started */
+	nbd->num_active_conns = nbd->num_conns;
+	for (i = 0; i < nbd->num_conns; i++) {
+		spdk_thread_send_msg(nbd->conns[i].thread, nbd_conn_start, &nbd->conns[i]);
+	}
 
 	if (ctx->cb_fn) {
-		ctx->cb_fn(ctx->cb_arg, ctx->nbd, 0);
+		ctx->cb_fn(ctx->cb_arg, nbd, 0);
 	}
 
 	/* nbd will possibly receive stop command while initing */
-	ctx->nbd->is_started = true;
+	nbd->is_started = true;
+	if (nbd->is_closing) {
+		spdk_nbd_stop(nbd);
+	}
 
 	free(ctx);
 }
@@ -872,7 +1176,7 @@ nbd_start_kernel(void *arg)
 	 */
 	spdk_thread_send_msg(ctx->thread, nbd_start_complete, ctx);
 
-	/* This will block in the kernel until we close the spdk_sp_fd. */
+	/* This will block in the kernel until we close all the spdk_sp_fd. */
 	ioctl(nbd->dev_fd, NBD_DO_IT);
 
 	nbd->has_nbd_pthread = false;
@@ -883,15 +1187,7 @@ nbd_start_kernel(void *arg)
 static void
 nbd_bdev_hot_remove(struct spdk_nbd_disk *nbd)
 {
-	struct nbd_io *io, *io_tmp;
-
-	nbd->is_closing = true;
-	nbd_cleanup_io(nbd);
-
-	TAILQ_FOREACH_SAFE(io, &nbd->received_io_list, tailq, io_tmp) {
-		TAILQ_REMOVE(&nbd->received_io_list, io, tailq);
-		nbd_io_done(NULL, false, io);
-	}
+	spdk_nbd_stop(nbd);
 }
 
 static void
@@ -908,14 +1204,6 @@ nbd_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev,
 	}
 }
 
-static void
-nbd_poller_set_interrupt_mode(struct spdk_poller *poller, void *cb_arg, bool interrupt_mode)
-{
-	struct spdk_nbd_disk *nbd = cb_arg;
-
-	nbd->interrupt_mode = interrupt_mode;
-}
-
 static void
 nbd_start_continue(struct spdk_nbd_start_ctx *ctx)
 {
@@ -958,6 +1246,12 @@ nbd_start_continue(struct spdk_nbd_start_ctx *ctx)
 		nbd_flags |= NBD_FLAG_SEND_TRIM;
 	}
 #endif
+#ifdef NBD_FLAG_CAN_MULTI_CONN
+	/* All connections go to the same bdev, so a flush on one covers writes done on others */
+	if (ctx->nbd->num_conns > 1) {
+		nbd_flags |= NBD_FLAG_CAN_MULTI_CONN;
+	}
+#endif
 
 	if (nbd_flags) {
 		rc = ioctl(ctx->nbd->dev_fd, NBD_SET_FLAGS, nbd_flags);
@@ -984,12 +1278,6 @@ nbd_start_continue(struct spdk_nbd_start_ctx *ctx)
 		goto err;
 	}
 
-	if (spdk_interrupt_mode_is_enabled()) {
-		ctx->nbd->intr = SPDK_INTERRUPT_REGISTER(ctx->nbd->spdk_sp_fd, nbd_poll, ctx->nbd);
-	}
-
-	ctx->nbd->nbd_poller = SPDK_POLLER_REGISTER(nbd_poll, ctx->nbd, 0);
-	spdk_poller_register_interrupt(ctx->nbd->nbd_poller, nbd_poller_set_interrupt_mode, ctx->nbd);
 	return;
 
 err:
@@ -1004,44 +1292,50 @@ static int
 nbd_enable_kernel(void *arg)
 {
 	struct spdk_nbd_start_ctx *ctx = arg;
+	struct spdk_nbd_disk *nbd = ctx->nbd;
 	int rc;
 
-	/* Declare device setup by this process */
-	rc = ioctl(ctx->nbd->dev_fd, NBD_SET_SOCK, ctx->nbd->kernel_sp_fd);
+	/* Declare device setup by this process, one socket per connection */
+	while (ctx->next_sock < nbd->num_conns) {
+		rc = ioctl(nbd->dev_fd, NBD_SET_SOCK, nbd->conns[ctx->next_sock].kernel_sp_fd);
+		if (rc == 0) {
+			ctx->next_sock++;
+			continue;
+		}
 
-	if (rc) {
 		if (errno == EBUSY) {
-			if (ctx->nbd->retry_poller == NULL) {
-				ctx->nbd->retry_count = NBD_START_BUSY_WAITING_MS * 1000ULL / NBD_BUSY_POLLING_INTERVAL_US;
-				ctx->nbd->retry_poller = SPDK_POLLER_REGISTER(nbd_enable_kernel, ctx,
-							 NBD_BUSY_POLLING_INTERVAL_US);
+			if (nbd->retry_poller == NULL) {
+				nbd->retry_count = NBD_START_BUSY_WAITING_MS * 1000ULL / NBD_BUSY_POLLING_INTERVAL_US;
+				nbd->retry_poller = SPDK_POLLER_REGISTER(nbd_enable_kernel, ctx,
+						    NBD_BUSY_POLLING_INTERVAL_US);
 				return SPDK_POLLER_BUSY;
-			} else if (ctx->nbd->retry_count-- > 0) {
+			} else if (nbd->retry_count-- > 0) {
 				/* Repeatedly unregister and register retry poller to avoid scan-build error */
-				spdk_poller_unregister(&ctx->nbd->retry_poller);
-				ctx->nbd->retry_poller = SPDK_POLLER_REGISTER(nbd_enable_kernel, ctx,
-							 NBD_BUSY_POLLING_INTERVAL_US);
+				spdk_poller_unregister(&nbd->retry_poller);
+				nbd->retry_poller = SPDK_POLLER_REGISTER(nbd_enable_kernel, ctx,
+						    NBD_BUSY_POLLING_INTERVAL_US);
 				return SPDK_POLLER_BUSY;
 			}
 		}
 
-		SPDK_ERRLOG("ioctl(NBD_SET_SOCK) failed: %s\n", spdk_strerror(errno));
-		if (ctx->nbd->retry_poller) {
-			spdk_poller_unregister(&ctx->nbd->retry_poller);
+		rc = -errno;
+		SPDK_ERRLOG("ioctl(NBD_SET_SOCK) failed: %s\n", spdk_strerror(-rc));
+		if (nbd->retry_poller) {
+			spdk_poller_unregister(&nbd->retry_poller);
 		}
 
-		_nbd_stop(ctx->nbd);
+		_nbd_stop(nbd);
 
 		if (ctx->cb_fn) {
-			ctx->cb_fn(ctx->cb_arg, NULL, -errno);
+			ctx->cb_fn(ctx->cb_arg, NULL, rc);
 		}
 
 		free(ctx);
 		return SPDK_POLLER_BUSY;
 	}
 
-	if (ctx->nbd->retry_poller) {
-		spdk_poller_unregister(&ctx->nbd->retry_poller);
+	if (nbd->retry_poller) {
+		spdk_poller_unregister(&nbd->retry_poller);
 	}
 
 	nbd_start_continue(ctx);
@@ -1049,15 +1343,72 @@ nbd_enable_kernel(void *arg)
 	return SPDK_POLLER_BUSY;
 }
 
+static int
+nbd_conn_init(struct spdk_nbd_disk *nbd, uint32_t idx)
+{
+	struct nbd_conn *conn = &nbd->conns[idx];
+	char thread_name[32];
+	const char *dev_name;
+	int sp[2];
+	int rc;
+
+	conn->nbd = nbd;
+	conn->idx = idx;
+	TAILQ_INIT(&conn->received_io_list);
+	TAILQ_INIT(&conn->executed_io_list);
+	TAILQ_INIT(&conn->processing_io_list);
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sp) != 0) {
+		rc = -errno;
+		SPDK_ERRLOG("socketpair failed: %s\n", spdk_strerror(-rc));
+		return rc;
+	}
+
+	conn->spdk_sp_fd = sp[0];
+	conn->kernel_sp_fd = sp[1];
+
+	/* The first connection stays on the calling thread, the others get their own */
+	if (idx == 0) {
+		conn->thread = nbd->thread;
+		return 0;
+	}
+
+	dev_name = strrchr(nbd->nbd_path, '/');
+	dev_name = dev_name ? dev_name + 1 : nbd->nbd_path;
+	snprintf(thread_name, sizeof(thread_name), "%s_conn%u", dev_name, idx);
+
+	conn->thread = spdk_thread_create(thread_name, NULL);
+	if (conn->thread == NULL) {
+		SPDK_ERRLOG("could not create thread for connection %u of %s\n", idx, nbd->nbd_path);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
 void
 spdk_nbd_start(const char *bdev_name, const char *nbd_path,
 	       spdk_nbd_start_cb cb_fn, void *cb_arg)
+{
+	spdk_nbd_start_ext(bdev_name, nbd_path, 1, cb_fn, cb_arg);
+}
+
+void
+spdk_nbd_start_ext(const char *bdev_name, const char *nbd_path, uint32_t num_connections,
+		   spdk_nbd_start_cb cb_fn, void *cb_arg)
 {
 	struct spdk_nbd_start_ctx	*ctx = NULL;
 	struct spdk_nbd_disk		*nbd = NULL;
 	struct spdk_bdev		*bdev;
+	uint32_t			i;
 	int				rc;
-	int				sp[2];
+
+	if (num_connections == 0 || num_connections > NBD_MAX_CONNECTIONS) {
+		SPDK_ERRLOG("invalid number of connections %u, must be between 1 and %u\n",
+			    num_connections, NBD_MAX_CONNECTIONS);
+		rc = -EINVAL;
+		goto err;
+	}
 
 	nbd = calloc(1, sizeof(*nbd));
 	if (nbd == NULL) {
@@ -1066,8 +1417,7 @@ spdk_nbd_start(const char *bdev_name, const char *nbd_path,
 	}
 
 	nbd->dev_fd = -1;
-	nbd->spdk_sp_fd = -1;
-	nbd->kernel_sp_fd = -1;
+	nbd->thread = spdk_get_thread();
 
 	ctx = calloc(1, sizeof(*ctx));
 	if (ctx == NULL) {
@@ -1089,18 +1439,8 @@ spdk_nbd_start(const char *bdev_name, const char *nbd_path,
 	bdev = spdk_bdev_desc_get_bdev(nbd->bdev_desc);
 	nbd->bdev = bdev;
 
-	nbd->ch = spdk_bdev_get_io_channel(nbd->bdev_desc);
 	nbd->buf_align = spdk_max(spdk_bdev_get_buf_align(bdev), 64);
 
-	rc = socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sp);
-	if (rc != 0) {
-		SPDK_ERRLOG("socketpair failed\n");
-		rc = -errno;
-		goto err;
-	}
-
-	nbd->spdk_sp_fd = sp[0];
-	nbd->kernel_sp_fd = sp[1];
 	nbd->nbd_path = strdup(nbd_path);
 	if (!nbd->nbd_path) {
 		SPDK_ERRLOG("strdup allocation failure\n");
@@ -1108,9 +1448,24 @@ spdk_nbd_start(const char *bdev_name, const char *nbd_path,
 		goto err;
 	}
 
-	TAILQ_INIT(&nbd->received_io_list);
-	TAILQ_INIT(&nbd->executed_io_list);
-	TAILQ_INIT(&nbd->processing_io_list);
+	nbd->conns = calloc(num_connections, sizeof(*nbd->conns));
+	if (nbd->conns == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	nbd->num_conns = num_connections;
+	for (i = 0; i < num_connections; i++) {
+		nbd->conns[i].spdk_sp_fd = -1;
+		nbd->conns[i].kernel_sp_fd = -1;
+	}
+
+	for (i = 0; i < num_connections; i++) {
+		rc = nbd_conn_init(nbd, i);
+		if (rc != 0) {
+			goto err;
+		}
+	}
 
 	/* Add nbd_disk to the end of disk list */
 	rc = nbd_disk_register(ctx->nbd);
@@ -1125,8 +1480,8 @@ spdk_nbd_start(const char *bdev_name, const char *nbd_path,
 		goto err;
 	}
 
-	SPDK_INFOLOG(nbd, "Enabling kernel access to bdev %s via %s\n",
-		     bdev_name, nbd_path);
+	SPDK_INFOLOG(nbd, "Enabling kernel access to bdev %s via %s with %u connection(s)\n",
+		     bdev_name, nbd_path, num_connections);
 
 	nbd_enable_kernel(ctx);
 	return;
@@ -275,6 +275,12 @@ struct nvme_error_cmd {
 struct nvme_request {
 	struct spdk_nvme_cmd		cmd;
 
+	/*
+	 * The members below, up to and including pool, are touched on every
+	 *  submission and completion.  They are packed into the two cache lines
+	 *  following the command, so that a non-split I/O only touches three
+	 *  cache lines of its request.
+	 */
 	uint8_t				retries;
 
 	uint8_t				timed_out : 1;
@@ -300,11 +306,15 @@ struct nvme_request {
 
 	uint32_t			payload_size;
 
+	uint32_t			md_size;
+
 	/**
-	 * Timeout ticks for error injection requests, can be extended in future
-	 * to support per-request timeout feature.
+	 * The active admin request can be moved to a per process pending
+	 *  list based on the saved pid to tell which process it belongs
+	 *  to. The cpl saves the original completion information which
+	 *  is used in the completion callback.
 	 */
-	uint64_t			timeout_tsc;
+	pid_t				pid;
 
 	/**
 	 * Data payload for this request's command.
@@ -323,25 +333,35 @@ struct nvme_request {
 	 */
 	uint64_t			submit_tick;
 
+	/** Sequence of accel operations associated with this request */
+	void				*accel_sequence;
+
 	/**
-	 * The active admin request can be moved to a per process pending
-	 *  list based on the saved pid to tell which process it belongs
-	 *  to. The cpl saves the original completion information which
-	 *  is used in the completion callback.
-	 * NOTE: these below two fields are only used for admin request.
+	 * Shared request pool this request belongs to, or NULL if the request
+	 *  was allocated as part of its qpair's own request array.
 	 */
-	pid_t				pid;
-	struct spdk_nvme_cpl		cpl;
-
-	uint32_t			md_size;
+	struct nvme_request_pool	*pool;
 
 	/**
 	 * The following members should not be reordered with members
-	 *  above.  These members are only needed when splitting
-	 *  requests which is done rarely, and the driver is careful
-	 *  to not touch the following fields until a split operation is
-	 *  needed, to avoid touching an extra cacheline.
+	 *  above.  These members are only needed for admin requests,
+	 *  error injection and when splitting requests, which is done
+	 *  rarely, and the driver is careful to not touch the following
+	 *  fields until they are needed, to avoid touching an extra cacheline.
+	 */
+
+	/**
+	 * Original completion of an admin request completed on behalf of
+	 *  another process, or the status to complete an injected error with.
+	 *  Only used for admin requests and error injection.
+	 */
+	struct spdk_nvme_cpl		cpl;
+
+	/**
+	 * Timeout ticks for error injection requests, can be extended in future
+	 * to support per-request timeout feature.
 	 */
+	uint64_t			timeout_tsc;
 
 	/**
 	 * Points to the outstanding child requests for a parent request.
@@ -377,9 +397,22 @@ struct nvme_request {
 	spdk_nvme_cmd_cb		user_cb_fn;
 	void				*user_cb_arg;
 	void				*user_buffer;
+};
+SPDK_STATIC_ASSERT(offsetof(struct nvme_request, cpl) <= 3 * SPDK_CACHE_LINE_SIZE,
+		   "Hot part of nvme_request must fit in three cache lines");
 
-	/** Sequence of accel operations associated with this request */
-	void				*accel_sequence;
+/*
+ * A pool of requests shared by all qpairs within a poll group.  qpairs take requests
+ *  from the pool only when their own free_req list is empty, so a poll group with many
+ *  qpairs can be sized for the I/O actually outstanding across the group rather than
+ *  for the sum of every qpair's queue depth.  The pool is only accessed from the
+ *  thread that owns the poll group.
+ */
+struct nvme_request_pool {
+	STAILQ_HEAD(, nvme_request)	free_req;
+	void				*req_buf;
+	uint32_t			num_requests;
+	uint32_t			num_free;
 };
 
 struct nvme_completion_poll_status {
@@ -541,6 +574,7 @@ struct spdk_nvme_poll_group {
 	bool						enable_interrupts_is_valid;
 	int						disconnect_qpair_fd;
 	struct spdk_fd_group				*fgrp;
+	struct nvme_request_pool			*req_pool;
 };
 
 struct spdk_nvme_transport_poll_group {
@@ -1419,6 +1453,33 @@ nvme_request_clear(struct nvme_request *req)
 		req->accel_sequence = NULL;		\
 	} while (0);
 
+static inline struct nvme_request *
+nvme_request_pool_get(struct spdk_nvme_qpair *qpair)
+{
+	struct nvme_request_pool *pool;
+	struct nvme_request *req;
+
+	if (qpair->poll_group == NULL) {
+		return NULL;
+	}
+
+	pool = qpair->poll_group->group->req_pool;
+	if (pool == NULL) {
+		return NULL;
+	}
+
+	req = STAILQ_FIRST(&pool->free_req);
+	if (req == NULL) {
+		return NULL;
+	}
+
+	STAILQ_REMOVE_HEAD(&pool->free_req, stailq);
+	pool->num_free--;
+	req->qpair = qpair;
+
+	return req;
+}
+
 static inline struct nvme_request *
 nvme_allocate_request(struct spdk_nvme_qpair *qpair,
 		      const struct nvme_payload *payload, uint32_t payload_size, uint32_t md_size,
@@ -1427,11 +1488,15 @@ nvme_allocate_request(struct spdk_nvme_qpair *qpair,
 	struct nvme_request *req;
 
 	req = STAILQ_FIRST(&qpair->free_req);
-	if (req == NULL) {
-		return req;
+	if (spdk_likely(req != NULL)) {
+		STAILQ_REMOVE_HEAD(&qpair->free_req, stailq);
+	} else {
+		req = nvme_request_pool_get(qpair);
+		if (req == NULL) {
+			return req;
+		}
 	}
 
-	STAILQ_REMOVE_HEAD(&qpair->free_req, stailq);
 	qpair->num_outstanding_reqs++;
 
 	NVME_INIT_REQUEST(req, cb_fn, cb_arg, *payload, payload_size, md_size);
@@ -1472,7 +1537,12 @@ _nvme_free_request(struct nvme_request *req, struct spdk_nvme_qpair *qpair)
 	 * saved only for use with a FABRICS/CONNECT command.
 	 */
 	if (spdk_likely(qpair->reserved_req != req)) {
-		STAILQ_INSERT_HEAD(&qpair->free_req, req, stailq);
+		if (spdk_likely(req->pool == NULL)) {
+			STAILQ_INSERT_HEAD(&qpair->free_req, req, stailq);
+		} else {
+			STAILQ_INSERT_HEAD(&req->pool->free_req, req, stailq);
+			req->pool->num_free++;
+		}
 
 		assert(qpair->num_outstanding_reqs > 0);
 		qpair->num_outstanding_reqs--;
@@ -981,11 +981,13 @@ nvme_pcie_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_
 		pqpair->stat->idle_polls++;
 	}
 
-	if (pqpair->flags.delay_cmd_submit) {
-		if (pqpair->last_sq_tail != pqpair->sq_tail) {
-			nvme_pcie_qpair_ring_sq_doorbell(qpair);
-			pqpair->last_sq_tail = pqpair->sq_tail;
-		}
+	/* When polled as part of a poll group, the delayed submissions of all qpairs
+	 * in the group are flushed together once all of them were processed, see
+	 * nvme_pcie_poll_group_process_completions().
+	 */
+	if (pqpair->flags.delay_cmd_submit &&
+	    (qpair->poll_group == NULL || !qpair->poll_group->group->in_process_completions)) {
+		nvme_pcie_qpair_flush_delayed_submissions(qpair);
 	}
 
 	if (spdk_unlikely(ctrlr->timeout_enabled)) {
@@ -1799,6 +1801,8 @@ nvme_pcie_poll_group_process_completions(struct spdk_nvme_transport_poll_group *
 	struct spdk_nvme_qpair *qpair, *tmp_qpair;
 	int32_t local_completions = 0;
 	int64_t total_completions = 0;
+	uint32_t num_qpairs = 0, num_exhausted = 0;
+	uint64_t budget;
 
 	STAILQ_FOREACH_SAFE(qpair, &tgroup->disconnected_qpairs, poll_group_stailq, tmp_qpair) {
 		disconnected_qpair_cb(qpair, tgroup->group->ctx);
@@ -1812,6 +1816,42 @@ nvme_pcie_poll_group_process_completions(struct spdk_nvme_transport_poll_group *
 		} else if (spdk_likely(total_completions >= 0)) {
 			total_completions += local_completions;
 		}
+
+		num_qpairs++;
+		nvme_pcie_qpair(qpair)->flags.budget_exhausted = completions_per_qpair != 0 &&
+				(uint32_t)local_completions == completions_per_qpair;
+		num_exhausted += nvme_pcie_qpair(qpair)->flags.budget_exhausted;
+	}
+
+	/* Give the budget left unused by idle qpairs to the qpairs that used up theirs, so that
+	 * the batch size follows the load instead of being fixed per qpair.
+	 */
+	if (num_exhausted > 0 && total_completions >= 0 &&
+	    (uint64_t)completions_per_qpair * num_qpairs >= (uint64_t)total_completions + num_exhausted) {
+		budget = ((uint64_t)completions_per_qpair * num_qpairs - total_completions) / num_exhausted;
+		STAILQ_FOREACH_SAFE(qpair, &tgroup->connected_qpairs, poll_group_stailq, tmp_qpair) {
+			if (!nvme_pcie_qpair(qpair)->flags.budget_exhausted) {
+				continue;
+			}
+
+			nvme_pcie_qpair(qpair)->flags.budget_exhausted = 0;
+			local_completions = spdk_nvme_qpair_process_completions(qpair, budget);
+			if (spdk_unlikely(local_completions < 0)) {
+				disconnected_qpair_cb(qpair, tgroup->group->ctx);
+				total_completions = -ENXIO;
+			} else if (spdk_likely(total_completions >= 0)) {
+				total_completions += local_completions;
+			}
+		}
+	}
+
+	/* Ring the submission queue doorbell of each qpair once per poll group iteration, after
+	 * the commands submitted from the completion callbacks of all qpairs were queued.
+	 */
+	STAILQ_FOREACH(qpair, &tgroup->connected_qpairs, poll_group_stailq) {
+		if (nvme_pcie_qpair(qpair)->flags.delay_cmd_submit) {
+			nvme_pcie_qpair_flush_delayed_submissions(qpair);
+		}
 	}
 
 	return total_completions;
@@ -165,6 +165,9 @@ struct nvme_pcie_qpair {
 
 		/* Disable merging of physically contiguous SGL entries */
 		uint8_t disable_pcie_sgl_merge	: 1;
+
+		/* Used up its completion budget during the current poll group iteration */
+		uint8_t budget_exhausted	: 1;
 	} flags;
 
 	/*
@@ -274,6 +277,17 @@ nvme_pcie_qpair_ring_sq_doorbell(struct spdk_nvme_qpair *qpair)
 	}
 }
 
+static inline void
+nvme_pcie_qpair_flush_delayed_submissions(struct spdk_nvme_qpair *qpair)
+{
+	struct nvme_pcie_qpair	*pqpair = nvme_pcie_qpair(qpair);
+
+	if (pqpair->last_sq_tail != pqpair->sq_tail) {
+		nvme_pcie_qpair_ring_sq_doorbell(qpair);
+		pqpair->last_sq_tail = pqpair->sq_tail;
+	}
+}
+
 static inline void
 nvme_pcie_qpair_ring_cq_doorbell(struct spdk_nvme_qpair *qpair)
 {
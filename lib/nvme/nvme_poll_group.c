@@ -77,6 +77,58 @@ spdk_nvme_poll_group_create(void *ctx, struct spdk_nvme_accel_fn_table *table)
 	return group;
 }
 
+int
+spdk_nvme_poll_group_set_req_pool_size(struct spdk_nvme_poll_group *group, uint32_t num_requests)
+{
+	struct nvme_request_pool *pool;
+	struct nvme_request *req;
+	size_t req_size_padded;
+	uint32_t i;
+
+	if (!STAILQ_EMPTY(&group->tgroups)) {
+		SPDK_ERRLOG("Request pool can only be resized before any qpair is added to the poll group\n");
+		return -EBUSY;
+	}
+
+	if (group->req_pool != NULL) {
+		assert(group->req_pool->num_free == group->req_pool->num_requests);
+		spdk_free(group->req_pool->req_buf);
+		free(group->req_pool);
+		group->req_pool = NULL;
+	}
+
+	if (num_requests == 0) {
+		return 0;
+	}
+
+	pool = calloc(1, sizeof(*pool));
+	if (pool == NULL) {
+		return -ENOMEM;
+	}
+
+	req_size_padded = SPDK_ALIGN_CEIL(sizeof(struct nvme_request), SPDK_CACHE_LINE_SIZE);
+	pool->req_buf = spdk_zmalloc(req_size_padded * num_requests, SPDK_CACHE_LINE_SIZE, NULL,
+				     SPDK_ENV_NUMA_ID_ANY, SPDK_MALLOC_SHARE);
+	if (pool->req_buf == NULL) {
+		SPDK_ERRLOG("Failed to allocate request pool with %u requests\n", num_requests);
+		free(pool);
+		return -ENOMEM;
+	}
+
+	STAILQ_INIT(&pool->free_req);
+	for (i = 0; i < num_requests; i++) {
+		req = (void *)((uintptr_t)pool->req_buf + i * req_size_padded);
+		req->pool = pool;
+		STAILQ_INSERT_HEAD(&pool->free_req, req, stailq);
+	}
+
+	pool->num_requests = num_requests;
+	pool->num_free = num_requests;
+	group->req_pool = pool;
+
+	return 0;
+}
+
 int
 spdk_nvme_poll_group_get_fd(struct spdk_nvme_poll_group *group)
 {
@@ -404,6 +456,10 @@ spdk_nvme_poll_group_destroy(struct spdk_nvme_poll_group *group)
 	struct spdk_nvme_transport_poll_group *tgroup, *tmp_tgroup;
 	struct spdk_fd_group *fgrp = group->fgrp;
 
+	if (group->req_pool != NULL && group->req_pool->num_free != group->req_pool->num_requests) {
+		return -EBUSY;
+	}
+
 	STAILQ_FOREACH_SAFE(tgroup, &group->tgroups, link, tmp_tgroup) {
 		STAILQ_REMOVE(&group->tgroups, tgroup, spdk_nvme_transport_poll_group, link);
 		if (nvme_transport_poll_group_destroy(tgroup) != 0) {
@@ -421,6 +477,11 @@ spdk_nvme_poll_group_destroy(struct spdk_nvme_poll_group *group)
 		spdk_fd_group_destroy(fgrp);
 	}
 
+	if (group->req_pool != NULL) {
+		spdk_free(group->req_pool->req_buf);
+		free(group->req_pool);
+	}
+
 	free(group);
 
 	return 0;
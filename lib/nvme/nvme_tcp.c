@@ -1368,25 +1368,47 @@ nvme_tcp_accel_seq_recv_compute_crc32_done(void *cb_arg)
 }
 
 static bool
-nvme_tcp_accel_recv_compute_crc32(struct nvme_tcp_req *treq, struct nvme_tcp_pdu *pdu)
+nvme_tcp_accel_recv_crc32_supported(struct nvme_tcp_req *treq, struct nvme_tcp_pdu *pdu)
 {
 	struct nvme_tcp_qpair *tqpair = treq->tqpair;
-	struct nvme_tcp_poll_group *tgroup = nvme_tcp_poll_group(tqpair->qpair.poll_group);
 	struct nvme_request *req = treq->req;
-	int rc, dummy = 0;
 
 	/* Only support this limited case that the request has only one c2h pdu */
-	if (spdk_unlikely(nvme_qpair_get_state(&tqpair->qpair) < NVME_QPAIR_CONNECTED ||
-			  tqpair->qpair.poll_group == NULL || pdu->dif_ctx != NULL ||
+	if (spdk_unlikely(tqpair->qpair.poll_group == NULL || pdu->dif_ctx != NULL ||
 			  pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT != 0 ||
 			  pdu->data_len != req->payload_size)) {
 		return false;
 	}
 
-	if (tgroup->group.group->accel_fn_table.append_crc32c == NULL) {
+	return tqpair->qpair.poll_group->group->accel_fn_table.append_crc32c != NULL;
+}
+
+/*
+ * When the data digest of a C2H data PDU is verified in software, it's computed
+ * incrementally as the payload is read from the socket, while the data is still hot in
+ * the cache, instead of walking the whole payload once again after it was received.
+ */
+static inline bool
+nvme_tcp_pdu_ddgst_incremental(struct nvme_tcp_pdu *pdu)
+{
+	return pdu->ddgst_enable && pdu->dif_ctx == NULL && pdu->req != NULL &&
+	       !nvme_tcp_accel_recv_crc32_supported(pdu->req, pdu);
+}
+
+static bool
+nvme_tcp_accel_recv_compute_crc32(struct nvme_tcp_req *treq, struct nvme_tcp_pdu *pdu)
+{
+	struct nvme_tcp_qpair *tqpair = treq->tqpair;
+	struct nvme_tcp_poll_group *tgroup;
+	struct nvme_request *req = treq->req;
+	int rc, dummy = 0;
+
+	if (spdk_unlikely(nvme_qpair_get_state(&tqpair->qpair) < NVME_QPAIR_CONNECTED ||
+			  !nvme_tcp_accel_recv_crc32_supported(treq, pdu))) {
 		return false;
 	}
 
+	tgroup = nvme_tcp_poll_group(tqpair->qpair.poll_group);
 	nvme_tcp_req_copy_pdu(treq, pdu);
 	rc = nvme_tcp_accel_append_crc32c(tgroup, &req->accel_sequence,
 					  &treq->pdu->data_digest_crc32,
@@ -1429,11 +1451,14 @@ nvme_tcp_pdu_payload_handle(struct nvme_tcp_qpair *tqpair,
 	if (pdu->ddgst_enable) {
 		/* But if the data digest is enabled, tcp_req cannot be NULL */
 		assert(tcp_req != NULL);
-		if (nvme_tcp_accel_recv_compute_crc32(tcp_req, pdu)) {
+		if (nvme_tcp_pdu_ddgst_incremental(pdu)) {
+			crc32c = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
+		} else if (nvme_tcp_accel_recv_compute_crc32(tcp_req, pdu)) {
 			return;
+		} else {
+			crc32c = nvme_tcp_pdu_calc_data_digest(pdu);
 		}
 
-		crc32c = nvme_tcp_pdu_calc_data_digest(pdu);
 		crc32c = crc32c ^ SPDK_CRC32C_XOR;
 		rc = MATCH_DIGEST_WORD(pdu->data_digest, crc32c);
 		if (rc == 0) {
@@ -1996,6 +2021,15 @@ nvme_tcp_read_pdu(struct nvme_tcp_qpair *tqpair, uint32_t *reaped, uint32_t max_
 				break;
 			}
 
+			if (nvme_tcp_pdu_ddgst_incremental(pdu) && pdu->rw_offset < pdu->data_len) {
+				if (pdu->rw_offset == 0) {
+					pdu->data_digest_crc32 = SPDK_CRC32C_XOR;
+				}
+				pdu->data_digest_crc32 = nvme_tcp_pdu_update_data_digest(pdu, pdu->rw_offset,
+							 spdk_min((uint32_t)rc, pdu->data_len - pdu->rw_offset),
+							 pdu->data_digest_crc32);
+			}
+
 			pdu->rw_offset += rc;
 			if (pdu->rw_offset < data_len) {
 				return NVME_TCP_PDU_IN_PROGRESS;
@@ -57,6 +57,8 @@ static struct spdk_nvmf_custom_admin_cmd g_nvmf_custom_admin_cmd_hdlrs[SPDK_NVME
 static void _nvmf_request_complete(void *ctx);
 int nvmf_passthru_admin_cmd_for_ctrlr(struct spdk_nvmf_request *req, struct spdk_nvmf_ctrlr *ctrlr);
 static int nvmf_passthru_admin_cmd(struct spdk_nvmf_request *req);
+static int nvmf_ctrlr_submit_io_cmd(struct spdk_nvmf_request *req, struct spdk_nvmf_ns *ns,
+				    struct spdk_nvmf_subsystem_pg_ns_info *ns_info);
 
 static inline void
 nvmf_invalid_connect_response(struct spdk_nvmf_fabric_connect_rsp *rsp,
@@ -348,6 +350,118 @@ _nvmf_ctrlr_add_admin_qpair(void *ctx)
 	nvmf_ctrlr_add_qpair(qpair, ctrlr, req);
 }
 
+static int
+nvmf_pg_ctrlr_cmp(struct nvmf_pg_ctrlr *entry1, struct nvmf_pg_ctrlr *entry2)
+{
+	return (int)entry1->cntlid - (int)entry2->cntlid;
+}
+
+RB_GENERATE_STATIC(nvmf_pg_ctrlr_tree, nvmf_pg_ctrlr, link, nvmf_pg_ctrlr_cmp);
+
+static struct spdk_nvmf_ctrlr *
+nvmf_subsystem_pg_find_ctrlr(struct spdk_nvmf_subsystem_poll_group *sgroup, uint16_t cntlid)
+{
+	struct nvmf_pg_ctrlr find = { .cntlid = cntlid }, *entry;
+
+	entry = RB_FIND(nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, &find);
+
+	return entry != NULL ? entry->ctrlr : NULL;
+}
+
+void
+nvmf_subsystem_pg_free_ctrlrs(struct spdk_nvmf_subsystem_poll_group *sgroup)
+{
+	struct nvmf_pg_ctrlr *entry, *tmp;
+
+	RB_FOREACH_SAFE(entry, nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, tmp) {
+		RB_REMOVE(nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, entry);
+		free(entry);
+	}
+}
+
+static void
+nvmf_ctrlr_add_to_pg(struct spdk_io_channel_iter *i)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct spdk_nvmf_poll_group *group = spdk_io_channel_get_ctx(ch);
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	struct nvmf_pg_ctrlr find = { .cntlid = ctrlr->cntlid }, *entry;
+
+	if (ctrlr->subsys->id >= group->num_sgroups) {
+		goto end;
+	}
+
+	sgroup = &group->sgroups[ctrlr->subsys->id];
+	entry = RB_FIND(nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, &find);
+	if (entry == NULL) {
+		entry = calloc(1, sizeof(*entry));
+		if (entry == NULL) {
+			/* Not fatal, CONNECTs will be routed through the subsystem thread */
+			goto end;
+		}
+		entry->cntlid = ctrlr->cntlid;
+		RB_INSERT(nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, entry);
+	}
+	/* The cntlid may have belonged to a controller that is still being destroyed */
+	entry->ctrlr = ctrlr;
+end:
+	spdk_for_each_channel_continue(i, 0);
+}
+
+static void
+nvmf_ctrlr_remove_from_pg(struct spdk_io_channel_iter *i)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct spdk_nvmf_poll_group *group = spdk_io_channel_get_ctx(ch);
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	struct nvmf_pg_ctrlr find = { .cntlid = ctrlr->cntlid }, *entry;
+
+	if (ctrlr->subsys->id < group->num_sgroups) {
+		sgroup = &group->sgroups[ctrlr->subsys->id];
+		entry = RB_FIND(nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, &find);
+		if (entry != NULL && entry->ctrlr == ctrlr) {
+			RB_REMOVE(nvmf_pg_ctrlr_tree, &sgroup->ctrlrs, entry);
+			free(entry);
+		}
+	}
+
+	spdk_for_each_channel_continue(i, 0);
+}
+
+static void _nvmf_ctrlr_destruct(void *ctx);
+
+static void
+nvmf_ctrlr_remove_from_pg_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = spdk_io_channel_iter_get_ctx(i);
+
+	/* No poll group can look the controller up anymore and any I/O CONNECT it
+	 * already routed is queued on the controller thread ahead of this message. */
+	ctrlr->pg_update_in_progress = false;
+	spdk_thread_send_msg(ctrlr->thread, _nvmf_ctrlr_destruct, ctrlr);
+}
+
+static void
+nvmf_ctrlr_remove_from_pgs(struct spdk_nvmf_ctrlr *ctrlr)
+{
+	ctrlr->pg_update_in_progress = true;
+	spdk_for_each_channel(ctrlr->subsys->tgt, nvmf_ctrlr_remove_from_pg, ctrlr,
+			      nvmf_ctrlr_remove_from_pg_done);
+}
+
+static void
+nvmf_ctrlr_add_to_pg_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = spdk_io_channel_iter_get_ctx(i);
+
+	ctrlr->pg_update_in_progress = false;
+	if (ctrlr->pg_destruct_pending) {
+		nvmf_ctrlr_remove_from_pgs(ctrlr);
+	}
+}
+
 static void
 _nvmf_subsystem_add_ctrlr(void *ctx)
 {
@@ -366,6 +480,12 @@ _nvmf_subsystem_add_ctrlr(void *ctx)
 		return;
 	}
 
+	/* Let the poll groups route I/O queue CONNECTs to this controller directly. There's
+	 * no need to wait, CONNECTs are sent through the subsystem thread until then. */
+	ctrlr->pg_update_in_progress = true;
+	spdk_for_each_channel(ctrlr->subsys->tgt, nvmf_ctrlr_add_to_pg, ctrlr,
+			      nvmf_ctrlr_add_to_pg_done);
+
 	spdk_thread_send_msg(ctrlr->thread, _nvmf_ctrlr_add_admin_qpair, req);
 }
 
@@ -645,7 +765,12 @@ nvmf_ctrlr_destruct(struct spdk_nvmf_ctrlr *ctrlr)
 {
 	nvmf_subsystem_remove_ctrlr(ctrlr->subsys, ctrlr);
 
-	spdk_thread_send_msg(ctrlr->thread, _nvmf_ctrlr_destruct, ctrlr);
+	if (ctrlr->pg_update_in_progress) {
+		ctrlr->pg_destruct_pending = true;
+		return;
+	}
+
+	nvmf_ctrlr_remove_from_pgs(ctrlr);
 }
 
 static void
@@ -732,6 +857,46 @@ end:
 	spdk_nvmf_request_complete(req);
 }
 
+static void
+nvmf_ctrlr_route_io_qpair(struct spdk_nvmf_request *req, struct spdk_nvmf_ctrlr *ctrlr)
+{
+	struct spdk_nvmf_fabric_connect_rsp *rsp = &req->rsp->connect_rsp;
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+	struct spdk_nvmf_qpair *admin_qpair;
+	struct spdk_nvmf_poll_group *admin_qpair_group = NULL;
+	enum spdk_nvmf_qpair_state admin_qpair_state = SPDK_NVMF_QPAIR_UNINITIALIZED;
+	bool admin_qpair_active = false;
+
+	/* fail before passing a message to the controller thread. */
+	if (ctrlr->in_destruct) {
+		SPDK_ERRLOG("Got I/O connect while ctrlr was being destroyed.\n");
+		SPDK_NVMF_INVALID_CONNECT_CMD(rsp, qid);
+		spdk_nvmf_request_complete(req);
+		return;
+	}
+
+	admin_qpair = ctrlr->admin_qpair;
+
+	/* There is a chance that admin qpair was destroyed. This is an issue that was observed only with ESX initiators */
+	if (admin_qpair) {
+		admin_qpair_active = spdk_nvmf_qpair_is_active(admin_qpair);
+		admin_qpair_group = admin_qpair->group;
+		admin_qpair_state = admin_qpair->state;
+	}
+
+	if (!admin_qpair_active || admin_qpair_group == NULL) {
+		/* There is a chance that admin qpair was destroyed or is being destroyed at this moment due to e.g.
+		 * expired keep alive timer. Part of the qpair destruction process is change of qpair's
+		 * state to DEACTIVATING and removing it from poll group */
+		SPDK_ERRLOG("Inactive admin qpair (state %d, group %p)\n", admin_qpair_state, admin_qpair_group);
+		SPDK_NVMF_INVALID_CONNECT_CMD(rsp, qid);
+		spdk_nvmf_request_complete(req);
+		return;
+	}
+	qpair->ctrlr = ctrlr;
+	spdk_thread_send_msg(admin_qpair_group->thread, nvmf_ctrlr_add_io_qpair, req);
+}
+
 static void
 _nvmf_ctrlr_add_io_qpair(void *ctx)
 {
@@ -740,14 +905,10 @@ _nvmf_ctrlr_add_io_qpair(void *ctx)
 	struct spdk_nvmf_fabric_connect_data *data;
 	struct spdk_nvmf_ctrlr *ctrlr;
 	struct spdk_nvmf_qpair *qpair = req->qpair;
-	struct spdk_nvmf_qpair *admin_qpair;
 	struct spdk_nvmf_tgt *tgt = qpair->transport->tgt;
 	struct spdk_nvmf_subsystem *subsystem;
 	struct spdk_nvme_transport_id listen_trid = {};
 	const struct spdk_nvmf_subsystem_listener *listener;
-	struct spdk_nvmf_poll_group *admin_qpair_group = NULL;
-	enum spdk_nvmf_qpair_state admin_qpair_state = SPDK_NVMF_QPAIR_UNINITIALIZED;
-	bool admin_qpair_active = false;
 
 	assert(req->iovcnt == 1);
 
@@ -767,14 +928,6 @@ _nvmf_ctrlr_add_io_qpair(void *ctx)
 		return;
 	}
 
-	/* fail before passing a message to the controller thread. */
-	if (ctrlr->in_destruct) {
-		SPDK_ERRLOG("Got I/O connect while ctrlr was being destroyed.\n");
-		SPDK_NVMF_INVALID_CONNECT_CMD(rsp, qid);
-		spdk_nvmf_request_complete(req);
-		return;
-	}
-
 	/* If ANA reporting is enabled, check if I/O connect is on the same listener. */
 	if (subsystem->flags.ana_reporting) {
 		if (spdk_nvmf_qpair_get_listen_trid(req->qpair, &listen_trid) != 0) {
@@ -793,26 +946,33 @@ _nvmf_ctrlr_add_io_qpair(void *ctx)
 		}
 	}
 
-	admin_qpair = ctrlr->admin_qpair;
+	nvmf_ctrlr_route_io_qpair(req, ctrlr);
+}
 
-	/* There is a chance that admin qpair was destroyed. This is an issue that was observed only with ESX initiators */
-	if (admin_qpair) {
-		admin_qpair_active = spdk_nvmf_qpair_is_active(admin_qpair);
-		admin_qpair_group = admin_qpair->group;
-		admin_qpair_state = admin_qpair->state;
+static bool
+nvmf_ctrlr_route_io_qpair_from_pg(struct spdk_nvmf_request *req,
+				  struct spdk_nvmf_subsystem *subsystem)
+{
+	struct spdk_nvmf_fabric_connect_data *data = req->iov[0].iov_base;
+	struct spdk_nvmf_poll_group *group = req->qpair->group;
+	struct spdk_nvmf_ctrlr *ctrlr;
+
+	/* Matching the listener requires the subsystem's listener list, which is only
+	 * safe to walk on the subsystem thread. */
+	if (subsystem->flags.ana_reporting || subsystem->id >= group->num_sgroups) {
+		return false;
 	}
 
-	if (!admin_qpair_active || admin_qpair_group == NULL) {
-		/* There is a chance that admin qpair was destroyed or is being destroyed at this moment due to e.g.
-		 * expired keep alive timer. Part of the qpair destruction process is change of qpair's
-		 * state to DEACTIVATING and removing it from poll group */
-		SPDK_ERRLOG("Inactive admin qpair (state %d, group %p)\n", admin_qpair_state, admin_qpair_group);
-		SPDK_NVMF_INVALID_CONNECT_CMD(rsp, qid);
-		spdk_nvmf_request_complete(req);
-		return;
+	ctrlr = nvmf_subsystem_pg_find_ctrlr(&group->sgroups[subsystem->id], data->cntlid);
+	if (ctrlr == NULL || ctrlr->subsys != subsystem) {
+		return false;
 	}
-	qpair->ctrlr = ctrlr;
-	spdk_thread_send_msg(admin_qpair_group->thread, nvmf_ctrlr_add_io_qpair, req);
+
+	SPDK_DEBUGLOG(nvmf, "Connect I/O Queue for controller id 0x%x\n", data->cntlid);
+
+	nvmf_ctrlr_route_io_qpair(req, ctrlr);
+
+	return true;
 }
 
 static bool
@@ -941,7 +1101,9 @@ _nvmf_ctrlr_connect(struct spdk_nvmf_request *req)
 			return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
 		}
 	} else {
-		spdk_thread_send_msg(subsystem->thread, _nvmf_ctrlr_add_io_qpair, req);
+		if (!nvmf_ctrlr_route_io_qpair_from_pg(req, subsystem)) {
+			spdk_thread_send_msg(subsystem->thread, _nvmf_ctrlr_add_io_qpair, req);
+		}
 		return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
 	}
 }
@@ -2082,7 +2244,7 @@ nvmf_ctrlr_set_features_number_of_queues(struct spdk_nvmf_request *req)
 	return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 }
 
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ctrlr) == 4928,
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ctrlr) == 4944,
 		   "Please check migration fields that need to be added or not");
 
 static void
@@ -4444,24 +4606,19 @@ nvmf_ctrlr_process_io_fused_cmd(struct spdk_nvmf_request *req, struct spdk_bdev
 	return rc;
 }
 
-bool
-nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req)
+static bool
+_nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req, bool read_only)
 {
-	struct spdk_nvmf_transport *transport = req->qpair->transport;
 	struct spdk_nvmf_ns *ns;
 
 	assert(req->zcopy_phase == NVMF_ZCOPY_PHASE_NONE);
 
-	if (!transport->opts.zcopy) {
-		return false;
-	}
-
 	if (nvmf_qpair_is_admin_queue(req->qpair)) {
 		/* Admin queue */
 		return false;
 	}
 
-	if ((req->cmd->nvme_cmd.opc != SPDK_NVME_OPC_WRITE) &&
+	if ((req->cmd->nvme_cmd.opc != SPDK_NVME_OPC_WRITE || read_only) &&
 	    (req->cmd->nvme_cmd.opc != SPDK_NVME_OPC_READ)) {
 		/* Not a READ or WRITE command */
 		return false;
@@ -4481,6 +4638,22 @@ nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req)
 	return true;
 }
 
+bool
+nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req)
+{
+	if (!req->qpair->transport->opts.zcopy) {
+		return false;
+	}
+
+	return _nvmf_ctrlr_use_zcopy(req, false);
+}
+
+bool
+nvmf_ctrlr_use_zcopy_read(struct spdk_nvmf_request *req)
+{
+	return _nvmf_ctrlr_use_zcopy(req, true);
+}
+
 void
 spdk_nvmf_request_zcopy_start(struct spdk_nvmf_request *req)
 {
@@ -4501,14 +4674,200 @@ spdk_nvmf_request_zcopy_end(struct spdk_nvmf_request *req, bool commit)
 	nvmf_bdev_ctrlr_zcopy_end(req, commit);
 }
 
+/* Virtual time charged for one 4KiB unit of data at weight 1. It is the largest weight,
+ * so that the charge is never truncated to zero.
+ */
+#define NVMF_FQ_COST_SCALE	SPDK_NVMF_FQ_MAX_WEIGHT
+#define NVMF_FQ_COST_UNIT_SHIFT	12
+
+void
+nvmf_ns_info_free_fq_flows(struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	struct nvmf_fq_flow *flow;
+
+	assert(ns_info->fq_queued == 0);
+
+	while ((flow = SLIST_FIRST(&ns_info->fq_flows))) {
+		SLIST_REMOVE_HEAD(&ns_info->fq_flows, link);
+		free(flow);
+	}
+}
+
+static struct nvmf_fq_flow *
+nvmf_fq_get_flow(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, struct spdk_nvmf_ctrlr *ctrlr)
+{
+	struct nvmf_fq_flow *flow, *tmp;
+	uint64_t now = spdk_get_ticks();
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+
+	SLIST_FOREACH_SAFE(flow, &ns_info->fq_flows, link, tmp) {
+		if (flow->cntlid == ctrlr->fq_cntlid && strcmp(flow->hostnqn, ctrlr->hostnqn) == 0) {
+			return flow;
+		}
+
+		/* Release flows that have been idle for a whole min_iops window */
+		if (STAILQ_EMPTY(&flow->queue) && now - flow->window_start_tsc >= ticks_hz) {
+			SLIST_REMOVE(&ns_info->fq_flows, flow, nvmf_fq_flow, link);
+			free(flow);
+		}
+	}
+
+	flow = calloc(1, sizeof(*flow));
+	if (flow == NULL) {
+		return NULL;
+	}
+
+	snprintf(flow->hostnqn, sizeof(flow->hostnqn), "%s", ctrlr->hostnqn);
+	flow->cntlid = ctrlr->fq_cntlid;
+	flow->finish = ns_info->fq_vtime;
+	flow->window_start_tsc = now;
+	STAILQ_INIT(&flow->queue);
+	SLIST_INSERT_HEAD(&ns_info->fq_flows, flow, link);
+
+	return flow;
+}
+
+/* Pick the flow whose head request has the lowest virtual start time. Flows that have
+ * not reached their min_iops within the current window take precedence.
+ */
+static struct nvmf_fq_flow *
+nvmf_fq_pick_flow(struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	struct nvmf_fq_flow *flow, *best = NULL, *reserved = NULL;
+	uint64_t now = spdk_get_ticks();
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+
+	SLIST_FOREACH(flow, &ns_info->fq_flows, link) {
+		if (now - flow->window_start_tsc >= ticks_hz) {
+			flow->window_start_tsc = now;
+			flow->window_count = 0;
+		}
+
+		if (STAILQ_EMPTY(&flow->queue)) {
+			continue;
+		}
+
+		if (flow->window_count < flow->min_iops) {
+			if (reserved == NULL || flow->start < reserved->start) {
+				reserved = flow;
+			}
+		} else if (best == NULL || flow->start < best->start) {
+			best = flow;
+		}
+	}
+
+	return reserved != NULL ? reserved : best;
+}
+
+static void
+nvmf_fq_submit_io_cmd(struct spdk_nvmf_request *req)
+{
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+	struct spdk_nvme_cpl *response = &req->rsp->nvme_cpl;
+	struct spdk_nvmf_ns *ns;
+	int status;
+
+	if (spdk_unlikely(qpair->state != SPDK_NVMF_QPAIR_ENABLED)) {
+		response->status.sct = SPDK_NVME_SCT_GENERIC;
+		response->status.sc = SPDK_NVME_SC_ABORTED_SQ_DELETION;
+		_nvmf_request_complete(req);
+		return;
+	}
+
+	ns = nvmf_ctrlr_get_ns(qpair->ctrlr, req->cmd->nvme_cmd.nsid);
+	if (spdk_unlikely(ns == NULL || ns->bdev == NULL)) {
+		response->status.sct = SPDK_NVME_SCT_GENERIC;
+		response->status.sc = SPDK_NVME_SC_INVALID_NAMESPACE_OR_FORMAT;
+		response->status.dnr = 1;
+		_nvmf_request_complete(req);
+		return;
+	}
+
+	status = nvmf_ctrlr_submit_io_cmd(req, ns, req->fq_ns_info);
+	if (status == SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE) {
+		_nvmf_request_complete(req);
+	}
+}
+
+static void
+nvmf_fq_dispatch(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, uint32_t depth)
+{
+	struct nvmf_fq_flow *flow;
+	struct spdk_nvmf_request *req;
+	uint64_t cost;
+
+	/* Requests completing inline are picked up by the loop below */
+	if (ns_info->fq_dispatching) {
+		return;
+	}
+
+	ns_info->fq_dispatching = true;
+	while (ns_info->fq_queued > 0 && (depth == 0 || ns_info->fq_inflight < depth)) {
+		flow = nvmf_fq_pick_flow(ns_info);
+		assert(flow != NULL);
+
+		req = STAILQ_FIRST(&flow->queue);
+		STAILQ_REMOVE_HEAD(&flow->queue, fq_link);
+		ns_info->fq_queued--;
+
+		cost = spdk_max(req->length >> NVMF_FQ_COST_UNIT_SHIFT, 1);
+		ns_info->fq_vtime = spdk_max(ns_info->fq_vtime, flow->start);
+		flow->finish = flow->start + spdk_max(cost * NVMF_FQ_COST_SCALE / flow->weight, 1);
+		flow->start = flow->finish;
+		flow->window_count++;
+
+		ns_info->fq_inflight++;
+		nvmf_fq_submit_io_cmd(req);
+	}
+	ns_info->fq_dispatching = false;
+}
+
+static int
+nvmf_fq_admit_io_cmd(struct spdk_nvmf_request *req, struct spdk_nvmf_ns *ns,
+		     struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = req->qpair->ctrlr;
+	struct nvmf_fq_flow *flow;
+
+	req->fq_ns_info = ns_info;
+
+	if (ns_info->fq_queued == 0 && ns_info->fq_inflight < ctrlr->subsys->fq_depth) {
+		ns_info->fq_inflight++;
+		return nvmf_ctrlr_submit_io_cmd(req, ns, ns_info);
+	}
+
+	flow = nvmf_fq_get_flow(ns_info, ctrlr);
+	if (spdk_unlikely(flow == NULL)) {
+		ns_info->fq_inflight++;
+		return nvmf_ctrlr_submit_io_cmd(req, ns, ns_info);
+	}
+
+	flow->weight = spdk_max(ctrlr->fq_weight, 1);
+	flow->min_iops = ctrlr->fq_min_iops;
+	if (STAILQ_EMPTY(&flow->queue)) {
+		flow->start = spdk_max(ns_info->fq_vtime, flow->finish);
+	}
+
+	STAILQ_INSERT_TAIL(&flow->queue, req, fq_link);
+	ns_info->fq_queued++;
+
+	return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
+}
+
+static void
+nvmf_fq_release(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, struct spdk_nvmf_subsystem *subsystem)
+{
+	assert(ns_info->fq_inflight > 0);
+	ns_info->fq_inflight--;
+
+	nvmf_fq_dispatch(ns_info, subsystem->fq_depth);
+}
+
 int
 nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
 {
 	uint32_t nsid;
 	struct spdk_nvmf_ns *ns;
-	struct spdk_bdev *bdev;
-	struct spdk_bdev_desc *desc;
-	struct spdk_io_channel *ch;
 	struct spdk_nvmf_qpair *qpair = req->qpair;
 	struct spdk_nvmf_poll_group *group = qpair->group;
 	struct spdk_nvmf_ctrlr *ctrlr = qpair->ctrlr;
@@ -4562,6 +4921,28 @@ nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
 		return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 	}
 
+	/* Fused commands must be submitted back to back, so they bypass fair queuing.
+	 * Requests resubmitted after ENOMEM were already admitted. */
+	if (spdk_unlikely(ctrlr->subsys->fq_depth != 0) && req->fq_ns_info == NULL &&
+	    !(cmd->fuse & SPDK_NVME_CMD_FUSE_MASK) && qpair->first_fused_req == NULL) {
+		return nvmf_fq_admit_io_cmd(req, ns, ns_info);
+	}
+
+	return nvmf_ctrlr_submit_io_cmd(req, ns, ns_info);
+}
+
+static int
+nvmf_ctrlr_submit_io_cmd(struct spdk_nvmf_request *req, struct spdk_nvmf_ns *ns,
+			 struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc;
+	struct spdk_io_channel *ch;
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+	struct spdk_nvmf_ctrlr *ctrlr = qpair->ctrlr;
+	struct spdk_nvme_cmd *cmd = &req->cmd->nvme_cmd;
+	struct spdk_nvme_cpl *response = &req->rsp->nvme_cpl;
+
 	bdev = ns->bdev;
 	desc = ns->desc;
 	ch = ns_info->channel;
@@ -4682,6 +5063,7 @@ _nvmf_request_complete(void *ctx)
 	struct spdk_nvmf_qpair *qpair;
 	struct spdk_nvmf_subsystem_poll_group *sgroup = NULL;
 	struct spdk_nvmf_subsystem_pg_ns_info *ns_info;
+	struct spdk_nvmf_subsystem_pg_ns_info *fq_ns_info = NULL;
 	bool is_aer = false;
 	uint32_t nsid;
 	bool paused;
@@ -4743,6 +5125,15 @@ _nvmf_request_complete(void *ctx)
 		break;
 	}
 
+	/* The transport may reuse the request once it's completed */
+	if (spdk_unlikely(req->fq_ns_info != NULL) &&
+	    (req->zcopy_phase == NVMF_ZCOPY_PHASE_NONE ||
+	     req->zcopy_phase == NVMF_ZCOPY_PHASE_COMPLETE ||
+	     req->zcopy_phase == NVMF_ZCOPY_PHASE_INIT_FAILED)) {
+		fq_ns_info = req->fq_ns_info;
+		req->fq_ns_info = NULL;
+	}
+
 	if (spdk_unlikely(nvmf_transport_req_complete(req))) {
 		SPDK_ERRLOG("Transport request completion error!\n");
 	}
@@ -4763,6 +5154,10 @@ _nvmf_request_complete(void *ctx)
 				if (spdk_likely(nsid - 1 < sgroup->num_ns)) {
 					sgroup->ns_info[nsid - 1].io_outstanding--;
 				}
+
+				if (spdk_unlikely(fq_ns_info != NULL)) {
+					nvmf_fq_release(fq_ns_info, qpair->ctrlr->subsys);
+				}
 			}
 		}
 
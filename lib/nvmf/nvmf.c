@@ -190,9 +190,11 @@ nvmf_tgt_cleanup_poll_group(struct spdk_nvmf_poll_group *group)
 				spdk_put_io_channel(sgroup->ns_info[nsid].channel);
 				sgroup->ns_info[nsid].channel = NULL;
 			}
+			nvmf_ns_info_free_fq_flows(&sgroup->ns_info[nsid]);
 		}
 
 		free(sgroup->ns_info);
+		nvmf_subsystem_pg_free_ctrlrs(sgroup);
 	}
 
 	free(group->sgroups);
@@ -288,6 +290,7 @@ nvmf_tgt_create_poll_group(void *io_device, void *ctx_buf)
 
 	for (i = 0; i < tgt->max_subsystems; i++) {
 		TAILQ_INIT(&group->sgroups[i].queued);
+		RB_INIT(&group->sgroups[i].ctrlrs);
 	}
 
 	for (subsystem = spdk_nvmf_subsystem_get_first(tgt);
@@ -551,6 +554,7 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 				 struct spdk_nvmf_subsystem *subsystem)
 {
 	struct spdk_nvmf_host *host;
+	struct spdk_nvmf_fq_host *fq_host;
 	struct spdk_nvmf_ns *ns;
 	struct spdk_nvmf_ns_opts ns_opts;
 	uint32_t max_namespaces;
@@ -679,6 +683,33 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 			spdk_json_write_object_end(w);
 		}
 	}
+
+	pthread_mutex_lock(&subsystem->mutex);
+	TAILQ_FOREACH(fq_host, &subsystem->fq_hosts, link) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "method", "nvmf_subsystem_set_host_fairness");
+		spdk_json_write_named_object_begin(w, "params");
+		spdk_json_write_named_string(w, "nqn", spdk_nvmf_subsystem_get_nqn(subsystem));
+		spdk_json_write_named_string(w, "host", fq_host->nqn);
+		if (fq_host->cntlid != 0) {
+			spdk_json_write_named_uint32(w, "cntlid", fq_host->cntlid);
+		}
+		spdk_json_write_named_uint32(w, "weight", fq_host->weight);
+		spdk_json_write_named_uint32(w, "min_iops", fq_host->min_iops);
+		spdk_json_write_object_end(w);
+		spdk_json_write_object_end(w);
+	}
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	if (subsystem->fq_depth != 0) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "method", "nvmf_subsystem_set_fair_queuing");
+		spdk_json_write_named_object_begin(w, "params");
+		spdk_json_write_named_string(w, "nqn", spdk_nvmf_subsystem_get_nqn(subsystem));
+		spdk_json_write_named_uint32(w, "queue_depth", subsystem->fq_depth);
+		spdk_json_write_object_end(w);
+		spdk_json_write_object_end(w);
+	}
 }
 
 static void
@@ -1528,6 +1559,7 @@ poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 			/* A namespace was here before, but was replaced by a new one. */
 			ns_changed = true;
 			spdk_put_io_channel(ns_info->channel);
+			nvmf_ns_info_free_fq_flows(ns_info);
 			memset(ns_info, 0, sizeof(*ns_info));
 
 			ch = spdk_bdev_get_io_channel(ns->desc);
@@ -1559,6 +1591,7 @@ poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 		}
 
 		if (ns == NULL) {
+			nvmf_ns_info_free_fq_flows(ns_info);
 			memset(ns_info, 0, sizeof(*ns_info));
 		} else {
 			ns_info->uuid = *spdk_bdev_get_uuid(ns->bdev);
@@ -1679,6 +1712,7 @@ _nvmf_poll_group_remove_subsystem_cb(void *ctx, int status)
 			spdk_put_io_channel(sgroup->ns_info[nsid].channel);
 			sgroup->ns_info[nsid].channel = NULL;
 		}
+		nvmf_ns_info_free_fq_flows(&sgroup->ns_info[nsid]);
 	}
 
 	sgroup->num_ns = 0;
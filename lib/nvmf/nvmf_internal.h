@@ -92,6 +92,15 @@ struct spdk_nvmf_host {
 	TAILQ_ENTRY(spdk_nvmf_host)	link;
 };
 
+struct spdk_nvmf_fq_host {
+	char				nqn[SPDK_NVMF_NQN_MAX_LEN + 1];
+	/* Zero if the settings apply to all controllers of the host */
+	uint16_t			cntlid;
+	uint32_t			weight;
+	uint32_t			min_iops;
+	TAILQ_ENTRY(spdk_nvmf_fq_host)	link;
+};
+
 struct spdk_nvmf_subsystem_listener {
 	struct spdk_nvmf_subsystem			*subsystem;
 	spdk_nvmf_tgt_subsystem_listen_done_fn		cb_fn;
@@ -113,6 +122,24 @@ struct spdk_nvmf_referral {
 	TAILQ_ENTRY(spdk_nvmf_referral) link;
 };
 
+/* Requests of one host (or one controller of a host) waiting for fair queuing dispatch */
+struct nvmf_fq_flow {
+	char					hostnqn[SPDK_NVMF_NQN_MAX_LEN + 1];
+	/* Zero if the flow is shared by all controllers of the host */
+	uint16_t				cntlid;
+	uint32_t				weight;
+	uint32_t				min_iops;
+	/* Virtual start time of the request at the head of the queue */
+	uint64_t				start;
+	/* Virtual finish time of the last dispatched request */
+	uint64_t				finish;
+	/* Requests dispatched during the current one second min_iops window */
+	uint64_t				window_start_tsc;
+	uint64_t				window_count;
+	STAILQ_HEAD(, spdk_nvmf_request)	queue;
+	SLIST_ENTRY(nvmf_fq_flow)		link;
+};
+
 struct spdk_nvmf_subsystem_pg_ns_info {
 	struct spdk_io_channel		*channel;
 	struct spdk_uuid		uuid;
@@ -130,10 +157,27 @@ struct spdk_nvmf_subsystem_pg_ns_info {
 	/* I/O outstanding to this namespace */
 	uint64_t			io_outstanding;
 	enum spdk_nvmf_subsystem_state	state;
+
+	/* Fair queuing state, see spdk_nvmf_subsystem_set_fair_queuing() */
+	uint32_t			fq_inflight;
+	uint32_t			fq_queued;
+	uint64_t			fq_vtime;
+	bool				fq_dispatching;
+	SLIST_HEAD(, nvmf_fq_flow)	fq_flows;
 };
 
 typedef void(*spdk_nvmf_poll_group_mod_done)(void *cb_arg, int status);
 
+/* Poll group's copy of a subsystem's controller list, used to route I/O queue CONNECTs
+ * to the controller without going through the subsystem thread */
+struct nvmf_pg_ctrlr {
+	uint16_t				cntlid;
+	struct spdk_nvmf_ctrlr			*ctrlr;
+	RB_ENTRY(nvmf_pg_ctrlr)			link;
+};
+
+RB_HEAD(nvmf_pg_ctrlr_tree, nvmf_pg_ctrlr);
+
 struct spdk_nvmf_subsystem_poll_group {
 	/* Array of namespace information for each namespace indexed by nsid - 1 */
 	struct spdk_nvmf_subsystem_pg_ns_info	*ns_info;
@@ -146,6 +190,8 @@ struct spdk_nvmf_subsystem_poll_group {
 	void					*cb_arg;
 
 	TAILQ_HEAD(, spdk_nvmf_request)		queued;
+
+	struct nvmf_pg_ctrlr_tree		ctrlrs;
 };
 
 struct spdk_nvmf_registrant {
@@ -262,6 +308,16 @@ struct spdk_nvmf_ctrlr {
 	/* LBA Format Extension Enabled (LBAFEE) */
 	bool				lbafee_enabled;
 
+	/* Adding to or removing from the poll groups' controller lists is in progress */
+	bool				pg_update_in_progress;
+	/* nvmf_ctrlr_destruct() was called while adding to the poll groups */
+	bool				pg_destruct_pending;
+
+	/* Fair queuing settings resolved from the subsystem's fq_hosts */
+	uint16_t			fq_cntlid;
+	uint32_t			fq_weight;
+	uint32_t			fq_min_iops;
+
 	TAILQ_ENTRY(spdk_nvmf_ctrlr)	link;
 };
 
@@ -352,6 +408,11 @@ struct spdk_nvmf_subsystem {
 	/* In-band authentication sequence number, protected by ->mutex */
 	uint32_t					auth_seqnum;
 	bool						passthrough;
+
+	/* Max I/O in flight per namespace per poll group, 0 disables fair queuing */
+	uint32_t					fq_depth;
+	/* Protected against concurrent access by ->mutex */
+	TAILQ_HEAD(, spdk_nvmf_fq_host)			fq_hosts;
 };
 
 static int
@@ -388,6 +449,13 @@ bool nvmf_ctrlr_write_zeroes_supported(struct spdk_nvmf_ctrlr *ctrlr);
 bool nvmf_ctrlr_copy_supported(struct spdk_nvmf_ctrlr *ctrlr);
 void nvmf_ctrlr_ns_changed(struct spdk_nvmf_ctrlr *ctrlr, uint32_t nsid);
 bool nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req);
+/* Same as nvmf_ctrlr_use_zcopy(), but only for READ commands and regardless of the
+ * transport's zcopy option.
+ */
+bool nvmf_ctrlr_use_zcopy_read(struct spdk_nvmf_request *req);
+void nvmf_subsystem_pg_free_ctrlrs(struct spdk_nvmf_subsystem_poll_group *sgroup);
+/* Free the fair queuing flows of a poll group namespace. No requests may be queued. */
+void nvmf_ns_info_free_fq_flows(struct spdk_nvmf_subsystem_pg_ns_info *ns_info);
 
 void nvmf_bdev_ctrlr_identify_ns(struct spdk_nvmf_ns *ns, struct spdk_nvme_ns_data *nsdata,
 				 bool dif_insert_or_strip);
@@ -473,7 +473,8 @@ cleanup:
 		spdk_nvmf_subsystem_destroy(subsystem, NULL, NULL);
 	}
 }
-SPDK_RPC_REGISTER("nvmf_create_subsystem", rpc_nvmf_create_subsystem, SPDK_RPC_RUNTIME)
+SPDK_RPC_REGISTER_CONCURRENT("nvmf_create_subsystem", rpc_nvmf_create_subsystem, SPDK_RPC_RUNTIME,
+			     "nqn")
 
 struct rpc_delete_subsystem {
 	char *nqn;
@@ -942,8 +943,8 @@ rpc_nvmf_subsystem_add_listener(struct spdk_jsonrpc_request *request,
 		nvmf_rpc_listener_ctx_free(ctx);
 	}
 }
-SPDK_RPC_REGISTER("nvmf_subsystem_add_listener", rpc_nvmf_subsystem_add_listener,
-		  SPDK_RPC_RUNTIME);
+SPDK_RPC_REGISTER_CONCURRENT("nvmf_subsystem_add_listener", rpc_nvmf_subsystem_add_listener,
+			     SPDK_RPC_RUNTIME, "nqn");
 
 static void
 rpc_nvmf_subsystem_remove_listener(struct spdk_jsonrpc_request *request,
@@ -1581,7 +1582,8 @@ rpc_nvmf_subsystem_add_ns(struct spdk_jsonrpc_request *request,
 		nvmf_rpc_ns_ctx_free(ctx);
 	}
 }
-SPDK_RPC_REGISTER("nvmf_subsystem_add_ns", rpc_nvmf_subsystem_add_ns, SPDK_RPC_RUNTIME)
+SPDK_RPC_REGISTER_CONCURRENT("nvmf_subsystem_add_ns", rpc_nvmf_subsystem_add_ns, SPDK_RPC_RUNTIME,
+			     "nqn")
 
 struct nvmf_rpc_ana_group_ctx {
 	char *nqn;
@@ -2050,7 +2052,8 @@ out:
 	spdk_keyring_put_key(key);
 	nvmf_rpc_host_ctx_free(&ctx);
 }
-SPDK_RPC_REGISTER("nvmf_subsystem_add_host", rpc_nvmf_subsystem_add_host, SPDK_RPC_RUNTIME)
+SPDK_RPC_REGISTER_CONCURRENT("nvmf_subsystem_add_host", rpc_nvmf_subsystem_add_host,
+			     SPDK_RPC_RUNTIME, "nqn")
 
 static void
 rpc_nvmf_subsystem_remove_host_done(void *_ctx, int status)
@@ -2252,6 +2255,137 @@ rpc_nvmf_subsystem_allow_any_host(struct spdk_jsonrpc_request *request,
 SPDK_RPC_REGISTER("nvmf_subsystem_allow_any_host", rpc_nvmf_subsystem_allow_any_host,
 		  SPDK_RPC_RUNTIME)
 
+struct nvmf_rpc_fair_queuing_ctx {
+	char *nqn;
+	char *host;
+	char *tgt_name;
+	uint32_t queue_depth;
+	uint16_t cntlid;
+	uint32_t weight;
+	uint32_t min_iops;
+};
+
+static void
+nvmf_rpc_fair_queuing_ctx_free(struct nvmf_rpc_fair_queuing_ctx *ctx)
+{
+	free(ctx->nqn);
+	free(ctx->host);
+	free(ctx->tgt_name);
+}
+
+static struct spdk_nvmf_subsystem *
+nvmf_rpc_fair_queuing_get_subsystem(struct spdk_jsonrpc_request *request,
+				    struct nvmf_rpc_fair_queuing_ctx *ctx)
+{
+	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_tgt *tgt;
+
+	tgt = spdk_nvmf_get_tgt(ctx->tgt_name);
+	if (!tgt) {
+		SPDK_ERRLOG("Unable to find a target object.\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Unable to find a target.");
+		return NULL;
+	}
+
+	subsystem = spdk_nvmf_tgt_find_subsystem(tgt, ctx->nqn);
+	if (!subsystem) {
+		SPDK_ERRLOG("Unable to find subsystem with NQN %s\n", ctx->nqn);
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		return NULL;
+	}
+
+	return subsystem;
+}
+
+static const struct spdk_json_object_decoder nvmf_rpc_subsystem_fair_queuing_decoder[] = {
+	{"nqn", offsetof(struct nvmf_rpc_fair_queuing_ctx, nqn), spdk_json_decode_string},
+	{"queue_depth", offsetof(struct nvmf_rpc_fair_queuing_ctx, queue_depth), spdk_json_decode_uint32},
+	{"tgt_name", offsetof(struct nvmf_rpc_fair_queuing_ctx, tgt_name), spdk_json_decode_string, true},
+};
+
+static void
+rpc_nvmf_subsystem_set_fair_queuing(struct spdk_jsonrpc_request *request,
+				    const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_fair_queuing_ctx ctx = {};
+	struct spdk_nvmf_subsystem *subsystem;
+	int rc;
+
+	if (spdk_json_decode_object(params, nvmf_rpc_subsystem_fair_queuing_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_subsystem_fair_queuing_decoder),
+				    &ctx)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		nvmf_rpc_fair_queuing_ctx_free(&ctx);
+		return;
+	}
+
+	subsystem = nvmf_rpc_fair_queuing_get_subsystem(request, &ctx);
+	if (!subsystem) {
+		nvmf_rpc_fair_queuing_ctx_free(&ctx);
+		return;
+	}
+
+	rc = spdk_nvmf_subsystem_set_fair_queuing(subsystem, ctx.queue_depth);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		nvmf_rpc_fair_queuing_ctx_free(&ctx);
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+	nvmf_rpc_fair_queuing_ctx_free(&ctx);
+}
+SPDK_RPC_REGISTER("nvmf_subsystem_set_fair_queuing", rpc_nvmf_subsystem_set_fair_queuing,
+		  SPDK_RPC_RUNTIME)
+
+static const struct spdk_json_object_decoder nvmf_rpc_subsystem_host_fairness_decoder[] = {
+	{"nqn", offsetof(struct nvmf_rpc_fair_queuing_ctx, nqn), spdk_json_decode_string},
+	{"host", offsetof(struct nvmf_rpc_fair_queuing_ctx, host), spdk_json_decode_string},
+	{"cntlid", offsetof(struct nvmf_rpc_fair_queuing_ctx, cntlid), spdk_json_decode_uint16, true},
+	{"weight", offsetof(struct nvmf_rpc_fair_queuing_ctx, weight), spdk_json_decode_uint32, true},
+	{"min_iops", offsetof(struct nvmf_rpc_fair_queuing_ctx, min_iops), spdk_json_decode_uint32, true},
+	{"tgt_name", offsetof(struct nvmf_rpc_fair_queuing_ctx, tgt_name), spdk_json_decode_string, true},
+};
+
+static void
+rpc_nvmf_subsystem_set_host_fairness(struct spdk_jsonrpc_request *request,
+				     const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_fair_queuing_ctx ctx = { .weight = 1 };
+	struct spdk_nvmf_subsystem *subsystem;
+	int rc;
+
+	if (spdk_json_decode_object(params, nvmf_rpc_subsystem_host_fairness_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_subsystem_host_fairness_decoder),
+				    &ctx)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		nvmf_rpc_fair_queuing_ctx_free(&ctx);
+		return;
+	}
+
+	subsystem = nvmf_rpc_fair_queuing_get_subsystem(request, &ctx);
+	if (!subsystem) {
+		nvmf_rpc_fair_queuing_ctx_free(&ctx);
+		return;
+	}
+
+	rc = spdk_nvmf_subsystem_set_host_fairness(subsystem, ctx.host, ctx.cntlid, ctx.weight,
+			ctx.min_iops);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		nvmf_rpc_fair_queuing_ctx_free(&ctx);
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+	nvmf_rpc_fair_queuing_ctx_free(&ctx);
+}
+SPDK_RPC_REGISTER("nvmf_subsystem_set_host_fairness", rpc_nvmf_subsystem_set_host_fairness,
+		  SPDK_RPC_RUNTIME)
+
 struct nvmf_rpc_target_ctx {
 	char *name;
 	uint32_t max_subsystems;
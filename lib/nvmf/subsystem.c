@@ -269,6 +269,7 @@ spdk_nvmf_subsystem_create(struct spdk_nvmf_tgt *tgt,
 	pthread_mutex_init(&subsystem->mutex, NULL);
 	TAILQ_INIT(&subsystem->listeners);
 	TAILQ_INIT(&subsystem->hosts);
+	TAILQ_INIT(&subsystem->fq_hosts);
 	TAILQ_INIT(&subsystem->ctrlrs);
 	TAILQ_INIT(&subsystem->state_changes);
 	subsystem->used_listener_ids = spdk_bit_array_create(NVMF_MAX_LISTENERS_PER_SUBSYSTEM);
@@ -450,6 +451,7 @@ spdk_nvmf_subsystem_destroy(struct spdk_nvmf_subsystem *subsystem, nvmf_subsyste
 			    void *cpl_cb_arg)
 {
 	struct spdk_nvmf_host *host, *host_tmp;
+	struct spdk_nvmf_fq_host *fq_host, *fq_host_tmp;
 	struct spdk_nvmf_transport *transport;
 
 	if (!subsystem) {
@@ -489,6 +491,11 @@ spdk_nvmf_subsystem_destroy(struct spdk_nvmf_subsystem *subsystem, nvmf_subsyste
 		nvmf_subsystem_remove_host(subsystem, host);
 	}
 
+	TAILQ_FOREACH_SAFE(fq_host, &subsystem->fq_hosts, link, fq_host_tmp) {
+		TAILQ_REMOVE(&subsystem->fq_hosts, fq_host, link);
+		free(fq_host);
+	}
+
 	pthread_mutex_unlock(&subsystem->mutex);
 
 	subsystem->async_destroy_cb = cpl_cb;
@@ -1355,6 +1362,104 @@ spdk_nvmf_host_get_nqn(const struct spdk_nvmf_host *host)
 	return host->nqn;
 }
 
+int
+spdk_nvmf_subsystem_set_fair_queuing(struct spdk_nvmf_subsystem *subsystem, uint32_t queue_depth)
+{
+	if (spdk_nvmf_subsystem_is_discovery(subsystem)) {
+		return -EINVAL;
+	}
+
+	subsystem->fq_depth = queue_depth;
+
+	return 0;
+}
+
+uint32_t
+spdk_nvmf_subsystem_get_fair_queuing(const struct spdk_nvmf_subsystem *subsystem)
+{
+	return subsystem->fq_depth;
+}
+
+/* Must hold subsystem->mutex while calling this function */
+static void
+nvmf_subsystem_resolve_fairness(struct spdk_nvmf_subsystem *subsystem, struct spdk_nvmf_ctrlr *ctrlr)
+{
+	struct spdk_nvmf_fq_host *fq_host, *match = NULL;
+
+	TAILQ_FOREACH(fq_host, &subsystem->fq_hosts, link) {
+		if (strcmp(fq_host->nqn, ctrlr->hostnqn) != 0) {
+			continue;
+		}
+		if (fq_host->cntlid == ctrlr->cntlid) {
+			match = fq_host;
+			break;
+		}
+		if (fq_host->cntlid == 0) {
+			match = fq_host;
+		}
+	}
+
+	if (match != NULL) {
+		ctrlr->fq_cntlid = match->cntlid;
+		ctrlr->fq_weight = match->weight;
+		ctrlr->fq_min_iops = match->min_iops;
+	} else {
+		ctrlr->fq_cntlid = 0;
+		ctrlr->fq_weight = 1;
+		ctrlr->fq_min_iops = 0;
+	}
+}
+
+int
+spdk_nvmf_subsystem_set_host_fairness(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
+				      uint16_t cntlid, uint32_t weight, uint32_t min_iops)
+{
+	struct spdk_nvmf_fq_host *fq_host;
+	struct spdk_nvmf_ctrlr *ctrlr;
+
+	if (weight == 0 || weight > SPDK_NVMF_FQ_MAX_WEIGHT || hostnqn == NULL ||
+	    !nvmf_nqn_is_valid(hostnqn)) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&subsystem->mutex);
+
+	TAILQ_FOREACH(fq_host, &subsystem->fq_hosts, link) {
+		if (fq_host->cntlid == cntlid && strcmp(fq_host->nqn, hostnqn) == 0) {
+			break;
+		}
+	}
+
+	if (weight == 1 && min_iops == 0) {
+		/* Back to the defaults, no need to keep the entry around */
+		if (fq_host != NULL) {
+			TAILQ_REMOVE(&subsystem->fq_hosts, fq_host, link);
+			free(fq_host);
+		}
+	} else {
+		if (fq_host == NULL) {
+			fq_host = calloc(1, sizeof(*fq_host));
+			if (fq_host == NULL) {
+				pthread_mutex_unlock(&subsystem->mutex);
+				return -ENOMEM;
+			}
+			snprintf(fq_host->nqn, sizeof(fq_host->nqn), "%s", hostnqn);
+			fq_host->cntlid = cntlid;
+			TAILQ_INSERT_TAIL(&subsystem->fq_hosts, fq_host, link);
+		}
+		fq_host->weight = weight;
+		fq_host->min_iops = min_iops;
+	}
+
+	TAILQ_FOREACH(ctrlr, &subsystem->ctrlrs, link) {
+		nvmf_subsystem_resolve_fairness(subsystem, ctrlr);
+	}
+
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	return 0;
+}
+
 struct spdk_nvmf_subsystem_listener *
 nvmf_subsystem_find_listener(struct spdk_nvmf_subsystem *subsystem,
 			     const struct spdk_nvme_transport_id *trid)
@@ -2565,6 +2670,10 @@ nvmf_subsystem_add_ctrlr(struct spdk_nvmf_subsystem *subsystem, struct spdk_nvmf
 
 	TAILQ_INSERT_TAIL(&subsystem->ctrlrs, ctrlr, link);
 
+	pthread_mutex_lock(&subsystem->mutex);
+	nvmf_subsystem_resolve_fairness(subsystem, ctrlr);
+	pthread_mutex_unlock(&subsystem->mutex);
+
 	SPDK_DTRACE_PROBE3(nvmf_subsystem_add_ctrlr, subsystem->subnqn, ctrlr, ctrlr->hostnqn);
 
 	return 0;
@@ -360,6 +360,7 @@ struct spdk_nvmf_tcp_port {
 
 struct tcp_transport_opts {
 	bool		c2h_success;
+	bool		c2h_zcopy;
 	uint16_t	control_msg_num;
 	uint32_t	sock_priority;
 };
@@ -396,6 +397,10 @@ static const struct spdk_json_object_decoder tcp_transport_opts_decoder[] = {
 		"c2h_success", offsetof(struct tcp_transport_opts, c2h_success),
 		spdk_json_decode_bool, true
 	},
+	{
+		"c2h_zcopy", offsetof(struct tcp_transport_opts, c2h_zcopy),
+		spdk_json_decode_bool, true
+	},
 	{
 		"control_msg_num", offsetof(struct tcp_transport_opts, control_msg_num),
 		spdk_json_decode_uint16, true
@@ -658,6 +663,7 @@ nvmf_tcp_dump_opts(struct spdk_nvmf_transport *transport, struct spdk_json_write
 
 	ttransport = SPDK_CONTAINEROF(transport, struct spdk_nvmf_tcp_transport, transport);
 	spdk_json_write_named_bool(w, "c2h_success", ttransport->tcp_opts.c2h_success);
+	spdk_json_write_named_bool(w, "c2h_zcopy", ttransport->tcp_opts.c2h_zcopy);
 	spdk_json_write_named_uint32(w, "sock_priority", ttransport->tcp_opts.sock_priority);
 }
 
@@ -744,7 +750,7 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 		     "  num_shared_buffers=%d, c2h_success=%d,\n"
 		     "  dif_insert_or_strip=%d, sock_priority=%d\n"
 		     "  abort_timeout_sec=%d, control_msg_num=%hu\n"
-		     "  ack_timeout=%d\n",
+		     "  ack_timeout=%d, c2h_zcopy=%d\n",
 		     opts->max_queue_depth,
 		     opts->max_io_size,
 		     opts->max_qpairs_per_ctrlr - 1,
@@ -757,7 +763,8 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 		     ttransport->tcp_opts.sock_priority,
 		     opts->abort_timeout_sec,
 		     ttransport->tcp_opts.control_msg_num,
-		     opts->ack_timeout);
+		     opts->ack_timeout,
+		     ttransport->tcp_opts.c2h_zcopy);
 
 	if (ttransport->tcp_opts.sock_priority > SPDK_NVMF_TCP_DEFAULT_MAX_SOCK_PRIORITY) {
 		SPDK_ERRLOG("Unsupported socket_priority=%d, the current range is: 0 to %d\n"
@@ -2684,10 +2691,12 @@ nvmf_tcp_req_parse_sgl(struct spdk_nvmf_tcp_req *tcp_req,
 	enum spdk_nvme_tcp_term_req_fes		fes;
 	struct nvme_tcp_pdu			*pdu;
 	struct spdk_nvmf_tcp_qpair		*tqpair;
+	struct spdk_nvmf_tcp_transport		*ttransport;
 	uint32_t				length, error_offset = 0;
 
 	cmd = &req->cmd->nvme_cmd;
 	sgl = &cmd->dptr.sgl1;
+	ttransport = SPDK_CONTAINEROF(transport, struct spdk_nvmf_tcp_transport, transport);
 
 	if (sgl->generic.type == SPDK_NVME_SGL_TYPE_TRANSPORT_DATA_BLOCK &&
 	    sgl->unkeyed.subtype == SPDK_NVME_SGL_SUBTYPE_TRANSPORT) {
@@ -2711,7 +2720,11 @@ nvmf_tcp_req_parse_sgl(struct spdk_nvmf_tcp_req *tcp_req,
 			req->dif.elba_length = length;
 		}
 
-		if (nvmf_ctrlr_use_zcopy(req)) {
+		/* With c2h_zcopy, the C2H data of reads is sent straight from the bdev's buffers,
+		 * which are released once the sock layer completes the send.
+		 */
+		if (nvmf_ctrlr_use_zcopy(req) ||
+		    (ttransport->tcp_opts.c2h_zcopy && nvmf_ctrlr_use_zcopy_read(req))) {
 			SPDK_DEBUGLOG(nvmf_tcp, "Using zero-copy to execute request %p\n", tcp_req);
 			req->data_from_pool = false;
 			nvmf_tcp_req_set_state(tcp_req, TCP_REQUEST_STATE_HAVE_BUFFER);
@@ -836,33 +836,7 @@ spdk_nvmf_request_free_buffers(struct spdk_nvmf_request *req,
 	req->data_from_pool = false;
 }
 
-static int
-nvmf_request_set_buffer(struct spdk_nvmf_request *req, void *buf, uint32_t length,
-			uint32_t io_unit_size)
-{
-	req->iov[req->iovcnt].iov_base = buf;
-	req->iov[req->iovcnt].iov_len  = spdk_min(length, io_unit_size);
-	length -= req->iov[req->iovcnt].iov_len;
-	req->iovcnt++;
-
-	return length;
-}
-
-static int
-nvmf_request_set_stripped_buffer(struct spdk_nvmf_request *req, void *buf, uint32_t length,
-				 uint32_t io_unit_size)
-{
-	struct spdk_nvmf_stripped_data *data = req->stripped_data;
-
-	data->iov[data->iovcnt].iov_base = buf;
-	data->iov[data->iovcnt].iov_len  = spdk_min(length, io_unit_size);
-	length -= data->iov[data->iovcnt].iov_len;
-	data->iovcnt++;
-
-	return length;
-}
-
-static void nvmf_request_iobuf_get_cb(struct spdk_iobuf_entry *entry, void *buf);
+static void nvmf_request_iobuf_get_cb(struct spdk_iobuf_iov_entry *entry, int iovcnt);
 
 static int
 nvmf_request_get_buffers(struct spdk_nvmf_request *req,
@@ -871,63 +845,45 @@ nvmf_request_get_buffers(struct spdk_nvmf_request *req,
 			 uint32_t length, uint32_t io_unit_size,
 			 bool stripped_buffers)
 {
-	struct spdk_iobuf_entry *entry = NULL;
-	uint32_t num_buffers;
-	uint32_t i = 0;
-	void *buffer;
-
-	/* If the number of buffers is too large, then we know the I/O is larger than allowed.
-	 *  Fail it.
-	 */
-	num_buffers = SPDK_CEIL_DIV(length, io_unit_size);
-	if (spdk_unlikely(num_buffers > NVMF_REQ_MAX_BUFFERS)) {
-		return -EINVAL;
-	}
+	spdk_iobuf_get_iov_cb cb_fn = NULL;
+	struct iovec *iovs;
+	int rc;
 
 	/* Use iobuf queuing only if transport supports it */
 	if (transport->ops->req_get_buffers_done != NULL) {
-		entry = &req->iobuf.entry;
+		cb_fn = nvmf_request_iobuf_get_cb;
 	}
 
-	while (i < num_buffers) {
-		buffer = spdk_iobuf_get(group->buf_cache, spdk_min(io_unit_size, length), entry,
-					nvmf_request_iobuf_get_cb);
-		if (spdk_unlikely(buffer == NULL)) {
-			req->iobuf.remaining_length = length;
-			return -ENOMEM;
-		}
-		if (stripped_buffers) {
-			length = nvmf_request_set_stripped_buffer(req, buffer, length, io_unit_size);
-		} else {
-			length = nvmf_request_set_buffer(req, buffer, length, io_unit_size);
-		}
-		i++;
+	iovs = stripped_buffers ? req->stripped_data->iov : req->iov;
+
+	/* If the number of buffers is too large, then we know the I/O is larger than allowed.
+	 *  Fail it.
+	 */
+	rc = spdk_iobuf_get_iov(group->buf_cache, length, io_unit_size, iovs, NVMF_REQ_MAX_BUFFERS,
+				&req->iobuf, cb_fn);
+	if (spdk_unlikely(rc < 0)) {
+		return rc;
 	}
 
-	assert(length == 0);
+	if (stripped_buffers) {
+		req->stripped_data->iovcnt = rc;
+	} else {
+		req->iovcnt = rc;
+	}
 	req->data_from_pool = true;
 
 	return 0;
 }
 
 static void
-nvmf_request_iobuf_get_cb(struct spdk_iobuf_entry *entry, void *buf)
+nvmf_request_iobuf_get_cb(struct spdk_iobuf_iov_entry *entry, int iovcnt)
 {
-	struct spdk_nvmf_request *req = SPDK_CONTAINEROF(entry, struct spdk_nvmf_request, iobuf.entry);
+	struct spdk_nvmf_request *req = SPDK_CONTAINEROF(entry, struct spdk_nvmf_request, iobuf);
 	struct spdk_nvmf_transport *transport = req->qpair->transport;
-	struct spdk_nvmf_poll_group *group = req->qpair->group;
-	struct spdk_nvmf_transport_poll_group *tgroup = nvmf_get_transport_poll_group(group, transport);
-	uint32_t length = req->iobuf.remaining_length;
-	uint32_t io_unit_size = transport->opts.io_unit_size;
-	int rc;
 
-	assert(tgroup != NULL);
-
-	length = nvmf_request_set_buffer(req, buf, length, io_unit_size);
-	rc = nvmf_request_get_buffers(req, tgroup, transport, length, io_unit_size, false);
-	if (rc == 0) {
-		transport->ops->req_get_buffers_done(req);
-	}
+	req->iovcnt = iovcnt;
+	req->data_from_pool = true;
+	transport->ops->req_get_buffers_done(req);
 }
 
 int
@@ -955,13 +911,12 @@ nvmf_request_get_buffers_abort_cb(struct spdk_iobuf_channel *ch, struct spdk_iob
 {
 	struct spdk_nvmf_request *req, *req_to_abort = cb_ctx;
 
-	req = SPDK_CONTAINEROF(entry, struct spdk_nvmf_request, iobuf.entry);
+	req = SPDK_CONTAINEROF(entry, struct spdk_nvmf_request, iobuf.iobuf);
 	if (req != req_to_abort) {
 		return 0;
 	}
 
-	spdk_iobuf_entry_abort(ch, entry, spdk_min(req->iobuf.remaining_length,
-			       req->qpair->transport->opts.io_unit_size));
+	spdk_iobuf_iov_entry_abort(ch, &req->iobuf);
 	return 1;
 }
 
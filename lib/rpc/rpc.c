@@ -37,6 +37,7 @@ struct spdk_rpc_method {
 	bool is_deprecated;
 	struct spdk_rpc_method *is_alias_of;
 	bool deprecation_warning_printed;
+	char *concurrency_key;
 };
 
 static SLIST_HEAD(, spdk_rpc_method) g_rpc_methods = SLIST_HEAD_INITIALIZER(g_rpc_methods);
@@ -258,8 +259,9 @@ spdk_rpc_server_accept(struct spdk_rpc_server *server)
 	spdk_jsonrpc_server_poll(server->jsonrpc_server);
 }
 
-void
-spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func, uint32_t state_mask)
+static void
+rpc_register_method(const char *method, spdk_rpc_method_handler func, uint32_t state_mask,
+		    const char *concurrency_key)
 {
 	struct spdk_rpc_method *m;
 
@@ -279,10 +281,29 @@ spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func, uint3
 	m->func = func;
 	m->state_mask = state_mask;
 
+	if (concurrency_key != NULL) {
+		m->concurrency_key = strdup(concurrency_key);
+		assert(m->concurrency_key != NULL);
+	}
+
 	/* TODO: use a hash table or sorted list */
 	SLIST_INSERT_HEAD(&g_rpc_methods, m, slist);
 }
 
+void
+spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func, uint32_t state_mask)
+{
+	rpc_register_method(method, func, state_mask, NULL);
+}
+
+void
+spdk_rpc_register_method_concurrent(const char *method, spdk_rpc_method_handler func,
+				    uint32_t state_mask, const char *concurrency_key)
+{
+	assert(concurrency_key != NULL);
+	rpc_register_method(method, func, state_mask, concurrency_key);
+}
+
 void
 spdk_rpc_register_alias_deprecated(const char *method, const char *alias)
 {
@@ -361,6 +382,25 @@ spdk_rpc_get_method_state_mask(const char *method, uint32_t *state_mask)
 	return -ENOENT;
 }
 
+int
+spdk_rpc_get_method_concurrency_key(const char *method, const char **concurrency_key)
+{
+	struct spdk_rpc_method *m;
+
+	SLIST_FOREACH(m, &g_rpc_methods, slist) {
+		if (strcmp(m->name, method) == 0) {
+			if (m->is_alias_of != NULL) {
+				m = m->is_alias_of;
+			}
+
+			*concurrency_key = m->concurrency_key;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
 void
 spdk_rpc_set_allowlist(const char **rpc_allowlist)
 {
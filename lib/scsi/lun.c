@@ -270,6 +270,8 @@ _scsi_lun_remove(void *arg)
 {
 	struct spdk_scsi_lun *lun = (struct spdk_scsi_lun *)arg;
 
+	/* The copy results are only accessed on the LUN's thread */
+	scsi_copy_free_results(lun);
 	spdk_bdev_close(lun->bdev_desc);
 	spdk_scsi_dev_delete_lun(lun->dev, lun);
 	free(lun);
@@ -466,6 +468,7 @@ struct spdk_scsi_lun *scsi_lun_construct(const char *bdev_name,
 
 	TAILQ_INIT(&lun->open_descs);
 	TAILQ_INIT(&lun->reg_head);
+	TAILQ_INIT(&lun->copy_results);
 
 	return lun;
 }
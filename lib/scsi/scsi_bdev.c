@@ -28,7 +28,7 @@
 
 static void bdev_scsi_process_block_resubmit(void *arg);
 
-static void
+void
 bdev_scsi_set_naa_ieee_extended(const char *name, uint8_t *buf)
 {
 	int i;
@@ -176,11 +176,12 @@ bdev_scsi_inquiry(struct spdk_bdev *bdev, struct spdk_scsi_task *task,
 			vpage->params[4] = SPDK_SPC_VPD_EXTENDED_INQUIRY_DATA;
 			vpage->params[5] = SPDK_SPC_VPD_MODE_PAGE_POLICY;
 			vpage->params[6] = SPDK_SPC_VPD_SCSI_PORTS;
-			vpage->params[7] = SPDK_SPC_VPD_BLOCK_LIMITS;
-			vpage->params[8] = SPDK_SPC_VPD_BLOCK_DEV_CHARS;
-			len = 9;
+			vpage->params[7] = SPDK_SPC_VPD_THIRD_PARTY_COPY;
+			vpage->params[8] = SPDK_SPC_VPD_BLOCK_LIMITS;
+			vpage->params[9] = SPDK_SPC_VPD_BLOCK_DEV_CHARS;
+			len = 10;
 			if (spdk_bdev_io_type_supported(bdev, SPDK_BDEV_IO_TYPE_UNMAP)) {
-				vpage->params[9] = SPDK_SPC_VPD_BLOCK_THIN_PROVISION;
+				vpage->params[10] = SPDK_SPC_VPD_BLOCK_THIN_PROVISION;
 				len++;
 			}
 
@@ -473,6 +474,23 @@ bdev_scsi_inquiry(struct spdk_bdev *bdev, struct spdk_scsi_task *task,
 			break;
 		}
 
+		case SPDK_SPC_VPD_THIRD_PARTY_COPY: {
+			int desc_len;
+
+			/* PAGE LENGTH */
+			hlen = 4;
+
+			/* Third-party copy descriptors */
+			desc_len = scsi_copy_vpd_page(lun, vpage->params, alloc_len - hlen);
+			if (desc_len < 0) {
+				goto inq_error;
+			}
+			len = desc_len;
+
+			to_be16(vpage->alloc_len, len);
+			break;
+		}
+
 		case SPDK_SPC_VPD_BLOCK_LIMITS: {
 			uint32_t block_size = spdk_bdev_get_data_block_size(bdev);
 
@@ -640,8 +658,8 @@ bdev_scsi_inquiry(struct spdk_bdev *bdev, struct spdk_scsi_task *task,
 		hlen = 5;
 
 		/* SCCS(7) ACC(6) TPGS(5-4) 3PC(3) PROTECT(0) */
-		/* Not support TPGS */
-		inqdata->flags = 0;
+		/* Not support TPGS, support third-party copy */
+		inqdata->flags = 1 << 3;
 
 		/* MULTIP */
 		inqdata->flags2 = 0x10;
@@ -1295,6 +1313,11 @@ bdev_scsi_readwrite(struct spdk_bdev *bdev, struct spdk_bdev_desc *bdev_desc,
 		      "%s: lba=%"PRIu64", len=%"PRIu64"\n",
 		      is_read ? "Read" : "Write", offset_blocks, num_blocks);
 
+	if (!is_read) {
+		/* Blocks overwritten under a ROD token make the token unusable */
+		scsi_copy_invalidate_tokens(task->lun, offset_blocks, num_blocks);
+	}
+
 	if (is_read) {
 		rc = spdk_bdev_readv_blocks(bdev_desc, bdev_ch, task->iovs, task->iovcnt,
 					    offset_blocks, num_blocks,
@@ -1500,6 +1523,8 @@ _bdev_scsi_unmap(struct spdk_bdev_scsi_split_ctx *ctx)
 	offset_blocks = from_be64(&desc->lba);
 	num_blocks = from_be32(&desc->block_count);
 
+	scsi_copy_invalidate_tokens(lun, offset_blocks, num_blocks);
+
 	return spdk_bdev_unmap_blocks(lun->bdev_desc,
 				      lun->io_channel,
 				      offset_blocks,
@@ -1631,6 +1656,8 @@ bdev_scsi_write_same(struct spdk_bdev *bdev, struct spdk_bdev_desc *bdev_desc,
 	SPDK_DEBUGLOG(scsi, "Writesame: lba=%"PRIu64", len=%"PRIu64"\n",
 		      offset_blocks, num_blocks);
 
+	scsi_copy_invalidate_tokens(task->lun, offset_blocks, num_blocks);
+
 	ctx = calloc(1, sizeof(*ctx));
 	if (!ctx) {
 		SPDK_ERRLOG("No enough memory on SCSI WRITE SAME\n");
@@ -1825,6 +1852,11 @@ bdev_scsi_process_block(struct spdk_scsi_task *task)
 		return bdev_scsi_write_same(bdev, lun->bdev_desc, lun->io_channel,
 					    task, lba, xfer_len, cdb[1]);
 
+	case SPDK_SPC_EXTENDED_COPY:
+		return scsi_copy_out(task);
+
+	case SPDK_SPC_RECEIVE_COPY_RESULTS:
+		return scsi_copy_in(task);
 
 	default:
 		return SPDK_SCSI_TASK_UNKNOWN;
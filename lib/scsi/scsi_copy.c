@@ -0,0 +1,1202 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 agent <agent@local>.
+ *   All rights reserved.
+ */
+
+#include "scsi_internal.h"
+
+#include "spdk/env.h"
+#include "spdk/bdev.h"
+#include "spdk/endian.h"
+#include "spdk/likely.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+#include "spdk/uuid.h"
+
+/*
+ * Third-party copy: EXTENDED COPY (LID1) and the token based POPULATE TOKEN /
+ * WRITE USING TOKEN pair.  Copies between blocks of the same bdev are passed
+ * down as SPDK_BDEV_IO_TYPE_COPY when the bdev supports it, all other copies
+ * are done by the target through a bounce buffer.  Either way the data never
+ * crosses the transport.
+ *
+ * The copy source and destination must be LUNs of the same SCSI device that
+ * are served by the thread executing the command.
+ */
+
+#define SCSI_COPY_TGT_DESC_LEN			32
+#define SCSI_COPY_SEG_DESC_LEN			28
+#define SCSI_COPY_RANGE_DESC_LEN		16
+#define SCSI_COPY_MAX_TGT_DESCS			8
+#define SCSI_COPY_MAX_SEG_DESCS			256
+#define SCSI_COPY_MAX_DESC_LIST_LEN		(SCSI_COPY_MAX_TGT_DESCS * SCSI_COPY_TGT_DESC_LEN + \
+						 SCSI_COPY_MAX_SEG_DESCS * SCSI_COPY_SEG_DESC_LEN)
+#define SCSI_COPY_MAX_RANGE_DESCS		64
+
+/* Inactivity timeouts of ROD tokens, in seconds */
+#define SCSI_COPY_DEFAULT_INACTIVITY_TIMEOUT	60
+#define SCSI_COPY_MAX_INACTIVITY_TIMEOUT	3600
+
+#define SCSI_COPY_MAX_TOKEN_TRANSFER_SIZE	(1ULL * 1024 * 1024 * 1024)
+#define SCSI_COPY_OPTIMAL_TRANSFER_SIZE		(64ULL * 1024 * 1024)
+
+/* Number of token based copy results (and thus ROD tokens) remembered per LUN */
+#define SCSI_COPY_MAX_RESULTS			64
+
+/* Bounce buffer used for copies that the bdev can't offload */
+#define SCSI_COPY_BUF_SIZE			(1024 * 1024)
+
+/* TRANSFER COUNT UNITS: logical blocks */
+#define SCSI_COPY_TRANSFER_COUNT_UNITS_BLOCKS	0xf1
+/* COPY OPERATION STATUS: operation completed without errors */
+#define SCSI_COPY_STATUS_COMPLETED		0x01
+
+#define SCSI_COPY_RRTI_HDR_LEN			32
+#define SCSI_COPY_OPER_PARAMS_LEN		45
+
+struct scsi_copy_range {
+	uint64_t	lba;
+	uint64_t	num_blocks;
+};
+
+/*
+ * Outcome of a POPULATE TOKEN or WRITE USING TOKEN command, kept for RECEIVE ROD
+ * TOKEN INFORMATION.  For POPULATE TOKEN it is also the ROD token itself.
+ */
+struct scsi_copy_result {
+	const struct spdk_scsi_port	*initiator_port;
+	uint32_t			list_id;
+	uint8_t				service_action;
+	uint64_t			transfer_count;
+	uint16_t			segments_processed;
+
+	/* The fields below are only used by POPULATE TOKEN */
+
+	/* Cleared when any of the represented blocks is overwritten */
+	bool				token_valid;
+	uint32_t			inactivity_timeout;
+	uint64_t			expire_tsc;
+	uint32_t			num_ranges;
+	struct scsi_copy_range		*ranges;
+	uint8_t				token[SPDK_SPC_ROD_TOKEN_LENGTH];
+
+	TAILQ_ENTRY(scsi_copy_result)	link;
+};
+
+struct scsi_copy_segment {
+	/* NULL if the destination blocks are to be zeroed */
+	struct spdk_scsi_lun	*src_lun;
+	struct spdk_scsi_lun	*dst_lun;
+	uint64_t		src_lba;
+	uint64_t		dst_lba;
+	uint64_t		num_blocks;
+};
+
+struct scsi_copy_ctx {
+	struct spdk_scsi_task		*task;
+	uint8_t				service_action;
+	uint32_t			list_id;
+
+	struct scsi_copy_segment	*segs;
+	uint32_t			num_segs;
+	uint32_t			cur_seg;
+	/* Blocks of the current segment that are done */
+	uint64_t			seg_offset;
+	/* Blocks of the current segment being copied, starting at step_offset */
+	uint64_t			step_offset;
+	uint64_t			step_blocks;
+	uint64_t			blocks_copied;
+
+	void				*buf;
+	uint64_t			buf_blocks;
+
+	struct spdk_bdev_io_wait_entry	bdev_io_wait;
+};
+
+static uint64_t g_rod_token_id;
+
+static void
+scsi_copy_set_check_condition(struct spdk_scsi_task *task, int sk, int asc, int ascq)
+{
+	spdk_scsi_task_set_status(task, SPDK_SCSI_STATUS_CHECK_CONDITION, sk, asc, ascq);
+}
+
+static void
+scsi_copy_invalid_param(struct spdk_scsi_task *task)
+{
+	scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+				      SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+				      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+}
+
+static void
+scsi_copy_invalid_cdb(struct spdk_scsi_task *task)
+{
+	scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+				      SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB,
+				      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+}
+
+static void
+scsi_copy_param_list_length_error(struct spdk_scsi_task *task)
+{
+	scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+				      SPDK_SCSI_ASC_PARAMETER_LIST_LENGTH_ERROR,
+				      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+}
+
+static void
+scsi_copy_target_unreachable(struct spdk_scsi_task *task)
+{
+	scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_COPY_ABORTED,
+				      SPDK_SCSI_ASC_COPY_TARGET_DEVICE_NOT_REACHABLE,
+				      SPDK_SCSI_ASCQ_COPY_TARGET_DEVICE_NOT_REACHABLE);
+}
+
+static bool
+scsi_copy_lun_reachable(const struct spdk_scsi_lun *lun)
+{
+	return !lun->removed && lun->io_channel != NULL && lun->thread == spdk_get_thread();
+}
+
+static bool
+scsi_copy_range_valid(const struct spdk_scsi_lun *lun, uint64_t lba, uint64_t num_blocks)
+{
+	uint64_t bdev_num_blocks = spdk_bdev_get_num_blocks(lun->bdev);
+
+	return lba < bdev_num_blocks && num_blocks <= bdev_num_blocks - lba;
+}
+
+static bool
+scsi_copy_ranges_overlap(uint64_t lba1, uint64_t num_blocks1, uint64_t lba2, uint64_t num_blocks2)
+{
+	return lba1 < lba2 + num_blocks2 && lba2 < lba1 + num_blocks1;
+}
+
+/* Identification descriptor CSCD descriptor, matching the NAA designator of VPD page 0x83 */
+static void
+scsi_copy_build_tgt_desc(const struct spdk_scsi_lun *lun, uint8_t *desc)
+{
+	uint32_t block_size = spdk_bdev_get_block_size(lun->bdev);
+
+	memset(desc, 0, SCSI_COPY_TGT_DESC_LEN);
+	desc[0] = SPDK_SPC_XCOPY_TGT_DESC_IDENTIFICATION;
+	desc[1] = SPDK_SPC_PERIPHERAL_DEVICE_TYPE_DISK;
+	desc[4] = SPDK_SPC_VPD_CODE_SET_BINARY;
+	desc[5] = SPDK_SPC_VPD_ASSOCIATION_LOGICAL_UNIT << 4 | SPDK_SPC_VPD_IDENTIFIER_TYPE_NAA;
+	desc[7] = 8;
+	bdev_scsi_set_naa_ieee_extended(spdk_bdev_get_name(lun->bdev), &desc[8]);
+	/* DISK BLOCK LENGTH */
+	desc[29] = (block_size >> 16) & 0xff;
+	desc[30] = (block_size >> 8) & 0xff;
+	desc[31] = block_size & 0xff;
+}
+
+static struct spdk_scsi_lun *
+scsi_copy_find_lun(struct spdk_scsi_dev *dev, const uint8_t *desc)
+{
+	struct spdk_scsi_lun *lun;
+	uint8_t naa[8];
+
+	if ((desc[5] & 0x0f) != SPDK_SPC_VPD_IDENTIFIER_TYPE_NAA || desc[7] != sizeof(naa)) {
+		return NULL;
+	}
+
+	TAILQ_FOREACH(lun, &dev->luns, tailq) {
+		bdev_scsi_set_naa_ieee_extended(spdk_bdev_get_name(lun->bdev), naa);
+		if (memcmp(naa, &desc[8], sizeof(naa)) == 0) {
+			return lun;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+scsi_copy_result_free(struct scsi_copy_result *result)
+{
+	free(result->ranges);
+	free(result);
+}
+
+static struct scsi_copy_result *
+scsi_copy_find_result(struct spdk_scsi_lun *lun, const struct spdk_scsi_port *initiator_port,
+		      uint32_t list_id)
+{
+	struct scsi_copy_result *result;
+
+	TAILQ_FOREACH(result, &lun->copy_results, link) {
+		if (result->initiator_port == initiator_port && result->list_id == list_id) {
+			return result;
+		}
+	}
+
+	return NULL;
+}
+
+/* A new result replaces the one with the same list identifier of the I_T nexus. */
+static void
+scsi_copy_add_result(struct spdk_scsi_lun *lun, struct scsi_copy_result *result)
+{
+	struct scsi_copy_result *old;
+
+	old = scsi_copy_find_result(lun, result->initiator_port, result->list_id);
+	if (old != NULL) {
+		TAILQ_REMOVE(&lun->copy_results, old, link);
+		lun->num_copy_results--;
+		scsi_copy_result_free(old);
+	}
+
+	if (lun->num_copy_results == SCSI_COPY_MAX_RESULTS) {
+		old = TAILQ_FIRST(&lun->copy_results);
+		TAILQ_REMOVE(&lun->copy_results, old, link);
+		lun->num_copy_results--;
+		scsi_copy_result_free(old);
+	}
+
+	TAILQ_INSERT_TAIL(&lun->copy_results, result, link);
+	lun->num_copy_results++;
+}
+
+void
+scsi_copy_free_results(struct spdk_scsi_lun *lun)
+{
+	struct scsi_copy_result *result, *tmp;
+
+	TAILQ_FOREACH_SAFE(result, &lun->copy_results, link, tmp) {
+		TAILQ_REMOVE(&lun->copy_results, result, link);
+		scsi_copy_result_free(result);
+	}
+	lun->num_copy_results = 0;
+}
+
+void
+scsi_copy_invalidate_tokens(struct spdk_scsi_lun *lun, uint64_t lba, uint64_t num_blocks)
+{
+	struct scsi_copy_result *result;
+	uint32_t i;
+
+	TAILQ_FOREACH(result, &lun->copy_results, link) {
+		if (!result->token_valid) {
+			continue;
+		}
+
+		for (i = 0; i < result->num_ranges; i++) {
+			if (scsi_copy_ranges_overlap(lba, num_blocks, result->ranges[i].lba,
+						     result->ranges[i].num_blocks)) {
+				SPDK_DEBUGLOG(scsi, "ROD token of list id %" PRIu32 " cancelled by a write\n",
+					      result->list_id);
+				result->token_valid = false;
+				break;
+			}
+		}
+	}
+}
+
+static void
+scsi_copy_ctx_free(struct scsi_copy_ctx *ctx)
+{
+	spdk_dma_free(ctx->buf);
+	free(ctx->segs);
+	free(ctx);
+}
+
+static void
+scsi_copy_complete(struct scsi_copy_ctx *ctx, bool success)
+{
+	struct spdk_scsi_task *task = ctx->task;
+	struct scsi_copy_result *result;
+
+	if (!success) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_COPY_ABORTED,
+					      SPDK_SCSI_ASC_THIRD_PARTY_DEVICE_FAILURE,
+					      SPDK_SCSI_ASCQ_THIRD_PARTY_DEVICE_FAILURE);
+	} else if (ctx->service_action == SPDK_SPC_SA_WRITE_USING_TOKEN) {
+		result = calloc(1, sizeof(*result));
+		if (result != NULL) {
+			result->initiator_port = task->initiator_port;
+			result->list_id = ctx->list_id;
+			result->service_action = ctx->service_action;
+			result->transfer_count = ctx->blocks_copied;
+			result->segments_processed = spdk_min(ctx->num_segs, UINT16_MAX);
+			scsi_copy_add_result(task->lun, result);
+		}
+	}
+
+	scsi_lun_complete_task(task->lun, task);
+	scsi_copy_ctx_free(ctx);
+}
+
+static void scsi_copy_submit(struct scsi_copy_ctx *ctx);
+static void scsi_copy_write(struct scsi_copy_ctx *ctx);
+
+static void
+_scsi_copy_submit(void *arg)
+{
+	scsi_copy_submit(arg);
+}
+
+static void
+_scsi_copy_write(void *arg)
+{
+	scsi_copy_write(arg);
+}
+
+static void
+scsi_copy_queue_io(struct scsi_copy_ctx *ctx, struct spdk_scsi_lun *lun, spdk_bdev_io_wait_cb cb_fn)
+{
+	int rc;
+
+	ctx->bdev_io_wait.bdev = lun->bdev;
+	ctx->bdev_io_wait.cb_fn = cb_fn;
+	ctx->bdev_io_wait.cb_arg = ctx;
+
+	rc = spdk_bdev_queue_io_wait(lun->bdev, lun->io_channel, &ctx->bdev_io_wait);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to queue copy I/O: %d\n", rc);
+		scsi_copy_complete(ctx, false);
+	}
+}
+
+static void
+scsi_copy_step_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct scsi_copy_ctx *ctx = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success) {
+		scsi_copy_complete(ctx, false);
+		return;
+	}
+
+	ctx->seg_offset += ctx->step_blocks;
+	ctx->blocks_copied += ctx->step_blocks;
+	if (ctx->seg_offset == ctx->segs[ctx->cur_seg].num_blocks) {
+		ctx->seg_offset = 0;
+		ctx->cur_seg++;
+	}
+
+	if (ctx->cur_seg == ctx->num_segs) {
+		scsi_copy_complete(ctx, true);
+		return;
+	}
+
+	scsi_copy_submit(ctx);
+}
+
+static void
+scsi_copy_write(struct scsi_copy_ctx *ctx)
+{
+	struct scsi_copy_segment *seg = &ctx->segs[ctx->cur_seg];
+	struct spdk_scsi_lun *dst = seg->dst_lun;
+	int rc;
+
+	rc = spdk_bdev_write_blocks(dst->bdev_desc, dst->io_channel, ctx->buf,
+				    seg->dst_lba + ctx->step_offset, ctx->step_blocks,
+				    scsi_copy_step_done, ctx);
+	if (spdk_unlikely(rc == -ENOMEM)) {
+		scsi_copy_queue_io(ctx, dst, _scsi_copy_write);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("Copy write to LUN %d failed: %d\n", dst->id, rc);
+		scsi_copy_complete(ctx, false);
+	}
+}
+
+static void
+scsi_copy_read_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct scsi_copy_ctx *ctx = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success) {
+		scsi_copy_complete(ctx, false);
+		return;
+	}
+
+	scsi_copy_write(ctx);
+}
+
+static void
+scsi_copy_submit(struct scsi_copy_ctx *ctx)
+{
+	struct scsi_copy_segment *seg = &ctx->segs[ctx->cur_seg];
+	struct spdk_scsi_lun *src = seg->src_lun, *dst = seg->dst_lun;
+	uint64_t remaining = seg->num_blocks - ctx->seg_offset;
+	struct spdk_scsi_lun *wait_lun = dst;
+	int rc;
+
+	if (ctx->seg_offset == 0 && !TAILQ_EMPTY(&dst->copy_results)) {
+		scsi_copy_invalidate_tokens(dst, seg->dst_lba, seg->num_blocks);
+	}
+
+	if (src == NULL) {
+		ctx->step_offset = ctx->seg_offset;
+		ctx->step_blocks = remaining;
+		rc = spdk_bdev_write_zeroes_blocks(dst->bdev_desc, dst->io_channel,
+						   seg->dst_lba + ctx->step_offset, remaining,
+						   scsi_copy_step_done, ctx);
+	} else if (src->bdev == dst->bdev &&
+		   spdk_bdev_io_type_supported(dst->bdev, SPDK_BDEV_IO_TYPE_COPY)) {
+		ctx->step_offset = ctx->seg_offset;
+		ctx->step_blocks = remaining;
+		rc = spdk_bdev_copy_blocks(dst->bdev_desc, dst->io_channel,
+					   seg->dst_lba + ctx->step_offset,
+					   seg->src_lba + ctx->step_offset,
+					   remaining, scsi_copy_step_done, ctx);
+	} else {
+		/* Not left to the bdev layer's emulation, it would need a buffer for all of it */
+		if (ctx->buf == NULL) {
+			ctx->buf = spdk_dma_malloc(SCSI_COPY_BUF_SIZE,
+						   spdk_max(spdk_bdev_get_buf_align(src->bdev),
+								   spdk_bdev_get_buf_align(dst->bdev)), NULL);
+			if (ctx->buf == NULL) {
+				SPDK_ERRLOG("Failed to allocate copy buffer\n");
+				scsi_copy_complete(ctx, false);
+				return;
+			}
+			ctx->buf_blocks = SCSI_COPY_BUF_SIZE / spdk_bdev_get_block_size(src->bdev);
+		}
+
+		ctx->step_blocks = spdk_min(remaining, ctx->buf_blocks);
+		if (src->bdev == dst->bdev && seg->dst_lba > seg->src_lba &&
+		    seg->dst_lba < seg->src_lba + seg->num_blocks) {
+			/* Copy overlapping ranges back to front, so no source block is overwritten
+			 * before it is read.
+			 */
+			ctx->step_offset = remaining - ctx->step_blocks;
+		} else {
+			ctx->step_offset = ctx->seg_offset;
+		}
+		wait_lun = src;
+		rc = spdk_bdev_read_blocks(src->bdev_desc, src->io_channel, ctx->buf,
+					   seg->src_lba + ctx->step_offset, ctx->step_blocks,
+					   scsi_copy_read_done, ctx);
+	}
+
+	if (spdk_unlikely(rc == -ENOMEM)) {
+		scsi_copy_queue_io(ctx, wait_lun, _scsi_copy_submit);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("Copy from LUN %d to LUN %d failed: %d\n", src ? src->id : -1, dst->id, rc);
+		scsi_copy_complete(ctx, false);
+	}
+}
+
+static struct scsi_copy_ctx *
+scsi_copy_ctx_alloc(struct spdk_scsi_task *task, uint32_t max_segs)
+{
+	struct scsi_copy_ctx *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return NULL;
+	}
+
+	ctx->segs = calloc(spdk_max(max_segs, 1), sizeof(*ctx->segs));
+	if (ctx->segs == NULL) {
+		free(ctx);
+		return NULL;
+	}
+
+	ctx->task = task;
+	ctx->service_action = task->cdb[1] & 0x1f;
+	ctx->list_id = from_be32(&task->cdb[6]);
+
+	return ctx;
+}
+
+static int
+scsi_copy_start(struct scsi_copy_ctx *ctx)
+{
+	if (ctx->num_segs == 0) {
+		scsi_copy_complete(ctx, true);
+		return SPDK_SCSI_TASK_PENDING;
+	}
+
+	scsi_copy_submit(ctx);
+	return SPDK_SCSI_TASK_PENDING;
+}
+
+static bool
+scsi_copy_block_size_match(const struct spdk_scsi_lun *src, const struct spdk_scsi_lun *dst)
+{
+	if (src->bdev == dst->bdev) {
+		return true;
+	}
+
+	/* Metadata is not carried over by the bounce buffer copy */
+	return spdk_bdev_get_block_size(src->bdev) == spdk_bdev_get_block_size(dst->bdev) &&
+	       spdk_bdev_get_md_size(src->bdev) == 0 && spdk_bdev_get_md_size(dst->bdev) == 0;
+}
+
+/* EXTENDED COPY (LID1) with identification CSCD descriptors and block to block segments */
+static int
+scsi_copy_xcopy_lid1(struct spdk_scsi_task *task, uint8_t *data, uint32_t data_len)
+{
+	struct spdk_scsi_lun *luns[SCSI_COPY_MAX_TGT_DESCS] = {};
+	struct spdk_scsi_lun *src, *dst;
+	struct scsi_copy_ctx *ctx;
+	struct scsi_copy_segment *seg;
+	uint32_t tdl, sdl, inline_len, num_tgts, i, off, end;
+	uint16_t desc_len, src_idx, dst_idx;
+	uint64_t src_lba, dst_lba, num_blocks;
+	uint8_t *desc;
+
+	if (data_len < 16) {
+		scsi_copy_param_list_length_error(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	tdl = from_be16(&data[2]);
+	sdl = from_be32(&data[8]);
+	inline_len = from_be32(&data[12]);
+
+	if (16 + tdl + sdl + inline_len > data_len) {
+		scsi_copy_param_list_length_error(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	if (tdl % SCSI_COPY_TGT_DESC_LEN != 0 || inline_len != 0) {
+		scsi_copy_invalid_param(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	num_tgts = tdl / SCSI_COPY_TGT_DESC_LEN;
+	if (num_tgts > SCSI_COPY_MAX_TGT_DESCS) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+					      SPDK_SCSI_ASCQ_TOO_MANY_TARGET_DESCRIPTORS);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	for (i = 0; i < num_tgts; i++) {
+		desc = &data[16 + i * SCSI_COPY_TGT_DESC_LEN];
+		if (desc[0] != SPDK_SPC_XCOPY_TGT_DESC_IDENTIFICATION) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+						      SPDK_SCSI_ASCQ_UNSUPPORTED_TARGET_DESCRIPTOR_TYPE_CODE);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		/* Only block devices, NUL CSCD descriptors are not supported */
+		if ((desc[1] & 0x3f) != SPDK_SPC_PERIPHERAL_DEVICE_TYPE_DISK) {
+			scsi_copy_invalid_param(task);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		/* An unknown LUN only fails the command if a segment refers to it */
+		luns[i] = scsi_copy_find_lun(task->lun->dev, desc);
+	}
+
+	if (sdl > SCSI_COPY_MAX_SEG_DESCS * SCSI_COPY_SEG_DESC_LEN) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+					      SPDK_SCSI_ASCQ_TOO_MANY_SEGMENT_DESCRIPTORS);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	ctx = scsi_copy_ctx_alloc(task, sdl / SCSI_COPY_SEG_DESC_LEN);
+	if (ctx == NULL) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_NO_SENSE,
+					      SPDK_SCSI_ASC_NO_ADDITIONAL_SENSE,
+					      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+	ctx->service_action = SPDK_SPC_SA_EXTENDED_COPY_LID1;
+
+	off = 16 + tdl;
+	end = off + sdl;
+	while (off < end) {
+		desc = &data[off];
+		if (end - off < 4) {
+			scsi_copy_invalid_param(task);
+			goto err;
+		}
+
+		desc_len = from_be16(&desc[2]);
+		if (desc[0] != SPDK_SPC_XCOPY_SEG_DESC_BLOCK_TO_BLOCK) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+						      SPDK_SCSI_ASCQ_UNSUPPORTED_SEGMENT_DESCRIPTOR_TYPE_CODE);
+			goto err;
+		}
+
+		if (desc_len + 4 != SCSI_COPY_SEG_DESC_LEN || end - off < SCSI_COPY_SEG_DESC_LEN) {
+			scsi_copy_invalid_param(task);
+			goto err;
+		}
+		off += SCSI_COPY_SEG_DESC_LEN;
+
+		src_idx = from_be16(&desc[4]);
+		dst_idx = from_be16(&desc[6]);
+		num_blocks = from_be16(&desc[10]);
+		src_lba = from_be64(&desc[12]);
+		dst_lba = from_be64(&desc[20]);
+
+		if (src_idx >= num_tgts || dst_idx >= num_tgts) {
+			scsi_copy_invalid_param(task);
+			goto err;
+		}
+
+		src = luns[src_idx];
+		dst = luns[dst_idx];
+		if (src == NULL || dst == NULL || !scsi_copy_lun_reachable(src) ||
+		    !scsi_copy_lun_reachable(dst)) {
+			scsi_copy_target_unreachable(task);
+			goto err;
+		}
+
+		if (!scsi_copy_block_size_match(src, dst)) {
+			scsi_copy_invalid_param(task);
+			goto err;
+		}
+
+		if (!scsi_copy_range_valid(src, src_lba, num_blocks) ||
+		    !scsi_copy_range_valid(dst, dst_lba, num_blocks)) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE,
+						      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+			goto err;
+		}
+
+		if (num_blocks == 0) {
+			continue;
+		}
+
+		seg = &ctx->segs[ctx->num_segs++];
+		seg->src_lun = src;
+		seg->dst_lun = dst;
+		seg->src_lba = src_lba;
+		seg->dst_lba = dst_lba;
+		seg->num_blocks = num_blocks;
+	}
+
+	SPDK_DEBUGLOG(scsi, "EXTENDED COPY: %" PRIu32 " segments\n", ctx->num_segs);
+	return scsi_copy_start(ctx);
+
+err:
+	scsi_copy_ctx_free(ctx);
+	return SPDK_SCSI_TASK_COMPLETE;
+}
+
+/* Parse block device range descriptors, returns the number of ranges or -1 */
+static int
+scsi_copy_parse_ranges(struct spdk_scsi_task *task, uint8_t *desc, uint32_t len,
+		       struct scsi_copy_range *ranges, uint64_t *total_blocks)
+{
+	uint32_t i, num_ranges;
+
+	if (len % SCSI_COPY_RANGE_DESC_LEN != 0 || len == 0) {
+		scsi_copy_invalid_param(task);
+		return -1;
+	}
+
+	num_ranges = len / SCSI_COPY_RANGE_DESC_LEN;
+	if (num_ranges > SCSI_COPY_MAX_RANGE_DESCS) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+					      SPDK_SCSI_ASCQ_TOO_MANY_SEGMENT_DESCRIPTORS);
+		return -1;
+	}
+
+	*total_blocks = 0;
+	for (i = 0; i < num_ranges; i++) {
+		ranges[i].lba = from_be64(&desc[i * SCSI_COPY_RANGE_DESC_LEN]);
+		ranges[i].num_blocks = from_be32(&desc[i * SCSI_COPY_RANGE_DESC_LEN + 8]);
+
+		if (!scsi_copy_range_valid(task->lun, ranges[i].lba, ranges[i].num_blocks)) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE,
+						      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+			return -1;
+		}
+		*total_blocks += ranges[i].num_blocks;
+	}
+
+	return num_ranges;
+}
+
+static void
+scsi_copy_build_token(struct spdk_scsi_lun *lun, struct scsi_copy_result *result)
+{
+	uint8_t *token = result->token;
+	struct spdk_uuid uuid;
+
+	memset(token, 0, sizeof(result->token));
+	to_be32(&token[0], SPDK_SPC_ROD_TYPE_PIT_COPY_DEFAULT);
+	/* ROD TOKEN LENGTH */
+	to_be16(&token[6], SPDK_SPC_ROD_TOKEN_LENGTH - 8);
+	/* COPY MANAGER ROD TOKEN IDENTIFIER */
+	to_be64(&token[8], __atomic_fetch_add(&g_rod_token_id, 1, __ATOMIC_RELAXED));
+	/* CREATOR LOGICAL UNIT DESCRIPTOR */
+	scsi_copy_build_tgt_desc(lun, &token[16]);
+	/* NUMBER OF BYTES REPRESENTED */
+	to_be64(&token[56], result->transfer_count * spdk_bdev_get_block_size(lun->bdev));
+
+	/* Tokens are matched on all their bytes, make the vendor specific part unguessable */
+	spdk_uuid_generate(&uuid);
+	memcpy(&token[128], &uuid, sizeof(uuid));
+	spdk_uuid_generate(&uuid);
+	memcpy(&token[128 + sizeof(uuid)], &uuid, sizeof(uuid));
+}
+
+static int
+scsi_copy_populate_token(struct spdk_scsi_task *task, uint8_t *data, uint32_t data_len)
+{
+	struct spdk_scsi_lun *lun = task->lun;
+	struct scsi_copy_result *result;
+	struct scsi_copy_range ranges[SCSI_COPY_MAX_RANGE_DESCS];
+	uint32_t inactivity_timeout, rod_type, rdl;
+	uint64_t total_blocks;
+	int num_ranges;
+
+	if (data_len < 16) {
+		scsi_copy_param_list_length_error(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	rdl = from_be16(&data[14]);
+	if (16 + rdl > data_len) {
+		scsi_copy_param_list_length_error(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	/* IMMED is not supported, the command returns once the token exists */
+	if (data[2] & 0x01) {
+		scsi_copy_invalid_param(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	/* RTV */
+	if (data[2] & 0x02) {
+		rod_type = from_be32(&data[8]);
+		if (rod_type != SPDK_SPC_ROD_TYPE_PIT_COPY_DEFAULT) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION,
+						      SPDK_SCSI_ASCQ_UNSUPPORTED_TOKEN_TYPE);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+	}
+
+	inactivity_timeout = from_be32(&data[4]);
+	if (inactivity_timeout == 0) {
+		inactivity_timeout = SCSI_COPY_DEFAULT_INACTIVITY_TIMEOUT;
+	} else if (inactivity_timeout > SCSI_COPY_MAX_INACTIVITY_TIMEOUT) {
+		scsi_copy_invalid_param(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	num_ranges = scsi_copy_parse_ranges(task, &data[16], rdl, ranges, &total_blocks);
+	if (num_ranges < 0) {
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	if (total_blocks > SCSI_COPY_MAX_TOKEN_TRANSFER_SIZE / spdk_bdev_get_block_size(lun->bdev)) {
+		scsi_copy_invalid_param(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	result = calloc(1, sizeof(*result));
+	if (result == NULL) {
+		goto nomem;
+	}
+
+	result->ranges = calloc(num_ranges, sizeof(*result->ranges));
+	if (result->ranges == NULL) {
+		free(result);
+		goto nomem;
+	}
+
+	memcpy(result->ranges, ranges, num_ranges * sizeof(*result->ranges));
+	result->num_ranges = num_ranges;
+	result->initiator_port = task->initiator_port;
+	result->list_id = from_be32(&task->cdb[6]);
+	result->service_action = SPDK_SPC_SA_POPULATE_TOKEN;
+	result->transfer_count = total_blocks;
+	result->segments_processed = num_ranges;
+	result->inactivity_timeout = inactivity_timeout;
+	result->expire_tsc = spdk_get_ticks() + inactivity_timeout * spdk_get_ticks_hz();
+	result->token_valid = true;
+	scsi_copy_build_token(lun, result);
+
+	scsi_copy_add_result(lun, result);
+
+	SPDK_DEBUGLOG(scsi, "POPULATE TOKEN: list id %" PRIu32 ", %d ranges, %" PRIu64 " blocks\n",
+		      result->list_id, num_ranges, total_blocks);
+
+	task->status = SPDK_SCSI_STATUS_GOOD;
+	return SPDK_SCSI_TASK_COMPLETE;
+
+nomem:
+	scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_NO_SENSE,
+				      SPDK_SCSI_ASC_NO_ADDITIONAL_SENSE,
+				      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	return SPDK_SCSI_TASK_COMPLETE;
+}
+
+static struct scsi_copy_result *
+scsi_copy_find_token(struct spdk_scsi_dev *dev, const uint8_t *token, struct spdk_scsi_lun **_lun)
+{
+	struct spdk_scsi_lun *lun;
+	struct scsi_copy_result *result;
+
+	TAILQ_FOREACH(lun, &dev->luns, tailq) {
+		TAILQ_FOREACH(result, &lun->copy_results, link) {
+			if (result->service_action == SPDK_SPC_SA_POPULATE_TOKEN &&
+			    memcmp(result->token, token, SPDK_SPC_ROD_TOKEN_LENGTH) == 0) {
+				*_lun = lun;
+				return result;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Map the destination ranges onto the blocks represented by the token, starting at offset */
+static void
+scsi_copy_map_token(struct scsi_copy_ctx *ctx, struct scsi_copy_result *token,
+		    struct spdk_scsi_lun *src, uint64_t offset, struct scsi_copy_range *ranges,
+		    int num_ranges)
+{
+	struct scsi_copy_segment *seg;
+	uint64_t dst_lba, dst_blocks, len;
+	uint32_t src_idx = 0;
+	int i;
+
+	/* Skip the source ranges entirely before offset */
+	while (src_idx < token->num_ranges && offset >= token->ranges[src_idx].num_blocks) {
+		offset -= token->ranges[src_idx].num_blocks;
+		src_idx++;
+	}
+
+	for (i = 0; i < num_ranges && src_idx < token->num_ranges; i++) {
+		dst_lba = ranges[i].lba;
+		dst_blocks = ranges[i].num_blocks;
+
+		while (dst_blocks > 0 && src_idx < token->num_ranges) {
+			len = spdk_min(dst_blocks, token->ranges[src_idx].num_blocks - offset);
+
+			seg = &ctx->segs[ctx->num_segs++];
+			seg->src_lun = src;
+			seg->dst_lun = ctx->task->lun;
+			seg->src_lba = token->ranges[src_idx].lba + offset;
+			seg->dst_lba = dst_lba;
+			seg->num_blocks = len;
+
+			dst_lba += len;
+			dst_blocks -= len;
+			offset += len;
+			if (offset == token->ranges[src_idx].num_blocks) {
+				offset = 0;
+				src_idx++;
+			}
+		}
+	}
+}
+
+static int
+scsi_copy_write_using_token(struct spdk_scsi_task *task, uint8_t *data, uint32_t data_len)
+{
+	struct spdk_scsi_lun *lun = task->lun, *src = NULL;
+	struct scsi_copy_range ranges[SCSI_COPY_MAX_RANGE_DESCS];
+	struct scsi_copy_result *token = NULL;
+	struct scsi_copy_ctx *ctx;
+	struct scsi_copy_segment *seg;
+	uint64_t offset, total_blocks, token_blocks = 0;
+	uint32_t rod_type, rdl, j;
+	int num_ranges, i;
+	uint8_t *rod;
+
+	if (data_len < 536) {
+		scsi_copy_param_list_length_error(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	rdl = from_be16(&data[534]);
+	if (536 + rdl > data_len) {
+		scsi_copy_param_list_length_error(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	if (data[2] & 0x01) {
+		scsi_copy_invalid_param(task);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	offset = from_be64(&data[8]);
+	rod = &data[16];
+	rod_type = from_be32(&rod[0]);
+
+	num_ranges = scsi_copy_parse_ranges(task, &data[536], rdl, ranges, &total_blocks);
+	if (num_ranges < 0) {
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	if (rod_type == SPDK_SPC_ROD_TYPE_PIT_COPY_DEFAULT) {
+		token = scsi_copy_find_token(lun->dev, rod, &src);
+		if (token == NULL) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION,
+						      SPDK_SCSI_ASCQ_TOKEN_UNKNOWN);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		if (!token->token_valid) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION,
+						      SPDK_SCSI_ASCQ_TOKEN_CANCELLED);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		if (spdk_get_ticks() > token->expire_tsc) {
+			scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+						      SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION,
+						      SPDK_SCSI_ASCQ_TOKEN_EXPIRED);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		if (!scsi_copy_lun_reachable(src)) {
+			scsi_copy_target_unreachable(task);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		if (!scsi_copy_block_size_match(src, lun)) {
+			scsi_copy_invalid_param(task);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+
+		/* An offset past the blocks represented by the token would copy nothing */
+		for (j = 0; j < token->num_ranges; j++) {
+			token_blocks += token->ranges[j].num_blocks;
+		}
+		if (offset >= token_blocks) {
+			scsi_copy_invalid_cdb(task);
+			return SPDK_SCSI_TASK_COMPLETE;
+		}
+	} else if (rod_type != SPDK_SPC_ROD_TYPE_BLOCK_ZERO) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION,
+					      SPDK_SCSI_ASCQ_UNSUPPORTED_TOKEN_TYPE);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	ctx = scsi_copy_ctx_alloc(task, num_ranges + (token ? token->num_ranges : 0));
+	if (ctx == NULL) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_NO_SENSE,
+					      SPDK_SCSI_ASC_NO_ADDITIONAL_SENSE,
+					      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	if (token != NULL) {
+		/* Using the token restarts its inactivity timer */
+		token->expire_tsc = spdk_get_ticks() + token->inactivity_timeout * spdk_get_ticks_hz();
+		scsi_copy_map_token(ctx, token, src, offset, ranges, num_ranges);
+	} else {
+		for (i = 0; i < num_ranges; i++) {
+			if (ranges[i].num_blocks == 0) {
+				continue;
+			}
+			seg = &ctx->segs[ctx->num_segs++];
+			seg->dst_lun = lun;
+			seg->dst_lba = ranges[i].lba;
+			seg->num_blocks = ranges[i].num_blocks;
+		}
+	}
+
+	SPDK_DEBUGLOG(scsi, "WRITE USING TOKEN: list id %" PRIu32 ", %" PRIu32 " segments\n",
+		      ctx->list_id, ctx->num_segs);
+	return scsi_copy_start(ctx);
+}
+
+int
+scsi_copy_out(struct spdk_scsi_task *task)
+{
+	uint8_t *cdb = task->cdb;
+	uint8_t sa = cdb[1] & 0x1f;
+	uint8_t *data;
+	uint32_t pllen;
+	int data_len, rc;
+
+	if (sa != SPDK_SPC_SA_EXTENDED_COPY_LID1 && sa != SPDK_SPC_SA_POPULATE_TOKEN &&
+	    sa != SPDK_SPC_SA_WRITE_USING_TOKEN) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB,
+					      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	pllen = from_be32(&cdb[10]);
+	task->data_transferred = 0;
+	if (pllen == 0) {
+		task->status = SPDK_SCSI_STATUS_GOOD;
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	data = spdk_scsi_task_gather_data(task, &data_len);
+	if (data_len < 0) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_NO_SENSE,
+					      SPDK_SCSI_ASC_NO_ADDITIONAL_SENSE,
+					      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+	data_len = spdk_min((uint32_t)data_len, pllen);
+	task->data_transferred = data_len;
+
+	switch (sa) {
+	case SPDK_SPC_SA_EXTENDED_COPY_LID1:
+		rc = scsi_copy_xcopy_lid1(task, data, data_len);
+		break;
+	case SPDK_SPC_SA_POPULATE_TOKEN:
+		rc = scsi_copy_populate_token(task, data, data_len);
+		break;
+	default:
+		rc = scsi_copy_write_using_token(task, data, data_len);
+		break;
+	}
+
+	free(data);
+	return rc;
+}
+
+static int
+scsi_copy_operating_parameters(struct spdk_scsi_task *task, uint8_t *data)
+{
+	uint32_t block_size = spdk_bdev_get_block_size(task->lun->bdev);
+
+	memset(data, 0, SCSI_COPY_OPER_PARAMS_LEN);
+	/* AVAILABLE DATA */
+	to_be32(&data[0], SCSI_COPY_OPER_PARAMS_LEN - 4);
+	/* SNLID: the list identifier is not needed, copies complete synchronously */
+	data[4] = 0x01;
+	to_be16(&data[8], SCSI_COPY_MAX_TGT_DESCS);
+	to_be16(&data[10], SCSI_COPY_MAX_SEG_DESCS);
+	to_be32(&data[12], SCSI_COPY_MAX_DESC_LIST_LEN);
+	/* MAXIMUM SEGMENT LENGTH, in bytes */
+	to_be32(&data[16], spdk_min((uint64_t)UINT16_MAX * block_size, UINT32_MAX));
+	/* TOTAL and MAXIMUM CONCURRENT COPIES */
+	data[34] = 1;
+	data[35] = 1;
+	/* DATA SEGMENT GRANULARITY */
+	data[36] = spdk_u32log2(block_size);
+	/* IMPLEMENTED DESCRIPTOR LIST */
+	data[42] = 2;
+	data[43] = SPDK_SPC_XCOPY_SEG_DESC_BLOCK_TO_BLOCK;
+	data[44] = SPDK_SPC_XCOPY_TGT_DESC_IDENTIFICATION;
+
+	return SCSI_COPY_OPER_PARAMS_LEN;
+}
+
+static int
+scsi_copy_rod_token_information(struct spdk_scsi_task *task, uint8_t *data)
+{
+	struct scsi_copy_result *result;
+	int len = SCSI_COPY_RRTI_HDR_LEN + 4;
+
+	result = scsi_copy_find_result(task->lun, task->initiator_port, from_be32(&task->cdb[2]));
+	if (result == NULL) {
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB,
+					      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+		return -1;
+	}
+
+	memset(data, 0, SCSI_COPY_RRTI_HDR_LEN + 6 + SPDK_SPC_ROD_TOKEN_LENGTH);
+	data[4] = result->service_action;
+	data[5] = SCSI_COPY_STATUS_COMPLETED;
+	data[12] = SPDK_SCSI_STATUS_GOOD;
+	data[15] = SCSI_COPY_TRANSFER_COUNT_UNITS_BLOCKS;
+	to_be64(&data[16], result->transfer_count);
+	to_be16(&data[24], result->segments_processed);
+
+	if (result->service_action == SPDK_SPC_SA_POPULATE_TOKEN) {
+		/* ROD TOKEN DESCRIPTORS LENGTH, then two reserved bytes and the token */
+		to_be32(&data[SCSI_COPY_RRTI_HDR_LEN], 2 + SPDK_SPC_ROD_TOKEN_LENGTH);
+		memcpy(&data[SCSI_COPY_RRTI_HDR_LEN + 6], result->token, SPDK_SPC_ROD_TOKEN_LENGTH);
+		len += 2 + SPDK_SPC_ROD_TOKEN_LENGTH;
+	}
+
+	/* AVAILABLE DATA */
+	to_be32(&data[0], len - 4);
+
+	return len;
+}
+
+int
+scsi_copy_in(struct spdk_scsi_task *task)
+{
+	uint8_t data[SCSI_COPY_RRTI_HDR_LEN + 6 + SPDK_SPC_ROD_TOKEN_LENGTH];
+	uint8_t *cdb = task->cdb;
+	uint32_t alloc_len = from_be32(&cdb[10]);
+	int len;
+
+	switch (cdb[1] & 0x1f) {
+	case SPDK_SPC_SA_RECEIVE_COPY_OPERATING_PARAMETERS:
+		len = scsi_copy_operating_parameters(task, data);
+		break;
+	case SPDK_SPC_SA_RECEIVE_ROD_TOKEN_INFORMATION:
+		len = scsi_copy_rod_token_information(task, data);
+		break;
+	default:
+		scsi_copy_set_check_condition(task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+					      SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB,
+					      SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	if (len < 0) {
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	len = spdk_min((uint32_t)len, alloc_len);
+	if (spdk_scsi_task_scatter_data(task, data, len) < 0) {
+		return SPDK_SCSI_TASK_COMPLETE;
+	}
+
+	task->data_transferred = len;
+	task->status = SPDK_SCSI_STATUS_GOOD;
+	return SPDK_SCSI_TASK_COMPLETE;
+}
+
+int
+scsi_copy_vpd_page(struct spdk_scsi_lun *lun, uint8_t *buf, uint16_t len)
+{
+	uint32_t block_size = spdk_bdev_get_block_size(lun->bdev);
+	uint8_t *desc = buf;
+
+	if (len < 36 + 16) {
+		return -1;
+	}
+
+	memset(buf, 0, 36 + 16);
+
+	/* Block Device ROD Token Limits descriptor */
+	to_be16(&desc[0], SPDK_SPC_TPC_DESC_BLOCK_ROD_LIMITS);
+	to_be16(&desc[2], 32);
+	to_be16(&desc[10], SCSI_COPY_MAX_RANGE_DESCS);
+	to_be32(&desc[12], SCSI_COPY_MAX_INACTIVITY_TIMEOUT);
+	to_be32(&desc[16], SCSI_COPY_DEFAULT_INACTIVITY_TIMEOUT);
+	/* MAXIMUM TOKEN TRANSFER SIZE and OPTIMAL TRANSFER COUNT, in blocks */
+	to_be64(&desc[20], SCSI_COPY_MAX_TOKEN_TRANSFER_SIZE / block_size);
+	to_be64(&desc[28], SCSI_COPY_OPTIMAL_TRANSFER_SIZE / block_size);
+	desc += 36;
+
+	/* Supported Commands descriptor */
+	to_be16(&desc[0], SPDK_SPC_TPC_DESC_SUPPORTED_COMMANDS);
+	to_be16(&desc[2], 12);
+	desc[4] = 9;
+	desc[5] = SPDK_SPC_EXTENDED_COPY;
+	desc[6] = 3;
+	desc[7] = SPDK_SPC_SA_EXTENDED_COPY_LID1;
+	desc[8] = SPDK_SPC_SA_POPULATE_TOKEN;
+	desc[9] = SPDK_SPC_SA_WRITE_USING_TOKEN;
+	desc[10] = SPDK_SPC_RECEIVE_COPY_RESULTS;
+	desc[11] = 2;
+	desc[12] = SPDK_SPC_SA_RECEIVE_COPY_OPERATING_PARAMETERS;
+	desc[13] = SPDK_SPC_SA_RECEIVE_ROD_TOKEN_INFORMATION;
+	desc += 16;
+
+	return desc - buf;
+}
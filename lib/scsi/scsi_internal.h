@@ -57,6 +57,8 @@ struct spdk_scsi_pr_reservation {
 	uint64_t				crkey;
 };
 
+struct scsi_copy_result;
+
 struct spdk_scsi_dev {
 	int					id;
 	int					is_allocated;
@@ -153,6 +155,11 @@ struct spdk_scsi_lun {
 	struct spdk_scsi_pr_reservation reservation;
 	/** Reservation holder for SPC2 RESERVE(6) and RESERVE(10) */
 	struct spdk_scsi_pr_registrant scsi2_holder;
+
+	/** Results of token based copies, including ROD tokens created from this LUN */
+	TAILQ_HEAD(, scsi_copy_result) copy_results;
+	/** Number of entries in copy_results */
+	uint32_t num_copy_results;
 };
 
 struct spdk_scsi_lun *scsi_lun_construct(const char *bdev_name,
@@ -189,6 +196,14 @@ int scsi_pr_out(struct spdk_scsi_task *task, uint8_t *cdb, uint8_t *data, uint16
 int scsi_pr_in(struct spdk_scsi_task *task, uint8_t *cdb, uint8_t *data, uint16_t data_len);
 int scsi_pr_check(struct spdk_scsi_task *task);
 
+int scsi_copy_out(struct spdk_scsi_task *task);
+int scsi_copy_in(struct spdk_scsi_task *task);
+int scsi_copy_vpd_page(struct spdk_scsi_lun *lun, uint8_t *buf, uint16_t len);
+void scsi_copy_invalidate_tokens(struct spdk_scsi_lun *lun, uint64_t lba, uint64_t num_blocks);
+void scsi_copy_free_results(struct spdk_scsi_lun *lun);
+
+void bdev_scsi_set_naa_ieee_extended(const char *name, uint8_t *buf);
+
 int scsi2_reserve(struct spdk_scsi_task *task, uint8_t *cdb);
 int scsi2_release(struct spdk_scsi_task *task);
 int scsi2_reserve_check(struct spdk_scsi_task *task);
@@ -23,6 +23,9 @@
  * for the default. */
 #define IOBUF_DEFAULT_LARGE_BUFSIZE	(132 * 1024)
 #define IOBUF_MAX_CHANNELS		64
+/* How often a thread with requests waiting for buffers checks the main pool for buffers
+ * handed off by other threads. */
+#define IOBUF_CHANNEL_POLL_PERIOD_US	10
 
 SPDK_STATIC_ASSERT(sizeof(struct spdk_iobuf_buffer) <= IOBUF_MIN_SMALL_BUFSIZE,
 		   "Invalid data offset");
@@ -37,6 +40,8 @@ struct iobuf_channel_node {
 struct iobuf_channel {
 	struct iobuf_channel_node	node[SPDK_CONFIG_MAX_NUMA_NODES];
 	struct spdk_iobuf_channel	*channels[IOBUF_MAX_CHANNELS];
+	/* Serves the wait queues with buffers released on other threads */
+	struct spdk_poller		*poller;
 };
 
 struct iobuf_module {
@@ -49,6 +54,9 @@ struct iobuf_node {
 	struct spdk_ring		*large_pool;
 	void				*small_pool_base;
 	void				*large_pool_base;
+	/* Number of requests waiting for a buffer on all threads */
+	uint32_t			small_waiters;
+	uint32_t			large_waiters;
 };
 
 struct iobuf {
@@ -110,6 +118,8 @@ iobuf_channel_destroy_cb(void *io_device, void *ctx)
 		assert(STAILQ_EMPTY(&node->small_queue));
 		assert(STAILQ_EMPTY(&node->large_queue));
 	}
+
+	spdk_poller_unregister(&ch->poller);
 }
 
 static int
@@ -395,6 +405,12 @@ iobuf_channel_node_init(struct spdk_iobuf_channel *ch, struct iobuf_channel *iob
 	cache->large.cache_size = large_cache_size;
 	cache->small.cache_count = 0;
 	cache->large.cache_count = 0;
+	cache->small.waiters = &node->small_waiters;
+	cache->large.waiters = &node->large_waiters;
+	cache->small.in_use = 0;
+	cache->large.in_use = 0;
+	memset(&cache->small.stats, 0, sizeof(cache->small.stats));
+	memset(&cache->large.stats, 0, sizeof(cache->large.stats));
 
 	STAILQ_INIT(&cache->small.cache);
 	STAILQ_INIT(&cache->large.cache);
@@ -435,6 +451,9 @@ iobuf_channel_node_populate(struct spdk_iobuf_channel *ch, const char *name, int
 		cache->large.cache_count++;
 	}
 
+	cache->small.stats.low_watermark = spdk_ring_count(node->small_pool);
+	cache->large.stats.low_watermark = spdk_ring_count(node->large_pool);
+
 	return 0;
 }
 
@@ -669,6 +688,7 @@ iobuf_entry_abort_node(struct spdk_iobuf_channel *ch, int32_t numa_id,
 	STAILQ_FOREACH(e, pool->queue, stailq) {
 		if (e == entry) {
 			STAILQ_REMOVE(pool->queue, entry, spdk_iobuf_entry, stailq);
+			__atomic_fetch_sub(pool->waiters, 1, __ATOMIC_RELAXED);
 			return true;
 		}
 	}
@@ -689,6 +709,158 @@ spdk_iobuf_entry_abort(struct spdk_iobuf_channel *ch, struct spdk_iobuf_entry *e
 
 #define IOBUF_BATCH_SIZE 32
 
+static inline void
+iobuf_pool_hold(struct spdk_iobuf_pool_cache *pool)
+{
+	pool->in_use++;
+	if (pool->in_use > pool->stats.high_watermark) {
+		pool->stats.high_watermark = pool->in_use;
+	}
+}
+
+static inline void
+iobuf_pool_release(struct spdk_iobuf_pool_cache *pool)
+{
+	/* Buffers may be released through a different channel of the same module */
+	if (pool->in_use > 0) {
+		pool->in_use--;
+	}
+}
+
+static void
+iobuf_pool_update_low_watermark(struct spdk_iobuf_pool_cache *pool)
+{
+	uint64_t count = spdk_ring_count(pool->pool);
+
+	if (count < pool->stats.low_watermark) {
+		pool->stats.low_watermark = count;
+	}
+}
+
+static struct spdk_iobuf_pool_cache *
+iobuf_channel_get_pool(struct iobuf_channel *iobuf_ch, const void *module, int32_t numa_id,
+		       bool large)
+{
+	struct spdk_iobuf_channel *ch;
+	uint32_t i;
+
+	for (i = 0; i < IOBUF_MAX_CHANNELS; ++i) {
+		ch = iobuf_ch->channels[i];
+		if (ch != NULL && ch->module == module) {
+			return large ? &ch->cache[numa_id].large : &ch->cache[numa_id].small;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+iobuf_entry_complete(spdk_iobuf_entry_stailq_t *queue, struct spdk_iobuf_entry *entry, void *buf)
+{
+	entry->cb_fn(entry, buf);
+	/* If the callback requested another buffer using the same entry, it's put at the end of
+	 * the queue.  Move it to the front, so that it's served first. */
+	if (spdk_unlikely(entry == STAILQ_LAST(queue, spdk_iobuf_entry, stailq))) {
+		STAILQ_REMOVE(queue, entry, spdk_iobuf_entry, stailq);
+		STAILQ_INSERT_HEAD(queue, entry, stailq);
+	}
+}
+
+static size_t
+iobuf_channel_serve_queue(struct iobuf_channel *iobuf_ch, spdk_iobuf_entry_stailq_t *queue,
+			  struct spdk_ring *ring, uint32_t *waiters, int32_t numa_id, bool large)
+{
+	struct spdk_iobuf_buffer *bufs[IOBUF_BATCH_SIZE];
+	struct spdk_iobuf_pool_cache *pool;
+	struct spdk_iobuf_entry *entry;
+	size_t count = 0, sz, i;
+
+	STAILQ_FOREACH(entry, queue, stailq) {
+		if (++count == IOBUF_BATCH_SIZE) {
+			break;
+		}
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	sz = spdk_ring_dequeue(ring, (void **)bufs, count);
+	for (i = 0; i < sz; ++i) {
+		entry = STAILQ_FIRST(queue);
+		if (spdk_unlikely(entry == NULL)) {
+			/* The callbacks might have aborted some of the remaining entries */
+			spdk_ring_enqueue(ring, (void **)&bufs[i], sz - i, NULL);
+			break;
+		}
+
+		STAILQ_REMOVE_HEAD(queue, stailq);
+		__atomic_fetch_sub(waiters, 1, __ATOMIC_RELAXED);
+
+		pool = iobuf_channel_get_pool(iobuf_ch, entry->module, numa_id, large);
+		if (pool != NULL) {
+			iobuf_pool_hold(pool);
+		}
+
+		iobuf_entry_complete(queue, entry, bufs[i]);
+	}
+
+	return sz;
+}
+
+static int
+iobuf_channel_poll(void *ctx)
+{
+	struct iobuf_channel *iobuf_ch = ctx;
+	struct iobuf_channel_node *ch_node;
+	struct iobuf_node *node;
+	bool waiting = false;
+	size_t count = 0;
+	int32_t i;
+
+	IOBUF_FOREACH_NUMA_ID(i) {
+		ch_node = &iobuf_ch->node[i];
+		node = &g_iobuf.node[i];
+
+		count += iobuf_channel_serve_queue(iobuf_ch, &ch_node->small_queue,
+						   node->small_pool,
+						   &node->small_waiters, i, false);
+		count += iobuf_channel_serve_queue(iobuf_ch, &ch_node->large_queue,
+						   node->large_pool,
+						   &node->large_waiters, i, true);
+
+		if (!STAILQ_EMPTY(&ch_node->small_queue) || !STAILQ_EMPTY(&ch_node->large_queue)) {
+			waiting = true;
+		}
+	}
+
+	if (!waiting) {
+		spdk_poller_unregister(&iobuf_ch->poller);
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static void
+iobuf_channel_queue_entry(struct spdk_iobuf_channel *ch, struct spdk_iobuf_pool_cache *pool,
+			  struct spdk_iobuf_entry *entry, spdk_iobuf_get_cb cb_fn)
+{
+	struct iobuf_channel *iobuf_ch = spdk_io_channel_get_ctx(ch->parent);
+
+	STAILQ_INSERT_TAIL(pool->queue, entry, stailq);
+	entry->module = ch->module;
+	entry->cb_fn = cb_fn;
+	pool->stats.retry++;
+	__atomic_fetch_add(pool->waiters, 1, __ATOMIC_RELAXED);
+
+	/* Buffers released on other threads end up in the main pool, so poll it until all
+	 * the requests are served. */
+	if (iobuf_ch->poller == NULL) {
+		iobuf_ch->poller = SPDK_POLLER_REGISTER(iobuf_channel_poll, iobuf_ch,
+							IOBUF_CHANNEL_POLL_PERIOD_US);
+	}
+}
+
 void *
 spdk_iobuf_get(struct spdk_iobuf_channel *ch, uint64_t len,
 	       struct spdk_iobuf_entry *entry, spdk_iobuf_get_cb cb_fn)
@@ -713,6 +885,7 @@ spdk_iobuf_get(struct spdk_iobuf_channel *ch, uint64_t len,
 		assert(pool->cache_count > 0);
 		pool->cache_count--;
 		pool->stats.cache++;
+		iobuf_pool_hold(pool);
 	} else {
 		struct spdk_iobuf_buffer *bufs[IOBUF_BATCH_SIZE];
 		size_t sz, i;
@@ -720,18 +893,17 @@ spdk_iobuf_get(struct spdk_iobuf_channel *ch, uint64_t len,
 		/* If we're going to dequeue, we may as well dequeue a batch. */
 		sz = spdk_ring_dequeue(pool->pool, (void **)bufs, spdk_min(IOBUF_BATCH_SIZE,
 				       spdk_max(pool->cache_size, 1)));
+		iobuf_pool_update_low_watermark(pool);
 		if (sz == 0) {
 			if (entry) {
-				STAILQ_INSERT_TAIL(pool->queue, entry, stailq);
-				entry->module = ch->module;
-				entry->cb_fn = cb_fn;
-				pool->stats.retry++;
+				iobuf_channel_queue_entry(ch, pool, entry, cb_fn);
 			}
 
 			return NULL;
 		}
 
 		pool->stats.main++;
+		iobuf_pool_hold(pool);
 		for (i = 0; i < (sz - 1); i++) {
 			STAILQ_INSERT_HEAD(&pool->cache, bufs[i], stailq);
 			pool->cache_count++;
@@ -750,7 +922,8 @@ spdk_iobuf_put(struct spdk_iobuf_channel *ch, void *buf, uint64_t len)
 	struct spdk_iobuf_entry *entry;
 	struct spdk_iobuf_buffer *iobuf_buf;
 	struct spdk_iobuf_node_cache *cache;
-	struct spdk_iobuf_pool_cache *pool;
+	struct spdk_iobuf_pool_cache *pool, *other;
+	struct iobuf_channel *iobuf_ch;
 	uint32_t numa_id;
 	size_t sz;
 
@@ -770,6 +943,16 @@ spdk_iobuf_put(struct spdk_iobuf_channel *ch, void *buf, uint64_t len)
 	}
 
 	if (STAILQ_EMPTY(pool->queue)) {
+		iobuf_pool_release(pool);
+
+		/* Nobody is waiting on this thread, but if there are requests waiting on other
+		 * threads, return the buffer to the main pool, so that they can pick it up. */
+		if (spdk_unlikely(__atomic_load_n(pool->waiters, __ATOMIC_RELAXED) > 0)) {
+			spdk_ring_enqueue(pool->pool, (void **)&buf, 1, NULL);
+			pool->stats.handoff++;
+			return;
+		}
+
 		if (pool->cache_size == 0) {
 			spdk_ring_enqueue(pool->pool, (void **)&buf, 1, NULL);
 			return;
@@ -800,11 +983,19 @@ spdk_iobuf_put(struct spdk_iobuf_channel *ch, void *buf, uint64_t len)
 	} else {
 		entry = STAILQ_FIRST(pool->queue);
 		STAILQ_REMOVE_HEAD(pool->queue, stailq);
-		entry->cb_fn(entry, buf);
-		if (spdk_unlikely(entry == STAILQ_LAST(pool->queue, spdk_iobuf_entry, stailq))) {
-			STAILQ_REMOVE(pool->queue, entry, spdk_iobuf_entry, stailq);
-			STAILQ_INSERT_HEAD(pool->queue, entry, stailq);
+		__atomic_fetch_sub(pool->waiters, 1, __ATOMIC_RELAXED);
+
+		if (entry->module != ch->module) {
+			iobuf_ch = spdk_io_channel_get_ctx(ch->parent);
+			iobuf_pool_release(pool);
+			other = iobuf_channel_get_pool(iobuf_ch, entry->module, numa_id,
+						       pool == &cache->large);
+			if (other != NULL) {
+				iobuf_pool_hold(other);
+			}
 		}
+
+		iobuf_entry_complete(pool->queue, entry, buf);
 	}
 }
 
@@ -812,12 +1003,36 @@ static void
 iobuf_get_channel_stats_done(struct spdk_io_channel_iter *iter, int status)
 {
 	struct iobuf_get_stats_ctx *ctx = spdk_io_channel_iter_get_ctx(iter);
+	struct spdk_iobuf_module_stats *it;
+	uint32_t i;
+
+	for (i = 0; i < ctx->num_modules; ++i) {
+		it = &ctx->modules[i];
+		/* Modules without any channels have never seen the pool */
+		if (it->small_pool.low_watermark == UINT64_MAX) {
+			it->small_pool.low_watermark = 0;
+		}
+		if (it->large_pool.low_watermark == UINT64_MAX) {
+			it->large_pool.low_watermark = 0;
+		}
+	}
 
 	ctx->cb_fn(ctx->modules, ctx->num_modules, ctx->cb_arg);
 	free(ctx->modules);
 	free(ctx);
 }
 
+static void
+iobuf_pool_stats_add(struct spdk_iobuf_pool_stats *stats, const struct spdk_iobuf_pool_stats *add)
+{
+	stats->cache += add->cache;
+	stats->main += add->main;
+	stats->retry += add->retry;
+	stats->handoff += add->handoff;
+	stats->high_watermark += add->high_watermark;
+	stats->low_watermark = spdk_min(stats->low_watermark, add->low_watermark);
+}
+
 static void
 iobuf_get_channel_stats(struct spdk_io_channel_iter *iter)
 {
@@ -839,19 +1054,13 @@ iobuf_get_channel_stats(struct spdk_io_channel_iter *iter)
 			it = &ctx->modules[i];
 			module = (struct iobuf_module *)channel->module;
 			if (strcmp(it->module, module->name) == 0) {
-				struct spdk_iobuf_pool_cache *cache;
 				uint32_t i;
 
 				IOBUF_FOREACH_NUMA_ID(i) {
-					cache = &channel->cache[i].small;
-					it->small_pool.cache += cache->stats.cache;
-					it->small_pool.main += cache->stats.main;
-					it->small_pool.retry += cache->stats.retry;
-
-					cache = &channel->cache[i].large;
-					it->large_pool.cache += cache->stats.cache;
-					it->large_pool.main += cache->stats.main;
-					it->large_pool.retry += cache->stats.retry;
+					iobuf_pool_stats_add(&it->small_pool,
+							     &channel->cache[i].small.stats);
+					iobuf_pool_stats_add(&it->large_pool,
+							     &channel->cache[i].large.stats);
 				}
 				break;
 			}
@@ -886,6 +1095,8 @@ spdk_iobuf_get_stats(spdk_iobuf_get_stats_cb cb_fn, void *cb_arg)
 	i = 0;
 	TAILQ_FOREACH(module, &g_iobuf.modules, tailq) {
 		ctx->modules[i].module = module->name;
+		ctx->modules[i].small_pool.low_watermark = UINT64_MAX;
+		ctx->modules[i].large_pool.low_watermark = UINT64_MAX;
 		++i;
 	}
 
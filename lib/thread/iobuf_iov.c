@@ -0,0 +1,114 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 agent <agent@local>.
+ *   All rights reserved.
+ */
+
+/*
+ * Scatter-gather allocations built on top of spdk_iobuf_get()/spdk_iobuf_put().  This is kept
+ * separate from iobuf.c, so that it can also be used with the iobuf stubs in unit tests.
+ */
+
+#include "spdk/stdinc.h"
+#include "spdk/likely.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+static void iobuf_get_iov_cb(struct spdk_iobuf_entry *iobuf, void *buf);
+
+static inline void
+iobuf_iov_set_buf(struct spdk_iobuf_iov_entry *entry, void *buf)
+{
+	struct iovec *iov = &entry->iovs[entry->iovcnt++];
+
+	iov->iov_base = buf;
+	iov->iov_len = spdk_min(entry->remaining, entry->bufsize);
+	entry->remaining -= iov->iov_len;
+}
+
+static int
+iobuf_iov_fill(struct spdk_iobuf_iov_entry *entry)
+{
+	struct spdk_iobuf_entry *iobuf = entry->cb_fn != NULL ? &entry->iobuf : NULL;
+	void *buf;
+
+	while (entry->remaining > 0) {
+		buf = spdk_iobuf_get(entry->ch, spdk_min(entry->remaining, entry->bufsize), iobuf,
+				     iobuf_get_iov_cb);
+		if (buf == NULL) {
+			return -ENOMEM;
+		}
+
+		iobuf_iov_set_buf(entry, buf);
+	}
+
+	return entry->iovcnt;
+}
+
+static void
+iobuf_get_iov_cb(struct spdk_iobuf_entry *iobuf, void *buf)
+{
+	struct spdk_iobuf_iov_entry *entry = SPDK_CONTAINEROF(iobuf, struct spdk_iobuf_iov_entry,
+					     iobuf);
+
+	iobuf_iov_set_buf(entry, buf);
+	/* If there's still not enough buffers, the entry is queued again.  It's done from within
+	 * the callback, so it'll be put at the front of the queue. */
+	if (iobuf_iov_fill(entry) > 0) {
+		entry->cb_fn(entry, entry->iovcnt);
+	}
+}
+
+int
+spdk_iobuf_get_iov(struct spdk_iobuf_channel *ch, uint64_t len, uint32_t bufsize,
+		   struct iovec *iovs, int iovcnt, struct spdk_iobuf_iov_entry *entry,
+		   spdk_iobuf_get_iov_cb cb_fn)
+{
+	struct spdk_iobuf_iov_entry local_entry;
+	int rc;
+
+	assert(entry != NULL || cb_fn == NULL);
+	if (bufsize == 0) {
+		bufsize = ch->cache[0].large.bufsize;
+	}
+
+	if (spdk_unlikely(SPDK_CEIL_DIV(len, bufsize) > (uint64_t)iovcnt)) {
+		return -EINVAL;
+	}
+
+	if (entry == NULL) {
+		entry = &local_entry;
+	}
+
+	entry->cb_fn = cb_fn;
+	entry->ch = ch;
+	entry->iovs = iovs;
+	entry->iovcnt = 0;
+	entry->bufsize = bufsize;
+	entry->remaining = len;
+
+	rc = iobuf_iov_fill(entry);
+	if (spdk_unlikely(rc < 0 && cb_fn == NULL)) {
+		spdk_iobuf_put_iov(ch, iovs, entry->iovcnt);
+		entry->iovcnt = 0;
+	}
+
+	return rc;
+}
+
+void
+spdk_iobuf_put_iov(struct spdk_iobuf_channel *ch, struct iovec *iovs, int iovcnt)
+{
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		spdk_iobuf_put(ch, iovs[i].iov_base, iovs[i].iov_len);
+	}
+}
+
+void
+spdk_iobuf_iov_entry_abort(struct spdk_iobuf_channel *ch, struct spdk_iobuf_iov_entry *entry)
+{
+	spdk_iobuf_entry_abort(ch, &entry->iobuf, spdk_min(entry->remaining, entry->bufsize));
+	spdk_iobuf_put_iov(ch, entry->iovs, entry->iovcnt);
+	entry->iovcnt = 0;
+}
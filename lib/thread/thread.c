@@ -128,6 +128,17 @@ struct spdk_thread {
 	int				msg_fd;
 	SLIST_HEAD(, spdk_msg)		msg_cache;
 	size_t				msg_cache_count;
+	/*
+	 * Per thread pair message channels, only used if enabled by
+	 * spdk_thread_lib_set_msg_channel_size(). out_channels is only accessed by this
+	 * thread as the producer, in_channels by this thread as the consumer. Channels
+	 * created by other threads are handed over through new_in_channels, which is
+	 * protected by g_devlist_mutex.
+	 */
+	RB_HEAD(msg_channel_tree, msg_channel)	out_channels;
+	struct msg_channel		*last_out_channel;
+	TAILQ_HEAD(, msg_channel)	in_channels;
+	TAILQ_HEAD(, msg_channel)	new_in_channels;
 	spdk_msg_fn			critical_msg;
 	uint64_t			id;
 	uint64_t			next_poller_id;
@@ -154,7 +165,15 @@ struct spdk_thread {
 
 	uint16_t			trace_id;
 
-	uint8_t				reserved[6];
+	bool				has_new_in_channels;
+
+	uint8_t				reserved[1];
+
+	/*
+	 * Messages enqueued on the shared ring and not executed yet, only counted if the
+	 * message channels are enabled. Senders don't use a channel while it is not 0.
+	 */
+	uint32_t			msg_ring_pending;
 
 	/* User context allocated at the end */
 	uint8_t				ctx[0];
@@ -289,7 +308,53 @@ struct spdk_msg {
 	SLIST_ENTRY(spdk_msg)	link;
 };
 
+struct msg_channel_entry {
+	spdk_msg_fn		fn;
+	void			*arg;
+};
+
+/*
+ * Single-producer/single-consumer ring carrying messages from one thread (src)
+ * to another (dst). The channel is owned by both threads. Whichever of them is
+ * freed last frees the channel; src and dst are cleared under g_devlist_mutex
+ * when the respective thread is freed.
+ *
+ * Messages must be executed in the order they were sent, also when the order comes
+ * from messages passed between other threads in the meantime. Two rules keep that
+ * order between the channels and the shared ring of the receiver:
+ *  - A sender only uses a channel while the receiver's msg_ring_pending is 0, so a
+ *    message sent on a channel never overtakes a message still in the ring.
+ *  - The receiver runs the messages found in its channels after dequeuing a batch
+ *    from the ring and before executing it, so a ring message never overtakes a
+ *    message sent on a channel before it.
+ */
+struct msg_channel {
+	/* Producer side, only written by src. */
+	uint32_t			tail;
+	uint32_t			cached_head;
+	uint32_t			mask;
+	uint64_t			dst_id;
+	struct spdk_thread		*dst;
+	RB_ENTRY(msg_channel)		node;
+
+	/* Consumer side, only written by dst. */
+	uint32_t			head __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
+	struct spdk_thread		*src;
+	TAILQ_ENTRY(msg_channel)	link;
+
+	struct msg_channel_entry	entries[] __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
+};
+
+static int
+msg_channel_cmp(struct msg_channel *ch1, struct msg_channel *ch2)
+{
+	return (ch1->dst_id < ch2->dst_id ? -1 : ch1->dst_id > ch2->dst_id);
+}
+
+RB_GENERATE_STATIC(msg_channel_tree, msg_channel, node, msg_channel_cmp);
+
 static struct spdk_mempool *g_spdk_msg_mempool = NULL;
+static uint32_t g_msg_channel_size = 0;
 
 static TAILQ_HEAD(, spdk_thread) g_threads = TAILQ_HEAD_INITIALIZER(g_threads);
 static uint32_t g_thread_count = 0;
@@ -373,6 +438,34 @@ _thread_lib_init(size_t ctx_sz, size_t msg_mempool_sz)
 static void thread_interrupt_destroy(struct spdk_thread *thread);
 static int thread_interrupt_create(struct spdk_thread *thread);
 
+/* Must be called with g_devlist_mutex held. */
+static void
+msg_channels_release(struct spdk_thread *thread)
+{
+	struct msg_channel *ch, *tmp;
+
+	RB_FOREACH_SAFE(ch, msg_channel_tree, &thread->out_channels, tmp) {
+		RB_REMOVE(msg_channel_tree, &thread->out_channels, ch);
+		if (ch->dst == NULL) {
+			free(ch);
+		} else {
+			__atomic_store_n(&ch->src, NULL, __ATOMIC_RELEASE);
+		}
+	}
+	thread->last_out_channel = NULL;
+
+	TAILQ_CONCAT(&thread->in_channels, &thread->new_in_channels, link);
+	TAILQ_FOREACH_SAFE(ch, &thread->in_channels, link, tmp) {
+		TAILQ_REMOVE(&thread->in_channels, ch, link);
+		if (ch->src == NULL) {
+			free(ch);
+		} else {
+			__atomic_store_n(&ch->dst, NULL, __ATOMIC_RELEASE);
+		}
+	}
+	thread->has_new_in_channels = false;
+}
+
 static void
 _free_thread(struct spdk_thread *thread)
 {
@@ -413,6 +506,7 @@ _free_thread(struct spdk_thread *thread)
 	assert(g_thread_count > 0);
 	g_thread_count--;
 	TAILQ_REMOVE(&g_threads, thread, tailq);
+	msg_channels_release(thread);
 	pthread_mutex_unlock(&g_devlist_mutex);
 
 	msg = SLIST_FIRST(&thread->msg_cache);
@@ -475,6 +569,24 @@ spdk_thread_lib_init_ext(spdk_thread_op_fn thread_op_fn,
 	return _thread_lib_init(ctx_sz, msg_mempool_sz);
 }
 
+int
+spdk_thread_lib_set_msg_channel_size(uint32_t size)
+{
+	if (g_thread_count != 0) {
+		SPDK_ERRLOG("Message channel size cannot be changed once threads exist\n");
+		return -EBUSY;
+	}
+
+	if (size != 0 && !spdk_u32_is_pow2(size)) {
+		SPDK_ERRLOG("Message channel size %" PRIu32 " is not a power of 2\n", size);
+		return -EINVAL;
+	}
+
+	g_msg_channel_size = size;
+
+	return 0;
+}
+
 void
 spdk_thread_lib_fini(void)
 {
@@ -492,6 +604,7 @@ spdk_thread_lib_fini(void)
 		_free_thread(g_app_thread);
 		g_app_thread = NULL;
 	}
+	g_msg_channel_size = 0;
 
 	if (g_spdk_msg_mempool) {
 		spdk_mempool_free(g_spdk_msg_mempool);
@@ -528,6 +641,9 @@ spdk_thread_create(const char *name, const struct spdk_cpuset *cpumask)
 	TAILQ_INIT(&thread->paused_pollers);
 	SLIST_INIT(&thread->msg_cache);
 	thread->msg_cache_count = 0;
+	RB_INIT(&thread->out_channels);
+	TAILQ_INIT(&thread->in_channels);
+	TAILQ_INIT(&thread->new_in_channels);
 
 	thread->tsc_last = spdk_get_ticks();
 
@@ -644,6 +760,28 @@ spdk_set_thread(struct spdk_thread *thread)
 	tls_thread = thread;
 }
 
+static bool
+msg_channels_pending(struct spdk_thread *thread)
+{
+	struct msg_channel *ch;
+
+	if (g_msg_channel_size == 0) {
+		return false;
+	}
+
+	if (__atomic_load_n(&thread->has_new_in_channels, __ATOMIC_ACQUIRE)) {
+		return true;
+	}
+
+	TAILQ_FOREACH(ch, &thread->in_channels, link) {
+		if (__atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE) != ch->head) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static void
 thread_exit(struct spdk_thread *thread, uint64_t now)
 {
@@ -656,7 +794,7 @@ thread_exit(struct spdk_thread *thread, uint64_t now)
 		goto exited;
 	}
 
-	if (spdk_ring_count(thread->messages) > 0) {
+	if (spdk_ring_count(thread->messages) > 0 || msg_channels_pending(thread)) {
 		SPDK_INFOLOG(thread, "thread %s still has messages\n", thread->name);
 		return;
 	}
@@ -828,13 +966,103 @@ spdk_thread_get_from_ctx(void *ctx)
 	return SPDK_CONTAINEROF(ctx, struct spdk_thread, ctx);
 }
 
+static inline int thread_send_msg_notification(const struct spdk_thread *target_thread);
+
+static inline void
+msg_put(struct spdk_thread *thread, struct spdk_msg *msg)
+{
+	if (thread->msg_cache_count < SPDK_MSG_MEMPOOL_CACHE_SIZE) {
+		/* Insert the messages at the head. We want to re-use the hot
+		 * ones. */
+		SLIST_INSERT_HEAD(&thread->msg_cache, msg, link);
+		thread->msg_cache_count++;
+	} else {
+		spdk_mempool_put(g_spdk_msg_mempool, msg);
+	}
+}
+
+static inline bool
+msg_channel_enqueue(struct msg_channel *ch, spdk_msg_fn fn, void *arg)
+{
+	struct msg_channel_entry *entry;
+
+	if (ch->tail - ch->cached_head > ch->mask) {
+		ch->cached_head = __atomic_load_n(&ch->head, __ATOMIC_ACQUIRE);
+		if (ch->tail - ch->cached_head > ch->mask) {
+			return false;
+		}
+	}
+
+	entry = &ch->entries[ch->tail & ch->mask];
+	entry->fn = fn;
+	entry->arg = arg;
+	__atomic_store_n(&ch->tail, ch->tail + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+static uint32_t
+msg_channels_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
+{
+	struct msg_channel *ch, *tmp;
+	struct msg_channel_entry entry;
+	uint32_t count = 0, tail;
+
+	if (spdk_unlikely(__atomic_load_n(&thread->has_new_in_channels, __ATOMIC_ACQUIRE))) {
+		pthread_mutex_lock(&g_devlist_mutex);
+		TAILQ_CONCAT(&thread->in_channels, &thread->new_in_channels, link);
+		thread->has_new_in_channels = false;
+		pthread_mutex_unlock(&g_devlist_mutex);
+	}
+
+	TAILQ_FOREACH_SAFE(ch, &thread->in_channels, link, tmp) {
+		if (count == max_msgs) {
+			break;
+		}
+
+		tail = __atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE);
+		while (ch->head != tail && count < max_msgs) {
+			entry = ch->entries[ch->head & ch->mask];
+			/* Free the slot before running the message, the sender may reuse it. */
+			__atomic_store_n(&ch->head, ch->head + 1, __ATOMIC_RELEASE);
+
+			SPDK_DTRACE_PROBE2(msg_exec, entry.fn, entry.arg);
+
+			entry.fn(entry.arg);
+
+			SPIN_ASSERT(thread->lock_count == 0, SPIN_ERR_HOLD_DURING_SWITCH);
+
+			count++;
+		}
+
+		if (ch->head != tail) {
+			/* Out of budget. Start with the next channel in the next batch. */
+			TAILQ_REMOVE(&thread->in_channels, ch, link);
+			TAILQ_INSERT_TAIL(&thread->in_channels, ch, link);
+			break;
+		}
+
+		if (spdk_unlikely(__atomic_load_n(&ch->src, __ATOMIC_ACQUIRE) == NULL)) {
+			/* The sender is gone and there are no messages left. */
+			pthread_mutex_lock(&g_devlist_mutex);
+			assert(ch->src == NULL);
+			if (__atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE) == ch->head) {
+				TAILQ_REMOVE(&thread->in_channels, ch, link);
+				free(ch);
+			}
+			pthread_mutex_unlock(&g_devlist_mutex);
+		}
+	}
+
+	return count;
+}
+
 static inline uint32_t
-msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
+msg_ring_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
 {
 	unsigned count, i;
+	uint32_t extra = 0;
 	void *messages[SPDK_MSG_BATCH_SIZE];
-	uint64_t notify = 1;
-	int rc;
 
 #ifdef DEBUG
 	/*
@@ -845,24 +1073,23 @@ msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
 	memset(messages, 0, sizeof(messages));
 #endif
 
-	if (max_msgs > 0) {
-		max_msgs = spdk_min(max_msgs, SPDK_MSG_BATCH_SIZE);
-	} else {
-		max_msgs = SPDK_MSG_BATCH_SIZE;
+	if (max_msgs == 0) {
+		return 0;
 	}
 
 	count = spdk_ring_dequeue(thread->messages, messages, max_msgs);
-	if (spdk_unlikely(thread->in_interrupt) &&
-	    spdk_ring_count(thread->messages) != 0) {
-		rc = write(thread->msg_fd, &notify, sizeof(notify));
-		if (rc < 0) {
-			SPDK_ERRLOG("failed to notify msg_queue: %s.\n", spdk_strerror(errno));
-		}
-	}
 	if (count == 0) {
 		return 0;
 	}
 
+	if (g_msg_channel_size != 0) {
+		/* Messages sent on a channel before any of the dequeued ones have to run
+		 * first. They are all in the channels by now, and no new ones are added
+		 * while msg_ring_pending isn't 0, so this is bounded by the channels' size.
+		 */
+		extra = msg_channels_run_batch(thread, UINT32_MAX);
+	}
+
 	for (i = 0; i < count; i++) {
 		struct spdk_msg *msg = messages[i];
 
@@ -874,13 +1101,46 @@ msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
 
 		SPIN_ASSERT(thread->lock_count == 0, SPIN_ERR_HOLD_DURING_SWITCH);
 
-		if (thread->msg_cache_count < SPDK_MSG_MEMPOOL_CACHE_SIZE) {
-			/* Insert the messages at the head. We want to re-use the hot
-			 * ones. */
-			SLIST_INSERT_HEAD(&thread->msg_cache, msg, link);
-			thread->msg_cache_count++;
-		} else {
-			spdk_mempool_put(g_spdk_msg_mempool, msg);
+		msg_put(thread, msg);
+	}
+
+	if (g_msg_channel_size != 0) {
+		__atomic_fetch_sub(&thread->msg_ring_pending, count, __ATOMIC_RELEASE);
+	}
+
+	return count + extra;
+}
+
+static inline uint32_t
+msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
+{
+	uint32_t count;
+	uint64_t notify = 1;
+	int rc;
+
+	if (max_msgs > 0) {
+		max_msgs = spdk_min(max_msgs, SPDK_MSG_BATCH_SIZE);
+	} else {
+		max_msgs = SPDK_MSG_BATCH_SIZE;
+	}
+
+	if (spdk_likely(g_msg_channel_size == 0)) {
+		count = msg_ring_run_batch(thread, max_msgs);
+	} else {
+		/* The ring can't starve: senders stop using the channels while it has
+		 * messages pending.
+		 */
+		count = msg_channels_run_batch(thread, max_msgs);
+		if (count < max_msgs) {
+			count += msg_ring_run_batch(thread, max_msgs - count);
+		}
+	}
+
+	if (spdk_unlikely(thread->in_interrupt) &&
+	    (spdk_ring_count(thread->messages) != 0 || msg_channels_pending(thread))) {
+		rc = write(thread->msg_fd, &notify, sizeof(notify));
+		if (rc < 0) {
+			SPDK_ERRLOG("failed to notify msg_queue: %s.\n", spdk_strerror(errno));
 		}
 	}
 
@@ -1258,6 +1518,7 @@ bool
 spdk_thread_is_idle(struct spdk_thread *thread)
 {
 	if (spdk_ring_count(thread->messages) ||
+	    msg_channels_pending(thread) ||
 	    thread_has_unpaused_pollers(thread) ||
 	    thread->critical_msg != NULL) {
 		return false;
@@ -1370,6 +1631,90 @@ thread_send_msg_notification(const struct spdk_thread *target_thread)
 	return 0;
 }
 
+static struct spdk_msg *
+msg_get(struct spdk_thread *local_thread)
+{
+	struct spdk_msg *msg = NULL;
+
+	if (local_thread != NULL) {
+		if (local_thread->msg_cache_count > 0) {
+			msg = SLIST_FIRST(&local_thread->msg_cache);
+			assert(msg != NULL);
+			SLIST_REMOVE_HEAD(&local_thread->msg_cache, link);
+			local_thread->msg_cache_count--;
+		}
+	}
+
+	if (msg == NULL) {
+		msg = spdk_mempool_get(g_spdk_msg_mempool);
+		if (!msg) {
+			SPDK_ERRLOG("msg could not be allocated\n");
+			return NULL;
+		}
+	}
+
+	return msg;
+}
+
+static struct msg_channel *
+msg_channel_create(struct spdk_thread *src, struct spdk_thread *dst)
+{
+	struct msg_channel *ch;
+	size_t size;
+	int rc;
+
+	size = sizeof(*ch) + g_msg_channel_size * sizeof(struct msg_channel_entry);
+	rc = posix_memalign((void **)&ch, SPDK_CACHE_LINE_SIZE, size);
+	if (rc != 0) {
+		SPDK_ERRLOG("Unable to allocate message channel from %s to %s\n",
+			    src->name, dst->name);
+		return NULL;
+	}
+	memset(ch, 0, sizeof(*ch));
+
+	ch->mask = g_msg_channel_size - 1;
+	ch->dst_id = dst->id;
+	ch->src = src;
+	ch->dst = dst;
+	RB_INSERT(msg_channel_tree, &src->out_channels, ch);
+
+	/* The receiver picks the channel up on its next msg_queue_run_batch(). */
+	pthread_mutex_lock(&g_devlist_mutex);
+	TAILQ_INSERT_TAIL(&dst->new_in_channels, ch, link);
+	__atomic_store_n(&dst->has_new_in_channels, true, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	return ch;
+}
+
+/* Returns false if the message has to go through the receiver's shared ring instead. */
+static bool
+msg_channel_send(struct spdk_thread *local_thread, const struct spdk_thread *thread,
+		 spdk_msg_fn fn, void *ctx)
+{
+	struct msg_channel *ch, find = {};
+
+	/* Don't overtake the messages in the ring, see struct msg_channel. */
+	if (__atomic_load_n(&thread->msg_ring_pending, __ATOMIC_ACQUIRE) != 0) {
+		return false;
+	}
+
+	ch = local_thread->last_out_channel;
+	if (ch == NULL || ch->dst_id != thread->id) {
+		find.dst_id = thread->id;
+		ch = RB_FIND(msg_channel_tree, &local_thread->out_channels, &find);
+		if (ch == NULL) {
+			ch = msg_channel_create(local_thread, (struct spdk_thread *)thread);
+			if (ch == NULL) {
+				return false;
+			}
+		}
+		local_thread->last_out_channel = ch;
+	}
+
+	return msg_channel_enqueue(ch, fn, ctx);
+}
+
 int
 spdk_thread_send_msg(const struct spdk_thread *thread, spdk_msg_fn fn, void *ctx)
 {
@@ -1386,31 +1731,35 @@ spdk_thread_send_msg(const struct spdk_thread *thread, spdk_msg_fn fn, void *ctx
 
 	local_thread = _get_thread();
 
-	msg = NULL;
-	if (local_thread != NULL) {
-		if (local_thread->msg_cache_count > 0) {
-			msg = SLIST_FIRST(&local_thread->msg_cache);
-			assert(msg != NULL);
-			SLIST_REMOVE_HEAD(&local_thread->msg_cache, link);
-			local_thread->msg_cache_count--;
-		}
+	if (g_msg_channel_size != 0 && local_thread != NULL &&
+	    msg_channel_send(local_thread, thread, fn, ctx)) {
+		return thread_send_msg_notification(thread);
 	}
 
+	msg = msg_get(local_thread);
 	if (msg == NULL) {
-		msg = spdk_mempool_get(g_spdk_msg_mempool);
-		if (!msg) {
-			SPDK_ERRLOG("msg could not be allocated\n");
-			return -ENOMEM;
-		}
+		return -ENOMEM;
 	}
 
 	msg->fn = fn;
 	msg->arg = ctx;
 
+	if (g_msg_channel_size != 0) {
+		/* Counted before the enqueue, so that senders seeing the message stop
+		 * using the channels until it has run.
+		 */
+		__atomic_fetch_add(&((struct spdk_thread *)thread)->msg_ring_pending, 1,
+				   __ATOMIC_SEQ_CST);
+	}
+
 	rc = spdk_ring_enqueue(thread->messages, (void **)&msg, 1, NULL);
 	if (rc != 1) {
 		SPDK_ERRLOG("msg could not be enqueued\n");
 		spdk_mempool_put(g_spdk_msg_mempool, msg);
+		if (g_msg_channel_size != 0) {
+			__atomic_fetch_sub(&((struct spdk_thread *)thread)->msg_ring_pending, 1,
+					   __ATOMIC_RELEASE);
+		}
 		return -EIO;
 	}
 
@@ -2529,6 +2878,12 @@ struct spdk_io_channel_iter {
 
 	struct spdk_thread *orig_thread;
 	spdk_channel_for_each_cpl cpl;
+
+	/* Used by spdk_for_each_channel_parallel(). The iterator passed to cpl owns an
+	 * array of per-channel iterators, each of which points back to it. */
+	struct spdk_io_channel_iter *parent;
+	struct spdk_io_channel_iter *children;
+	uint32_t outstanding;
 };
 
 void *
@@ -2560,6 +2915,7 @@ _call_completion(void *ctx)
 	if (i->cpl != NULL) {
 		i->cpl(i, i->status);
 	}
+	free(i->children);
 	free(i);
 }
 
@@ -2647,6 +3003,98 @@ end:
 	assert(rc == 0);
 }
 
+void
+spdk_for_each_channel_parallel(void *io_device, spdk_channel_msg fn, void *ctx,
+			       spdk_channel_for_each_cpl cpl)
+{
+	struct spdk_thread *thread;
+	struct spdk_io_channel *ch;
+	struct spdk_io_channel_iter *i, *child;
+	uint32_t count = 0, idx;
+	int rc __attribute__((unused));
+
+	i = calloc(1, sizeof(*i));
+	if (!i) {
+		SPDK_ERRLOG("Unable to allocate iterator\n");
+		assert(false);
+		return;
+	}
+
+	i->io_device = io_device;
+	i->fn = fn;
+	i->ctx = ctx;
+	i->cpl = cpl;
+	i->orig_thread = _get_thread();
+
+	i->orig_thread->for_each_count++;
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	i->dev = io_device_get(io_device);
+	if (i->dev == NULL) {
+		SPDK_ERRLOG("could not find io_device %p\n", io_device);
+		assert(false);
+		i->status = -ENODEV;
+		goto end;
+	}
+
+	if (i->dev->pending_unregister) {
+		SPDK_ERRLOG("io_device %p has a pending unregister\n", io_device);
+		i->status = -ENODEV;
+		goto end;
+	}
+
+	TAILQ_FOREACH(thread, &g_threads, tailq) {
+		if (thread_get_io_channel(thread, i->dev) != NULL) {
+			count++;
+		}
+	}
+
+	if (count == 0) {
+		goto end;
+	}
+
+	i->children = calloc(count, sizeof(*i->children));
+	if (!i->children) {
+		SPDK_ERRLOG("Unable to allocate iterators\n");
+		i->status = -ENOMEM;
+		goto end;
+	}
+
+	idx = 0;
+	TAILQ_FOREACH(thread, &g_threads, tailq) {
+		ch = thread_get_io_channel(thread, i->dev);
+		if (ch != NULL) {
+			child = &i->children[idx++];
+			child->io_device = io_device;
+			child->dev = i->dev;
+			child->fn = fn;
+			child->ctx = ctx;
+			child->orig_thread = i->orig_thread;
+			child->cur_thread = thread;
+			child->ch = ch;
+			child->parent = i;
+		}
+	}
+
+	/* The whole operation holds a single reference, released by the last channel */
+	i->dev->for_each_count++;
+	i->outstanding = count;
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	for (idx = 0; idx < count; idx++) {
+		child = &i->children[idx];
+		rc = spdk_thread_send_msg(child->cur_thread, _call_channel, child);
+		assert(rc == 0);
+	}
+
+	return;
+end:
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	rc = spdk_thread_send_msg(i->orig_thread, _call_completion, i);
+	assert(rc == 0);
+}
+
 static void
 __pending_unregister(void *arg)
 {
@@ -2657,6 +3105,46 @@ __pending_unregister(void *arg)
 	spdk_io_device_unregister(dev->io_device, dev->unregister_cb);
 }
 
+static void
+for_each_channel_done(struct spdk_io_channel_iter *i)
+{
+	struct io_device *dev = i->dev;
+	int rc __attribute__((unused));
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	dev->for_each_count--;
+	i->ch = NULL;
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	rc = spdk_thread_send_msg(i->orig_thread, _call_completion, i);
+	assert(rc == 0);
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	if (dev->pending_unregister && dev->for_each_count == 0) {
+		rc = spdk_thread_send_msg(dev->unregister_thread, __pending_unregister, dev);
+		assert(rc == 0);
+	}
+	pthread_mutex_unlock(&g_devlist_mutex);
+}
+
+static void
+for_each_channel_parallel_continue(struct spdk_io_channel_iter *i, int status)
+{
+	struct spdk_io_channel_iter *parent = i->parent;
+	int expected = 0;
+
+	i->status = status;
+	if (status != 0) {
+		/* Report the first error, the other channels are already being visited */
+		__atomic_compare_exchange_n(&parent->status, &expected, status, false,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	}
+
+	if (__atomic_sub_fetch(&parent->outstanding, 1, __ATOMIC_ACQ_REL) == 0) {
+		for_each_channel_done(parent);
+	}
+}
+
 void
 spdk_for_each_channel_continue(struct spdk_io_channel_iter *i, int status)
 {
@@ -2667,6 +3155,11 @@ spdk_for_each_channel_continue(struct spdk_io_channel_iter *i, int status)
 
 	assert(i->cur_thread == spdk_get_thread());
 
+	if (i->parent != NULL) {
+		for_each_channel_parallel_continue(i, status);
+		return;
+	}
+
 	i->status = status;
 
 	pthread_mutex_lock(&g_devlist_mutex);
@@ -2690,19 +3183,9 @@ spdk_for_each_channel_continue(struct spdk_io_channel_iter *i, int status)
 	}
 
 end:
-	dev->for_each_count--;
-	i->ch = NULL;
 	pthread_mutex_unlock(&g_devlist_mutex);
 
-	rc = spdk_thread_send_msg(i->orig_thread, _call_completion, i);
-	assert(rc == 0);
-
-	pthread_mutex_lock(&g_devlist_mutex);
-	if (dev->pending_unregister && dev->for_each_count == 0) {
-		rc = spdk_thread_send_msg(dev->unregister_thread, __pending_unregister, dev);
-		assert(rc == 0);
-	}
-	pthread_mutex_unlock(&g_devlist_mutex);
+	for_each_channel_done(i);
 }
 
 static void
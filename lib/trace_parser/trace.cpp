@@ -13,27 +13,52 @@
 #include <exception>
 #include <map>
 #include <new>
+#include <queue>
+#include <vector>
+
+/*
+ * Entries of each lcore are already ordered by tsc, so instead of sorting all of them up front,
+ * they're merged on the fly.  This keeps the memory used by the parser independent of the size
+ * of the trace file.
+ */
+struct lcore_cursor {
+	lcore_cursor(spdk_trace_entry *_entries, uint64_t _num_entries, uint64_t _pos,
+		     uint64_t _remaining, uint16_t _lcore) :
+		entries(_entries), num_entries(_num_entries), pos(_pos), remaining(_remaining),
+		lcore(_lcore) {}
+	spdk_trace_entry	*entries;
+	/* Number of filled entries */
+	uint64_t		num_entries;
+	/* Index of the next entry to return */
+	uint64_t		pos;
+	/* Number of entries left, including the one at pos */
+	uint64_t		remaining;
+	uint16_t		lcore;
+};
 
 struct entry_key {
-	entry_key(uint16_t _lcore, uint64_t _tsc) : lcore(_lcore), tsc(_tsc) {}
+	entry_key(uint16_t _lcore, uint64_t _tsc, size_t _cursor) :
+		lcore(_lcore), tsc(_tsc), cursor(_cursor) {}
 	uint16_t lcore;
 	uint64_t tsc;
+	size_t cursor;
 };
 
 class compare_entry_key
 {
 public:
+	/* Inverted, so that the priority queue returns the oldest entry first */
 	bool operator()(const entry_key &first, const entry_key &second) const
 	{
 		if (first.tsc == second.tsc) {
-			return first.lcore < second.lcore;
+			return first.lcore > second.lcore;
 		} else {
-			return first.tsc < second.tsc;
+			return first.tsc > second.tsc;
 		}
 	}
 };
 
-typedef std::map<entry_key, spdk_trace_entry *, compare_entry_key> entry_map;
+typedef std::priority_queue<entry_key, std::vector<entry_key>, compare_entry_key> entry_queue;
 
 struct argument_context {
 	spdk_trace_entry	*entry;
@@ -76,6 +101,7 @@ private:
 	bool build_arg(argument_context *argctx, const spdk_trace_argument *arg, int argid,
 		       spdk_trace_parser_entry *pe);
 	void populate_events(spdk_trace_history *history, int num_entries, bool overflowed);
+	void queue_cursor(size_t idx);
 	bool init(const spdk_trace_parser_opts *opts);
 	void cleanup();
 
@@ -83,8 +109,8 @@ private:
 	size_t			_map_size;
 	int			_fd;
 	uint64_t		_tsc_offset;
-	entry_map		_entries;
-	entry_map::iterator	_iter;
+	std::vector<lcore_cursor>	_cursors;
+	entry_queue		_entries;
 	object_stats		_stats[SPDK_TRACE_MAX_OBJECT];
 };
 
@@ -165,12 +191,16 @@ spdk_trace_parser::next_entry(spdk_trace_parser_entry *pe)
 	object_stats *stats;
 	std::map<uint64_t, uint64_t>::iterator related_kv;
 
-	if (_iter == _entries.end()) {
+	if (_entries.empty()) {
 		return false;
 	}
 
-	pe->entry = entry = _iter->second;
-	pe->lcore = _iter->first.lcore;
+	const entry_key key = _entries.top();
+	lcore_cursor &cursor = _cursors[key.cursor];
+
+	_entries.pop();
+	pe->entry = entry = &cursor.entries[cursor.pos];
+	pe->lcore = cursor.lcore;
 	/* Set related index to the max value to indicate "empty" state */
 	pe->related_index = UINT64_MAX;
 	pe->related_type = OBJECT_NONE;
@@ -219,16 +249,39 @@ spdk_trace_parser::next_entry(spdk_trace_parser_entry *pe)
 		}
 	}
 
-	_iter++;
+	cursor.pos = cursor.pos + 1 == cursor.num_entries ? 0 : cursor.pos + 1;
+	cursor.remaining--;
+	queue_cursor(key.cursor);
+
 	return true;
 }
 
+void
+spdk_trace_parser::queue_cursor(size_t idx)
+{
+	lcore_cursor &cursor = _cursors[idx];
+	spdk_trace_entry *e;
+
+	while (cursor.remaining > 0) {
+		e = &cursor.entries[cursor.pos];
+		/* Skip argument buffers, they're consumed along with the entry they belong to */
+		if (e->tpoint_id != SPDK_TRACE_MAX_TPOINT_ID) {
+			_entries.push(entry_key(cursor.lcore, e->tsc, idx));
+			return;
+		}
+
+		cursor.pos = cursor.pos + 1 == cursor.num_entries ? 0 : cursor.pos + 1;
+		cursor.remaining--;
+	}
+}
+
 void
 spdk_trace_parser::populate_events(spdk_trace_history *history, int num_entries, bool overflowed)
 {
 	int i, num_entries_filled;
 	spdk_trace_entry *e;
 	int first, last, lcore;
+	uint64_t count;
 
 	lcore = history->lcore;
 	e = history->entries;
@@ -264,19 +317,9 @@ spdk_trace_parser::populate_events(spdk_trace_history *history, int num_entries,
 		_tsc_offset = e[first].tsc;
 	}
 
-	i = first;
-	while (1) {
-		if (e[i].tpoint_id != SPDK_TRACE_MAX_TPOINT_ID) {
-			_entries[entry_key(lcore, e[i].tsc)] = &e[i];
-		}
-		if (i == last) {
-			break;
-		}
-		i++;
-		if (i == num_entries_filled) {
-			i = 0;
-		}
-	}
+	count = last >= first ? last - first + 1 : num_entries_filled - first + last + 1;
+	_cursors.push_back(lcore_cursor(e, num_entries_filled, first, count, lcore));
+	queue_cursor(_cursors.size() - 1);
 }
 
 bool
@@ -381,7 +424,6 @@ spdk_trace_parser::init(const spdk_trace_parser_opts *opts)
 		}
 	}
 
-	_iter = _entries.begin();
 	return true;
 }
 
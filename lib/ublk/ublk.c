@@ -53,6 +53,7 @@ struct ublk_io;
 static void _ublk_submit_bdev_io(struct ublk_queue *q, struct ublk_io *io);
 static void ublk_dev_queue_fini(struct ublk_queue *q);
 static int ublk_poll(void *arg);
+static inline void ublksrv_queue_io_cmd(struct ublk_queue *q, struct ublk_io *io, unsigned tag);
 
 static int ublk_set_params(struct spdk_ublk_dev *ublk);
 static int ublk_start_dev(struct spdk_ublk_dev *ublk, bool is_recovering);
@@ -81,6 +82,8 @@ struct ublk_io {
 	void			*mpool_entry;
 	bool			need_data;
 	bool			user_copy;
+	/* Commit is queued right behind the user copy of read data, linked to it */
+	bool			linked_commit;
 	uint16_t		tag;
 	uint64_t		payload_size;
 	uint32_t		cmd_op;
@@ -149,6 +152,8 @@ struct ublk_poll_group {
 	struct spdk_poller		*ublk_poller;
 	struct spdk_iobuf_channel	iobuf_ch;
 	TAILQ_HEAD(, ublk_queue)	queue_list;
+	/* Number of queues assigned to this poll group, only accessed from app thread */
+	uint32_t			num_queues;
 };
 
 struct ublk_tgt {
@@ -169,6 +174,8 @@ struct ublk_tgt {
 	bool			user_copy;
 	/* `ublk_drv` supports UBLK_F_USER_RECOVERY */
 	bool			user_recovery;
+	/* `ublk_drv` supports UBLK_F_SUPPORT_ZERO_COPY */
+	bool			zero_copy;
 };
 
 static TAILQ_HEAD(, spdk_ublk_dev) g_ublk_devs = TAILQ_HEAD_INITIALIZER(g_ublk_devs);
@@ -569,13 +576,27 @@ ublk_ctrl_cmd_get_features(void)
 		g_ublk_tgt.user_copy = !!(g_ublk_tgt.features & UBLK_F_USER_COPY);
 		g_ublk_tgt.user_copy &= !g_disable_user_copy;
 		g_ublk_tgt.user_recovery = !!(g_ublk_tgt.features & UBLK_F_USER_RECOVERY);
+		g_ublk_tgt.zero_copy = !!(g_ublk_tgt.features & UBLK_F_SUPPORT_ZERO_COPY);
 		SPDK_NOTICELOG("User Copy %s\n", g_ublk_tgt.user_copy ? "enabled" : "disabled");
+		/* Zero copy only exposes request pages as io_uring fixed buffers, which bdev I/O
+		 * cannot address, so data keeps going through user copy or NEED_GET_DATA buffers.
+		 */
+		if (g_ublk_tgt.zero_copy) {
+			SPDK_INFOLOG(ublk, "Kernel supports zero copy, not usable with bdev I/O\n");
+		}
 	}
 	io_uring_cqe_seen(&g_ublk_tgt.ctrl_ring, cqe);
 
 	return 0;
 }
 
+/* With user copy, a read may have both its copy out and its commit SQE queued */
+static inline uint32_t
+ublk_queue_ring_depth(struct ublk_queue *q)
+{
+	return g_ublk_tgt.user_copy ? q->q_depth * 2 : q->q_depth;
+}
+
 static int
 ublk_queue_cmd_buf_sz(uint32_t q_depth)
 {
@@ -1154,14 +1175,25 @@ ublk_queue_user_copy(struct ublk_io *io, bool is_write)
 
 	if (is_write) {
 		io_uring_prep_read(sqe, 0, io->payload, nbytes, pos);
+		io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
 	} else {
 		io_uring_prep_write(sqe, 0, io->payload, nbytes, pos);
+		io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE | IOSQE_IO_LINK);
 	}
-	io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
 	io_uring_sqe_set_data64(sqe, build_user_data(io->tag, 0));
 
 	io->user_copy = true;
 	TAILQ_REMOVE(&q->inflight_io_list, io, tailq);
+
+	if (!is_write) {
+		/* Nothing is left to do for a read once its data is copied out, so
+		 * queue the commit right behind the copy instead of waiting for the
+		 * copy completion first. The kernel only runs it if the copy succeeds.
+		 */
+		ublk_mark_io_done(io, io->result);
+		ublksrv_queue_io_cmd(q, io, io->tag);
+		io->linked_commit = true;
+	}
 	TAILQ_INSERT_TAIL(&q->completed_io_list, io, tailq);
 }
 
@@ -1402,6 +1434,9 @@ ublk_io_xmit(struct ublk_queue *q)
 				TAILQ_INSERT_TAIL(&buffer_free_list, io, tailq);
 			}
 			ublksrv_queue_io_cmd(q, io, io->tag);
+		} else if (io->linked_commit) {
+			/* Commit SQE was queued along with the copy */
+			count++;
 		}
 		count++;
 	}
@@ -1466,7 +1501,12 @@ ublk_io_recv(struct ublk_queue *q)
 		q->cmd_inflight--;
 		TAILQ_INSERT_TAIL(&q->inflight_io_list, io, tailq);
 
-		if (!io->user_copy) {
+		if (spdk_unlikely(!io->user_copy && io->linked_commit && cqe->res == -ECANCELED)) {
+			/* Copy out failed, so the commit linked to it was never issued */
+			io->linked_commit = false;
+			ublk_io_done(NULL, false, io);
+		} else if (!io->user_copy) {
+			io->linked_commit = false;
 			fetch = (cqe->res != UBLK_IO_RES_ABORT) && !q->is_stopping;
 			if (!fetch) {
 				q->is_stopping = true;
@@ -1493,7 +1533,13 @@ ublk_io_recv(struct ublk_queue *q)
 
 			assert((ublksrv_get_op(io->iod) == UBLK_IO_OP_READ) ||
 			       (ublksrv_get_op(io->iod) == UBLK_IO_OP_WRITE));
-			if (cqe->res != io->result) {
+			if (io->linked_commit) {
+				/* Commit is already in flight, or gets cancelled if the copy
+				 * failed. Either way the read buffer is not needed anymore.
+				 */
+				TAILQ_REMOVE(&q->inflight_io_list, io, tailq);
+				ublk_io_put_buffer(io, iobuf_ch);
+			} else if (cqe->res != io->result) {
 				/* EIO */
 				ublk_io_done(NULL, false, io);
 			} else {
@@ -1599,7 +1645,7 @@ ublk_dev_queue_init(struct ublk_queue *q)
 		q->ios[j].iod = &q->io_cmd_buf[j];
 	}
 
-	rc = ublk_setup_ring(q->q_depth, &q->ring, IORING_SETUP_SQE128);
+	rc = ublk_setup_ring(ublk_queue_ring_depth(q), &q->ring, IORING_SETUP_SQE128);
 	if (rc < 0) {
 		SPDK_ERRLOG("Failed at setup uring: %s\n", spdk_strerror(-rc));
 		munmap(q->io_cmd_buf, ublk_queue_cmd_buf_sz(q->q_depth));
@@ -1617,7 +1663,7 @@ ublk_dev_queue_init(struct ublk_queue *q)
 		return rc;
 	}
 
-	ublk_dev_init_io_cmds(&q->ring, q->q_depth);
+	ublk_dev_init_io_cmds(&q->ring, ublk_queue_ring_depth(q));
 
 	return 0;
 }
@@ -1799,6 +1845,8 @@ ublk_free_dev(struct spdk_ublk_dev *ublk)
 		 * back to this function to continue.
 		 */
 		if (q->poll_group) {
+			assert(q->poll_group->num_queues > 0);
+			q->poll_group->num_queues--;
 			spdk_thread_send_msg(q->poll_group->ublk_thread, free_buffers, q);
 			return;
 		} else {
@@ -1976,6 +2024,33 @@ ublk_start_disk(const char *bdev_name, uint32_t ublk_id,
 	return rc;
 }
 
+/*
+ * Pick the poll group serving the fewest queues.  The scan starts right after
+ * the previously picked one, so poll groups with equal load still take turns.
+ */
+static struct ublk_poll_group *
+ublk_get_poll_group(void)
+{
+	struct ublk_poll_group *poll_group, *least_loaded = NULL;
+	uint32_t i, idx;
+
+	assert(spdk_thread_is_app_thread(NULL));
+
+	for (i = 0; i < g_num_ublk_poll_groups; i++) {
+		idx = (g_next_ublk_poll_group + i) % g_num_ublk_poll_groups;
+		poll_group = &g_ublk_tgt.poll_groups[idx];
+		if (least_loaded == NULL || poll_group->num_queues < least_loaded->num_queues) {
+			least_loaded = poll_group;
+		}
+	}
+
+	assert(least_loaded != NULL);
+	g_next_ublk_poll_group = (least_loaded - g_ublk_tgt.poll_groups + 1) % g_num_ublk_poll_groups;
+	least_loaded->num_queues++;
+
+	return least_loaded;
+}
+
 static int
 ublk_start_dev(struct spdk_ublk_dev *ublk, bool is_recovering)
 {
@@ -2010,13 +2085,9 @@ ublk_start_dev(struct spdk_ublk_dev *ublk, bool is_recovering)
 
 	/* Send queue to different spdk_threads for load balance */
 	for (q_id = 0; q_id < ublk->num_queues; q_id++) {
-		ublk->queues[q_id].poll_group = &g_ublk_tgt.poll_groups[g_next_ublk_poll_group];
-		ublk_thread = g_ublk_tgt.poll_groups[g_next_ublk_poll_group].ublk_thread;
+		ublk->queues[q_id].poll_group = ublk_get_poll_group();
+		ublk_thread = ublk->queues[q_id].poll_group->ublk_thread;
 		spdk_thread_send_msg(ublk_thread, ublk_queue_run, &ublk->queues[q_id]);
-		g_next_ublk_poll_group++;
-		if (g_next_ublk_poll_group == g_num_ublk_poll_groups) {
-			g_next_ublk_poll_group = 0;
-		}
 	}
 
 	return 0;
@@ -319,6 +319,30 @@ vhost_inflight_queue_get_desc(struct spdk_vhost_session *vsession,
 	return 0;
 }
 
+/*
+ * Publish used ring entries that were enqueued without updating used->idx.
+ * Without inflight tracking the driver only needs to see the entries before
+ * it is signalled or polls again, so used->idx is written once per batch.
+ */
+static inline void
+vhost_vq_used_ring_flush(struct spdk_vhost_session *vsession,
+			 struct spdk_vhost_virtqueue *virtqueue)
+{
+	struct vring_used *used = virtqueue->vring.used;
+
+	if (virtqueue->packed.packed_ring || used == NULL ||
+	    used->idx == virtqueue->last_used_idx) {
+		return;
+	}
+
+	/* Ensure the used ring entries are updated before we increment used->idx. */
+	spdk_smp_wmb();
+
+	* (volatile uint16_t *) &used->idx = virtqueue->last_used_idx;
+	vhost_log_used_vring_idx(vsession, virtqueue);
+	virtqueue->stats.used_idx_updates++;
+}
+
 int
 vhost_vq_used_signal(struct spdk_vhost_session *vsession,
 		     struct spdk_vhost_virtqueue *virtqueue)
@@ -327,6 +351,8 @@ vhost_vq_used_signal(struct spdk_vhost_session *vsession,
 		return 0;
 	}
 
+	vhost_vq_used_ring_flush(vsession, virtqueue);
+
 	SPDK_DEBUGLOG(vhost_ring,
 		      "Queue %td - USED RING: sending IRQ: last used %"PRIu16"\n",
 		      virtqueue - vsession->virtqueue, virtqueue->last_used_idx);
@@ -337,8 +363,9 @@ vhost_vq_used_signal(struct spdk_vhost_session *vsession,
 	if (rte_vhost_vring_call_nonblock(vsession->vid, virtqueue->vring_idx) == 0) {
 #endif
 		/* interrupt signalled */
-		virtqueue->req_cnt += virtqueue->used_req_cnt;
 		virtqueue->used_req_cnt = 0;
+		virtqueue->held_req_cnt = 0;
+		virtqueue->stats.irqs++;
 		return 1;
 	} else {
 		/* interrupt not signalled */
@@ -352,30 +379,35 @@ session_vq_io_stats_update(struct spdk_vhost_session *vsession,
 {
 	uint32_t irq_delay_base = vsession->coalescing_delay_time_base;
 	uint32_t io_threshold = vsession->coalescing_io_rate_threshold;
-	int32_t irq_delay;
 	uint32_t req_cnt;
 
-	req_cnt = virtqueue->req_cnt + virtqueue->used_req_cnt;
+	req_cnt = virtqueue->req_cnt;
+	virtqueue->req_cnt = 0;
+
 	if (req_cnt <= io_threshold) {
+		/* Load dropped below the threshold, stop delaying events. */
+		if (virtqueue->irq_delay_time != 0) {
+			virtqueue->irq_delay_time = 0;
+			virtqueue->next_event_time = now;
+		}
 		return;
 	}
 
-	irq_delay = (irq_delay_base * (req_cnt - io_threshold)) / io_threshold;
-	virtqueue->irq_delay_time = (uint32_t) spdk_max(0, irq_delay);
-
-	virtqueue->req_cnt = 0;
-	virtqueue->next_event_time = now;
+	virtqueue->irq_delay_time = spdk_min((uint64_t)irq_delay_base * (req_cnt - io_threshold) /
+					     io_threshold, UINT32_MAX);
+	virtqueue->next_event_time = spdk_min(virtqueue->next_event_time,
+					      now + virtqueue->irq_delay_time);
 }
 
 static void
 check_session_vq_io_stats(struct spdk_vhost_session *vsession,
 			  struct spdk_vhost_virtqueue *virtqueue, uint64_t now)
 {
-	if (now < vsession->next_stats_check_time) {
+	if (now < virtqueue->next_stats_check_time) {
 		return;
 	}
 
-	vsession->next_stats_check_time = now + vsession->stats_check_interval;
+	virtqueue->next_stats_check_time = now + vsession->stats_check_interval;
 	session_vq_io_stats_update(vsession, virtqueue, now);
 }
 
@@ -397,18 +429,43 @@ vhost_vq_event_is_suppressed(struct spdk_vhost_virtqueue *vq)
 	return false;
 }
 
+/*
+ * Returns true if completions arrived since the last signal that was not sent, so that a
+ * pending signal is counted once rather than on every poll until it goes out.
+ */
+static inline bool
+vhost_vq_signal_held(struct spdk_vhost_virtqueue *vq)
+{
+	if (vq->held_req_cnt == vq->used_req_cnt) {
+		return false;
+	}
+
+	vq->held_req_cnt = vq->used_req_cnt;
+	return true;
+}
+
 void
 vhost_session_vq_used_signal(struct spdk_vhost_virtqueue *virtqueue)
 {
 	struct spdk_vhost_session *vsession = virtqueue->vsession;
 	uint64_t now;
 
+	if (virtqueue->vring.desc == NULL) {
+		return;
+	}
+
+	/* A driver polling with events disabled still has to see completions. */
+	vhost_vq_used_ring_flush(vsession, virtqueue);
+
 	if (vsession->coalescing_delay_time_base == 0) {
-		if (virtqueue->vring.desc == NULL) {
+		if (virtqueue->used_req_cnt == 0) {
 			return;
 		}
 
 		if (vhost_vq_event_is_suppressed(virtqueue)) {
+			if (vhost_vq_signal_held(virtqueue)) {
+				virtqueue->stats.irqs_suppressed++;
+			}
 			return;
 		}
 
@@ -417,12 +474,24 @@ vhost_session_vq_used_signal(struct spdk_vhost_virtqueue *virtqueue)
 		now = spdk_get_ticks();
 		check_session_vq_io_stats(vsession, virtqueue, now);
 
-		/* No need for event right now */
-		if (now < virtqueue->next_event_time) {
+		if (virtqueue->used_req_cnt == 0) {
+			return;
+		}
+
+		/* No need for event right now, unless enough completions piled up. */
+		if (now < virtqueue->next_event_time &&
+		    (vsession->coalescing_max_reqs == 0 ||
+		     virtqueue->used_req_cnt < vsession->coalescing_max_reqs)) {
+			if (vhost_vq_signal_held(virtqueue)) {
+				virtqueue->stats.irqs_coalesced++;
+			}
 			return;
 		}
 
 		if (vhost_vq_event_is_suppressed(virtqueue)) {
+			if (vhost_vq_signal_held(virtqueue)) {
+				virtqueue->stats.irqs_suppressed++;
+			}
 			return;
 		}
 
@@ -459,21 +528,36 @@ vhost_vq_used_ring_enqueue(struct spdk_vhost_session *vsession,
 	used->ring[last_idx].id = id;
 	used->ring[last_idx].len = len;
 
-	/* Ensure the used ring is updated before we log it or increment used->idx. */
-	spdk_smp_wmb();
+	virtqueue->req_cnt++;
+	virtqueue->used_req_cnt++;
+	virtqueue->stats.completed_reqs++;
 
-	rte_vhost_set_last_inflight_io_split(vsession->vid, vq_idx, id);
+	if (virtqueue->vring_inflight.inflight_split == NULL) {
+		/* No inflight region to keep consistent with used->idx, so the
+		 * index update is deferred to vhost_vq_used_ring_flush().
+		 */
+		vhost_log_used_vring_elem(vsession, virtqueue, last_idx);
+	} else {
+		/* Ensure the used ring is updated before we log it or increment used->idx. */
+		spdk_smp_wmb();
 
-	vhost_log_used_vring_elem(vsession, virtqueue, last_idx);
-	* (volatile uint16_t *) &used->idx = virtqueue->last_used_idx;
-	vhost_log_used_vring_idx(vsession, virtqueue);
+		rte_vhost_set_last_inflight_io_split(vsession->vid, vq_idx, id);
 
-	rte_vhost_clr_inflight_desc_split(vsession->vid, vq_idx, virtqueue->last_used_idx, id);
+		vhost_log_used_vring_elem(vsession, virtqueue, last_idx);
+		* (volatile uint16_t *) &used->idx = virtqueue->last_used_idx;
+		vhost_log_used_vring_idx(vsession, virtqueue);
+		virtqueue->stats.used_idx_updates++;
 
-	virtqueue->used_req_cnt++;
+		rte_vhost_clr_inflight_desc_split(vsession->vid, vq_idx, virtqueue->last_used_idx, id);
+	}
 
 	if (spdk_unlikely(spdk_interrupt_mode_is_enabled())) {
-		if (virtqueue->vring.desc == NULL || vhost_vq_event_is_suppressed(virtqueue)) {
+		if (virtqueue->vring.desc == NULL) {
+			return;
+		}
+
+		vhost_vq_used_ring_flush(vsession, virtqueue);
+		if (vhost_vq_event_is_suppressed(virtqueue)) {
 			return;
 		}
 
@@ -546,7 +630,9 @@ vhost_vq_packed_ring_enqueue(struct spdk_vhost_session *vsession,
 		virtqueue->packed.used_phase = !virtqueue->packed.used_phase;
 	}
 
+	virtqueue->req_cnt++;
 	virtqueue->used_req_cnt++;
+	virtqueue->stats.completed_reqs++;
 }
 
 bool
@@ -868,6 +954,8 @@ _stop_session(struct spdk_vhost_session *vsession)
 					    ((uint16_t)q->packed.avail_phase << 15);
 			q->last_used_idx = q->last_used_idx |
 					   ((uint16_t)q->packed.used_phase << 15);
+		} else {
+			vhost_vq_used_ring_flush(vsession, q);
 		}
 
 		rte_vhost_set_vring_base(vsession->vid, i, q->last_avail_idx, q->last_used_idx);
@@ -956,7 +1044,6 @@ new_connection(int vid)
 
 	vsession->started = false;
 	vsession->starting = false;
-	vsession->next_stats_check_time = 0;
 	vsession->stats_check_interval = SPDK_VHOST_STATS_CHECK_INTERVAL_MS *
 					 spdk_get_ticks_hz() / 1000UL;
 	TAILQ_INSERT_TAIL(&user_dev->vsessions, vsession, tailq);
@@ -1677,7 +1764,7 @@ vhost_get_negotiated_features(int vid, uint64_t *negotiated_features)
 
 int
 vhost_user_dev_set_coalescing(struct spdk_vhost_user_dev *user_dev, uint32_t delay_base_us,
-			      uint32_t iops_threshold)
+			      uint32_t iops_threshold, uint32_t max_coalesced_reqs)
 {
 	uint64_t delay_time_base = delay_base_us * spdk_get_ticks_hz() / 1000000ULL;
 	uint32_t io_rate = iops_threshold * SPDK_VHOST_STATS_CHECK_INTERVAL_MS / 1000U;
@@ -1693,6 +1780,7 @@ vhost_user_dev_set_coalescing(struct spdk_vhost_user_dev *user_dev, uint32_t del
 
 	user_dev->coalescing_delay_us = delay_base_us;
 	user_dev->coalescing_iops_threshold = iops_threshold;
+	user_dev->coalescing_max_reqs = max_coalesced_reqs;
 	return 0;
 }
 
@@ -1704,16 +1792,18 @@ vhost_user_session_set_coalescing(struct spdk_vhost_dev *vdev,
 		to_user_dev(vdev)->coalescing_delay_us * spdk_get_ticks_hz() / 1000000ULL;
 	vsession->coalescing_io_rate_threshold =
 		to_user_dev(vdev)->coalescing_iops_threshold * SPDK_VHOST_STATS_CHECK_INTERVAL_MS / 1000U;
+	vsession->coalescing_max_reqs = to_user_dev(vdev)->coalescing_max_reqs;
 	return 0;
 }
 
 int
 vhost_user_set_coalescing(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
-			  uint32_t iops_threshold)
+			  uint32_t iops_threshold, uint32_t max_coalesced_reqs)
 {
 	int rc;
 
-	rc = vhost_user_dev_set_coalescing(to_user_dev(vdev), delay_base_us, iops_threshold);
+	rc = vhost_user_dev_set_coalescing(to_user_dev(vdev), delay_base_us, iops_threshold,
+					   max_coalesced_reqs);
 	if (rc != 0) {
 		return rc;
 	}
@@ -1725,7 +1815,7 @@ vhost_user_set_coalescing(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
 
 void
 vhost_user_get_coalescing(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
-			  uint32_t *iops_threshold)
+			  uint32_t *iops_threshold, uint32_t *max_coalesced_reqs)
 {
 	struct spdk_vhost_user_dev *user_dev = to_user_dev(vdev);
 
@@ -1736,6 +1826,10 @@ vhost_user_get_coalescing(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
 	if (iops_threshold) {
 		*iops_threshold = user_dev->coalescing_iops_threshold;
 	}
+
+	if (max_coalesced_reqs) {
+		*max_coalesced_reqs = user_dev->coalescing_max_reqs;
+	}
 }
 
 int
@@ -1810,7 +1904,7 @@ vhost_user_dev_init(struct spdk_vhost_dev *vdev, const char *name,
 	pthread_mutex_init(&user_dev->lock, NULL);
 
 	vhost_user_dev_set_coalescing(user_dev, SPDK_VHOST_COALESCING_DELAY_BASE_US,
-				      SPDK_VHOST_VQ_IOPS_COALESCING_THRESHOLD);
+				      SPDK_VHOST_VQ_IOPS_COALESCING_THRESHOLD, 0);
 
 	return 0;
 }
@@ -1997,6 +2091,33 @@ vhost_user_fini(spdk_vhost_fini_cb vhost_cb)
 	pthread_detach(tid);
 }
 
+static void
+vhost_session_vq_info_json(struct spdk_vhost_session *vsession, struct spdk_json_write_ctx *w)
+{
+	struct spdk_vhost_virtqueue *q;
+	uint16_t i;
+
+	spdk_json_write_named_array_begin(w, "virtqueues");
+	for (i = 0; i < vsession->max_queues; i++) {
+		q = &vsession->virtqueue[i];
+		if (q->vring.desc == NULL) {
+			continue;
+		}
+
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_uint32(w, "id", i);
+		spdk_json_write_named_uint64(w, "irq_delay_us",
+					     (uint64_t)q->irq_delay_time * SPDK_SEC_TO_USEC / spdk_get_ticks_hz());
+		spdk_json_write_named_uint64(w, "completed_reqs", q->stats.completed_reqs);
+		spdk_json_write_named_uint64(w, "irqs", q->stats.irqs);
+		spdk_json_write_named_uint64(w, "irqs_coalesced", q->stats.irqs_coalesced);
+		spdk_json_write_named_uint64(w, "irqs_suppressed", q->stats.irqs_suppressed);
+		spdk_json_write_named_uint64(w, "used_idx_updates", q->stats.used_idx_updates);
+		spdk_json_write_object_end(w);
+	}
+	spdk_json_write_array_end(w);
+}
+
 void
 vhost_session_info_json(struct spdk_vhost_dev *vdev, struct spdk_json_write_ctx *w)
 {
@@ -2013,6 +2134,7 @@ vhost_session_info_json(struct spdk_vhost_dev *vdev, struct spdk_json_write_ctx
 		spdk_json_write_named_bool(w, "started", vsession->started);
 		spdk_json_write_named_uint32(w, "max_queues", vsession->max_queues);
 		spdk_json_write_named_uint32(w, "inflight_task_cnt", vsession->task_cnt);
+		vhost_session_vq_info_json(vsession, w);
 		spdk_json_write_object_end(w);
 	}
 	pthread_mutex_unlock(&user_dev->lock);
@@ -55,7 +55,7 @@ spdk_vhost_dev_find(const char *ctrlr_name)
 	return RB_FIND(vhost_dev_name_tree, &g_vhost_devices, &find);
 }
 
-static int
+int
 vhost_parse_core_mask(const char *mask, struct spdk_cpuset *cpumask)
 {
 	int rc;
@@ -226,20 +226,37 @@ spdk_vhost_dev_remove(struct spdk_vhost_dev *vdev)
 	return vdev->backend->remove_device(vdev);
 }
 
+int
+spdk_vhost_set_coalescing_ext(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
+			      uint32_t iops_threshold, uint32_t max_coalesced_reqs)
+{
+	assert(vdev->backend->set_coalescing != NULL);
+	return vdev->backend->set_coalescing(vdev, delay_base_us, iops_threshold, max_coalesced_reqs);
+}
+
 int
 spdk_vhost_set_coalescing(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
 			  uint32_t iops_threshold)
 {
-	assert(vdev->backend->set_coalescing != NULL);
-	return vdev->backend->set_coalescing(vdev, delay_base_us, iops_threshold);
+	uint32_t max_coalesced_reqs;
+
+	spdk_vhost_get_coalescing_ext(vdev, NULL, NULL, &max_coalesced_reqs);
+	return spdk_vhost_set_coalescing_ext(vdev, delay_base_us, iops_threshold, max_coalesced_reqs);
+}
+
+void
+spdk_vhost_get_coalescing_ext(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
+			      uint32_t *iops_threshold, uint32_t *max_coalesced_reqs)
+{
+	assert(vdev->backend->get_coalescing != NULL);
+	vdev->backend->get_coalescing(vdev, delay_base_us, iops_threshold, max_coalesced_reqs);
 }
 
 void
 spdk_vhost_get_coalescing(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
 			  uint32_t *iops_threshold)
 {
-	assert(vdev->backend->get_coalescing != NULL);
-	vdev->backend->get_coalescing(vdev, delay_base_us, iops_threshold);
+	spdk_vhost_get_coalescing_ext(vdev, delay_base_us, iops_threshold, NULL);
 }
 
 void
@@ -353,10 +370,11 @@ vhost_user_config_json(struct spdk_vhost_dev *vdev, struct spdk_json_write_ctx *
 {
 	uint32_t delay_base_us;
 	uint32_t iops_threshold;
+	uint32_t max_coalesced_reqs;
 
 	vdev->backend->write_config_json(vdev, w);
 
-	spdk_vhost_get_coalescing(vdev, &delay_base_us, &iops_threshold);
+	spdk_vhost_get_coalescing_ext(vdev, &delay_base_us, &iops_threshold, &max_coalesced_reqs);
 	if (delay_base_us) {
 		spdk_json_write_object_begin(w);
 		spdk_json_write_named_string(w, "method", "vhost_controller_set_coalescing");
@@ -365,6 +383,9 @@ vhost_user_config_json(struct spdk_vhost_dev *vdev, struct spdk_json_write_ctx *
 		spdk_json_write_named_string(w, "ctrlr", vdev->name);
 		spdk_json_write_named_uint32(w, "delay_base_us", delay_base_us);
 		spdk_json_write_named_uint32(w, "iops_threshold", iops_threshold);
+		if (max_coalesced_reqs) {
+			spdk_json_write_named_uint32(w, "max_coalesced_reqs", max_coalesced_reqs);
+		}
 		spdk_json_write_object_end(w);
 
 		spdk_json_write_object_end(w);
@@ -41,6 +41,8 @@ struct spdk_vhost_user_blk_task {
 	struct spdk_vhost_blk_task blk_task;
 	struct spdk_vhost_blk_session *bvsession;
 	struct spdk_vhost_virtqueue *vq;
+	/* Queue group polling the virtqueue, NULL if the session thread does */
+	struct vhost_blk_queue_group *group;
 
 	uint16_t req_idx;
 	uint16_t num_descs;
@@ -58,6 +60,31 @@ struct spdk_vhost_blk_dev {
 	const struct spdk_virtio_blk_transport_ops *ops;
 
 	bool readonly;
+
+	/* Threads the virtqueues are spread across, one per core of queue_cpumask */
+	struct spdk_cpuset queue_cpumask;
+	struct spdk_thread **queue_threads;
+	uint32_t num_queue_threads;
+};
+
+/* Virtqueues of a session polled by one of the controller's queue threads. */
+struct vhost_blk_queue_group {
+	struct spdk_vhost_blk_session *bvsession;
+	struct spdk_thread *thread;
+	struct spdk_poller *poller;
+	struct spdk_poller *stop_poller;
+	struct spdk_io_channel *io_channel;
+
+	/* The group polls every num_groups-th virtqueue starting at this one. */
+	uint16_t first_vq;
+
+	/* Requests in flight on the virtqueues of this group. */
+	int task_cnt;
+
+	bool bdev_removed;
+	/* Set on the session thread once the stop message was sent to the group's thread */
+	bool stop_sent;
+	bool stopped;
 };
 
 struct spdk_vhost_blk_session {
@@ -67,6 +94,14 @@ struct spdk_vhost_blk_session {
 	struct spdk_poller *requestq_poller;
 	struct spdk_io_channel *io_channel;
 	struct spdk_poller *stop_poller;
+
+	struct vhost_blk_queue_group *groups;
+	uint16_t num_groups;
+
+	/* Task pools of the virtqueues of a failed start, freed along with the groups once they
+	 * stopped.  Allocated with the groups. */
+	void **stale_tasks;
+	uint16_t num_stale_tasks;
 };
 
 /* forward declaration */
@@ -80,8 +115,11 @@ vhost_user_process_blk_request(struct spdk_vhost_user_blk_task *user_task)
 {
 	struct spdk_vhost_blk_session *bvsession = user_task->bvsession;
 	struct spdk_vhost_dev *vdev = &bvsession->bvdev->vdev;
+	struct spdk_io_channel *ch;
 
-	return virtio_blk_process_request(vdev, bvsession->io_channel, &user_task->blk_task,
+	ch = user_task->group ? user_task->group->io_channel : bvsession->io_channel;
+
+	return virtio_blk_process_request(vdev, ch, &user_task->blk_task,
 					  vhost_user_blk_request_finish, NULL);
 }
 
@@ -120,14 +158,23 @@ to_blk_session(struct spdk_vhost_session *vsession)
 static inline void
 blk_task_inc_task_cnt(struct spdk_vhost_user_blk_task *task)
 {
-	task->bvsession->vsession.task_cnt++;
+	if (task->group) {
+		task->group->task_cnt++;
+	} else {
+		task->bvsession->vsession.task_cnt++;
+	}
 }
 
 static inline void
 blk_task_dec_task_cnt(struct spdk_vhost_user_blk_task *task)
 {
-	assert(task->bvsession->vsession.task_cnt > 0);
-	task->bvsession->vsession.task_cnt--;
+	if (task->group) {
+		assert(task->group->task_cnt > 0);
+		task->group->task_cnt--;
+	} else {
+		assert(task->bvsession->vsession.task_cnt > 0);
+		task->bvsession->vsession.task_cnt--;
+	}
 }
 
 static void
@@ -1065,6 +1112,42 @@ no_bdev_vdev_worker(void *arg)
 	return SPDK_POLLER_BUSY;
 }
 
+static int
+vdev_queue_group_worker(void *arg)
+{
+	struct vhost_blk_queue_group *group = arg;
+	struct spdk_vhost_blk_session *bvsession = group->bvsession;
+	struct spdk_vhost_session *vsession = &bvsession->vsession;
+	uint16_t q_idx;
+	int rc = 0;
+
+	for (q_idx = group->first_vq; q_idx < vsession->max_queues; q_idx += bvsession->num_groups) {
+		rc += _vdev_vq_worker(&vsession->virtqueue[q_idx]);
+	}
+
+	return rc > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static int
+no_bdev_queue_group_worker(void *arg)
+{
+	struct vhost_blk_queue_group *group = arg;
+	struct spdk_vhost_blk_session *bvsession = group->bvsession;
+	struct spdk_vhost_session *vsession = &bvsession->vsession;
+	uint16_t q_idx;
+
+	for (q_idx = group->first_vq; q_idx < vsession->max_queues; q_idx += bvsession->num_groups) {
+		_no_bdev_vdev_vq_worker(&vsession->virtqueue[q_idx]);
+	}
+
+	if (group->task_cnt == 0 && group->io_channel) {
+		vhost_blk_put_io_channel(group->io_channel);
+		group->io_channel = NULL;
+	}
+
+	return SPDK_POLLER_BUSY;
+}
+
 static void
 vhost_blk_session_unregister_interrupts(struct spdk_vhost_blk_session *bvsession)
 {
@@ -1218,12 +1301,140 @@ vhost_user_session_bdev_remove_cb(struct spdk_vhost_dev *vdev,
 	return 0;
 }
 
+struct vhost_blk_remove_ctx {
+	struct spdk_vhost_blk_dev *bvdev;
+	bdev_event_cb_complete cb;
+	void *cb_arg;
+	uint32_t thread_idx;
+	struct spdk_poller *retry_poller;
+};
+
+static void vhost_user_bdev_remove_queue_thread(void *arg);
+
+static int
+vhost_user_bdev_remove_retry(void *arg)
+{
+	struct vhost_blk_remove_ctx *ctx = arg;
+	struct spdk_vhost_blk_dev *bvdev = ctx->bvdev;
+	struct spdk_poller *poller = ctx->retry_poller;
+	int rc;
+
+	rc = spdk_thread_send_msg(bvdev->queue_threads[ctx->thread_idx],
+				  vhost_user_bdev_remove_queue_thread, ctx);
+	if (rc != 0) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	/* ctx belongs to the next thread now */
+	spdk_poller_unregister(&poller);
+	return SPDK_POLLER_BUSY;
+}
+
+/* Pass the hot-remove on to the queue thread at ctx->thread_idx.  The bdev mustn't be
+ * closed before all queue threads stopped submitting to it, so a message that can't be
+ * sent is retried rather than skipping the thread.
+ */
+static int
+vhost_user_bdev_remove_send(struct vhost_blk_remove_ctx *ctx)
+{
+	struct spdk_vhost_blk_dev *bvdev = ctx->bvdev;
+	int rc;
+
+	rc = spdk_thread_send_msg(bvdev->queue_threads[ctx->thread_idx],
+				  vhost_user_bdev_remove_queue_thread, ctx);
+	if (rc == 0) {
+		return 0;
+	}
+
+	SPDK_ERRLOG("%s: failed to reach queue thread %"PRIu32" for hot-remove, will retry: %s\n",
+		    bvdev->vdev.name, ctx->thread_idx, spdk_strerror(-rc));
+	ctx->retry_poller = SPDK_POLLER_REGISTER(vhost_user_bdev_remove_retry, ctx,
+			    SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+	if (ctx->retry_poller == NULL) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void
+vhost_user_bdev_remove_queue_thread(void *arg)
+{
+	struct vhost_blk_remove_ctx *ctx = arg;
+	struct spdk_vhost_blk_dev *bvdev = ctx->bvdev;
+	struct spdk_vhost_user_dev *user_dev = to_user_dev(&bvdev->vdev);
+	struct spdk_thread *thread = spdk_get_thread();
+	struct spdk_vhost_session *vsession;
+	struct spdk_vhost_blk_session *bvsession;
+	struct vhost_blk_queue_group *group;
+	uint16_t i;
+
+	/* Don't block the queue thread on the lock, try again later instead. */
+	if (pthread_mutex_trylock(&user_dev->lock) != 0) {
+		spdk_thread_send_msg(thread, vhost_user_bdev_remove_queue_thread, arg);
+		return;
+	}
+
+	/* Stop submitting to the bdev from the groups on this thread. */
+	TAILQ_FOREACH(vsession, &user_dev->vsessions, tailq) {
+		bvsession = to_blk_session(vsession);
+		for (i = 0; i < bvsession->num_groups; i++) {
+			group = &bvsession->groups[i];
+			if (group->thread != thread || group->bdev_removed) {
+				continue;
+			}
+
+			group->bdev_removed = true;
+			if (group->poller) {
+				spdk_poller_unregister(&group->poller);
+				group->poller = SPDK_POLLER_REGISTER(no_bdev_queue_group_worker, group, 0);
+			}
+		}
+	}
+	pthread_mutex_unlock(&user_dev->lock);
+
+	if (++ctx->thread_idx < bvdev->num_queue_threads) {
+		if (vhost_user_bdev_remove_send(ctx) == 0) {
+			return;
+		}
+
+		/* Nothing can reach the remaining threads, don't hang the hot-remove forever. */
+		SPDK_ERRLOG("%s: failed to retry hot-remove, completing it without queue thread "
+			    "%"PRIu32"\n", bvdev->vdev.name, ctx->thread_idx);
+	}
+
+	vhost_user_dev_foreach_session(&bvdev->vdev, vhost_user_session_bdev_remove_cb,
+				       ctx->cb, ctx->cb_arg);
+	free(ctx);
+}
+
 static void
 vhost_user_bdev_remove_cb(struct spdk_vhost_dev *vdev, bdev_event_cb_complete cb, void *cb_arg)
 {
+	struct spdk_vhost_blk_dev *bvdev = to_blk_dev(vdev);
+	struct vhost_blk_remove_ctx *ctx;
+
 	SPDK_WARNLOG("%s: hot-removing bdev - all further requests will fail.\n",
 		     vdev->name);
 
+	assert(bvdev != NULL);
+	if (bvdev->num_queue_threads > 0) {
+		/* The bdev can only be closed once none of the queue threads submit to it. */
+		ctx = calloc(1, sizeof(*ctx));
+		if (ctx != NULL) {
+			ctx->bvdev = bvdev;
+			ctx->cb = cb;
+			ctx->cb_arg = cb_arg;
+			if (vhost_user_bdev_remove_send(ctx) == 0) {
+				return;
+			}
+
+			free(ctx);
+		}
+
+		SPDK_ERRLOG("%s: failed to start hot-remove on the queue threads\n", vdev->name);
+	}
+
 	vhost_user_dev_foreach_session(vdev, vhost_user_session_bdev_remove_cb,
 				       cb, cb_arg);
 }
@@ -1331,6 +1542,201 @@ alloc_vq_task_pool(struct spdk_vhost_session *vsession, uint16_t qid)
 	return 0;
 }
 
+static void
+vhost_blk_queue_group_start(void *arg)
+{
+	struct vhost_blk_queue_group *group = arg;
+	struct spdk_vhost_blk_dev *bvdev = group->bvsession->bvdev;
+
+	if (!group->bdev_removed) {
+		group->io_channel = vhost_blk_get_io_channel(&bvdev->vdev);
+		if (group->io_channel == NULL) {
+			SPDK_ERRLOG("%s: I/O channel allocation failed, queues %"PRIu16"+ will fail requests\n",
+				    group->bvsession->vsession.name, group->first_vq);
+			group->bdev_removed = true;
+		}
+	}
+
+	if (!group->bdev_removed) {
+		group->poller = SPDK_POLLER_REGISTER(vdev_queue_group_worker, group, 0);
+	} else {
+		group->poller = SPDK_POLLER_REGISTER(no_bdev_queue_group_worker, group, 0);
+	}
+}
+
+static void vhost_blk_session_stop_groups(struct spdk_vhost_blk_session *bvsession);
+
+static int
+vhost_blk_session_start_groups(struct spdk_vhost_blk_session *bvsession)
+{
+	struct spdk_vhost_session *vsession = &bvsession->vsession;
+	struct spdk_vhost_blk_dev *bvdev = bvsession->bvdev;
+	struct spdk_vhost_user_blk_task *tasks;
+	struct spdk_vhost_virtqueue *vq;
+	struct vhost_blk_queue_group *group;
+	uint16_t num_groups, i, j;
+	int rc;
+
+	num_groups = spdk_min(bvdev->num_queue_threads, spdk_max(vsession->max_queues, 1));
+	/* Room for the task pools to unwind a failed start is allocated upfront. */
+	bvsession->groups = calloc(1, num_groups * sizeof(*bvsession->groups) +
+				   vsession->max_queues * sizeof(*bvsession->stale_tasks));
+	if (bvsession->groups == NULL) {
+		free_task_pool(bvsession);
+		SPDK_ERRLOG("%s: failed to allocate queue groups\n", vsession->name);
+		return -ENOMEM;
+	}
+	bvsession->num_groups = num_groups;
+	bvsession->stale_tasks = (void **)&bvsession->groups[num_groups];
+
+	for (i = 0; i < num_groups; i++) {
+		group = &bvsession->groups[i];
+		group->bvsession = bvsession;
+		group->first_vq = i;
+		/* Rotate by session so that sessions with fewer queues than threads don't pile up. */
+		group->thread = bvdev->queue_threads[(vsession->id + i) % bvdev->num_queue_threads];
+		group->bdev_removed = bvdev->bdev == NULL;
+	}
+
+	for (i = 0; i < vsession->max_queues; i++) {
+		vq = &vsession->virtqueue[i];
+		tasks = vq->tasks;
+		if (tasks == NULL) {
+			continue;
+		}
+
+		for (j = 0; j < vq->vring.size; j++) {
+			tasks[j].group = &bvsession->groups[i % num_groups];
+		}
+	}
+
+	for (i = 0; i < num_groups; i++) {
+		group = &bvsession->groups[i];
+		rc = spdk_thread_send_msg(group->thread, vhost_blk_queue_group_start, group);
+		if (rc != 0) {
+			SPDK_ERRLOG("%s: failed to start queue group %"PRIu16": %s\n",
+				    vsession->name, i, spdk_strerror(-rc));
+			/* The remaining groups never started. Stop the others, the groups are
+			 * freed by the next start once all of them report being stopped.
+			 */
+			for (j = i; j < num_groups; j++) {
+				bvsession->groups[j].stopped = true;
+			}
+			vhost_blk_session_stop_groups(bvsession);
+
+			/* The virtqueues of the started groups may have requests in flight, so
+			 * their task pools are only freed along with the groups.
+			 */
+			for (j = 0; j < vsession->max_queues; j++) {
+				vq = &vsession->virtqueue[j];
+				if (j % num_groups < i) {
+					bvsession->stale_tasks[j] = vq->tasks;
+				} else {
+					spdk_free(vq->tasks);
+				}
+				vq->tasks = NULL;
+			}
+			bvsession->num_stale_tasks = vsession->max_queues;
+			return rc;
+		}
+	}
+
+	SPDK_INFOLOG(vhost, "%s: spread %"PRIu16" queues across %"PRIu16" threads\n",
+		     vsession->name, vsession->max_queues, num_groups);
+
+	return 0;
+}
+
+static void
+vhost_blk_session_free_groups(struct spdk_vhost_blk_session *bvsession)
+{
+	uint16_t i;
+
+	for (i = 0; i < bvsession->num_stale_tasks; i++) {
+		spdk_free(bvsession->stale_tasks[i]);
+	}
+	bvsession->stale_tasks = NULL;
+	bvsession->num_stale_tasks = 0;
+
+	free(bvsession->groups);
+	bvsession->groups = NULL;
+	bvsession->num_groups = 0;
+}
+
+static bool
+vhost_blk_session_groups_stopped(struct spdk_vhost_blk_session *bvsession)
+{
+	uint16_t i;
+
+	for (i = 0; i < bvsession->num_groups; i++) {
+		if (!__atomic_load_n(&bvsession->groups[i].stopped, __ATOMIC_ACQUIRE)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int
+vhost_blk_queue_group_stop_poller(void *arg)
+{
+	struct vhost_blk_queue_group *group = arg;
+
+	if (group->task_cnt > 0) {
+		return SPDK_POLLER_BUSY;
+	}
+
+	if (group->io_channel) {
+		vhost_blk_put_io_channel(group->io_channel);
+		group->io_channel = NULL;
+	}
+
+	spdk_poller_unregister(&group->stop_poller);
+	__atomic_store_n(&group->stopped, true, __ATOMIC_RELEASE);
+
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+vhost_blk_queue_group_stop(void *arg)
+{
+	struct vhost_blk_queue_group *group = arg;
+
+	if (group->stop_poller != NULL || group->stopped) {
+		return;
+	}
+
+	spdk_poller_unregister(&group->poller);
+	group->stop_poller = SPDK_POLLER_REGISTER(vhost_blk_queue_group_stop_poller, group,
+			     SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+}
+
+/* Ask every group that wasn't asked yet to stop. Called again while waiting for the groups,
+ * so that a message that couldn't be sent is retried.
+ */
+static void
+vhost_blk_session_stop_groups(struct spdk_vhost_blk_session *bvsession)
+{
+	struct vhost_blk_queue_group *group;
+	uint16_t i;
+	int rc;
+
+	for (i = 0; i < bvsession->num_groups; i++) {
+		group = &bvsession->groups[i];
+		if (group->stop_sent || __atomic_load_n(&group->stopped, __ATOMIC_ACQUIRE)) {
+			continue;
+		}
+
+		rc = spdk_thread_send_msg(group->thread, vhost_blk_queue_group_stop, group);
+		if (rc != 0) {
+			SPDK_ERRLOG("%s: failed to stop queue group %"PRIu16", will retry: %s\n",
+				    bvsession->vsession.name, i, spdk_strerror(-rc));
+			continue;
+		}
+		group->stop_sent = true;
+	}
+}
+
 static int
 vhost_blk_start(struct spdk_vhost_dev *vdev,
 		struct spdk_vhost_session *vsession, void *unused)
@@ -1345,6 +1751,16 @@ vhost_blk_start(struct spdk_vhost_dev *vdev,
 		return -EINPROGRESS;
 	}
 
+	if (bvsession->groups) {
+		if (!vhost_blk_session_groups_stopped(bvsession)) {
+			SPDK_INFOLOG(vhost, "%s: start in progress\n", vsession->name);
+			return -EINPROGRESS;
+		}
+
+		/* Left behind by a failed start or a stop that timed out */
+		vhost_blk_session_free_groups(bvsession);
+	}
+
 	/* validate all I/O queues are in a contiguous index range */
 	for (i = 0; i < vsession->max_queues; i++) {
 		/* vring.desc and vring.desc_packed are in a union struct
@@ -1360,6 +1776,10 @@ vhost_blk_start(struct spdk_vhost_dev *vdev,
 	assert(bvdev != NULL);
 	bvsession->bvdev = bvdev;
 
+	if (bvdev->num_queue_threads > 0) {
+		return vhost_blk_session_start_groups(bvsession);
+	}
+
 	if (bvdev->bdev) {
 		bvsession->io_channel = vhost_blk_get_io_channel(vdev);
 		if (!bvsession->io_channel) {
@@ -1391,12 +1811,19 @@ destroy_session_poller_cb(void *arg)
 	struct spdk_vhost_user_dev *user_dev = to_user_dev(vsession->vdev);
 	int i;
 
-	if (vsession->task_cnt > 0 || (pthread_mutex_trylock(&user_dev->lock) != 0)) {
+	vhost_blk_session_stop_groups(bvsession);
+
+	if (vsession->task_cnt > 0 || !vhost_blk_session_groups_stopped(bvsession) ||
+	    (pthread_mutex_trylock(&user_dev->lock) != 0)) {
 		assert(vsession->stop_retry_count > 0);
 		vsession->stop_retry_count--;
 		if (vsession->stop_retry_count == 0) {
 			SPDK_ERRLOG("%s: Timedout when destroy session (task_cnt %d)\n", vsession->name,
 				    vsession->task_cnt);
+			/* Groups still running are freed by the next start, once they stopped. */
+			if (vhost_blk_session_groups_stopped(bvsession)) {
+				vhost_blk_session_free_groups(bvsession);
+			}
 			spdk_poller_unregister(&bvsession->stop_poller);
 			vhost_user_session_stop_done(vsession, -ETIMEDOUT);
 		}
@@ -1418,6 +1845,7 @@ destroy_session_poller_cb(void *arg)
 	}
 
 	free_task_pool(bvsession);
+	vhost_blk_session_free_groups(bvsession);
 	spdk_poller_unregister(&bvsession->stop_poller);
 	vhost_user_session_stop_done(vsession, 0);
 
@@ -1438,6 +1866,7 @@ vhost_blk_stop(struct spdk_vhost_dev *vdev,
 
 	spdk_poller_unregister(&bvsession->requestq_poller);
 	vhost_blk_session_unregister_interrupts(bvsession);
+	vhost_blk_session_stop_groups(bvsession);
 
 	bvsession->vsession.stop_retry_count = (SPDK_VHOST_SESSION_STOP_RETRY_TIMEOUT_IN_SEC * 1000 *
 						1000) / SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US;
@@ -1465,6 +1894,10 @@ vhost_blk_dump_info_json(struct spdk_vhost_dev *vdev, struct spdk_json_write_ctx
 		spdk_json_write_null(w);
 	}
 	spdk_json_write_named_string(w, "transport", bvdev->ops->name);
+	if (bvdev->num_queue_threads > 0) {
+		spdk_json_write_named_string_fmt(w, "queue_cpumask", "0x%s",
+						 spdk_cpuset_fmt(&bvdev->queue_cpumask));
+	}
 
 	spdk_json_write_object_end(w);
 }
@@ -1491,6 +1924,9 @@ vhost_blk_write_config_json(struct spdk_vhost_dev *vdev, struct spdk_json_write_
 				     spdk_cpuset_fmt(spdk_thread_get_cpumask(vdev->thread)));
 	spdk_json_write_named_bool(w, "readonly", bvdev->readonly);
 	spdk_json_write_named_string(w, "transport", bvdev->ops->name);
+	if (bvdev->num_queue_threads > 0) {
+		spdk_json_write_named_string(w, "queue_cpumask", spdk_cpuset_fmt(&bvdev->queue_cpumask));
+	}
 	spdk_json_write_object_end(w);
 
 	spdk_json_write_object_end(w);
@@ -1562,24 +1998,24 @@ vhost_blk_get_config(struct spdk_vhost_dev *vdev, uint8_t *config,
 
 static int
 vhost_blk_set_coalescing(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
-			 uint32_t iops_threshold)
+			 uint32_t iops_threshold, uint32_t max_coalesced_reqs)
 {
 	struct spdk_vhost_blk_dev *bvdev = to_blk_dev(vdev);
 
 	assert(bvdev != NULL);
 
-	return bvdev->ops->set_coalescing(vdev, delay_base_us, iops_threshold);
+	return bvdev->ops->set_coalescing(vdev, delay_base_us, iops_threshold, max_coalesced_reqs);
 }
 
 static void
 vhost_blk_get_coalescing(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
-			 uint32_t *iops_threshold)
+			 uint32_t *iops_threshold, uint32_t *max_coalesced_reqs)
 {
 	struct spdk_vhost_blk_dev *bvdev = to_blk_dev(vdev);
 
 	assert(bvdev != NULL);
 
-	bvdev->ops->get_coalescing(vdev, delay_base_us, iops_threshold);
+	bvdev->ops->get_coalescing(vdev, delay_base_us, iops_threshold, max_coalesced_reqs);
 }
 
 static const struct spdk_vhost_user_dev_backend vhost_blk_user_device_backend = {
@@ -1761,19 +2197,146 @@ vhost_user_blk_destroy(struct spdk_virtio_blk_transport *transport,
 struct rpc_vhost_blk {
 	bool readonly;
 	bool packed_ring;
+	char *queue_cpumask;
 };
 
 static const struct spdk_json_object_decoder rpc_construct_vhost_blk[] = {
 	{"readonly", offsetof(struct rpc_vhost_blk, readonly), spdk_json_decode_bool, true},
 	{"packed_ring", offsetof(struct rpc_vhost_blk, packed_ring), spdk_json_decode_bool, true},
+	{"queue_cpumask", offsetof(struct rpc_vhost_blk, queue_cpumask), spdk_json_decode_string, true},
+};
+
+static void
+vhost_blk_queue_thread_exit(void *arg)
+{
+	spdk_thread_exit(spdk_get_thread());
+}
+
+struct vhost_blk_release_ctx {
+	struct spdk_thread **threads;
+	uint32_t num_threads;
+	struct spdk_poller *poller;
 };
 
+/* Ask the threads to exit.  The ones that couldn't be reached are moved to the front of the
+ * array and their number is returned.
+ */
+static uint32_t
+vhost_blk_exit_queue_threads(struct spdk_thread **threads, uint32_t num_threads)
+{
+	uint32_t i, remaining = 0;
+
+	for (i = 0; i < num_threads; i++) {
+		if (spdk_thread_send_msg(threads[i], vhost_blk_queue_thread_exit, NULL) != 0) {
+			threads[remaining++] = threads[i];
+		}
+	}
+
+	return remaining;
+}
+
+static int
+vhost_blk_release_queue_threads_retry(void *arg)
+{
+	struct vhost_blk_release_ctx *ctx = arg;
+
+	ctx->num_threads = vhost_blk_exit_queue_threads(ctx->threads, ctx->num_threads);
+	if (ctx->num_threads > 0) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	spdk_poller_unregister(&ctx->poller);
+	free(ctx->threads);
+	free(ctx);
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+vhost_blk_release_queue_threads(struct spdk_vhost_blk_dev *bvdev)
+{
+	struct vhost_blk_release_ctx *ctx = NULL;
+	uint32_t remaining;
+
+	remaining = vhost_blk_exit_queue_threads(bvdev->queue_threads, bvdev->num_queue_threads);
+	if (remaining > 0) {
+		/* The controller goes away, so keep trying from a context of our own. */
+		SPDK_ERRLOG("%s: failed to stop %"PRIu32" queue threads, will retry\n",
+			    bvdev->vdev.name, remaining);
+		ctx = calloc(1, sizeof(*ctx));
+	}
+
+	if (ctx != NULL) {
+		ctx->threads = bvdev->queue_threads;
+		ctx->num_threads = remaining;
+		ctx->poller = SPDK_POLLER_REGISTER(vhost_blk_release_queue_threads_retry, ctx,
+						   SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+		if (ctx->poller != NULL) {
+			bvdev->queue_threads = NULL;
+		} else {
+			free(ctx);
+		}
+	}
+
+	if (remaining > 0 && bvdev->queue_threads != NULL) {
+		SPDK_ERRLOG("%s: leaking %"PRIu32" queue threads\n", bvdev->vdev.name, remaining);
+	}
+
+	free(bvdev->queue_threads);
+	bvdev->queue_threads = NULL;
+	bvdev->num_queue_threads = 0;
+}
+
+static int
+vhost_blk_create_queue_threads(struct spdk_vhost_blk_dev *bvdev, const char *name,
+			       const char *mask)
+{
+	struct spdk_cpuset cpumask;
+	char thread_name[64];
+	uint32_t core;
+
+	if (spdk_interrupt_mode_is_enabled()) {
+		SPDK_ERRLOG("%s: spreading queues across threads is not supported in interrupt mode\n", name);
+		return -ENOTSUP;
+	}
+
+	if (vhost_parse_core_mask(mask, &bvdev->queue_cpumask) != 0) {
+		SPDK_ERRLOG("%s: queue cpumask %s is invalid\n", name, mask);
+		return -EINVAL;
+	}
+
+	bvdev->queue_threads = calloc(spdk_cpuset_count(&bvdev->queue_cpumask),
+				      sizeof(*bvdev->queue_threads));
+	if (bvdev->queue_threads == NULL) {
+		return -ENOMEM;
+	}
+
+	SPDK_ENV_FOREACH_CORE(core) {
+		if (!spdk_cpuset_get_cpu(&bvdev->queue_cpumask, core)) {
+			continue;
+		}
+
+		spdk_cpuset_zero(&cpumask);
+		spdk_cpuset_set_cpu(&cpumask, core, true);
+		snprintf(thread_name, sizeof(thread_name), "%s_q%"PRIu32, name, core);
+		bvdev->queue_threads[bvdev->num_queue_threads] = spdk_thread_create(thread_name, &cpumask);
+		if (bvdev->queue_threads[bvdev->num_queue_threads] == NULL) {
+			SPDK_ERRLOG("%s: failed to create queue thread on core %"PRIu32"\n", name, core);
+			vhost_blk_release_queue_threads(bvdev);
+			return -EIO;
+		}
+		bvdev->num_queue_threads++;
+	}
+
+	return 0;
+}
+
 static int
 vhost_user_blk_create_ctrlr(struct spdk_vhost_dev *vdev, struct spdk_cpuset *cpumask,
 			    const char *address, const struct spdk_json_val *params, void *custom_opts)
 {
 	struct rpc_vhost_blk req = {0};
 	struct spdk_vhost_blk_dev *bvdev = to_blk_dev(vdev);
+	int rc;
 
 	assert(bvdev != NULL);
 
@@ -1781,6 +2344,7 @@ vhost_user_blk_create_ctrlr(struct spdk_vhost_dev *vdev, struct spdk_cpuset *cpu
 					    SPDK_COUNTOF(rpc_construct_vhost_blk),
 					    &req)) {
 		SPDK_DEBUGLOG(vhost_blk, "spdk_json_decode_object failed\n");
+		free(req.queue_cpumask);
 		return -EINVAL;
 	}
 
@@ -1792,13 +2356,36 @@ vhost_user_blk_create_ctrlr(struct spdk_vhost_dev *vdev, struct spdk_cpuset *cpu
 		bvdev->readonly = req.readonly;
 	}
 
-	return vhost_user_dev_create(vdev, address, cpumask, custom_opts, false);
+	if (req.queue_cpumask) {
+		rc = vhost_blk_create_queue_threads(bvdev, address, req.queue_cpumask);
+		free(req.queue_cpumask);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	rc = vhost_user_dev_create(vdev, address, cpumask, custom_opts, false);
+	if (rc != 0) {
+		vhost_blk_release_queue_threads(bvdev);
+	}
+
+	return rc;
 }
 
 static int
 vhost_user_blk_destroy_ctrlr(struct spdk_vhost_dev *vdev)
 {
-	return vhost_user_dev_unregister(vdev);
+	struct spdk_vhost_blk_dev *bvdev = to_blk_dev(vdev);
+	int rc;
+
+	assert(bvdev != NULL);
+
+	rc = vhost_user_dev_unregister(vdev);
+	if (rc == 0) {
+		vhost_blk_release_queue_threads(bvdev);
+	}
+
+	return rc;
 }
 
 static void
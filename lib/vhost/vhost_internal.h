@@ -102,12 +102,31 @@ struct spdk_vhost_virtqueue {
 	/* Request count from last event */
 	uint16_t used_req_cnt;
 
+	/* used_req_cnt when the last signal was held back or suppressed */
+	uint16_t held_req_cnt;
+
 	/* How long interrupt is delayed */
 	uint32_t irq_delay_time;
 
 	/* Next time when we need to send event */
 	uint64_t next_event_time;
 
+	/* Next time when stats for event coalescing will be checked. */
+	uint64_t next_stats_check_time;
+
+	struct {
+		/* Requests put on the used ring */
+		uint64_t completed_reqs;
+		/* Interrupts sent to the driver */
+		uint64_t irqs;
+		/* Signals held back by the coalescing delay */
+		uint64_t irqs_coalesced;
+		/* Signals skipped because the driver disabled events */
+		uint64_t irqs_suppressed;
+		/* Writes of the split ring used->idx */
+		uint64_t used_idx_updates;
+	} stats;
+
 	/* Associated vhost_virtqueue in the virtio device's virtqueue list */
 	uint32_t vring_idx;
 
@@ -144,9 +163,7 @@ struct spdk_vhost_session {
 	/* Local copy of device coalescing settings. */
 	uint32_t coalescing_delay_time_base;
 	uint32_t coalescing_io_rate_threshold;
-
-	/* Next time when stats for event coalescing will be checked. */
-	uint64_t next_stats_check_time;
+	uint32_t coalescing_max_reqs;
 
 	/* Interval used for event coalescing checking. */
 	uint64_t stats_check_interval;
@@ -180,6 +197,7 @@ struct spdk_vhost_user_dev {
 	 */
 	uint32_t coalescing_delay_us;
 	uint32_t coalescing_iops_threshold;
+	uint32_t coalescing_max_reqs;
 
 	bool registered;
 
@@ -270,9 +288,9 @@ struct spdk_vhost_dev_backend {
 	void (*write_config_json)(struct spdk_vhost_dev *vdev, struct spdk_json_write_ctx *w);
 	int (*remove_device)(struct spdk_vhost_dev *vdev);
 	int (*set_coalescing)(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
-			      uint32_t iops_threshold);
+			      uint32_t iops_threshold, uint32_t max_coalesced_reqs);
 	void (*get_coalescing)(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
-			       uint32_t *iops_threshold);
+			       uint32_t *iops_threshold, uint32_t *max_coalesced_reqs);
 };
 
 void *vhost_gpa_to_vva(struct spdk_vhost_session *vsession, uint64_t addr, uint64_t len);
@@ -495,12 +513,21 @@ void vhost_blk_put_io_channel(struct spdk_io_channel *ch);
  * the device properties, ex. number of blocks or I/O type supported. */
 struct spdk_bdev *vhost_blk_get_bdev(struct spdk_vhost_dev *vdev);
 
+/**
+ * Parse a cpumask string and make sure it is a subset of the vhost core mask.
+ *
+ * \param mask cpumask string, NULL selects the whole vhost core mask.
+ * \param cpumask parsed cpumask.
+ * \return 0 on success, -1 on failure.
+ */
+int vhost_parse_core_mask(const char *mask, struct spdk_cpuset *cpumask);
+
 /* Function calls from vhost.c to rte_vhost_user.c,
  * shall removed once virtio transport abstraction is complete. */
 int vhost_user_session_set_coalescing(struct spdk_vhost_dev *dev,
 				      struct spdk_vhost_session *vsession, void *ctx);
 int vhost_user_dev_set_coalescing(struct spdk_vhost_user_dev *user_dev, uint32_t delay_base_us,
-				  uint32_t iops_threshold);
+				  uint32_t iops_threshold, uint32_t max_coalesced_reqs);
 int vhost_user_dev_create(struct spdk_vhost_dev *vdev, const char *name,
 			  struct spdk_cpuset *cpumask,
 			  const struct spdk_vhost_user_dev_backend *user_backend, bool dealy);
@@ -511,9 +538,9 @@ int vhost_user_dev_unregister(struct spdk_vhost_dev *vdev);
 int vhost_user_init(void);
 void vhost_user_fini(spdk_vhost_fini_cb vhost_cb);
 int vhost_user_set_coalescing(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
-			      uint32_t iops_threshold);
+			      uint32_t iops_threshold, uint32_t max_coalesced_reqs);
 void vhost_user_get_coalescing(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
-			       uint32_t *iops_threshold);
+			       uint32_t *iops_threshold, uint32_t *max_coalesced_reqs);
 
 int virtio_blk_construct_ctrlr(struct spdk_vhost_dev *vdev, const char *address,
 			       struct spdk_cpuset *cpumask, const struct spdk_json_val *params,
@@ -597,13 +624,13 @@ struct spdk_virtio_blk_transport_ops {
 	 * Set coalescing parameters.
 	 */
 	int (*set_coalescing)(struct spdk_vhost_dev *vdev, uint32_t delay_base_us,
-			      uint32_t iops_threshold);
+			      uint32_t iops_threshold, uint32_t max_coalesced_reqs);
 
 	/**
 	 * Get coalescing parameters.
 	 */
 	void (*get_coalescing)(struct spdk_vhost_dev *vdev, uint32_t *delay_base_us,
-			       uint32_t *iops_threshold);
+			       uint32_t *iops_threshold, uint32_t *max_coalesced_reqs);
 };
 
 struct spdk_virtio_blk_transport {
@@ -402,9 +402,9 @@ struct rpc_get_vhost_ctrlrs {
 static void
 _rpc_get_vhost_controller(struct spdk_json_write_ctx *w, struct spdk_vhost_dev *vdev)
 {
-	uint32_t delay_base_us, iops_threshold;
+	uint32_t delay_base_us, iops_threshold, max_coalesced_reqs;
 
-	spdk_vhost_get_coalescing(vdev, &delay_base_us, &iops_threshold);
+	spdk_vhost_get_coalescing_ext(vdev, &delay_base_us, &iops_threshold, &max_coalesced_reqs);
 
 	spdk_json_write_object_begin(w);
 
@@ -413,6 +413,7 @@ _rpc_get_vhost_controller(struct spdk_json_write_ctx *w, struct spdk_vhost_dev *
 					 spdk_cpuset_fmt(spdk_thread_get_cpumask(vdev->thread)));
 	spdk_json_write_named_uint32(w, "delay_base_us", delay_base_us);
 	spdk_json_write_named_uint32(w, "iops_threshold", iops_threshold);
+	spdk_json_write_named_uint32(w, "max_coalesced_reqs", max_coalesced_reqs);
 	spdk_json_write_named_string(w, "socket", vdev->path);
 	spdk_json_write_named_array_begin(w, "sessions");
 	vhost_session_info_json(vdev, w);
@@ -501,12 +502,14 @@ struct rpc_vhost_ctrlr_coalescing {
 	char *ctrlr;
 	uint32_t delay_base_us;
 	uint32_t iops_threshold;
+	uint32_t max_coalesced_reqs;
 };
 
 static const struct spdk_json_object_decoder rpc_set_vhost_ctrlr_coalescing[] = {
 	{"ctrlr", offsetof(struct rpc_vhost_ctrlr_coalescing, ctrlr), spdk_json_decode_string },
 	{"delay_base_us", offsetof(struct rpc_vhost_ctrlr_coalescing, delay_base_us), spdk_json_decode_uint32},
 	{"iops_threshold", offsetof(struct rpc_vhost_ctrlr_coalescing, iops_threshold), spdk_json_decode_uint32},
+	{"max_coalesced_reqs", offsetof(struct rpc_vhost_ctrlr_coalescing, max_coalesced_reqs), spdk_json_decode_uint32, true},
 };
 
 static void
@@ -538,7 +541,8 @@ rpc_vhost_controller_set_coalescing(struct spdk_jsonrpc_request *request,
 		goto invalid;
 	}
 
-	rc = spdk_vhost_set_coalescing(vdev, req.delay_base_us, req.iops_threshold);
+	rc = spdk_vhost_set_coalescing_ext(vdev, req.delay_base_us, req.iops_threshold,
+					   req.max_coalesced_reqs);
 	spdk_vhost_unlock();
 	if (rc) {
 		goto invalid;
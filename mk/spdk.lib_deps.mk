@@ -85,7 +85,7 @@ DEPDIRS-mlx5 = log rdma_utils util
 endif
 DEPDIRS-scsi := log util thread $(JSON_LIBS) trace bdev
 
-DEPDIRS-iscsi := log sock util conf thread $(JSON_LIBS) trace scsi
+DEPDIRS-iscsi := log sock util conf thread $(JSON_LIBS) trace scsi accel
 DEPDIRS-vhost = log util thread $(JSON_LIBS) bdev scsi
 
 DEPDIRS-fsdev := log thread util $(JSON_LIBS) notify
@@ -29,6 +29,17 @@ static uint32_t g_shallow_copy_count = 0;
 static LIST_HEAD(, rpc_shallow_copy_status) g_shallow_copy_status_list = LIST_HEAD_INITIALIZER(
 			&g_shallow_copy_status_list);
 
+struct rpc_inflate_status {
+	struct spdk_jsonrpc_request		*request;
+	struct spdk_uuid			lvol_uuid;
+	uint64_t				copied_clusters;
+	uint64_t				total_clusters;
+	LIST_ENTRY(rpc_inflate_status)		link;
+};
+
+static LIST_HEAD(, rpc_inflate_status) g_inflate_status_list = LIST_HEAD_INITIALIZER(
+			&g_inflate_status_list);
+
 struct rpc_bdev_lvol_create_lvstore {
 	char *lvs_name;
 	char *bdev_name;
@@ -698,6 +709,8 @@ SPDK_RPC_REGISTER("bdev_lvol_rename", rpc_bdev_lvol_rename, SPDK_RPC_RUNTIME)
 
 struct rpc_bdev_lvol_inflate {
 	char *name;
+	uint32_t queue_depth;
+	uint64_t clusters_per_sec;
 };
 
 static void
@@ -708,12 +721,19 @@ free_rpc_bdev_lvol_inflate(struct rpc_bdev_lvol_inflate *req)
 
 static const struct spdk_json_object_decoder rpc_bdev_lvol_inflate_decoders[] = {
 	{"name", offsetof(struct rpc_bdev_lvol_inflate, name), spdk_json_decode_string},
+	{"queue_depth", offsetof(struct rpc_bdev_lvol_inflate, queue_depth), spdk_json_decode_uint32, true},
+	{"clusters_per_sec", offsetof(struct rpc_bdev_lvol_inflate, clusters_per_sec), spdk_json_decode_uint64, true},
 };
 
 static void
 rpc_bdev_lvol_inflate_cb(void *cb_arg, int lvolerrno)
 {
-	struct spdk_jsonrpc_request *request = cb_arg;
+	struct rpc_inflate_status *status = cb_arg;
+	struct spdk_jsonrpc_request *request = status->request;
+
+	/* The outcome is reported by this response, so the progress entry is no longer needed. */
+	LIST_REMOVE(status, link);
+	free(status);
 
 	if (lvolerrno != 0) {
 		goto invalid;
@@ -728,14 +748,27 @@ invalid:
 }
 
 static void
-rpc_bdev_lvol_inflate(struct spdk_jsonrpc_request *request,
-		      const struct spdk_json_val *params)
+rpc_bdev_lvol_inflate_status_cb(uint64_t copied_clusters, uint64_t total_clusters, void *cb_arg)
+{
+	struct rpc_inflate_status *status = cb_arg;
+
+	status->copied_clusters = copied_clusters;
+	status->total_clusters = total_clusters;
+}
+
+static void
+_rpc_bdev_lvol_inflate(struct spdk_jsonrpc_request *request, const struct spdk_json_val *params,
+		       bool allocate_all)
 {
 	struct rpc_bdev_lvol_inflate req = {};
+	struct spdk_bs_inflate_opts opts;
+	struct rpc_inflate_status *status;
 	struct spdk_bdev *bdev;
 	struct spdk_lvol *lvol;
 
-	SPDK_INFOLOG(lvol_rpc, "Inflating lvol\n");
+	spdk_bs_inflate_opts_init(&opts, sizeof(opts));
+	req.queue_depth = opts.queue_depth;
+	req.clusters_per_sec = opts.clusters_per_sec;
 
 	if (spdk_json_decode_object(params, rpc_bdev_lvol_inflate_decoders,
 				    SPDK_COUNTOF(rpc_bdev_lvol_inflate_decoders),
@@ -746,6 +779,11 @@ rpc_bdev_lvol_inflate(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
+	if (req.queue_depth == 0) {
+		spdk_jsonrpc_send_error_response(request, -EINVAL, "queue_depth must be greater than 0");
+		goto cleanup;
+	}
+
 	bdev = spdk_bdev_get_by_name(req.name);
 	if (bdev == NULL) {
 		SPDK_ERRLOG("bdev '%s' does not exist\n", req.name);
@@ -760,26 +798,79 @@ rpc_bdev_lvol_inflate(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
-	spdk_lvol_inflate(lvol, rpc_bdev_lvol_inflate_cb, request);
+	status = calloc(1, sizeof(*status));
+	if (status == NULL) {
+		SPDK_ERRLOG("Cannot allocate status entry for inflate of '%s'\n", req.name);
+		spdk_jsonrpc_send_error_response(request, -ENOMEM, spdk_strerror(ENOMEM));
+		goto cleanup;
+	}
+	status->request = request;
+	spdk_uuid_copy(&status->lvol_uuid, &lvol->uuid);
+	LIST_INSERT_HEAD(&g_inflate_status_list, status, link);
+
+	opts.queue_depth = req.queue_depth;
+	opts.clusters_per_sec = req.clusters_per_sec;
+	opts.status_cb_fn = rpc_bdev_lvol_inflate_status_cb;
+	opts.status_cb_arg = status;
+
+	if (allocate_all) {
+		spdk_lvol_inflate_ext(lvol, &opts, rpc_bdev_lvol_inflate_cb, status);
+	} else {
+		spdk_lvol_decouple_parent_ext(lvol, &opts, rpc_bdev_lvol_inflate_cb, status);
+	}
 
 cleanup:
 	free_rpc_bdev_lvol_inflate(&req);
 }
 
+static void
+rpc_bdev_lvol_inflate(struct spdk_jsonrpc_request *request,
+		      const struct spdk_json_val *params)
+{
+	SPDK_INFOLOG(lvol_rpc, "Inflating lvol\n");
+
+	_rpc_bdev_lvol_inflate(request, params, true);
+}
+
 SPDK_RPC_REGISTER("bdev_lvol_inflate", rpc_bdev_lvol_inflate, SPDK_RPC_RUNTIME)
 
 static void
 rpc_bdev_lvol_decouple_parent(struct spdk_jsonrpc_request *request,
 			      const struct spdk_json_val *params)
 {
-	struct rpc_bdev_lvol_inflate req = {};
+	SPDK_INFOLOG(lvol_rpc, "Decoupling parent of lvol\n");
+
+	_rpc_bdev_lvol_inflate(request, params, false);
+}
+
+SPDK_RPC_REGISTER("bdev_lvol_decouple_parent", rpc_bdev_lvol_decouple_parent, SPDK_RPC_RUNTIME)
+
+struct rpc_bdev_lvol_check_inflate {
+	char *name;
+};
+
+static void
+free_rpc_bdev_lvol_check_inflate(struct rpc_bdev_lvol_check_inflate *req)
+{
+	free(req->name);
+}
+
+static const struct spdk_json_object_decoder rpc_bdev_lvol_check_inflate_decoders[] = {
+	{"name", offsetof(struct rpc_bdev_lvol_check_inflate, name), spdk_json_decode_string},
+};
+
+static void
+rpc_bdev_lvol_check_inflate(struct spdk_jsonrpc_request *request,
+			    const struct spdk_json_val *params)
+{
+	struct rpc_bdev_lvol_check_inflate req = {};
+	struct rpc_inflate_status *status;
+	struct spdk_json_write_ctx *w;
 	struct spdk_bdev *bdev;
 	struct spdk_lvol *lvol;
 
-	SPDK_INFOLOG(lvol_rpc, "Decoupling parent of lvol\n");
-
-	if (spdk_json_decode_object(params, rpc_bdev_lvol_inflate_decoders,
-				    SPDK_COUNTOF(rpc_bdev_lvol_inflate_decoders),
+	if (spdk_json_decode_object(params, rpc_bdev_lvol_check_inflate_decoders,
+				    SPDK_COUNTOF(rpc_bdev_lvol_check_inflate_decoders),
 				    &req)) {
 		SPDK_INFOLOG(lvol_rpc, "spdk_json_decode_object failed\n");
 		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
@@ -801,13 +892,31 @@ rpc_bdev_lvol_decouple_parent(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
-	spdk_lvol_decouple_parent(lvol, rpc_bdev_lvol_inflate_cb, request);
+	LIST_FOREACH(status, &g_inflate_status_list, link) {
+		if (spdk_uuid_compare(&status->lvol_uuid, &lvol->uuid) == 0) {
+			break;
+		}
+	}
+
+	if (!status) {
+		spdk_jsonrpc_send_error_response(request, -ENOENT, "No inflate in progress");
+		goto cleanup;
+	}
+
+	w = spdk_jsonrpc_begin_result(request);
+
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_uint64(w, "copied_clusters", status->copied_clusters);
+	spdk_json_write_named_uint64(w, "total_clusters", status->total_clusters);
+	spdk_json_write_object_end(w);
+
+	spdk_jsonrpc_end_result(request, w);
 
 cleanup:
-	free_rpc_bdev_lvol_inflate(&req);
+	free_rpc_bdev_lvol_check_inflate(&req);
 }
 
-SPDK_RPC_REGISTER("bdev_lvol_decouple_parent", rpc_bdev_lvol_decouple_parent, SPDK_RPC_RUNTIME)
+SPDK_RPC_REGISTER("bdev_lvol_check_inflate", rpc_bdev_lvol_check_inflate, SPDK_RPC_RUNTIME)
 
 struct rpc_bdev_lvol_resize {
 	char *name;
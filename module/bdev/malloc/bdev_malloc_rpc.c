@@ -63,7 +63,8 @@ rpc_bdev_malloc_create(struct spdk_jsonrpc_request *request,
 cleanup:
 	free_rpc_construct_malloc(&req);
 }
-SPDK_RPC_REGISTER("bdev_malloc_create", rpc_bdev_malloc_create, SPDK_RPC_RUNTIME)
+SPDK_RPC_REGISTER_CONCURRENT("bdev_malloc_create", rpc_bdev_malloc_create, SPDK_RPC_RUNTIME,
+			     "name")
 
 struct rpc_delete_malloc {
 	char *name;
@@ -62,7 +62,8 @@ rpc_bdev_null_create(struct spdk_jsonrpc_request *request,
 cleanup:
 	free_rpc_construct_null(&req);
 }
-SPDK_RPC_REGISTER("bdev_null_create", rpc_bdev_null_create, SPDK_RPC_RUNTIME)
+SPDK_RPC_REGISTER_CONCURRENT("bdev_null_create", rpc_bdev_null_create, SPDK_RPC_RUNTIME,
+			     "name")
 
 struct rpc_delete_null {
 	char *name;
@@ -3774,6 +3774,14 @@ bdev_nvme_create_poll_group_cb(void *io_device, void *ctx_buf)
 		return -1;
 	}
 
+	if (g_opts.poll_group_requests != 0 &&
+	    spdk_nvme_poll_group_set_req_pool_size(group->group, g_opts.poll_group_requests) != 0) {
+		SPDK_ERRLOG("Failed to allocate %u shared requests for poll group\n",
+			    g_opts.poll_group_requests);
+		spdk_nvme_poll_group_destroy(group->group);
+		return -1;
+	}
+
 	period = spdk_interrupt_mode_is_enabled() ? 0 : g_opts.nvme_ioq_poll_period_us;
 	group->poller = SPDK_POLLER_REGISTER(bdev_nvme_poll, group, period);
 
@@ -6157,12 +6165,13 @@ spdk_bdev_nvme_get_opts(struct spdk_bdev_nvme_opts *opts, size_t opts_size)
 	SET_FIELD(rdma_cm_event_timeout_ms, 0);
 	SET_FIELD(dhchap_digests, 0);
 	SET_FIELD(dhchap_dhgroups, 0);
+	SET_FIELD(poll_group_requests, 0);
 
 #undef SET_FIELD
 
 	/* Do not remove this statement, you should always update this statement when you adding a new field,
 	 * and do not forget to add the SET_FIELD statement for your added field. */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_nvme_opts) == 120, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_nvme_opts) == 128, "Incorrect size");
 }
 
 static bool bdev_nvme_check_io_error_resiliency_params(int32_t ctrlr_loss_timeout_sec,
@@ -6274,6 +6283,7 @@ spdk_bdev_nvme_set_opts(const struct spdk_bdev_nvme_opts *opts)
 	SET_FIELD(rdma_cm_event_timeout_ms, 0);
 	SET_FIELD(dhchap_digests, 0);
 	SET_FIELD(dhchap_dhgroups, 0);
+	SET_FIELD(poll_group_requests, 0);
 
 	g_opts.opts_size = opts->opts_size;
 
@@ -8833,6 +8843,7 @@ bdev_nvme_opts_config_json(struct spdk_json_write_ctx *w)
 	spdk_json_write_named_uint64(w, "nvme_adminq_poll_period_us", g_opts.nvme_adminq_poll_period_us);
 	spdk_json_write_named_uint64(w, "nvme_ioq_poll_period_us", g_opts.nvme_ioq_poll_period_us);
 	spdk_json_write_named_uint32(w, "io_queue_requests", g_opts.io_queue_requests);
+	spdk_json_write_named_uint32(w, "poll_group_requests", g_opts.poll_group_requests);
 	spdk_json_write_named_bool(w, "delay_cmd_submit", g_opts.delay_cmd_submit);
 	spdk_json_write_named_uint32(w, "transport_retry_count", g_opts.transport_retry_count);
 	spdk_json_write_named_int32(w, "bdev_retry_count", g_opts.bdev_retry_count);
@@ -55,6 +55,9 @@ struct spdk_posix_sock {
 
 	SSL_CTX			*ctx;
 	SSL			*ssl;
+	bool			ktls_checked;
+	bool			ktls_tx;
+	bool			ktls_rx;
 
 	TAILQ_ENTRY(spdk_posix_sock)	link;
 
@@ -926,6 +929,64 @@ SSL_writev(SSL *ssl, struct iovec *iov, int iovcnt)
 	}
 }
 
+/*
+ * Once the handshake is done, check whether OpenSSL handed the session keys over to the
+ * kernel.  If it did, the kernel takes care of the record layer and the data can be sent
+ * and received with a single vectored syscall, directly from and into the caller's
+ * buffers, instead of going through SSL_write()/SSL_read() for each iovec.
+ */
+static void
+posix_sock_check_ktls(struct spdk_posix_sock *sock)
+{
+	if (sock->ktls_checked || !sock->base.impl_opts.enable_ktls ||
+	    !SSL_is_init_finished(sock->ssl)) {
+		return;
+	}
+
+	sock->ktls_checked = true;
+#if defined(BIO_get_ktls_send) && defined(BIO_get_ktls_recv)
+	sock->ktls_tx = BIO_get_ktls_send(SSL_get_wbio(sock->ssl));
+	sock->ktls_rx = BIO_get_ktls_recv(SSL_get_rbio(sock->ssl));
+#endif
+	SPDK_DEBUGLOG(sock_posix, "kTLS on sock %p: tx %s, rx %s\n", sock,
+		      sock->ktls_tx ? "enabled" : "disabled", sock->ktls_rx ? "enabled" : "disabled");
+}
+
+static ssize_t
+posix_sock_ssl_readv(struct spdk_posix_sock *sock, struct iovec *iov, int iovcnt)
+{
+	ssize_t rc;
+
+	if (sock->ktls_rx && SSL_pending(sock->ssl) == 0) {
+		rc = readv(sock->fd, iov, iovcnt);
+		if (rc >= 0 || errno != EIO) {
+			return rc;
+		}
+		/* The kernel returns EIO when the next record is not application data
+		 * (e.g. a NewSessionTicket), so let OpenSSL process it. */
+	}
+
+	rc = SSL_readv(sock->ssl, iov, iovcnt);
+	posix_sock_check_ktls(sock);
+
+	return rc;
+}
+
+static ssize_t
+posix_sock_ssl_sendmsg(struct spdk_posix_sock *sock, struct msghdr *msg, int flags)
+{
+	ssize_t rc;
+
+	if (sock->ktls_tx) {
+		return sendmsg(sock->fd, msg, flags);
+	}
+
+	rc = SSL_writev(sock->ssl, msg->msg_iov, msg->msg_iovlen);
+	posix_sock_check_ktls(sock);
+
+	return rc;
+}
+
 static struct spdk_sock *
 posix_sock_create(const char *ip, int port,
 		  enum posix_sock_create_type type,
@@ -1387,7 +1448,7 @@ _sock_flush(struct spdk_sock *sock)
 	msg.msg_iovlen = iovcnt;
 
 	if (psock->ssl) {
-		rc = SSL_writev(psock->ssl, iovs, iovcnt);
+		rc = posix_sock_ssl_sendmsg(psock, &msg, flags);
 	} else {
 		rc = sendmsg(psock->fd, &msg, flags);
 	}
@@ -1536,7 +1597,7 @@ posix_sock_read(struct spdk_posix_sock *sock)
 	}
 
 	if (sock->ssl) {
-		bytes_recvd = SSL_readv(sock->ssl, iov, 2);
+		bytes_recvd = posix_sock_ssl_readv(sock, iov, 2);
 	} else {
 		bytes_recvd = readv(sock->fd, iov, 2);
 	}
@@ -1587,7 +1648,7 @@ posix_sock_readv(struct spdk_sock *_sock, struct iovec *iov, int iovcnt)
 			TAILQ_REMOVE(&group->socks_with_data, sock, link);
 		}
 		if (sock->ssl) {
-			return SSL_readv(sock->ssl, iov, iovcnt);
+			return posix_sock_ssl_readv(sock, iov, iovcnt);
 		} else {
 			return readv(sock->fd, iov, iovcnt);
 		}
@@ -1606,7 +1667,7 @@ posix_sock_readv(struct spdk_sock *_sock, struct iovec *iov, int iovcnt)
 		if (len >= MIN_SOCK_PIPE_SIZE) {
 			/* TODO: Should this detect if kernel socket is drained? */
 			if (sock->ssl) {
-				return SSL_readv(sock->ssl, iov, iovcnt);
+				return posix_sock_ssl_readv(sock, iov, iovcnt);
 			} else {
 				return readv(sock->fd, iov, iovcnt);
 			}
@@ -1653,7 +1714,12 @@ posix_sock_writev(struct spdk_sock *_sock, struct iovec *iov, int iovcnt)
 	}
 
 	if (sock->ssl) {
-		return SSL_writev(sock->ssl, iov, iovcnt);
+		struct msghdr msg = {
+			.msg_iov = iov,
+			.msg_iovlen = iovcnt,
+		};
+
+		return posix_sock_ssl_sendmsg(sock, &msg, MSG_NOSIGNAL);
 	} else {
 		return writev(sock->fd, iov, iovcnt);
 	}
@@ -79,12 +79,15 @@ def framework_get_governor(client):
     return client.call('framework_get_governor')
 
 
-def scheduler_set_options(client, scheduling_core=None, isolated_core_mask=None):
+def scheduler_set_options(client, scheduling_core=None, isolated_core_mask=None,
+                          work_stealing_threshold=None):
     params = {}
     if isolated_core_mask is not None:
         params['isolated_core_mask'] = isolated_core_mask
     if scheduling_core is not None:
         params['scheduling_core'] = scheduling_core
+    if work_stealing_threshold is not None:
+        params['work_stealing_threshold'] = work_stealing_threshold
     return client.call('scheduler_set_options', params)
 
 
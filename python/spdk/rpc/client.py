@@ -208,6 +208,35 @@ class JSONRPCClient(object):
 
         return response['result']
 
+    def call_batch(self, calls):
+        """Send multiple calls as a single JSON-RPC batch request
+
+        Args:
+            calls: list of (method, params) tuples
+
+        Returns:
+            List of responses (dictionaries with either 'result' or 'error'), in the
+            order of the calls.
+        """
+        if self.timeout <= 0:
+            raise JSONRPCException("Timeout value is invalid: %s\n" % self.timeout)
+        if not calls:
+            return []
+        ids = [self.add_request(method, params) for method, params in calls]
+        self._logger.debug("call_batch(%d calls)" % len(ids))
+        reqstr = json.dumps(self._reqs)
+        self._reqs = []
+        self._logger.info("Batch request:\n%s\n", reqstr)
+        self.sock.sendall(reqstr.encode("utf-8"))
+        response = self.recv()
+        if not isinstance(response, list):
+            # The whole batch was rejected, e.g. it was too large
+            raise JSONRPCException("Batch request failed:\n%s\n" % json.dumps(response, indent=2))
+
+        responses = {r.get('id'): r for r in response}
+        return [responses.get(id, {'error': {'code': -32603, 'message': 'No response'}})
+                for id in ids]
+
 
 class JSONRPCGoClient(object):
     INVALID_PARAMETER_ERROR = 1
@@ -203,30 +203,54 @@ def bdev_lvol_delete(client, name):
     return client.call('bdev_lvol_delete', params)
 
 
-def bdev_lvol_inflate(client, name):
+def bdev_lvol_inflate(client, name, queue_depth=None, clusters_per_sec=None):
     """Inflate a logical volume.
 
     Args:
         name: name of logical volume to inflate
+        queue_depth: maximum number of clusters copied concurrently (optional)
+        clusters_per_sec: maximum number of clusters copied per second (optional)
     """
     params = {
         'name': name,
     }
+    if queue_depth is not None:
+        params['queue_depth'] = queue_depth
+    if clusters_per_sec is not None:
+        params['clusters_per_sec'] = clusters_per_sec
     return client.call('bdev_lvol_inflate', params)
 
 
-def bdev_lvol_decouple_parent(client, name):
+def bdev_lvol_decouple_parent(client, name, queue_depth=None, clusters_per_sec=None):
     """Decouple parent of a logical volume.
 
     Args:
         name: name of logical volume to decouple parent
+        queue_depth: maximum number of clusters copied concurrently (optional)
+        clusters_per_sec: maximum number of clusters copied per second (optional)
     """
     params = {
         'name': name,
     }
+    if queue_depth is not None:
+        params['queue_depth'] = queue_depth
+    if clusters_per_sec is not None:
+        params['clusters_per_sec'] = clusters_per_sec
     return client.call('bdev_lvol_decouple_parent', params)
 
 
+def bdev_lvol_check_inflate(client, name):
+    """Get the progress of an inflate or decouple parent operation in progress on a logical volume.
+
+    Args:
+        name: name of logical volume being inflated
+    """
+    params = {
+        'name': name,
+    }
+    return client.call('bdev_lvol_check_inflate', params)
+
+
 def bdev_lvol_start_shallow_copy(client, src_lvol_name, dst_bdev_name):
     """Start a shallow copy of an lvol over a given bdev. The status of the operation
     can be obtained with bdev_lvol_check_shallow_copy
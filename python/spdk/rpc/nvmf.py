@@ -120,6 +120,7 @@ def nvmf_create_transport(client, **params):
         max_srq_depth: Max number of outstanding I/O per shared receive queue - RDMA specific (optional)
         no_srq: Boolean flag to disable SRQ even for devices that support it - RDMA specific (optional)
         c2h_success: Boolean flag to disable the C2H success optimization - TCP specific (optional)
+        c2h_zcopy: Send C2H data of reads from the bdev's zero-copy buffers - TCP specific (optional)
         dif_insert_or_strip: Boolean flag to enable DIF insert/strip for I/O - TCP specific (optional)
         acceptor_backlog: Pending connections allowed at one time - RDMA specific (optional)
         abort_timeout_sec: Abort execution timeout value, in seconds (optional)
@@ -651,6 +652,54 @@ def nvmf_subsystem_allow_any_host(client, nqn, disable, tgt_name=None):
     return client.call('nvmf_subsystem_allow_any_host', params)
 
 
+def nvmf_subsystem_set_fair_queuing(client, nqn, queue_depth, tgt_name=None):
+    """Enable or disable weighted fair queuing of I/O between the hosts of a subsystem.
+
+    Args:
+        nqn: Subsystem NQN.
+        queue_depth: Max I/O submitted per namespace per poll group, 0 to disable.
+        tgt_name: name of the parent NVMe-oF target (optional).
+
+    Returns:
+        True or False
+    """
+    params = {'nqn': nqn, 'queue_depth': queue_depth}
+
+    if tgt_name:
+        params['tgt_name'] = tgt_name
+
+    return client.call('nvmf_subsystem_set_fair_queuing', params)
+
+
+def nvmf_subsystem_set_host_fairness(client, nqn, host, cntlid=None, weight=None, min_iops=None,
+                                     tgt_name=None):
+    """Set the fair queuing weight and reserved IOPS of a host.
+
+    Args:
+        nqn: Subsystem NQN.
+        host: Host NQN.
+        cntlid: Controller ID the settings apply to, 0 for all controllers of the host (optional).
+        weight: Relative share of the namespace bandwidth, default 1 (optional).
+        min_iops: I/O per second per namespace and poll group dispatched ahead of other hosts (optional).
+        tgt_name: name of the parent NVMe-oF target (optional).
+
+    Returns:
+        True or False
+    """
+    params = {'nqn': nqn, 'host': host}
+
+    if cntlid is not None:
+        params['cntlid'] = cntlid
+    if weight is not None:
+        params['weight'] = weight
+    if min_iops is not None:
+        params['min_iops'] = min_iops
+    if tgt_name:
+        params['tgt_name'] = tgt_name
+
+    return client.call('nvmf_subsystem_set_host_fairness', params)
+
+
 def nvmf_delete_subsystem(client, nqn, tgt_name=None):
     """Delete an existing NVMe-oF subsystem.
 
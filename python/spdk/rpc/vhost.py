@@ -5,18 +5,21 @@
 from .cmd_parser import *
 
 
-def vhost_controller_set_coalescing(client, ctrlr, delay_base_us, iops_threshold):
+def vhost_controller_set_coalescing(client, ctrlr, delay_base_us, iops_threshold, max_coalesced_reqs=None):
     """Set coalescing for vhost controller.
     Args:
         ctrlr: controller name
         delay_base_us: base delay time
         iops_threshold: IOPS threshold when coalescing is enabled
+        max_coalesced_reqs: send an event once this many completions are pending (optional)
     """
     params = {
         'ctrlr': ctrlr,
         'delay_base_us': delay_base_us,
         'iops_threshold': iops_threshold,
     }
+    if max_coalesced_reqs is not None:
+        params['max_coalesced_reqs'] = max_coalesced_reqs
     return client.call('vhost_controller_set_coalescing', params)
 
 
@@ -110,6 +113,7 @@ def vhost_create_blk_controller(client, **params):
         transport: virtio blk transport name (default: vhost_user_blk)
         readonly: set controller as read-only
         packed_ring: support controller packed_ring
+        queue_cpumask: cpu mask to spread the virtqueues across (optional)
     """
     strip_globals(params)
     remove_null(params)
@@ -201,11 +201,14 @@ if __name__ == "__main__":
     def scheduler_set_options(args):
         rpc.app.scheduler_set_options(args.client,
                                       isolated_core_mask=args.isolated_core_mask,
-                                      scheduling_core=args.scheduling_core)
+                                      scheduling_core=args.scheduling_core,
+                                      work_stealing_threshold=args.work_stealing_threshold)
     p = subparsers.add_parser('scheduler_set_options', help='Set scheduler options')
     p.add_argument('-i', '--isolated-core-mask', help="Mask of CPU cores to isolate from scheduling change", type=str)
     p.add_argument('-s', '--scheduling-core', help="Scheduler scheduling core. Idle threads will move to scheduling core."
                    "Reserved for dynamic scheduler.", type=int)
+    p.add_argument('-w', '--work-stealing-threshold', help="Time in microseconds after which an idle reactor takes a busy "
+                   "thread from an overloaded reactor on the same NUMA node. 0 disables work stealing.", type=int)
     p.set_defaults(func=scheduler_set_options)
 
     def framework_disable_cpumask_locks(args):
@@ -626,7 +629,8 @@ if __name__ == "__main__":
                                        rdma_max_cq_size=args.rdma_max_cq_size,
                                        rdma_cm_event_timeout_ms=args.rdma_cm_event_timeout_ms,
                                        dhchap_digests=args.dhchap_digests,
-                                       dhchap_dhgroups=args.dhchap_dhgroups)
+                                       dhchap_dhgroups=args.dhchap_dhgroups,
+                                       poll_group_requests=args.poll_group_requests)
 
     p = subparsers.add_parser('bdev_nvme_set_options',
                               help='Set options for the bdev nvme type. This is startup command.')
@@ -713,6 +717,9 @@ if __name__ == "__main__":
                    type=lambda d: d.split(','))
     p.add_argument('--dhchap-dhgroups', help='Comma-separated list of allowed DH-HMAC-CHAP DH groups',
                    type=lambda d: d.split(','))
+    p.add_argument('--poll-group-requests',
+                   help='The number of requests shared by all NVMe I/O queues of a poll group. Default: 0 (disabled)',
+                   type=int)
 
     p.set_defaults(func=bdev_nvme_set_options)
 
@@ -2151,20 +2158,37 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
 
     def bdev_lvol_inflate(args):
         rpc.lvol.bdev_lvol_inflate(args.client,
-                                   name=args.name)
+                                   name=args.name,
+                                   queue_depth=args.queue_depth,
+                                   clusters_per_sec=args.clusters_per_sec)
 
     p = subparsers.add_parser('bdev_lvol_inflate', help='Make thin provisioned lvol a thick provisioned lvol')
     p.add_argument('name', help='lvol bdev name')
+    p.add_argument('-q', '--queue-depth', help='maximum number of clusters copied concurrently', type=int)
+    p.add_argument('-r', '--clusters-per-sec', help='maximum number of clusters copied per second', type=int)
     p.set_defaults(func=bdev_lvol_inflate)
 
     def bdev_lvol_decouple_parent(args):
         rpc.lvol.bdev_lvol_decouple_parent(args.client,
-                                           name=args.name)
+                                           name=args.name,
+                                           queue_depth=args.queue_depth,
+                                           clusters_per_sec=args.clusters_per_sec)
 
     p = subparsers.add_parser('bdev_lvol_decouple_parent', help='Decouple parent of lvol')
     p.add_argument('name', help='lvol bdev name')
+    p.add_argument('-q', '--queue-depth', help='maximum number of clusters copied concurrently', type=int)
+    p.add_argument('-r', '--clusters-per-sec', help='maximum number of clusters copied per second', type=int)
     p.set_defaults(func=bdev_lvol_decouple_parent)
 
+    def bdev_lvol_check_inflate(args):
+        print_json(rpc.lvol.bdev_lvol_check_inflate(args.client,
+                                                    name=args.name))
+
+    p = subparsers.add_parser('bdev_lvol_check_inflate',
+                              help='Get the progress of an inflate or decouple parent operation of lvol')
+    p.add_argument('name', help='lvol bdev name')
+    p.set_defaults(func=bdev_lvol_check_inflate)
+
     def bdev_lvol_resize(args):
         rpc.lvol.bdev_lvol_resize(args.client,
                                   name=args.name,
@@ -2551,12 +2575,15 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     def nbd_start_disk(args):
         print(rpc.nbd.nbd_start_disk(args.client,
                                      bdev_name=args.bdev_name,
-                                     nbd_device=args.nbd_device))
+                                     nbd_device=args.nbd_device,
+                                     num_connections=args.num_connections))
 
     p = subparsers.add_parser('nbd_start_disk',
                               help='Export a bdev as an nbd disk')
     p.add_argument('bdev_name', help='Blockdev name to be exported. Example: Malloc0.')
     p.add_argument('nbd_device', help='Nbd device name to be assigned. Example: /dev/nbd0.', nargs='?')
+    p.add_argument('-c', '--num-connections', help="""Number of connections to the kernel NBD driver,
+    each polled on its own SPDK thread. Default: 1.""", type=int)
     p.set_defaults(func=nbd_start_disk)
 
     def nbd_stop_disk(args):
@@ -2628,6 +2655,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-s', '--max-srq-depth', help='Max number of outstanding I/O per SRQ. Relevant only for RDMA transport', type=int)
     p.add_argument('-r', '--no-srq', action='store_true', help='Disable per-thread shared receive queue. Relevant only for RDMA transport')
     p.add_argument('-o', '--c2h-success', action='store_false', help='Disable C2H success optimization. Relevant only for TCP transport')
+    p.add_argument('--c2h-zcopy', action='store_true', help='''Send C2H data of reads from the bdev's zero-copy
+    buffers, even if zcopy is not enabled. Relevant only for TCP transport''')
     p.add_argument('-f', '--dif-insert-or-strip', action='store_true', help='Enable DIF insert/strip. Relevant only for TCP transport')
     p.add_argument('-y', '--sock-priority', help='The sock priority of the tcp connection. Relevant only for TCP transport', type=int)
     p.add_argument('-l', '--acceptor-backlog', help='Pending connections allowed at one time. Relevant only for RDMA transport', type=int)
@@ -2940,6 +2969,41 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
     p.set_defaults(func=nvmf_subsystem_allow_any_host)
 
+    def nvmf_subsystem_set_fair_queuing(args):
+        rpc.nvmf.nvmf_subsystem_set_fair_queuing(args.client,
+                                                 nqn=args.nqn,
+                                                 queue_depth=args.queue_depth,
+                                                 tgt_name=args.tgt_name)
+
+    p = subparsers.add_parser('nvmf_subsystem_set_fair_queuing',
+                              help='Enable weighted fair queuing of I/O between the hosts of a subsystem')
+    p.add_argument('nqn', help='NVMe-oF subsystem NQN')
+    p.add_argument('-q', '--queue-depth', help='Max I/O submitted per namespace per poll group, 0 disables fair queuing',
+                   type=int, required=True)
+    p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
+    p.set_defaults(func=nvmf_subsystem_set_fair_queuing)
+
+    def nvmf_subsystem_set_host_fairness(args):
+        rpc.nvmf.nvmf_subsystem_set_host_fairness(args.client,
+                                                  nqn=args.nqn,
+                                                  host=args.host,
+                                                  cntlid=args.cntlid,
+                                                  weight=args.weight,
+                                                  min_iops=args.min_iops,
+                                                  tgt_name=args.tgt_name)
+
+    p = subparsers.add_parser('nvmf_subsystem_set_host_fairness',
+                              help='Set the fair queuing weight and reserved IOPS of a host')
+    p.add_argument('nqn', help='NVMe-oF subsystem NQN')
+    p.add_argument('host', help='Host NQN')
+    p.add_argument('-c', '--cntlid', help='Controller ID the settings apply to, 0 for all controllers of the host',
+                   type=int)
+    p.add_argument('-w', '--weight', help='Relative share of the namespace bandwidth, 1 to 65536 (default: 1)', type=int)
+    p.add_argument('-m', '--min-iops', help='I/O per second per namespace and poll group dispatched ahead of other hosts',
+                   type=int)
+    p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
+    p.set_defaults(func=nvmf_subsystem_set_host_fairness)
+
     def nvmf_subsystem_get_controllers(args):
         print_dict(rpc.nvmf.nvmf_subsystem_get_controllers(args.client,
                                                            nqn=args.nqn,
@@ -3030,12 +3094,15 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
         rpc.vhost.vhost_controller_set_coalescing(args.client,
                                                   ctrlr=args.ctrlr,
                                                   delay_base_us=args.delay_base_us,
-                                                  iops_threshold=args.iops_threshold)
+                                                  iops_threshold=args.iops_threshold,
+                                                  max_coalesced_reqs=args.max_coalesced_reqs)
 
     p = subparsers.add_parser('vhost_controller_set_coalescing', help='Set vhost controller coalescing')
     p.add_argument('ctrlr', help='controller name')
     p.add_argument('delay_base_us', help='Base delay time', type=int)
     p.add_argument('iops_threshold', help='IOPS threshold when coalescing is enabled', type=int)
+    p.add_argument('-m', '--max-coalesced-reqs', help='Send an event once this many completions are pending '
+                   'on a queue, even if it is still delayed (0 - no limit)', type=int)
     p.set_defaults(func=vhost_controller_set_coalescing)
 
     def virtio_blk_create_transport(args):
@@ -3106,6 +3173,7 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--transport', help='virtio blk transport name (default: vhost_user_blk)')
     p.add_argument("-r", "--readonly", action='store_true', help='Set controller as read-only')
     p.add_argument("-p", "--packed_ring", action='store_true', help='Set controller as packed ring supported')
+    p.add_argument('--queue-cpumask', help='cpu mask to spread the virtqueues across, one thread per core')
     p.set_defaults(func=vhost_create_blk_controller)
 
     def vhost_get_controllers(args):
@@ -0,0 +1,208 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 agent <agent@local>.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/file.h"
+#include "spdk/json.h"
+#include "spdk/string.h"
+#include "spdk/util.h"
+
+/*
+ * This application measures the throughput of spdk_json_parse().  It can be used to measure
+ *  the effect of changes to the JSON parser.
+ *
+ * Each iteration parses the input the same way the JSON-RPC server and the JSON config loader
+ *  do: first to count the values, then again to decode them in place.  The input is either
+ *  read from a file (e.g. the output of save_config) or generated as a config creating the
+ *  given number of bdevs.
+ */
+
+struct perf_buf {
+	uint8_t *buf;
+	size_t len;
+	size_t size;
+};
+
+static void
+usage(const char *prog)
+{
+	printf("usage: %s [options]\n", prog);
+	printf("Options:\n");
+	printf(" -f <file>   parse the given JSON file\n");
+	printf(" -n <num>    number of bdevs in the generated config (default: 10000)\n");
+	printf(" -c          generate the config without any formatting\n");
+	printf(" -t <sec>    time to run for in seconds (default: 5)\n");
+}
+
+static int
+perf_buf_write_cb(void *cb_ctx, const void *data, size_t size)
+{
+	struct perf_buf *b = cb_ctx;
+	uint8_t *buf;
+
+	if (b->len + size > b->size) {
+		b->size = spdk_max(b->size * 2, b->len + size);
+		buf = realloc(b->buf, b->size);
+		if (buf == NULL) {
+			return -ENOMEM;
+		}
+		b->buf = buf;
+	}
+
+	memcpy(b->buf + b->len, data, size);
+	b->len += size;
+
+	return 0;
+}
+
+static int
+generate_config(struct perf_buf *b, uint32_t num_bdevs, bool formatted)
+{
+	struct spdk_json_write_ctx *w;
+	uint32_t i;
+
+	w = spdk_json_write_begin(perf_buf_write_cb, b,
+				  formatted ? SPDK_JSON_WRITE_FLAG_FORMATTED : 0);
+	if (w == NULL) {
+		return -ENOMEM;
+	}
+
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_array_begin(w, "subsystems");
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_string(w, "subsystem", "bdev");
+	spdk_json_write_named_array_begin(w, "config");
+	for (i = 0; i < num_bdevs; i++) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "method", "bdev_malloc_create");
+		spdk_json_write_named_object_begin(w, "params");
+		spdk_json_write_named_string_fmt(w, "name", "Malloc%u", i);
+		spdk_json_write_named_uint64(w, "num_blocks", 262144);
+		spdk_json_write_named_uint32(w, "block_size", 512);
+		spdk_json_write_named_uint32(w, "physical_block_size", 512);
+		spdk_json_write_named_string_fmt(w, "uuid", "%08x-1a2b-4c3d-8e4f-%012x", i, i);
+		spdk_json_write_named_uint32(w, "optimal_io_boundary", 0);
+		spdk_json_write_named_uint32(w, "md_size", 0);
+		spdk_json_write_named_bool(w, "md_interleave", false);
+		spdk_json_write_object_end(w);
+		spdk_json_write_object_end(w);
+	}
+	spdk_json_write_array_end(w);
+	spdk_json_write_object_end(w);
+	spdk_json_write_array_end(w);
+	spdk_json_write_object_end(w);
+
+	return spdk_json_write_end(w);
+}
+
+static uint64_t
+get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int
+main(int argc, char **argv)
+{
+	struct perf_buf b = {};
+	struct spdk_json_val *values = NULL;
+	uint8_t *work = NULL;
+	const char *file = NULL;
+	uint64_t start, end, elapsed = 0, count = 0;
+	uint32_t num_bdevs = 10000, run_time = 5;
+	bool formatted = true;
+	ssize_t num_values;
+	int ch, rc = 0;
+
+	while ((ch = getopt(argc, argv, "f:n:ct:")) != -1) {
+		switch (ch) {
+		case 'f':
+			file = optarg;
+			break;
+		case 'n':
+			num_bdevs = spdk_strtol(optarg, 10);
+			if ((int32_t)num_bdevs <= 0) {
+				fprintf(stderr, "Invalid number of bdevs: %s\n", optarg);
+				return 1;
+			}
+			break;
+		case 'c':
+			formatted = false;
+			break;
+		case 't':
+			run_time = spdk_strtol(optarg, 10);
+			if ((int32_t)run_time <= 0) {
+				fprintf(stderr, "Invalid time: %s\n", optarg);
+				return 1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (file != NULL) {
+		b.buf = spdk_posix_file_load_from_name(file, &b.len);
+		if (b.buf == NULL) {
+			fprintf(stderr, "Unable to read %s: %s\n", file, spdk_strerror(errno));
+			return 1;
+		}
+	} else if (generate_config(&b, num_bdevs, formatted) != 0) {
+		fprintf(stderr, "Unable to generate config\n");
+		rc = 1;
+		goto out;
+	}
+
+	work = malloc(b.len);
+	if (work == NULL) {
+		rc = 1;
+		goto out;
+	}
+
+	num_values = spdk_json_parse(b.buf, b.len, NULL, 0, NULL, 0);
+	if (num_values <= 0) {
+		fprintf(stderr, "Unable to parse JSON: %zd\n", num_values);
+		rc = 1;
+		goto out;
+	}
+
+	values = calloc(num_values, sizeof(*values));
+	if (values == NULL) {
+		rc = 1;
+		goto out;
+	}
+
+	end = get_time_ns() + run_time * 1000000000ULL;
+	do {
+		/* Decoding happens in place, so each iteration needs a fresh copy of the input */
+		memcpy(work, b.buf, b.len);
+
+		start = get_time_ns();
+		rc = spdk_json_parse(work, b.len, NULL, 0, NULL, 0) != num_values;
+		rc |= spdk_json_parse(work, b.len, values, num_values, NULL,
+				      SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE) != num_values;
+		elapsed += get_time_ns() - start;
+		count++;
+		if (rc != 0) {
+			fprintf(stderr, "Unexpected result of spdk_json_parse()\n");
+			goto out;
+		}
+	} while (get_time_ns() < end);
+
+	printf("Input: %zu bytes, %zd values\n", b.len, num_values);
+	printf("Parsed %" PRIu64 " times, %.3f ms per parse, %.1f MiB/s\n", count,
+	       (double)elapsed / count / 1000000,
+	       (double)b.len * count / ((double)elapsed / 1000000000) / (1024 * 1024));
+out:
+	free(values);
+	free(work);
+	free(b.buf);
+	return rc;
+}
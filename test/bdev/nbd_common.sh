@@ -142,6 +142,48 @@ function nbd_with_lvol_verify() {
 	nbd_stop_disks $rpc_server "$nbd"
 }
 
+function nbd_multi_conn_verify() {
+	local rpc_server=$1
+	local nbd=$2
+	local num_conns=4
+	local tmp_file=$SPDK_TEST_STORAGE/nbdmulticonn
+	local pids=() pid i
+
+	$rootdir/scripts/rpc.py -s $rpc_server bdev_malloc_create -b malloc_multi_conn 16 4096
+	$rootdir/scripts/rpc.py -s $rpc_server nbd_start_disk -c $num_conns malloc_multi_conn "$nbd"
+	waitfornbd $(basename "$nbd")
+
+	[[ $($rootdir/scripts/rpc.py -s $rpc_server nbd_get_disks -n "$nbd" | jq -r '.[0].num_connections') == "$num_conns" ]]
+
+	# Issue direct I/O to separate regions concurrently so that it is spread over the connections
+	dd if=/dev/urandom of=$tmp_file bs=1M count=16
+	for ((i = 0; i < num_conns; i++)); do
+		dd if=$tmp_file of="$nbd" bs=1M count=4 skip=$((i * 4)) seek=$((i * 4)) oflag=direct &
+		pids+=($!)
+	done
+	for pid in "${pids[@]}"; do
+		wait $pid
+	done
+
+	pids=()
+	for ((i = 0; i < num_conns; i++)); do
+		dd if="$nbd" of=$tmp_file.$i bs=1M count=4 skip=$((i * 4)) iflag=direct &
+		pids+=($!)
+	done
+	for pid in "${pids[@]}"; do
+		wait $pid
+	done
+	for ((i = 0; i < num_conns; i++)); do
+		cmp -n 4M -i $((i * 4))M:0 $tmp_file $tmp_file.$i
+		rm -f $tmp_file.$i
+	done
+	cmp -n 16M "$nbd" $tmp_file
+	rm -f $tmp_file
+
+	nbd_stop_disks $rpc_server "$nbd"
+	$rootdir/scripts/rpc.py -s $rpc_server bdev_malloc_delete malloc_multi_conn
+}
+
 function wait_for_nbd_set_capacity() {
 	local nbd=${1##*/}
 
@@ -20,6 +20,7 @@ fi
 run_test "spdk_dd_basic_rw" "$testdir/basic_rw.sh" "${nvmes[@]}"
 run_test "spdk_dd_posix" "$testdir/posix.sh"
 run_test "spdk_dd_malloc" "$testdir/malloc.sh"
+run_test "spdk_dd_parallel" "$testdir/parallel.sh"
 run_test "spdk_dd_bdev_to_bdev" "$testdir/bdev_to_bdev.sh" "${nvmes[@]}"
 if ((SPDK_TEST_URING == 1)); then
 	run_test "spdk_dd_uring" "$testdir/uring.sh"
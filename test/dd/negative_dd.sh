@@ -66,6 +66,18 @@ invalid_count() {
 		--count="-9"
 }
 
+invalid_threads() {
+	# --threads must be between 1 and the maximum
+	local threads
+
+	for threads in 0 -1 abc 1025; do
+		NOT "${DD_APP[@]}" \
+			--if="$test_file0" \
+			--of="$test_file1" \
+			--threads="$threads"
+	done
+}
+
 invalid_oflag() {
 	# --oflag may be used only with --of
 	NOT "${DD_APP[@]}" \
@@ -221,6 +233,7 @@ run_test "dd_no_output" no_output
 run_test "dd_wrong_blocksize" wrong_blocksize
 run_test "dd_smaller_blocksize" smaller_blocksize
 run_test "dd_invalid_count" invalid_count
+run_test "dd_invalid_threads" invalid_threads
 run_test "dd_invalid_oflag" invalid_oflag
 run_test "dd_invalid_iflag" invalid_iflag
 run_test "dd_unknown_flag" unknown_flag
@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+#  SPDX-License-Identifier: BSD-3-Clause
+#  Copyright (C) 2026 agent <agent@local>.
+#  All rights reserved.
+#
+testdir=$(readlink -f "$(dirname "$0")")
+rootdir=$(readlink -f "$testdir/../../")
+source "$testdir/common.sh"
+
+cleanup() {
+	rm -f "$aio0" "$aio1"
+}
+
+prepare() {
+	# 16M of data to copy, the output is large enough for a second copy behind it
+	dd if=/dev/urandom of="$aio0" bs=1M count=16
+	truncate -s 32M "$aio1"
+}
+
+copy_parallel() {
+	"${DD_APP[@]}" \
+		-m 0x3 \
+		--ib="$bdev0" \
+		--ob="$bdev1" \
+		--threads=4 \
+		--qd=8 \
+		--json <(gen_conf)
+
+	cmp -n 16M "$aio0" "$aio1"
+}
+
+copy_parallel_same_bdev() {
+	# Copy the first 8M of the output bdev behind the data copied before
+	"${DD_APP[@]}" \
+		-m 0x3 \
+		--ib="$bdev1" \
+		--ob="$bdev1" \
+		--bs=65536 \
+		--count=128 \
+		--seek=256 \
+		--threads=2 \
+		--json <(gen_conf)
+
+	cmp -n 8M -i 0:16M "$aio0" "$aio1"
+}
+
+aio0=$SPDK_TEST_STORAGE/dd.aio0 bdev0=aio0
+aio1=$SPDK_TEST_STORAGE/dd.aio1 bdev1=aio1
+
+declare -A method_bdev_aio_create_0=(
+	["name"]=$bdev0
+	["filename"]=$aio0
+	["block_size"]=4096
+)
+
+declare -A method_bdev_aio_create_1=(
+	["name"]=$bdev1
+	["filename"]=$aio1
+	["block_size"]=4096
+)
+
+trap "cleanup" EXIT
+
+prepare
+run_test "dd_copy_parallel" copy_parallel
+run_test "dd_copy_parallel_same_bdev" copy_parallel_same_bdev
@@ -14,6 +14,19 @@ TRACE_TMP_FOLDER=./tmp-trace
 TRACE_RECORD_OUTPUT=${TRACE_TMP_FOLDER}/record.trace
 TRACE_RECORD_NOTICE_LOG=${TRACE_TMP_FOLDER}/record.notice
 TRACE_TOOL_LOG=${TRACE_TMP_FOLDER}/trace.log
+# Streamed into 1MiB files, of which only the two newest are kept
+TRACE_STREAM_OUTPUT=${TRACE_TMP_FOLDER}/stream.trace
+TRACE_STREAM_NOTICE_LOG=${TRACE_TMP_FOLDER}/stream.notice
+# Streamed into a single file, to compare with the regular recording
+TRACE_STREAM_FULL_OUTPUT=${TRACE_TMP_FOLDER}/stream-full.trace
+TRACE_STREAM_FULL_NOTICE_LOG=${TRACE_TMP_FOLDER}/stream-full.notice
+TRACE_STREAM_DECODE_LOG=${TRACE_TMP_FOLDER}/stream-decode.log
+TRACE_STREAM_TOOL_LOG=${TRACE_TMP_FOLDER}/stream-trace.log
+TRACE_EVENTS_JSON=${TRACE_TMP_FOLDER}/events.json
+TRACE_ANALYZE_JSON=${TRACE_TMP_FOLDER}/analyze.json
+TRACE_ANALYZE_CSV=${TRACE_TMP_FOLDER}/analyze.csv
+# Number of slowest objects of each type reported by the latency analysis
+TRACE_ANALYZE_TOP=3
 
 delete_tmp_files() {
 	rm -rf $TRACE_TMP_FOLDER
@@ -55,6 +68,11 @@ mkdir -p ${TRACE_TMP_FOLDER}
 $rootdir/build/bin/spdk_trace_record -s iscsi -p ${iscsi_pid} -f ${TRACE_RECORD_OUTPUT} -q 1> ${TRACE_RECORD_NOTICE_LOG} &
 record_pid=$!
 echo "Trace record pid: $record_pid"
+$rootdir/build/bin/spdk_trace_record -s iscsi -p ${iscsi_pid} -f ${TRACE_STREAM_OUTPUT} -q -z -r 1 -n 2 1> ${TRACE_STREAM_NOTICE_LOG} &
+stream_pid=$!
+$rootdir/build/bin/spdk_trace_record -s iscsi -p ${iscsi_pid} -f ${TRACE_STREAM_FULL_OUTPUT} -q -z -r 1024 1> ${TRACE_STREAM_FULL_NOTICE_LOG} &
+stream_full_pid=$!
+echo "Trace stream pids: $stream_pid $stream_full_pid"
 
 RPCS=
 RPCS+="iscsi_create_portal_group $PORTAL_TAG $TARGET_IP:$ISCSI_PORT\n"
@@ -74,7 +92,7 @@ iscsiadm -m discovery -t sendtargets -p $TARGET_IP:$ISCSI_PORT
 iscsiadm -m node --login -p $TARGET_IP:$ISCSI_PORT
 waitforiscsidevices $((CONNECTION_NUMBER + 1))
 
-trap 'iscsicleanup; killprocess $iscsi_pid; killprocess $record_pid; delete_tmp_files; iscsitestfini; exit 1' SIGINT SIGTERM EXIT
+trap 'iscsicleanup; killprocess $iscsi_pid; killprocess $record_pid; killprocess $stream_pid; killprocess $stream_full_pid; delete_tmp_files; iscsitestfini; exit 1' SIGINT SIGTERM EXIT
 
 echo "Running FIO"
 $fio_py -p iscsi -i 131072 -d 32 -t randrw -r 1
@@ -93,8 +111,89 @@ trap 'delete_tmp_files; iscsitestfini; exit 1' SIGINT SIGTERM EXIT
 
 killprocess $iscsi_pid
 killprocess $record_pid
+killprocess $stream_pid
+killprocess $stream_full_pid
 $rootdir/build/bin/spdk_trace -f ${TRACE_RECORD_OUTPUT} > ${TRACE_TOOL_LOG}
 
+#verify that the stream rotation only kept the two newest files, and that they can be decoded
+stream_files="$(grep -o "into [0-9]* file(s)" ${TRACE_STREAM_NOTICE_LOG} | cut -d ' ' -f 2)"
+kept_files=(${TRACE_STREAM_OUTPUT}.*)
+echo "stream files written: $stream_files, kept: ${kept_files[*]}"
+if [ ${#kept_files[@]} -ne $((stream_files < 2 ? stream_files : 2)) ] \
+	|| [ ! -e ${TRACE_STREAM_OUTPUT}.$((stream_files - 1)) ]; then
+	echo "trace record test on iscsi: failure on stream file rotation check"
+	exit 1
+fi
+$rootdir/build/bin/spdk_trace_record -d ${TRACE_STREAM_OUTPUT}.$((stream_files - 1)) -f ${TRACE_STREAM_OUTPUT}.decoded
+$rootdir/build/bin/spdk_trace -f ${TRACE_STREAM_OUTPUT}.decoded > /dev/null
+
+#verify that the single stream file decodes to the entries of the regular recording, except
+#for the ones the streaming dropped
+$rootdir/build/bin/spdk_trace_record -d ${TRACE_STREAM_FULL_OUTPUT}.0 -f ${TRACE_STREAM_FULL_OUTPUT}.decoded > ${TRACE_STREAM_DECODE_LOG}
+$rootdir/build/bin/spdk_trace -f ${TRACE_STREAM_FULL_OUTPUT}.decoded > ${TRACE_STREAM_TOOL_LOG}
+
+declare -A record_entries stream_entries stream_dropped
+while read -r lcore num; do
+	record_entries[$lcore]=$num
+done < <(sed -n 's/^Trace Size of lcore (\([0-9]*\)): \([0-9]*\)$/\1 \2/p' ${TRACE_TOOL_LOG})
+while read -r lcore num; do
+	stream_entries[$lcore]=$num
+done < <(sed -n 's/^Trace Size of lcore (\([0-9]*\)): \([0-9]*\)$/\1 \2/p' ${TRACE_STREAM_TOOL_LOG})
+while read -r lcore num; do
+	stream_dropped[$lcore]=$num
+done < <(sed -n 's/^Decoded [0-9]* trace entries for lcore (\([0-9]*\)), \([0-9]*\) dropped$/\1 \2/p' ${TRACE_STREAM_DECODE_LOG})
+
+if [ ${#record_entries[@]} -ne ${#stream_dropped[@]} ]; then
+	echo "trace record test on iscsi: failure on stream lcore number check"
+	exit 1
+fi
+for lcore in "${!record_entries[@]}"; do
+	if [[ ! -v stream_dropped[$lcore] ]]; then
+		echo "trace record test on iscsi: failure on stream lcore check"
+		exit 1
+	fi
+	echo "lcore $lcore: ${record_entries[$lcore]} recorded, ${stream_entries[$lcore]:-0} streamed, ${stream_dropped[$lcore]} dropped"
+	if [ $((${stream_entries[$lcore]:-0} + ${stream_dropped[$lcore]})) -ne ${record_entries[$lcore]} ]; then
+		echo "trace record test on iscsi: failure on stream entries number check"
+		exit 1
+	fi
+done
+
+#verify that the latency analysis sees one object lifetime for each event creating an object
+$rootdir/build/bin/spdk_trace -j -f ${TRACE_RECORD_OUTPUT} > ${TRACE_EVENTS_JSON}
+$rootdir/build/bin/spdk_trace -a -j -n ${TRACE_ANALYZE_TOP} -f ${TRACE_RECORD_OUTPUT} > ${TRACE_ANALYZE_JSON}
+$rootdir/build/bin/spdk_trace -a -C -n ${TRACE_ANALYZE_TOP} -f ${TRACE_RECORD_OUTPUT} > ${TRACE_ANALYZE_CSV}
+
+declare -A event_objects lifetime_objects slowest_objects
+while read -r num object; do
+	event_objects[$object]=$num
+done < <(jq -r '[.tpoints[] | select(.new_object) | .id] as $new | .entries[]
+	| select(.tpoint as $t | any($new[]; . == $t)) | .object.id[0:1]' ${TRACE_EVENTS_JSON} | sort | uniq -c)
+while read -r object num; do
+	lifetime_objects[$object]=$num
+done < <(jq -r '.lifetimes[] | "\(.object) \(.count)"' ${TRACE_ANALYZE_JSON})
+while read -r num object; do
+	slowest_objects[$object]=$num
+done < <(jq -r '.slowest[].id[0:1]' ${TRACE_ANALYZE_JSON} | sort | uniq -c)
+
+if [ ${#event_objects[@]} -eq 0 ] || [ ${#event_objects[@]} -ne ${#lifetime_objects[@]} ] \
+	|| [ ${#event_objects[@]} -ne "$(grep -c '^lifetime,' ${TRACE_ANALYZE_CSV})" ]; then
+	echo "trace record test on iscsi: failure on object type number check"
+	exit 1
+fi
+for object in "${!event_objects[@]}"; do
+	echo "object $object: ${event_objects[$object]} created, ${lifetime_objects[$object]:-0} lifetimes, ${slowest_objects[$object]:-0} slowest"
+	if [ "${lifetime_objects[$object]:-0}" -ne ${event_objects[$object]} ]; then
+		echo "trace record test on iscsi: failure on object lifetime number check"
+		exit 1
+	fi
+	num=$((event_objects[$object] < TRACE_ANALYZE_TOP ? event_objects[$object] : TRACE_ANALYZE_TOP))
+	if [ "${slowest_objects[$object]:-0}" -ne $num ]; then
+		echo "trace record test on iscsi: failure on slowest object number check"
+		exit 1
+	fi
+done
+
 #verify trace record and trace tool
 #trace entries str in trace-record, like "Trace Size of lcore (0): 4136"
 record_num="$(grep "trace entries for lcore" ${TRACE_RECORD_NOTICE_LOG} | cut -d ' ' -f 2)"
@@ -140,6 +140,27 @@ setup_nvmf_tgt $key_path
 subnqn:nqn.2016-06.io.spdk:cnode1 hostnqn:nqn.2016-06.io.spdk:host1" \
 	--psk-path $key_path "${NO_HUGE[@]}"
 
+# kTLS requires the tls ULP in the kernel and OpenSSL built with enable-ktls (which is
+# when its s_client has the -ktls option).
+ktls_supported() {
+	modprobe -q tls || return 1
+	grep -qw tls /proc/sys/net/ipv4/tcp_available_ulp || return 1
+	openssl s_client -help 2>&1 | grep -q -- '-ktls'
+}
+
+# Compare the throughput of userspace TLS and kTLS on the host side.
+if ktls_supported; then
+	for ktls in disable enable; do
+		echo "spdk_nvme_perf with --$ktls-ktls:"
+		"${NVMF_TARGET_NS_CMD[@]}" $SPDK_BIN_DIR/spdk_nvme_perf -S ssl --$ktls-ktls -q 64 -o 131072 \
+			-w read -t 10 -r "trtype:${TEST_TRANSPORT} adrfam:IPv4 traddr:${NVMF_FIRST_TARGET_IP} \
+trsvcid:${NVMF_PORT} subnqn:nqn.2016-06.io.spdk:cnode1 hostnqn:nqn.2016-06.io.spdk:host1" \
+			--psk-path $key_path "${NO_HUGE[@]}"
+	done
+else
+	echo "kTLS is not supported, skipping userspace TLS vs kTLS comparison"
+fi
+
 # Check connectivity with bdevperf with 32 bytes long key
 run_bdevperf nqn.2016-06.io.spdk:cnode1 nqn.2016-06.io.spdk:host1 "$key_path"
 
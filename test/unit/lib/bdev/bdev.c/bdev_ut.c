@@ -3445,6 +3445,85 @@ bdev_io_alignment(void)
 	free(buf);
 }
 
+static void
+bdev_io_sg_buf(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *io_ch;
+	struct spdk_bdev_opts bdev_opts = {};
+	struct spdk_iobuf_opts iobuf_opts = {};
+	struct spdk_bdev_io_sg_buf *sg;
+	uint64_t bufsize, num_blocks;
+	int rc;
+
+	spdk_bdev_get_opts(&bdev_opts, sizeof(bdev_opts));
+	bdev_opts.bdev_io_pool_size = 20;
+	bdev_opts.bdev_io_cache_size = 2;
+	ut_init_bdev(&bdev_opts);
+	spdk_iobuf_get_opts(&iobuf_opts, sizeof(iobuf_opts));
+
+	fn_table.submit_request = stub_submit_request_get_buf;
+	bdev = allocate_bdev("bdev0");
+
+	rc = spdk_bdev_open_ext("bdev0", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	CU_ASSERT(io_ch != NULL);
+
+	/* A read larger than a single large buffer should get several of them */
+	bufsize = iobuf_opts.large_bufsize / bdev->blocklen * bdev->blocklen;
+	num_blocks = (bufsize * 2) / bdev->blocklen + 8;
+	SPDK_CU_ASSERT_FATAL(num_blocks <= bdev->blockcnt);
+
+	g_io_done = false;
+	rc = spdk_bdev_read_blocks(desc, io_ch, NULL, 0, num_blocks, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_io->internal.f.sg_buf == true);
+	CU_ASSERT(g_bdev_io->internal.f.has_buf == true);
+	sg = g_bdev_io->internal.buf.sg;
+	SPDK_CU_ASSERT_FATAL(sg != NULL);
+	CU_ASSERT(sg->bdev_io == g_bdev_io);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs == sg->iovs);
+	SPDK_CU_ASSERT_FATAL(g_bdev_io->u.bdev.iovcnt == 3);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs[0].iov_base != NULL);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs[0].iov_len == bufsize);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs[1].iov_base != NULL);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs[1].iov_len == bufsize);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs[2].iov_base != NULL);
+	CU_ASSERT(g_bdev_io->u.bdev.iovs[2].iov_len == 8 * bdev->blocklen);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+	CU_ASSERT(g_bdev_io->internal.f.sg_buf == false);
+	CU_ASSERT(g_bdev_io->internal.f.has_buf == false);
+
+	/* The buffer state is reused by the next one */
+	g_io_done = false;
+	rc = spdk_bdev_read_blocks(desc, io_ch, NULL, 0, num_blocks, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_io->internal.f.sg_buf == true);
+	CU_ASSERT(g_bdev_io->internal.buf.sg == sg);
+	CU_ASSERT(g_bdev_io->u.bdev.iovcnt == 3);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+
+	/* A plain read doesn't use it */
+	g_io_done = false;
+	rc = spdk_bdev_read_blocks(desc, io_ch, NULL, 0, 8, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_io->internal.f.sg_buf == false);
+	CU_ASSERT(g_bdev_io->u.bdev.iovcnt == 1);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	fn_table.submit_request = stub_submit_request;
+	ut_fini_bdev();
+}
+
 static void
 bdev_io_alignment_with_boundary(void)
 {
@@ -7783,6 +7862,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, bdev_io_write_unit_split_test);
 	CU_ADD_TEST(suite, bdev_io_alignment_with_boundary);
 	CU_ADD_TEST(suite, bdev_io_alignment);
+	CU_ADD_TEST(suite, bdev_io_sg_buf);
 	CU_ADD_TEST(suite, bdev_histograms);
 	CU_ADD_TEST(suite, bdev_write_zeroes);
 	CU_ADD_TEST(suite, bdev_compare_and_write);
@@ -1179,6 +1179,176 @@ blob_inflate(void)
 	_blob_inflate(true);
 }
 
+static uint64_t g_inflate_copied_clusters;
+static uint64_t g_inflate_total_clusters;
+
+static void
+blob_inflate_status(uint64_t copied_clusters, uint64_t total_clusters, void *cb_arg)
+{
+	g_inflate_copied_clusters = copied_clusters;
+	g_inflate_total_clusters = total_clusters;
+}
+
+/*
+ * Inflate a new 10 cluster clone of snapshotid at the given rate and check the number of clusters
+ * copied every 100ms. Up to 100ms worth of clusters, at least one, may be copied right away.
+ */
+static void
+blob_inflate_ext_rate(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+		      spdk_blob_id snapshotid, uint64_t clusters_per_sec)
+{
+	struct spdk_bs_inflate_opts inflate_opts;
+	struct spdk_blob *clone;
+	uint64_t burst, expected;
+	int i, j;
+
+	spdk_bs_create_clone(bs, snapshotid, NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	spdk_bs_open_blob(bs, g_blobid, blob_op_with_handle_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_blob != NULL);
+	clone = g_blob;
+
+	spdk_bs_inflate_opts_init(&inflate_opts, sizeof(inflate_opts));
+	inflate_opts.queue_depth = 4;
+	inflate_opts.clusters_per_sec = clusters_per_sec;
+	inflate_opts.status_cb_fn = blob_inflate_status;
+	g_inflate_copied_clusters = 0;
+	g_bserrno = -1;
+
+	spdk_bs_inflate_blob_ext(bs, channel, g_blobid, &inflate_opts, blob_op_complete, NULL);
+	poll_threads();
+
+	/* In tenths of a cluster */
+	burst = spdk_max(clusters_per_sec, 10);
+	for (i = 0; g_bserrno == -1; i++) {
+		/* Allow the copy due exactly at this point to still be pending */
+		expected = spdk_min((burst + clusters_per_sec * i) / 10, 10);
+		CU_ASSERT(g_inflate_copied_clusters <= expected);
+		CU_ASSERT(g_inflate_copied_clusters + 1 >= expected);
+		SPDK_CU_ASSERT_FATAL(i < 100);
+
+		for (j = 0; j < 100; j++) {
+			spdk_delay_us(1000);
+			poll_threads();
+		}
+	}
+
+	/* The last cluster was copied on time */
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_inflate_copied_clusters == 10);
+	CU_ASSERT((burst + clusters_per_sec * (i - 2)) / 10 < 10);
+	CU_ASSERT((burst + clusters_per_sec * i) / 10 >= 10);
+
+	ut_blob_close_and_delete(bs, clone);
+}
+
+static void
+blob_inflate_ext(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob_opts opts;
+	struct spdk_bs_inflate_opts inflate_opts;
+	struct spdk_blob *blob, *clone;
+	spdk_blob_id blobid, snapshotid, cloneid;
+	struct spdk_io_channel *channel;
+	uint64_t free_clusters;
+	int i;
+
+	channel = spdk_bs_alloc_io_channel(bs);
+	SPDK_CU_ASSERT_FATAL(channel != NULL);
+
+	/* Create a thick blob with 10 clusters and make it a clone of its snapshot */
+	ut_spdk_blob_opts_init(&opts);
+	opts.num_clusters = 10;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+	blobid = spdk_blob_get_id(blob);
+
+	spdk_bs_create_snapshot(bs, blobid, NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
+	snapshotid = g_blobid;
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 0);
+
+	free_clusters = spdk_bs_free_cluster_count(bs);
+
+	/* 1) Copy up to 4 clusters at a time, with progress reported */
+	spdk_bs_inflate_opts_init(&inflate_opts, sizeof(inflate_opts));
+	CU_ASSERT(inflate_opts.queue_depth == 1);
+	CU_ASSERT(inflate_opts.clusters_per_sec == 0);
+	inflate_opts.queue_depth = 4;
+	inflate_opts.status_cb_fn = blob_inflate_status;
+	g_inflate_copied_clusters = 0;
+	g_inflate_total_clusters = 0;
+
+	spdk_bs_inflate_blob_ext(bs, channel, blobid, &inflate_opts, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_inflate_copied_clusters == 10);
+	CU_ASSERT(g_inflate_total_clusters == 10);
+	CU_ASSERT(spdk_bs_free_cluster_count(bs) == free_clusters - 10);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(blob) == 10);
+	CU_ASSERT(spdk_blob_is_thin_provisioned(blob) == false);
+
+	/* 2) Limit the rate to 20 clusters per second, i.e. 2 clusters per 100ms slice */
+	spdk_bs_create_clone(bs, snapshotid, NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	cloneid = g_blobid;
+
+	spdk_bs_open_blob(bs, cloneid, blob_op_with_handle_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_blob != NULL);
+	clone = g_blob;
+
+	inflate_opts.clusters_per_sec = 20;
+	g_inflate_copied_clusters = 0;
+	g_bserrno = -1;
+
+	spdk_bs_inflate_blob_ext(bs, channel, cloneid, &inflate_opts, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_inflate_copied_clusters == 2);
+	CU_ASSERT(g_bserrno == -1);
+
+	for (i = 2; i <= 5; i++) {
+		spdk_delay_us(100 * 1000);
+		poll_threads();
+		CU_ASSERT(g_inflate_copied_clusters == 2 * (uint64_t)i);
+	}
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(spdk_blob_get_num_allocated_clusters(clone) == 10);
+	CU_ASSERT(spdk_blob_is_thin_provisioned(clone) == false);
+
+	/* 3) Rates that aren't a multiple of 10 clusters per second are honored */
+	blob_inflate_ext_rate(bs, channel, snapshotid, 15);
+
+	/* 4) Rates below 10 clusters per second are honored */
+	blob_inflate_ext_rate(bs, channel, snapshotid, 3);
+
+	/* 5) Inflating a blob that's already fully allocated has nothing to copy */
+	g_inflate_copied_clusters = 0;
+	spdk_bs_inflate_blob_ext(bs, channel, cloneid, &inflate_opts, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_inflate_copied_clusters == 0);
+
+	spdk_bs_free_io_channel(channel);
+	poll_threads();
+
+	ut_blob_close_and_delete(bs, clone);
+	ut_blob_close_and_delete(bs, blob);
+
+	spdk_bs_delete_blob(bs, snapshotid, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+}
+
 static void
 blob_delete(void)
 {
@@ -10123,6 +10293,7 @@ main(int argc, char **argv)
 		CU_ADD_TEST(suite_bs, blob_snapshot);
 		CU_ADD_TEST(suite_bs, blob_clone);
 		CU_ADD_TEST(suite_bs, blob_inflate);
+		CU_ADD_TEST(suite_bs, blob_inflate_ext);
 		CU_ADD_TEST(suite_bs, blob_delete);
 		CU_ADD_TEST(suite_bs, blob_resize_test);
 		CU_ADD_TEST(suite_bs, blob_resize_thin_test);
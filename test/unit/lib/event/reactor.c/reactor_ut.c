@@ -874,6 +874,114 @@ test_bind_thread(void)
 	free_cores();
 }
 
+static void
+test_work_stealing(void)
+{
+	struct spdk_cpuset cpuset = {};
+	struct spdk_thread *thread[2];
+	struct spdk_lw_thread *lw_thread;
+	struct spdk_reactor *reactor0, *reactor1;
+	struct spdk_poller *busy[2];
+	int i;
+
+	MOCK_SET(spdk_env_get_current_core, 0);
+
+	allocate_cores(2);
+
+	CU_ASSERT(spdk_reactors_init(SPDK_DEFAULT_MSG_MEMPOOL_SIZE) == 0);
+
+	/* Work stealing skips isolated cores, make sure none are left from other tests. */
+	spdk_cpuset_zero(&g_scheduler_isolated_core_mask);
+
+	/* spdk_get_ticks_hz() is 1000000, so the threshold is 100 ticks. */
+	scheduler_set_work_stealing_threshold(100);
+	CU_ASSERT(scheduler_get_work_stealing_threshold() == 100);
+
+	reactor0 = spdk_reactor_get(0);
+	SPDK_CU_ASSERT_FATAL(reactor0 != NULL);
+	reactor1 = spdk_reactor_get(1);
+	SPDK_CU_ASSERT_FATAL(reactor1 != NULL);
+
+	/* Create two threads on core 0. The first one becomes the app thread. */
+	spdk_cpuset_set_cpu(&cpuset, 0, true);
+	for (i = 0; i < 2; i++) {
+		thread[i] = spdk_thread_create(NULL, &cpuset);
+		SPDK_CU_ASSERT_FATAL(thread[i] != NULL);
+	}
+	CU_ASSERT(event_queue_run_batch(reactor0) == 2);
+	CU_ASSERT(reactor0->thread_count == 2);
+
+	/* Allow both threads to run on core 1 from now on. */
+	for (i = 0; i < 2; i++) {
+		spdk_cpuset_set_cpu(spdk_thread_get_cpumask(thread[i]), 1, true);
+		spdk_set_thread(thread[i]);
+		busy[i] = spdk_poller_register(poller_run_busy, (void *)50, 0);
+		CU_ASSERT(busy[i] != NULL);
+	}
+	spdk_set_thread(NULL);
+
+	MOCK_SET(spdk_get_ticks, 100);
+	reactor0->tsc_last = 100;
+	reactor1->tsc_last = 100;
+
+	/* Both threads on core 0 are busy. */
+	_reactor_run(reactor0);
+	CU_ASSERT(reactor0->tsc_last == 200);
+	CU_ASSERT(reactor0->steal_lcore == SPDK_ENV_LCORE_ID_ANY);
+
+	/* Core 1 has been idle for long enough and asks core 0 for a thread. */
+	MOCK_SET(spdk_env_get_current_core, 1);
+	_reactor_run(reactor1);
+	CU_ASSERT(reactor0->steal_lcore == 1);
+
+	/* Core 0 gives away the thread that isn't the app thread. */
+	MOCK_SET(spdk_env_get_current_core, 0);
+	_reactor_run(reactor0);
+	CU_ASSERT(reactor0->steal_lcore == SPDK_ENV_LCORE_ID_ANY);
+	CU_ASSERT(reactor0->thread_count == 1);
+	CU_ASSERT(reactor0->stolen_count == 1);
+	CU_ASSERT(reactor1->steal_count == 1);
+
+	MOCK_SET(spdk_env_get_current_core, 1);
+	CU_ASSERT(event_queue_run_batch(reactor1) == 1);
+	lw_thread = TAILQ_FIRST(&reactor1->threads);
+	SPDK_CU_ASSERT_FATAL(lw_thread != NULL);
+	CU_ASSERT(spdk_thread_get_from_ctx(lw_thread) == thread[1]);
+	CU_ASSERT(lw_thread->lcore == 1);
+
+	/* Each core runs a single busy thread now, nothing is stolen anymore. */
+	MOCK_SET(spdk_get_ticks, 1000);
+	for (i = 0; i < 2; i++) {
+		MOCK_SET(spdk_env_get_current_core, 1 - i);
+		_reactor_run(spdk_reactor_get(1 - i));
+	}
+	CU_ASSERT(reactor0->steal_lcore == SPDK_ENV_LCORE_ID_ANY);
+	CU_ASSERT(reactor1->steal_lcore == SPDK_ENV_LCORE_ID_ANY);
+	CU_ASSERT(reactor0->thread_count == 1);
+	CU_ASSERT(reactor1->thread_count == 1);
+
+	scheduler_set_work_stealing_threshold(0);
+
+	/* Destroy threads */
+	for (i = 0; i < 2; i++) {
+		spdk_set_thread(thread[i]);
+		spdk_poller_unregister(&busy[i]);
+		spdk_thread_exit(thread[i]);
+	}
+	for (i = 0; i < 2; i++) {
+		MOCK_SET(spdk_env_get_current_core, i);
+		reactor_run(spdk_reactor_get(i));
+	}
+
+	spdk_set_thread(NULL);
+
+	MOCK_CLEAR(spdk_env_get_current_core);
+
+	spdk_reactors_fini();
+
+	free_cores();
+}
+
 #ifndef __FreeBSD__
 uint8_t g_curr_freq;
 
@@ -1249,6 +1357,7 @@ main(int argc, char **argv)
 #endif
 	CU_ADD_TEST(suite, test_scheduler_set_isolated_core_mask);
 	CU_ADD_TEST(suite, test_mixed_workload);
+	CU_ADD_TEST(suite, test_work_stealing);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
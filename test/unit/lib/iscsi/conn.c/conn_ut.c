@@ -6,7 +6,7 @@
 
 #include "spdk/stdinc.h"
 
-#include "common/lib/test_env.c"
+#include "common/lib/ut_multithread.c"
 #include "spdk_internal/cunit.h"
 
 #include "iscsi/conn.c"
@@ -22,8 +22,34 @@ DEFINE_STUB(iscsi_get_pdu, struct spdk_iscsi_pdu *,
 DEFINE_STUB(iscsi_param_eq_val, int,
 	    (struct iscsi_param *params, const char *key, const char *val), 0);
 DEFINE_STUB(iscsi_pdu_calc_data_digest, uint32_t, (struct spdk_iscsi_pdu *pdu), 0);
-DEFINE_STUB_V(spdk_sock_writev_async,
-	      (struct spdk_sock *sock, struct spdk_sock_request *req));
+DEFINE_STUB(iscsi_data_digest_finish, uint32_t, (uint32_t crc32c, uint32_t data_len), 0);
+
+#define UT_MAX_WRITTEN_PDUS	4
+
+static struct spdk_iscsi_pdu *g_written_pdus[UT_MAX_WRITTEN_PDUS];
+static int g_num_written_pdus;
+
+void
+spdk_sock_writev_async(struct spdk_sock *sock, struct spdk_sock_request *req)
+{
+	if (g_num_written_pdus < UT_MAX_WRITTEN_PDUS) {
+		g_written_pdus[g_num_written_pdus] = req->cb_arg;
+	}
+	g_num_written_pdus++;
+}
+
+static spdk_accel_completion_cb g_digest_cb_fn;
+
+DEFINE_RETURN_MOCK(iscsi_pdu_submit_data_digest, int);
+int
+iscsi_pdu_submit_data_digest(struct spdk_io_channel *accel_ch, struct spdk_iscsi_pdu *pdu,
+			     uint32_t data_len, spdk_accel_completion_cb cb_fn)
+{
+	HANDLE_RETURN_MOCK(iscsi_pdu_submit_data_digest);
+
+	g_digest_cb_fn = cb_fn;
+	return 0;
+}
 
 struct spdk_scsi_lun {
 	uint8_t reserved;
@@ -886,6 +912,107 @@ abort_queued_datain_tasks_test(void)
 	g_new_task = NULL;
 }
 
+static int
+ut_accel_ch_create(void *io_device, void *ctx_buf)
+{
+	return 0;
+}
+
+static void
+ut_accel_ch_destroy(void *io_device, void *ctx_buf)
+{
+}
+
+static void
+write_pdu_with_data_digest_offload(void)
+{
+	struct spdk_iscsi_conn conn = {};
+	struct spdk_iscsi_poll_group pg = {};
+	struct spdk_iscsi_pdu pdu1 = {}, pdu2 = {}, pdu3 = {};
+	int accel_dev, rc;
+
+	allocate_threads(1);
+	set_thread(0);
+
+	spdk_io_device_register(&accel_dev, ut_accel_ch_create, ut_accel_ch_destroy, 0, "ut_accel");
+	pg.accel_channel = spdk_get_io_channel(&accel_dev);
+	SPDK_CU_ASSERT_FATAL(pg.accel_channel != NULL);
+
+	TAILQ_INIT(&conn.write_pdu_list);
+	TAILQ_INIT(&conn.snack_pdu_list);
+	TAILQ_INIT(&conn.queued_datain_tasks);
+	STAILQ_INIT(&conn.send_pdu_list);
+	conn.pg = &pg;
+	conn.data_digest = true;
+	conn.state = ISCSI_CONN_STATE_RUNNING;
+
+	pdu1.conn = &conn;
+	pdu1.bhs.opcode = ISCSI_OP_SCSI_DATAIN;
+	DSET24(pdu1.bhs.data_segment_len, 512);
+	pdu2.conn = &conn;
+	pdu2.bhs.opcode = ISCSI_OP_NOPIN;
+	pdu3.conn = &conn;
+	pdu3.bhs.opcode = ISCSI_OP_SCSI_DATAIN;
+	DSET24(pdu3.bhs.data_segment_len, 512);
+
+	g_num_written_pdus = 0;
+
+	/* The PDU is held back until accel computes its data digest. */
+	iscsi_conn_write_pdu(&conn, &pdu1, iscsi_conn_pdu_dummy_complete, NULL);
+	CU_ASSERT(g_num_written_pdus == 0);
+	CU_ASSERT(pdu1.digest_pending);
+	CU_ASSERT(conn.pending_digest_cnt == 1);
+	SPDK_CU_ASSERT_FATAL(g_digest_cb_fn != NULL);
+
+	/* PDUs without data must not overtake it. */
+	iscsi_conn_write_pdu(&conn, &pdu2, iscsi_conn_pdu_dummy_complete, NULL);
+	CU_ASSERT(g_num_written_pdus == 0);
+
+	MOCK_SET(iscsi_data_digest_finish, 0x12345678);
+	g_digest_cb_fn(&pdu1, 0);
+	MOCK_CLEAR(iscsi_data_digest_finish);
+	CU_ASSERT(!pdu1.digest_pending);
+	CU_ASSERT(conn.pending_digest_cnt == 0);
+	CU_ASSERT(from_le32(pdu1.data_digest) == 0x12345678);
+	CU_ASSERT(g_num_written_pdus == 2);
+	CU_ASSERT(g_written_pdus[0] == &pdu1);
+	CU_ASSERT(g_written_pdus[1] == &pdu2);
+	CU_ASSERT(STAILQ_EMPTY(&conn.send_pdu_list));
+
+	/* Fall back to the inline calculation if the submission fails. */
+	MOCK_SET(iscsi_pdu_submit_data_digest, -ENOMEM);
+	iscsi_conn_write_pdu(&conn, &pdu3, iscsi_conn_pdu_dummy_complete, NULL);
+	MOCK_CLEAR(iscsi_pdu_submit_data_digest);
+	CU_ASSERT(!pdu3.digest_pending);
+	CU_ASSERT(conn.pending_digest_cnt == 0);
+	CU_ASSERT(g_num_written_pdus == 3);
+	CU_ASSERT(g_written_pdus[2] == &pdu3);
+
+	/* The connection cannot be freed while a digest is outstanding. */
+	TAILQ_INIT(&conn.write_pdu_list);
+	pdu1.cb_fn = NULL;
+	g_digest_cb_fn = NULL;
+	iscsi_conn_write_pdu(&conn, &pdu1, iscsi_conn_pdu_dummy_complete, NULL);
+	SPDK_CU_ASSERT_FATAL(g_digest_cb_fn != NULL);
+	conn.state = ISCSI_CONN_STATE_EXITING;
+
+	rc = iscsi_conn_free_tasks(&conn);
+	CU_ASSERT(rc == -1);
+	CU_ASSERT(TAILQ_FIRST(&conn.write_pdu_list) == &pdu1);
+
+	g_digest_cb_fn(&pdu1, 0);
+	CU_ASSERT(g_num_written_pdus == 3);
+
+	rc = iscsi_conn_free_tasks(&conn);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_EMPTY(&conn.write_pdu_list));
+
+	spdk_put_io_channel(pg.accel_channel);
+	poll_threads();
+	spdk_io_device_unregister(&accel_dev, NULL);
+	free_threads();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -904,6 +1031,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, free_tasks_with_queued_datain);
 	CU_ADD_TEST(suite, abort_queued_datain_task_test);
 	CU_ADD_TEST(suite, abort_queued_datain_tasks_test);
+	CU_ADD_TEST(suite, write_pdu_with_data_digest_offload);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
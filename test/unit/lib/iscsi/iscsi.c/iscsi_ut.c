@@ -91,6 +91,13 @@ DEFINE_STUB(iscsi_chap_get_authinfo, int,
 
 DEFINE_STUB(spdk_sock_set_recvbuf, int, (struct spdk_sock *sock, int sz), 0);
 
+DEFINE_STUB(iscsi_conn_get_accel_channel, struct spdk_io_channel *,
+	    (struct spdk_iscsi_conn *conn), NULL);
+
+DEFINE_STUB(spdk_accel_submit_crc32cv, int,
+	    (struct spdk_io_channel *ch, uint32_t *crc_dst, struct iovec *iovs, uint32_t iovcnt,
+	     uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg), 0);
+
 int
 spdk_scsi_lun_get_id(const struct spdk_scsi_lun *lun)
 {
@@ -6,6 +6,7 @@
 #include "spdk/stdinc.h"
 
 #include "spdk_internal/cunit.h"
+#include "spdk/util.h"
 
 #include "json/json_parse.c"
 
@@ -170,6 +171,74 @@ test_parse_string_simple(void)
 	VAL_STRING("hello world");
 }
 
+static void
+test_parse_string_long(void)
+{
+	/* Special sequences at every offset of strings spanning multiple scan blocks */
+	static const struct {
+		const char *in;
+		const char *out;
+		ssize_t rc;
+	} specials[] = {
+		{"", "", 1},
+		{"\\n", "\n", 1},
+		{"\\\"", "\"", 1},
+		{"\\u00e9", "\xc3\xa9", 1},
+		{"\xc3\xa9", "\xc3\xa9", 1},
+		{"\xe2\x82\xac", "\xe2\x82\xac", 1},
+		{"\x01", NULL, SPDK_JSON_PARSE_INVALID},
+		{"\x7f", "\x7f", 1},
+		{"\xff", NULL, SPDK_JSON_PARSE_INVALID},
+	};
+	char expected[256];
+	const char *in, *out;
+	size_t i, len, pos, in_len, out_len;
+	ssize_t rc;
+
+	for (i = 0; i < SPDK_COUNTOF(specials); i++) {
+		in = specials[i].in;
+		out = specials[i].out;
+		for (len = 0; len < 80; len++) {
+			for (pos = 0; pos <= len; pos++) {
+				memset(g_buf, 0, sizeof(g_buf));
+				in_len = 0;
+				g_buf[in_len++] = '"';
+				memset(&g_buf[in_len], 'a', pos);
+				in_len += pos;
+				memcpy(&g_buf[in_len], in, strlen(in));
+				in_len += strlen(in);
+				memset(&g_buf[in_len], 'b', len - pos);
+				in_len += len - pos;
+				g_buf[in_len++] = '"';
+
+				/* Missing the closing quote */
+				rc = spdk_json_parse(g_buf, in_len - 1, NULL, 0, NULL, 0);
+				CU_ASSERT(rc == (specials[i].rc < 0 ? specials[i].rc :
+						 SPDK_JSON_PARSE_INCOMPLETE));
+
+				rc = spdk_json_parse(g_buf, in_len, g_vals, JSONVALUE_NUM, &g_end,
+						     SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE);
+				CU_ASSERT(rc == specials[i].rc);
+				if (rc != 1) {
+					continue;
+				}
+
+				memset(expected, 'a', pos);
+				out_len = pos;
+				memcpy(&expected[out_len], out, strlen(out));
+				out_len += strlen(out);
+				memset(&expected[out_len], 'b', len - pos);
+				out_len += len - pos;
+
+				CU_ASSERT(g_end == g_buf + in_len);
+				CU_ASSERT(g_vals[0].type == SPDK_JSON_VAL_STRING);
+				CU_ASSERT(g_vals[0].len == out_len);
+				CU_ASSERT(memcmp(g_vals[0].start, expected, out_len) == 0);
+			}
+		}
+	}
+}
+
 static void
 test_parse_string_control_chars(void)
 {
@@ -460,6 +529,43 @@ test_parse_number(void)
 	NUM_FAIL(".123", SPDK_JSON_PARSE_INVALID);
 }
 
+static void
+test_parse_whitespace(void)
+{
+	static const char ws[] = " \t\r\n";
+	size_t len, i, in_len;
+
+	/* Runs of whitespace spanning multiple scan blocks */
+	for (len = 0; len < 80; len++) {
+		in_len = 0;
+		g_buf[in_len++] = '[';
+		for (i = 0; i < len; i++) {
+			g_buf[in_len++] = ws[i % 4];
+		}
+		g_buf[in_len++] = '1';
+		for (i = 0; i < len; i++) {
+			g_buf[in_len++] = ws[(i + 1) % 4];
+		}
+		g_buf[in_len++] = ']';
+		for (i = 0; i < len; i++) {
+			g_buf[in_len++] = ws[(i + 2) % 4];
+		}
+
+		CU_ASSERT(spdk_json_parse(g_buf, in_len, g_vals, JSONVALUE_NUM, &g_end, 0) == 3);
+		CU_ASSERT(g_end == g_buf + in_len);
+		CU_ASSERT(g_vals[1].type == SPDK_JSON_VAL_NUMBER);
+		CU_ASSERT(g_vals[1].start == &g_buf[len + 1]);
+
+		/* Anything else in the middle of the whitespace is invalid */
+		if (len > 0) {
+			g_buf[len / 2 + 1] = 'x';
+			CU_ASSERT(spdk_json_parse(g_buf, in_len, NULL, 0, &g_end, 0) ==
+				  SPDK_JSON_PARSE_INVALID);
+			CU_ASSERT(g_end == &g_buf[len / 2 + 1]);
+		}
+	}
+}
+
 static void
 test_parse_array(void)
 {
@@ -884,11 +990,13 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_parse_literal);
 	CU_ADD_TEST(suite, test_parse_string_simple);
+	CU_ADD_TEST(suite, test_parse_string_long);
 	CU_ADD_TEST(suite, test_parse_string_control_chars);
 	CU_ADD_TEST(suite, test_parse_string_utf8);
 	CU_ADD_TEST(suite, test_parse_string_escapes_twochar);
 	CU_ADD_TEST(suite, test_parse_string_escapes_unicode);
 	CU_ADD_TEST(suite, test_parse_number);
+	CU_ADD_TEST(suite, test_parse_whitespace);
 	CU_ADD_TEST(suite, test_parse_array);
 	CU_ADD_TEST(suite, test_parse_object);
 	CU_ADD_TEST(suite, test_parse_nesting);
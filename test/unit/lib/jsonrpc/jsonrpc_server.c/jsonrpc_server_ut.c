@@ -16,6 +16,12 @@ const struct spdk_json_val *g_params;
 
 const struct spdk_json_val *g_cur_param;
 
+static bool g_batch;
+static struct spdk_jsonrpc_request *g_batch_reqs[8];
+static int g_batch_errors[8];
+static int g_batch_cnt;
+static struct spdk_jsonrpc_request *g_sent_request;
+
 #define PARSE_PASS(in, trailing) \
 	CU_ASSERT(g_cur_param == NULL); \
 	g_cur_param = NULL; \
@@ -137,6 +143,14 @@ static void
 ut_handle(struct spdk_jsonrpc_request *request, int error, const struct spdk_json_val *method,
 	  const struct spdk_json_val *params)
 {
+	if (g_batch) {
+		SPDK_CU_ASSERT_FATAL(g_batch_cnt < (int)SPDK_COUNTOF(g_batch_reqs));
+		CU_ASSERT(request->batch != NULL);
+		g_batch_errors[g_batch_cnt] = error;
+		g_batch_reqs[g_batch_cnt++] = request;
+		return;
+	}
+
 	CU_ASSERT(g_request == NULL);
 	g_request = request;
 	g_parse_error = error;
@@ -160,6 +174,10 @@ jsonrpc_server_handle_request(struct spdk_jsonrpc_request *request,
 void
 jsonrpc_server_send_response(struct spdk_jsonrpc_request *request)
 {
+	if (g_batch) {
+		CU_ASSERT(g_sent_request == NULL);
+		g_sent_request = request;
+	}
 }
 
 static void
@@ -280,20 +298,6 @@ test_parse_request(void)
 	REQ_BEGIN_INVALID(SPDK_JSONRPC_ERROR_INVALID_REQUEST);
 	FREE_REQUEST();
 
-	/* batch - not supported */
-	PARSE_PASS(
-		"["
-		"{\"jsonrpc\": \"2.0\", \"method\": \"sum\", \"params\": [1,2,4], \"id\": \"1\"},"
-		"{\"jsonrpc\": \"2.0\", \"method\": \"notify_hello\", \"params\": [7]},"
-		"{\"jsonrpc\": \"2.0\", \"method\": \"subtract\", \"params\": [42,23], \"id\": \"2\"},"
-		"{\"foo\": \"boo\"},"
-		"{\"jsonrpc\": \"2.0\", \"method\": \"foo.get\", \"params\": {\"name\": \"myself\"}, \"id\": \"5\"},"
-		"{\"jsonrpc\": \"2.0\", \"method\": \"get_data\", \"id\": \"9\"}"
-		"]", "");
-
-	REQ_BEGIN_INVALID(SPDK_JSONRPC_ERROR_INVALID_REQUEST);
-	FREE_REQUEST();
-
 	CU_ASSERT(conn->outstanding_requests == 0);
 	free(conn);
 	free(server);
@@ -360,6 +364,107 @@ test_parse_request_streaming(void)
 	free(server);
 }
 
+static void
+ut_batch_complete(int idx)
+{
+	struct spdk_jsonrpc_request *request = g_batch_reqs[idx];
+	struct spdk_json_write_ctx *w;
+
+	if (g_batch_errors[idx] != 0) {
+		spdk_jsonrpc_send_error_response(request, g_batch_errors[idx], "err");
+	} else {
+		w = spdk_jsonrpc_begin_result(request);
+		spdk_json_write_uint32(w, idx);
+		spdk_jsonrpc_end_result(request, w);
+	}
+}
+
+static void
+test_parse_batch_request(void)
+{
+	struct spdk_jsonrpc_server *server;
+	struct spdk_jsonrpc_server_conn *conn;
+	struct spdk_jsonrpc_request *batch;
+	const char batch_req[] =
+		"["
+		"{\"jsonrpc\": \"2.0\", \"method\": \"sum\", \"params\": [1,2,4], \"id\": \"1\"},"
+		"{\"jsonrpc\": \"2.0\", \"method\": \"notify_hello\", \"params\": [7]},"
+		"{\"jsonrpc\": \"2.0\", \"method\": \"subtract\", \"params\": [42,23], \"id\": 2},"
+		"{\"foo\": \"boo\"},"
+		"1"
+		"]";
+	const char notify_req[] =
+		"["
+		"{\"jsonrpc\": \"2.0\", \"method\": \"a\"},"
+		"{\"jsonrpc\": \"2.0\", \"method\": \"b\"}"
+		"]";
+	const char *expected =
+		"["
+		"{\"jsonrpc\":\"2.0\",\"id\":\"1\",\"result\":0},"
+		"{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":2},"
+		"{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32600,\"message\":\"err\"}},"
+		"{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32600,\"message\":\"err\"}}"
+		"]\n";
+
+	server = calloc(1, sizeof(*server));
+	SPDK_CU_ASSERT_FATAL(server != NULL);
+
+	conn = calloc(1, sizeof(*conn));
+	SPDK_CU_ASSERT_FATAL(conn != NULL);
+	pthread_spin_init(&conn->queue_lock, PTHREAD_PROCESS_PRIVATE);
+	STAILQ_INIT(&conn->outstanding_queue);
+
+	conn->server = server;
+	g_batch = true;
+
+	/* Each element is dispatched as a separate request */
+	CU_ASSERT(jsonrpc_parse_request(conn, batch_req, sizeof(batch_req) - 1) ==
+		  sizeof(batch_req) - 1);
+	CU_ASSERT(g_batch_cnt == 5);
+	CU_ASSERT(g_batch_errors[0] == 0);
+	CU_ASSERT(g_batch_errors[1] == 0);
+	CU_ASSERT(g_batch_errors[2] == 0);
+	CU_ASSERT(g_batch_errors[3] == SPDK_JSONRPC_ERROR_INVALID_REQUEST);
+	CU_ASSERT(g_batch_errors[4] == SPDK_JSONRPC_ERROR_INVALID_REQUEST);
+	CU_ASSERT(conn->outstanding_requests == 1);
+	batch = g_batch_reqs[0]->batch;
+	CU_ASSERT(spdk_jsonrpc_get_conn(g_batch_reqs[0]) == conn);
+
+	/* Complete the requests out of order, the response is only sent after the last one */
+	ut_batch_complete(2);
+	ut_batch_complete(4);
+	ut_batch_complete(0);
+	ut_batch_complete(3);
+	CU_ASSERT(g_sent_request == NULL);
+	ut_batch_complete(1);
+	CU_ASSERT(g_sent_request == batch);
+
+	/* Responses keep the order of the requests, notifications don't get one */
+	SPDK_CU_ASSERT_FATAL(batch->send_len == strlen(expected));
+	CU_ASSERT(memcmp(batch->send_buf, expected, batch->send_len) == 0);
+	jsonrpc_free_request(batch);
+	g_sent_request = NULL;
+	g_batch_cnt = 0;
+
+	/* A batch of notifications only doesn't get any response */
+	CU_ASSERT(jsonrpc_parse_request(conn, notify_req, sizeof(notify_req) - 1) ==
+		  sizeof(notify_req) - 1);
+	CU_ASSERT(g_batch_cnt == 2);
+	batch = g_batch_reqs[0]->batch;
+	ut_batch_complete(0);
+	ut_batch_complete(1);
+	CU_ASSERT(g_sent_request == batch);
+	CU_ASSERT(batch->send_len == 0);
+	jsonrpc_free_request(batch);
+	g_sent_request = NULL;
+	g_batch_cnt = 0;
+
+	g_batch = false;
+	CU_ASSERT(conn->outstanding_requests == 0);
+	free(conn);
+	free(server);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -372,6 +477,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_parse_request);
 	CU_ADD_TEST(suite, test_parse_request_streaming);
+	CU_ADD_TEST(suite, test_parse_batch_request);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 
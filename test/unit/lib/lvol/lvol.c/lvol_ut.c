@@ -92,15 +92,17 @@ struct ut_cb_res {
 };
 
 void
-spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
-		     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
+spdk_bs_inflate_blob_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+			 spdk_blob_id blobid, const struct spdk_bs_inflate_opts *opts,
+			 spdk_blob_op_complete cb_fn, void *cb_arg)
 {
 	cb_fn(cb_arg, g_inflate_rc);
 }
 
 void
-spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
-			     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
+spdk_bs_blob_decouple_parent_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+				 spdk_blob_id blobid, const struct spdk_bs_inflate_opts *opts,
+				 spdk_blob_op_complete cb_fn, void *cb_arg)
 {
 	cb_fn(cb_arg, g_inflate_rc);
 }
@@ -711,7 +711,7 @@ test_nvme_allocate_request_null(void)
 static void
 test_nvme_allocate_request(void)
 {
-	struct spdk_nvme_qpair qpair;
+	struct spdk_nvme_qpair qpair = {};
 	struct nvme_payload payload;
 	uint32_t payload_struct_size = sizeof(payload);
 	spdk_nvme_cmd_cb cb_fn = (spdk_nvme_cmd_cb)0x1234;
@@ -749,7 +749,7 @@ test_nvme_allocate_request(void)
 static void
 test_nvme_free_request(void)
 {
-	struct nvme_request match_req;
+	struct nvme_request match_req = {};
 	struct spdk_nvme_qpair qpair = {0};
 	struct nvme_request *req;
 
@@ -771,7 +771,7 @@ test_nvme_free_request(void)
 static void
 test_nvme_allocate_request_user_copy(void)
 {
-	struct spdk_nvme_qpair qpair;
+	struct spdk_nvme_qpair qpair = {};
 	spdk_nvme_cmd_cb cb_fn = (spdk_nvme_cmd_cb)0x12345;
 	void *cb_arg = (void *)0x12345;
 	bool host_to_controller = true;
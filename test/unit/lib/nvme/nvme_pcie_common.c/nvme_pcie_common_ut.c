@@ -37,8 +37,34 @@ DEFINE_STUB_V(nvme_qpair_deinit, (struct spdk_nvme_qpair *qpair));
 DEFINE_STUB(nvme_ctrlr_get_current_process, struct spdk_nvme_ctrlr_process *,
 	    (struct spdk_nvme_ctrlr *ctrlr), NULL);
 
-DEFINE_STUB(spdk_nvme_qpair_process_completions, int32_t,
-	    (struct spdk_nvme_qpair *qpair, uint32_t max_completions), 0);
+struct ut_qpair_completions {
+	struct spdk_nvme_qpair	*qpair;
+	uint32_t		pending;
+};
+
+static struct ut_qpair_completions g_ut_completions[2];
+
+int32_t
+spdk_nvme_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_completions)
+{
+	uint32_t i, num_completions;
+
+	for (i = 0; i < SPDK_COUNTOF(g_ut_completions); i++) {
+		if (g_ut_completions[i].qpair != qpair) {
+			continue;
+		}
+
+		num_completions = g_ut_completions[i].pending;
+		if (max_completions != 0) {
+			num_completions = spdk_min(num_completions, max_completions);
+		}
+		g_ut_completions[i].pending -= num_completions;
+
+		return num_completions;
+	}
+
+	return 0;
+}
 
 DEFINE_STUB(nvme_request_check_timeout, int, (struct nvme_request *req, uint16_t cid,
 		struct spdk_nvme_ctrlr_process *active_proc, uint64_t now_tick), 0);
@@ -578,6 +604,78 @@ test_nvme_pcie_poll_group_get_stats(void)
 	CU_ASSERT(rc == 0);
 }
 
+static void
+test_nvme_pcie_poll_group_process_completions(void)
+{
+	struct spdk_nvme_poll_group group = {};
+	struct nvme_pcie_ctrlr pctrlr = {};
+	struct nvme_pcie_qpair pqpair[2] = {};
+	struct spdk_nvme_pcie_stat stat = {};
+	struct spdk_nvme_transport_poll_group *tgroup;
+	uint32_t doorbell[2] = {};
+	int64_t num_completions;
+	int i;
+
+	tgroup = nvme_pcie_poll_group_create();
+	SPDK_CU_ASSERT_FATAL(tgroup != NULL);
+	tgroup->group = &group;
+	STAILQ_INIT(&tgroup->connected_qpairs);
+	STAILQ_INIT(&tgroup->disconnected_qpairs);
+
+	for (i = 0; i < 2; i++) {
+		pqpair[i].qpair.ctrlr = &pctrlr.ctrlr;
+		pqpair[i].qpair.poll_group = tgroup;
+		pqpair[i].stat = &stat;
+		pqpair[i].sq_tdbl = &doorbell[i];
+		pqpair[i].flags.delay_cmd_submit = 1;
+		STAILQ_INSERT_TAIL(&tgroup->connected_qpairs, &pqpair[i].qpair, poll_group_stailq);
+		g_ut_completions[i].qpair = &pqpair[i].qpair;
+	}
+
+	/* The budget unused by the idle qpair is given to the busy one. */
+	g_ut_completions[0].pending = 10;
+	g_ut_completions[1].pending = 1;
+	num_completions = nvme_pcie_poll_group_process_completions(tgroup, 4, NULL);
+	CU_ASSERT(num_completions == 8);
+	CU_ASSERT(g_ut_completions[0].pending == 3);
+	CU_ASSERT(g_ut_completions[1].pending == 0);
+	CU_ASSERT(pqpair[0].flags.budget_exhausted == 0);
+	CU_ASSERT(pqpair[1].flags.budget_exhausted == 0);
+
+	/* Both qpairs are busy, there is no budget left to redistribute. */
+	g_ut_completions[0].pending = 10;
+	g_ut_completions[1].pending = 10;
+	num_completions = nvme_pcie_poll_group_process_completions(tgroup, 4, NULL);
+	CU_ASSERT(num_completions == 8);
+	CU_ASSERT(g_ut_completions[0].pending == 6);
+	CU_ASSERT(g_ut_completions[1].pending == 6);
+
+	/* No limit - everything is reaped in the first pass. */
+	num_completions = nvme_pcie_poll_group_process_completions(tgroup, 0, NULL);
+	CU_ASSERT(num_completions == 12);
+	CU_ASSERT(g_ut_completions[0].pending == 0);
+	CU_ASSERT(g_ut_completions[1].pending == 0);
+
+	/* Delayed submissions are flushed once per poll group iteration, only for the
+	 * qpairs that have new commands queued.
+	 */
+	pqpair[0].sq_tail = 5;
+	num_completions = nvme_pcie_poll_group_process_completions(tgroup, 0, NULL);
+	CU_ASSERT(num_completions == 0);
+	CU_ASSERT(doorbell[0] == 5);
+	CU_ASSERT(pqpair[0].last_sq_tail == 5);
+	CU_ASSERT(stat.sq_mmio_doorbell_updates == 1);
+
+	num_completions = nvme_pcie_poll_group_process_completions(tgroup, 0, NULL);
+	CU_ASSERT(stat.sq_mmio_doorbell_updates == 1);
+
+	for (i = 0; i < 2; i++) {
+		STAILQ_REMOVE(&tgroup->connected_qpairs, &pqpair[i].qpair, spdk_nvme_qpair, poll_group_stailq);
+		g_ut_completions[i].qpair = NULL;
+	}
+	CU_ASSERT(nvme_pcie_poll_group_destroy(tgroup) == 0);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -593,6 +691,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_pcie_ctrlr_connect_qpair);
 	CU_ADD_TEST(suite, test_nvme_pcie_ctrlr_construct_admin_qpair);
 	CU_ADD_TEST(suite, test_nvme_pcie_poll_group_get_stats);
+	CU_ADD_TEST(suite, test_nvme_pcie_poll_group_process_completions);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
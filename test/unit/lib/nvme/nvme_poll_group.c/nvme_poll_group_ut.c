@@ -42,6 +42,7 @@ struct spdk_nvme_ctrlr c2 = {
 
 int64_t g_process_completions_return_value = 0;
 int g_destroy_return_value = 0;
+pid_t g_spdk_nvme_pid;
 
 TAILQ_HEAD(nvme_transport_list, spdk_nvme_transport) g_spdk_nvme_transports =
 	TAILQ_HEAD_INITIALIZER(g_spdk_nvme_transports);
@@ -579,6 +580,71 @@ test_spdk_nvme_poll_group_get_free_stats(void)
 	CU_ASSERT(rc == -ENOTSUP);
 }
 
+static void
+test_spdk_nvme_poll_group_req_pool(void)
+{
+	struct spdk_nvme_poll_group *group;
+	struct spdk_nvme_transport_poll_group *tgroup, *tmp_tgroup;
+	struct spdk_nvme_qpair qpair1_1 = {0};
+	struct nvme_request *req1, *req2, *req3;
+
+	TAILQ_INSERT_TAIL(&g_spdk_nvme_transports, &t1, link);
+
+	group = spdk_nvme_poll_group_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(group != NULL);
+
+	CU_ASSERT(spdk_nvme_poll_group_set_req_pool_size(group, 2) == 0);
+	SPDK_CU_ASSERT_FATAL(group->req_pool != NULL);
+	CU_ASSERT(group->req_pool->num_requests == 2);
+	CU_ASSERT(group->req_pool->num_free == 2);
+
+	/* The pool can be resized while the poll group is empty. */
+	CU_ASSERT(spdk_nvme_poll_group_set_req_pool_size(group, 0) == 0);
+	CU_ASSERT(group->req_pool == NULL);
+	CU_ASSERT(spdk_nvme_poll_group_set_req_pool_size(group, 2) == 0);
+	SPDK_CU_ASSERT_FATAL(group->req_pool != NULL);
+
+	/* The qpair has no requests of its own, so all requests come from the pool. */
+	STAILQ_INIT(&qpair1_1.free_req);
+	qpair1_1.state = NVME_QPAIR_DISCONNECTED;
+	qpair1_1.transport = &t1;
+	qpair1_1.ctrlr = &c1;
+	CU_ASSERT(spdk_nvme_poll_group_add(group, &qpair1_1) == 0);
+	CU_ASSERT(spdk_nvme_poll_group_set_req_pool_size(group, 4) == -EBUSY);
+
+	req1 = nvme_allocate_request_null(&qpair1_1, NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(req1 != NULL);
+	CU_ASSERT(req1->qpair == &qpair1_1);
+	CU_ASSERT(req1->pool == group->req_pool);
+	req2 = nvme_allocate_request_null(&qpair1_1, NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(req2 != NULL);
+	CU_ASSERT(req2 != req1);
+	CU_ASSERT(group->req_pool->num_free == 0);
+	CU_ASSERT(qpair1_1.num_outstanding_reqs == 2);
+
+	/* The pool is exhausted. */
+	req3 = nvme_allocate_request_null(&qpair1_1, NULL, NULL);
+	CU_ASSERT(req3 == NULL);
+
+	/* Don't destroy the poll group while pool requests are outstanding. */
+	CU_ASSERT(spdk_nvme_poll_group_destroy(group) == -EBUSY);
+
+	nvme_free_request(req1);
+	nvme_free_request(req2);
+	CU_ASSERT(group->req_pool->num_free == 2);
+	CU_ASSERT(qpair1_1.num_outstanding_reqs == 0);
+	CU_ASSERT(STAILQ_EMPTY(&qpair1_1.free_req));
+
+	CU_ASSERT(spdk_nvme_poll_group_remove(group, &qpair1_1) == 0);
+	STAILQ_FOREACH_SAFE(tgroup, &group->tgroups, link, tmp_tgroup) {
+		STAILQ_REMOVE(&group->tgroups, tgroup, spdk_nvme_transport_poll_group, link);
+		free(tgroup);
+	}
+	SPDK_CU_ASSERT_FATAL(spdk_nvme_poll_group_destroy(group) == 0);
+
+	TAILQ_REMOVE(&g_spdk_nvme_transports, &t1, link);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -603,7 +669,8 @@ main(int argc, char **argv)
 			    test_spdk_nvme_poll_group_process_completions) == NULL ||
 		CU_add_test(suite, "nvme_poll_group_destroy_test", test_spdk_nvme_poll_group_destroy) == NULL ||
 		CU_add_test(suite, "nvme_poll_group_get_free_stats",
-			    test_spdk_nvme_poll_group_get_free_stats) == NULL
+			    test_spdk_nvme_poll_group_get_free_stats) == NULL ||
+		CU_add_test(suite, "nvme_poll_group_req_pool", test_spdk_nvme_poll_group_req_pool) == NULL
 	) {
 		CU_cleanup_registry();
 		return CU_get_error();
@@ -1919,6 +1919,44 @@ test_nvme_tcp_qpair_submit_request(void)
 	free(tctrlr);
 }
 
+static void
+test_nvme_tcp_pdu_update_data_digest(void)
+{
+	struct nvme_tcp_pdu pdu = {};
+	uint8_t buf[3][16];
+	uint32_t crc32c, expected, offset, len, chunk, i;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		((uint8_t *)buf)[i] = i * 7 + 1;
+	}
+
+	/* Data spread over three iovecs and not a multiple of the digest alignment */
+	pdu.data_iov[0].iov_base = buf[0];
+	pdu.data_iov[0].iov_len = 5;
+	pdu.data_iov[1].iov_base = buf[1];
+	pdu.data_iov[1].iov_len = 16;
+	pdu.data_iov[2].iov_base = buf[2];
+	pdu.data_iov[2].iov_len = 9;
+	pdu.data_iovcnt = 3;
+	pdu.data_len = 30;
+
+	expected = nvme_tcp_pdu_calc_data_digest(&pdu);
+
+	/* Digest the data in chunks of any size, crossing the iovec boundaries */
+	for (chunk = 1; chunk <= pdu.data_len; chunk++) {
+		crc32c = SPDK_CRC32C_XOR;
+		for (offset = 0; offset < pdu.data_len; offset += len) {
+			len = spdk_min(chunk, pdu.data_len - offset);
+			crc32c = nvme_tcp_pdu_update_data_digest(&pdu, offset, len, crc32c);
+		}
+		CU_ASSERT(nvme_tcp_pdu_pad_data_digest(&pdu, crc32c) == expected);
+	}
+
+	/* Zero length update doesn't change the digest */
+	crc32c = nvme_tcp_pdu_update_data_digest(&pdu, 0, 0, SPDK_CRC32C_XOR);
+	CU_ASSERT(crc32c == SPDK_CRC32C_XOR);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1955,6 +1993,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_tcp_poll_group_get_stats);
 	CU_ADD_TEST(suite, test_nvme_tcp_ctrlr_construct);
 	CU_ADD_TEST(suite, test_nvme_tcp_qpair_submit_request);
+	CU_ADD_TEST(suite, test_nvme_tcp_pdu_update_data_digest);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -445,6 +445,35 @@ nvme_status_success(const struct spdk_nvme_status *status)
 	return status->sct == SPDK_NVME_SCT_GENERIC && status->sc == SPDK_NVME_SC_SUCCESS;
 }
 
+static int
+ut_tgt_create_poll_group(void *io_device, void *ctx_buf)
+{
+	struct spdk_nvmf_poll_group *group = ctx_buf;
+	uint32_t i;
+
+	group->thread = spdk_get_thread();
+	group->num_sgroups = 2;
+	group->sgroups = calloc(group->num_sgroups, sizeof(struct spdk_nvmf_subsystem_poll_group));
+	SPDK_CU_ASSERT_FATAL(group->sgroups != NULL);
+	for (i = 0; i < group->num_sgroups; i++) {
+		RB_INIT(&group->sgroups[i].ctrlrs);
+	}
+
+	return 0;
+}
+
+static void
+ut_tgt_destroy_poll_group(void *io_device, void *ctx_buf)
+{
+	struct spdk_nvmf_poll_group *group = ctx_buf;
+	uint32_t i;
+
+	for (i = 0; i < group->num_sgroups; i++) {
+		nvmf_subsystem_pg_free_ctrlrs(&group->sgroups[i]);
+	}
+	free(group->sgroups);
+}
+
 static void
 test_connect(void)
 {
@@ -486,6 +515,8 @@ test_connect(void)
 	admin_qpair.state = SPDK_NVMF_QPAIR_CONNECTING;
 
 	memset(&tgt, 0, sizeof(tgt));
+	spdk_io_device_register(&tgt, ut_tgt_create_poll_group, ut_tgt_destroy_poll_group,
+				sizeof(struct spdk_nvmf_poll_group), NULL);
 	memset(&transport, 0, sizeof(transport));
 	transport.ops = &tops;
 	transport.opts.max_aq_depth = 32;
@@ -950,6 +981,160 @@ test_connect(void)
 
 	spdk_bit_array_free(&ctrlr.qpair_mask);
 	free(sgroups);
+	spdk_io_device_unregister(&tgt, NULL);
+	poll_threads();
+}
+
+static void
+ut_pg_update_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = spdk_io_channel_iter_get_ctx(i);
+
+	ctrlr->pg_update_in_progress = false;
+}
+
+static void
+test_connect_pg_ctrlr_cache(void)
+{
+	struct spdk_nvmf_fabric_connect_data connect_data = {};
+	struct spdk_nvmf_poll_group *group;
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_transport_ops tops = {};
+	struct spdk_nvmf_subsystem subsystem = {};
+	struct spdk_nvmf_request req = {};
+	struct spdk_nvmf_qpair admin_qpair = {};
+	struct spdk_nvmf_qpair qpair = {};
+	struct spdk_nvmf_ctrlr ctrlr = {}, ctrlr2 = {};
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_io_channel *ch;
+	union nvmf_h2c_msg cmd = {};
+	union nvmf_c2h_msg rsp = {};
+	int rc;
+
+	spdk_io_device_register(&tgt, ut_tgt_create_poll_group, ut_tgt_destroy_poll_group,
+				sizeof(struct spdk_nvmf_poll_group), NULL);
+	ch = spdk_get_io_channel(&tgt);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	group = spdk_io_channel_get_ctx(ch);
+
+	subsystem.thread = spdk_get_thread();
+	subsystem.id = 1;
+	subsystem.tgt = &tgt;
+	subsystem.subtype = SPDK_NVMF_SUBTYPE_NVME;
+	subsystem.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	snprintf(subsystem.subnqn, sizeof(subsystem.subnqn), "nqn.2016-06.io.spdk:subsystem1");
+	TAILQ_INIT(&subsystem.ctrlrs);
+
+	transport.ops = &tops;
+	transport.opts.max_aq_depth = 32;
+	transport.opts.max_queue_depth = 64;
+	transport.opts.max_qpairs_per_ctrlr = 3;
+	transport.tgt = &tgt;
+
+	admin_qpair.group = group;
+	admin_qpair.state = SPDK_NVMF_QPAIR_ENABLED;
+
+	ctrlr.cntlid = 5;
+	ctrlr.subsys = &subsystem;
+	ctrlr.admin_qpair = &admin_qpair;
+	ctrlr.thread = spdk_get_thread();
+	ctrlr.qpair_mask = spdk_bit_array_create(3);
+	SPDK_CU_ASSERT_FATAL(ctrlr.qpair_mask != NULL);
+	ctrlr.vcprop.cc.bits.en = 1;
+	ctrlr.vcprop.cc.bits.iosqes = 6;
+	ctrlr.vcprop.cc.bits.iocqes = 4;
+
+	qpair.transport = &transport;
+	qpair.group = group;
+	qpair.state = SPDK_NVMF_QPAIR_CONNECTING;
+	TAILQ_INIT(&qpair.outstanding);
+
+	connect_data.cntlid = ctrlr.cntlid;
+	snprintf(connect_data.subnqn, sizeof(connect_data.subnqn), "%s", subsystem.subnqn);
+	snprintf(connect_data.hostnqn, sizeof(connect_data.hostnqn), "nqn.2016-06.io.spdk:host1");
+
+	cmd.connect_cmd.opcode = SPDK_NVME_OPC_FABRIC;
+	cmd.connect_cmd.fctype = SPDK_NVMF_FABRIC_COMMAND_CONNECT;
+	cmd.connect_cmd.qid = 1;
+	cmd.connect_cmd.sqsize = 63;
+
+	req.qpair = &qpair;
+	req.xfer = SPDK_NVME_DATA_HOST_TO_CONTROLLER;
+	req.length = sizeof(connect_data);
+	SPDK_IOV_ONE(req.iov, &req.iovcnt, &connect_data, req.length);
+	req.cmd = &cmd;
+	req.rsp = &rsp;
+
+	MOCK_SET(spdk_nvmf_tgt_find_subsystem, &subsystem);
+
+	/* Publish the controller to the poll groups */
+	ctrlr.pg_update_in_progress = true;
+	spdk_for_each_channel(&tgt, nvmf_ctrlr_add_to_pg, &ctrlr, nvmf_ctrlr_add_to_pg_done);
+	poll_threads();
+	CU_ASSERT(ctrlr.pg_update_in_progress == false);
+	CU_ASSERT(nvmf_subsystem_pg_find_ctrlr(&group->sgroups[1], 5) == &ctrlr);
+	CU_ASSERT(nvmf_subsystem_pg_find_ctrlr(&group->sgroups[1], 6) == NULL);
+	CU_ASSERT(nvmf_subsystem_pg_find_ctrlr(&group->sgroups[0], 5) == NULL);
+
+	/* I/O connect is routed by the poll group, the subsystem's list is never consulted */
+	MOCK_SET(nvmf_subsystem_get_ctrlr, NULL);
+	group->sgroups[subsystem.id].mgmt_io_outstanding++;
+	TAILQ_INSERT_TAIL(&qpair.outstanding, &req, link);
+	rc = nvmf_ctrlr_cmd_connect(&req);
+	poll_threads();
+	CU_ASSERT(rc == SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+	CU_ASSERT(nvme_status_success(&rsp.nvme_cpl.status));
+	CU_ASSERT(qpair.state == SPDK_NVMF_QPAIR_ENABLED);
+	CU_ASSERT(qpair.ctrlr == &ctrlr);
+	CU_ASSERT(group->sgroups[subsystem.id].mgmt_io_outstanding == 0);
+	qpair.ctrlr = NULL;
+	qpair.state = SPDK_NVMF_QPAIR_CONNECTING;
+	spdk_bit_array_clear(ctrlr.qpair_mask, 1);
+
+	/* Controller being destroyed is rejected without a trip to the subsystem thread */
+	memset(&rsp, 0, sizeof(rsp));
+	ctrlr.in_destruct = true;
+	group->sgroups[subsystem.id].mgmt_io_outstanding++;
+	TAILQ_INSERT_TAIL(&qpair.outstanding, &req, link);
+	rc = nvmf_ctrlr_cmd_connect(&req);
+	poll_threads();
+	CU_ASSERT(rc == SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+	CU_ASSERT(rsp.nvme_cpl.status.sct == SPDK_NVME_SCT_COMMAND_SPECIFIC);
+	CU_ASSERT(rsp.nvme_cpl.status.sc == SPDK_NVMF_FABRIC_SC_INVALID_PARAM);
+	CU_ASSERT(qpair.ctrlr == NULL);
+	ctrlr.in_destruct = false;
+
+	/* A new controller reusing the cntlid replaces the entry, removing the
+	 * old controller must not drop it. */
+	ctrlr2.cntlid = ctrlr.cntlid;
+	ctrlr2.subsys = &subsystem;
+	spdk_for_each_channel(&tgt, nvmf_ctrlr_add_to_pg, &ctrlr2, ut_pg_update_done);
+	poll_threads();
+	CU_ASSERT(nvmf_subsystem_pg_find_ctrlr(&group->sgroups[1], 5) == &ctrlr2);
+	spdk_for_each_channel(&tgt, nvmf_ctrlr_remove_from_pg, &ctrlr, ut_pg_update_done);
+	poll_threads();
+	CU_ASSERT(nvmf_subsystem_pg_find_ctrlr(&group->sgroups[1], 5) == &ctrlr2);
+	spdk_for_each_channel(&tgt, nvmf_ctrlr_remove_from_pg, &ctrlr2, ut_pg_update_done);
+	poll_threads();
+	CU_ASSERT(nvmf_subsystem_pg_find_ctrlr(&group->sgroups[1], 5) == NULL);
+
+	/* Without an entry, the connect goes through the subsystem thread */
+	memset(&rsp, 0, sizeof(rsp));
+	group->sgroups[subsystem.id].mgmt_io_outstanding++;
+	TAILQ_INSERT_TAIL(&qpair.outstanding, &req, link);
+	rc = nvmf_ctrlr_cmd_connect(&req);
+	poll_threads();
+	CU_ASSERT(rc == SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+	CU_ASSERT(rsp.nvme_cpl.status.sct == SPDK_NVME_SCT_COMMAND_SPECIFIC);
+	CU_ASSERT(rsp.nvme_cpl.status.sc == SPDK_NVMF_FABRIC_SC_INVALID_PARAM);
+	CU_ASSERT(qpair.ctrlr == NULL);
+
+	MOCK_CLEAR(nvmf_subsystem_get_ctrlr);
+	MOCK_CLEAR(spdk_nvmf_tgt_find_subsystem);
+	spdk_bit_array_free(&ctrlr.qpair_mask);
+	spdk_put_io_channel(ch);
+	spdk_io_device_unregister(&tgt, NULL);
+	poll_threads();
 }
 
 static void
@@ -2575,6 +2760,8 @@ test_nvmf_ctrlr_create_destruct(void)
 	transport.opts.max_qpairs_per_ctrlr = 3;
 	transport.opts.dif_insert_or_strip = true;
 	transport.tgt = &tgt;
+	spdk_io_device_register(&tgt, ut_tgt_create_poll_group, ut_tgt_destroy_poll_group,
+				sizeof(struct spdk_nvmf_poll_group), NULL);
 	qpair.transport = &transport;
 	qpair.group = &group;
 	qpair.state = SPDK_NVMF_QPAIR_CONNECTING;
@@ -2651,6 +2838,8 @@ test_nvmf_ctrlr_create_destruct(void)
 	poll_threads();
 	CU_ASSERT(TAILQ_EMPTY(&subsystem.ctrlrs));
 	CU_ASSERT(TAILQ_EMPTY(&qpair.outstanding));
+	spdk_io_device_unregister(&tgt, NULL);
+	poll_threads();
 }
 
 static void
@@ -2743,6 +2932,16 @@ test_nvmf_ctrlr_use_zcopy(void)
 	/* Success */
 	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req));
 	CU_ASSERT(req.zcopy_phase == NVMF_ZCOPY_PHASE_INIT);
+	req.zcopy_phase = NVMF_ZCOPY_PHASE_NONE;
+
+	/* Read only ZCOPY ignores the transport option, but not WRITEs */
+	transport.opts.zcopy = false;
+	CU_ASSERT(nvmf_ctrlr_use_zcopy_read(&req) == false);
+	CU_ASSERT(req.zcopy_phase == NVMF_ZCOPY_PHASE_NONE);
+	cmd.nvme_cmd.opc = SPDK_NVME_OPC_READ;
+	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
+	CU_ASSERT(nvmf_ctrlr_use_zcopy_read(&req));
+	CU_ASSERT(req.zcopy_phase == NVMF_ZCOPY_PHASE_INIT);
 
 	spdk_bit_array_free(&ctrlr.visible_ns);
 }
@@ -3385,6 +3584,207 @@ test_nvmf_ctrlr_ns_attachment(void)
 	free(subsystem.ns);
 }
 
+static uint32_t
+ut_fq_flow_queued(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, const char *hostnqn)
+{
+	struct nvmf_fq_flow *flow;
+	struct spdk_nvmf_request *req;
+	uint32_t count = 0;
+
+	SLIST_FOREACH(flow, &ns_info->fq_flows, link) {
+		if (strcmp(flow->hostnqn, hostnqn) == 0) {
+			STAILQ_FOREACH(req, &flow->queue, fq_link) {
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+static void
+test_nvmf_fair_queuing(void)
+{
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_subsystem subsystem = {};
+	struct spdk_nvmf_ns ns = {};
+	struct spdk_nvmf_ns *subsys_ns[1] = {};
+	enum spdk_nvme_ana_state ana_state[1];
+	struct spdk_nvmf_subsystem_listener listener = { .ana_state = ana_state };
+	struct spdk_bdev bdev = { .blockcnt = 100, .blocklen = 512};
+	struct spdk_nvmf_poll_group group = {};
+	struct spdk_nvmf_subsystem_poll_group sgroups = {};
+	struct spdk_nvmf_subsystem_pg_ns_info ns_info = {};
+	struct spdk_io_channel io_ch = {};
+	struct spdk_nvmf_ctrlr ctrlr[2] = {};
+	struct spdk_nvmf_qpair qpair[2] = {};
+	struct spdk_nvme_cmd cmd[16] = {};
+	union nvmf_c2h_msg rsp[16] = {};
+	struct spdk_nvmf_request req[16] = {};
+	struct spdk_nvmf_request *inflight;
+	const char *hostnqn[2] = { "nqn.2016-06.io.spdk:host0", "nqn.2016-06.io.spdk:host1" };
+	const uint32_t weights[][2] = {
+		{ 3, 1 },
+		{ SPDK_NVMF_FQ_MAX_WEIGHT, SPDK_NVMF_FQ_MAX_WEIGHT / 3 },
+	};
+	uint32_t i, w, next[2], dispatched[2], queued;
+
+	ns.bdev = &bdev;
+	ns.anagrpid = 1;
+	subsystem.id = 0;
+	subsystem.max_nsid = 1;
+	subsys_ns[0] = &ns;
+	subsystem.ns = (struct spdk_nvmf_ns **)&subsys_ns;
+	subsystem.fq_depth = 1;
+	listener.ana_state[0] = SPDK_NVME_ANA_OPTIMIZED_STATE;
+
+	group.thread = spdk_get_thread();
+	group.num_sgroups = 1;
+	sgroups.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	sgroups.num_ns = 1;
+	ns_info.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	ns_info.channel = &io_ch;
+	sgroups.ns_info = &ns_info;
+	TAILQ_INIT(&sgroups.queued);
+	group.sgroups = &sgroups;
+
+	for (i = 0; i < 2; i++) {
+		snprintf(ctrlr[i].hostnqn, sizeof(ctrlr[i].hostnqn), "%s", hostnqn[i]);
+		ctrlr[i].cntlid = i + 1;
+		ctrlr[i].vcprop.cc.bits.en = 1;
+		ctrlr[i].subsys = &subsystem;
+		ctrlr[i].listener = &listener;
+		ctrlr[i].visible_ns = spdk_bit_array_create(1);
+		spdk_bit_array_set(ctrlr[i].visible_ns, 0);
+
+		TAILQ_INIT(&qpair[i].outstanding);
+		qpair[i].ctrlr = &ctrlr[i];
+		qpair[i].group = &group;
+		qpair[i].transport = &transport;
+		qpair[i].qid = 1;
+		qpair[i].state = SPDK_NVMF_QPAIR_ENABLED;
+	}
+
+	/* Even requests come from host 0, odd ones from host 1 */
+	for (i = 0; i < 16; i++) {
+		cmd[i].opc = SPDK_NVME_OPC_READ;
+		cmd[i].nsid = 1;
+		req[i].qpair = &qpair[i % 2];
+		req[i].cmd = (union nvmf_h2c_msg *)&cmd[i];
+		req[i].rsp = &rsp[i];
+		req[i].length = 4096;
+	}
+
+	MOCK_SET(nvmf_bdev_ctrlr_read_cmd, SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+
+	/* Case 1: host 0 gets three times the bandwidth of host 1, also with the largest weights */
+	for (w = 0; w < SPDK_COUNTOF(weights); w++) {
+		ctrlr[0].fq_weight = weights[w][0];
+		ctrlr[1].fq_weight = weights[w][1];
+
+		/* The first request is submitted right away, the rest is queued per host */
+		spdk_nvmf_request_exec(&req[0]);
+		CU_ASSERT(ns_info.fq_inflight == 1);
+		CU_ASSERT(ns_info.fq_queued == 0);
+		for (i = 1; i < 16; i++) {
+			spdk_nvmf_request_exec(&req[i]);
+		}
+		CU_ASSERT(ns_info.fq_inflight == 1);
+		CU_ASSERT(ns_info.fq_queued == 15);
+		CU_ASSERT(ns_info.io_outstanding == 16);
+		CU_ASSERT(ut_fq_flow_queued(&ns_info, hostnqn[0]) == 7);
+		CU_ASSERT(ut_fq_flow_queued(&ns_info, hostnqn[1]) == 8);
+
+		/* Each completion dispatches the next request of one of the hosts */
+		inflight = &req[0];
+		next[0] = 2;
+		next[1] = 1;
+		dispatched[0] = dispatched[1] = 0;
+		for (i = 0; i < 15; i++) {
+			queued = ut_fq_flow_queued(&ns_info, hostnqn[0]);
+			_nvmf_request_complete(inflight);
+			CU_ASSERT(inflight->fq_ns_info == NULL);
+			CU_ASSERT(ns_info.fq_inflight == 1);
+			if (ut_fq_flow_queued(&ns_info, hostnqn[0]) < queued) {
+				inflight = &req[next[0]];
+				next[0] += 2;
+				dispatched[0]++;
+			} else {
+				inflight = &req[next[1]];
+				next[1] += 2;
+				dispatched[1]++;
+			}
+			CU_ASSERT(inflight->fq_ns_info == &ns_info);
+
+			if (i == 7) {
+				CU_ASSERT(dispatched[0] == 6);
+				CU_ASSERT(dispatched[1] == 2);
+			}
+		}
+		CU_ASSERT(ns_info.fq_queued == 0);
+
+		_nvmf_request_complete(inflight);
+		CU_ASSERT(ns_info.fq_inflight == 0);
+		CU_ASSERT(ns_info.io_outstanding == 0);
+		nvmf_ns_info_free_fq_flows(&ns_info);
+		CU_ASSERT(SLIST_EMPTY(&ns_info.fq_flows));
+	}
+
+	/* Case 2: host 1 is dispatched first until it reaches its min_iops */
+	ctrlr[1].fq_min_iops = 3;
+
+	for (i = 0; i < 16; i++) {
+		spdk_nvmf_request_exec(&req[i]);
+	}
+	CU_ASSERT(ns_info.fq_inflight == 1);
+	CU_ASSERT(ns_info.fq_queued == 15);
+
+	inflight = &req[0];
+	next[0] = 2;
+	next[1] = 1;
+	dispatched[0] = dispatched[1] = 0;
+	for (i = 0; i < 15; i++) {
+		queued = ut_fq_flow_queued(&ns_info, hostnqn[0]);
+		_nvmf_request_complete(inflight);
+		if (ut_fq_flow_queued(&ns_info, hostnqn[0]) < queued) {
+			inflight = &req[next[0]];
+			next[0] += 2;
+			dispatched[0]++;
+		} else {
+			inflight = &req[next[1]];
+			next[1] += 2;
+			dispatched[1]++;
+		}
+
+		if (i == 2) {
+			CU_ASSERT(dispatched[0] == 0);
+			CU_ASSERT(dispatched[1] == 3);
+		}
+	}
+
+	_nvmf_request_complete(inflight);
+	CU_ASSERT(ns_info.fq_inflight == 0);
+	CU_ASSERT(ns_info.fq_queued == 0);
+	CU_ASSERT(ns_info.io_outstanding == 0);
+	nvmf_ns_info_free_fq_flows(&ns_info);
+
+	/* Case 3: no queuing with fair queuing disabled */
+	subsystem.fq_depth = 0;
+	spdk_nvmf_request_exec(&req[0]);
+	spdk_nvmf_request_exec(&req[1]);
+	CU_ASSERT(req[0].fq_ns_info == NULL);
+	CU_ASSERT(req[1].fq_ns_info == NULL);
+	CU_ASSERT(ns_info.fq_inflight == 0);
+	CU_ASSERT(ns_info.io_outstanding == 2);
+	_nvmf_request_complete(&req[0]);
+	_nvmf_request_complete(&req[1]);
+	CU_ASSERT(ns_info.io_outstanding == 0);
+
+	MOCK_CLEAR(nvmf_bdev_ctrlr_read_cmd);
+	spdk_bit_array_free(&ctrlr[0].visible_ns);
+	spdk_bit_array_free(&ctrlr[1].visible_ns);
+}
+
 static void
 test_nvmf_check_qpair_active(void)
 {
@@ -3459,6 +3859,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_get_log_page);
 	CU_ADD_TEST(suite, test_process_fabrics_cmd);
 	CU_ADD_TEST(suite, test_connect);
+	CU_ADD_TEST(suite, test_connect_pg_ctrlr_cache);
 	CU_ADD_TEST(suite, test_get_ns_id_desc_list);
 	CU_ADD_TEST(suite, test_identify_ns);
 	CU_ADD_TEST(suite, test_identify_ns_iocs_specific);
@@ -3488,6 +3889,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvmf_ctrlr_set_features_host_behavior_support);
 	CU_ADD_TEST(suite, test_nvmf_ctrlr_ns_attachment);
 	CU_ADD_TEST(suite, test_nvmf_check_qpair_active);
+	CU_ADD_TEST(suite, test_nvmf_fair_queuing);
 
 	allocate_threads(1);
 	set_thread(0);
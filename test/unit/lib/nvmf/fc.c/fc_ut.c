@@ -39,6 +39,8 @@ DEFINE_STUB(spdk_nvme_transport_id_compare, int,
 	     const struct spdk_nvme_transport_id *trid2), 0);
 DEFINE_STUB(spdk_bdev_get_name, const char *, (const struct spdk_bdev *bdev), "fc_ut_test");
 DEFINE_STUB_V(nvmf_ctrlr_destruct, (struct spdk_nvmf_ctrlr *ctrlr));
+DEFINE_STUB_V(nvmf_ns_info_free_fq_flows, (struct spdk_nvmf_subsystem_pg_ns_info *ns_info));
+DEFINE_STUB_V(nvmf_subsystem_pg_free_ctrlrs, (struct spdk_nvmf_subsystem_poll_group *sgroup));
 DEFINE_STUB_V(nvmf_qpair_free_aer, (struct spdk_nvmf_qpair *qpair));
 DEFINE_STUB_V(nvmf_qpair_abort_pending_zcopy_reqs, (struct spdk_nvmf_qpair *qpair));
 DEFINE_STUB(spdk_bdev_get_io_channel, struct spdk_io_channel *, (struct spdk_bdev_desc *desc),
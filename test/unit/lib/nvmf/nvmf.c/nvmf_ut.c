@@ -11,6 +11,8 @@
 
 DEFINE_STUB_V(nvmf_transport_poll_group_destroy, (struct spdk_nvmf_transport_poll_group *group));
 DEFINE_STUB_V(nvmf_ctrlr_destruct, (struct spdk_nvmf_ctrlr *ctrlr));
+DEFINE_STUB_V(nvmf_ns_info_free_fq_flows, (struct spdk_nvmf_subsystem_pg_ns_info *ns_info));
+DEFINE_STUB_V(nvmf_subsystem_pg_free_ctrlrs, (struct spdk_nvmf_subsystem_poll_group *sgroup));
 DEFINE_STUB_V(nvmf_transport_qpair_fini, (struct spdk_nvmf_qpair *qpair,
 		spdk_nvmf_transport_qpair_fini_cb cb_fn,
 		void *cb_arg));
@@ -173,6 +173,60 @@ test_spdk_rpc_is_method_allowed(void)
 	CU_ASSERT(rc == -ENOENT);
 }
 
+static void
+test_spdk_rpc_concurrency_key(void)
+{
+	struct spdk_rpc_method *m, *alias;
+	const char *key;
+	int rc;
+
+	/* Method registered without a concurrency key */
+	spdk_rpc_register_method("test_serial", fn_rpc_method_handler, SPDK_RPC_RUNTIME);
+	key = (const char *)0xdeadbeef;
+	rc = spdk_rpc_get_method_concurrency_key("test_serial", &key);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(key == NULL);
+
+	/* Method registered with a concurrency key and its alias */
+	spdk_rpc_register_method_concurrent("test_concurrent", fn_rpc_method_handler,
+					    SPDK_RPC_RUNTIME, "name");
+	spdk_rpc_register_alias_deprecated("test_concurrent", "test_concurrent_alias");
+	CU_ASSERT(spdk_rpc_verify_methods());
+
+	key = NULL;
+	rc = spdk_rpc_get_method_concurrency_key("test_concurrent", &key);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(key != NULL);
+	CU_ASSERT(strcmp(key, "name") == 0);
+
+	key = NULL;
+	rc = spdk_rpc_get_method_concurrency_key("test_concurrent_alias", &key);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(key != NULL);
+	CU_ASSERT(strcmp(key, "name") == 0);
+
+	/* Unknown method */
+	rc = spdk_rpc_get_method_concurrency_key("test_unknown", &key);
+	CU_ASSERT(rc == -ENOENT);
+
+	alias = _get_rpc_method_raw("test_concurrent_alias");
+	m = _get_rpc_method_raw("test_concurrent");
+	SPDK_CU_ASSERT_FATAL(alias != NULL && m != NULL);
+	SLIST_REMOVE(&g_rpc_methods, alias, spdk_rpc_method, slist);
+	SLIST_REMOVE(&g_rpc_methods, m, spdk_rpc_method, slist);
+	free((char *)alias->name);
+	free(alias);
+	free((char *)m->name);
+	free(m->concurrency_key);
+	free(m);
+
+	m = _get_rpc_method_raw("test_serial");
+	SPDK_CU_ASSERT_FATAL(m != NULL);
+	SLIST_REMOVE(&g_rpc_methods, m, spdk_rpc_method, slist);
+	free((char *)m->name);
+	free(m);
+}
+
 static void
 test_rpc_get_methods(void)
 {
@@ -282,6 +336,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_jsonrpc_handler);
 	CU_ADD_TEST(suite, test_spdk_rpc_is_method_allowed);
+	CU_ADD_TEST(suite, test_spdk_rpc_concurrency_key);
 	CU_ADD_TEST(suite, test_rpc_get_methods);
 	CU_ADD_TEST(suite, test_rpc_spdk_get_version);
 	CU_ADD_TEST(suite, test_spdk_rpc_listen_close);
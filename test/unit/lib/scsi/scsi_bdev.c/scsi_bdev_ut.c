@@ -86,6 +86,11 @@ DEFINE_STUB(scsi_pr_in, int, (struct spdk_scsi_task *task, uint8_t *cdb,
 
 DEFINE_STUB(scsi2_reserve, int, (struct spdk_scsi_task *task, uint8_t *cdb), 0);
 DEFINE_STUB(scsi2_release, int, (struct spdk_scsi_task *task), 0);
+DEFINE_STUB(scsi_copy_out, int, (struct spdk_scsi_task *task), SPDK_SCSI_TASK_COMPLETE);
+DEFINE_STUB(scsi_copy_in, int, (struct spdk_scsi_task *task), SPDK_SCSI_TASK_COMPLETE);
+DEFINE_STUB(scsi_copy_vpd_page, int, (struct spdk_scsi_lun *lun, uint8_t *buf, uint16_t len), 0);
+DEFINE_STUB_V(scsi_copy_invalidate_tokens, (struct spdk_scsi_lun *lun, uint64_t lba,
+		uint64_t num_blocks));
 
 void
 scsi_lun_complete_task(struct spdk_scsi_lun *lun, struct spdk_scsi_task *task)
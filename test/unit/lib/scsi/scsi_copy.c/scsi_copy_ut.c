@@ -0,0 +1,767 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2026 agent <agent@local>.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "scsi/task.c"
+#include "scsi/scsi_copy.c"
+#include "common/lib/test_env.c"
+
+#include "spdk_internal/cunit.h"
+
+#include "spdk_internal/mock.h"
+#include "spdk/bdev_module.h"
+
+SPDK_LOG_REGISTER_COMPONENT(scsi)
+
+#define UT_BLOCK_SIZE	512
+#define UT_NUM_BLOCKS	8192
+
+struct ut_bdev {
+	struct spdk_bdev	bdev;
+	uint8_t			data[UT_NUM_BLOCKS * UT_BLOCK_SIZE];
+};
+
+static struct ut_bdev g_ut_bdev[2];
+static struct spdk_scsi_dev g_dev;
+static struct spdk_scsi_lun g_lun[3];
+static struct spdk_scsi_port g_i_port;
+static struct spdk_bdev_io g_bdev_io;
+static int g_copy_cnt;
+static int g_read_cnt;
+static int g_write_cnt;
+static int g_write_zeroes_cnt;
+static int g_task_completed;
+static bool g_copy_supported;
+
+DEFINE_STUB_V(spdk_bdev_free_io, (struct spdk_bdev_io *bdev_io));
+DEFINE_STUB(spdk_bdev_queue_io_wait, int, (struct spdk_bdev *bdev, struct spdk_io_channel *ch,
+		struct spdk_bdev_io_wait_entry *entry), 0);
+
+const char *
+spdk_bdev_get_name(const struct spdk_bdev *bdev)
+{
+	return bdev->name;
+}
+
+uint32_t
+spdk_bdev_get_block_size(const struct spdk_bdev *bdev)
+{
+	return bdev->blocklen;
+}
+
+uint64_t
+spdk_bdev_get_num_blocks(const struct spdk_bdev *bdev)
+{
+	return bdev->blockcnt;
+}
+
+uint32_t
+spdk_bdev_get_md_size(const struct spdk_bdev *bdev)
+{
+	return bdev->md_len;
+}
+
+size_t
+spdk_bdev_get_buf_align(const struct spdk_bdev *bdev)
+{
+	return 64;
+}
+
+bool
+spdk_bdev_io_type_supported(struct spdk_bdev *bdev, enum spdk_bdev_io_type io_type)
+{
+	CU_ASSERT(io_type == SPDK_BDEV_IO_TYPE_COPY);
+	return g_copy_supported;
+}
+
+void
+bdev_scsi_set_naa_ieee_extended(const char *name, uint8_t *buf)
+{
+	memset(buf, 0, 8);
+	snprintf((char *)buf, 8, "%s", name);
+}
+
+void
+scsi_lun_complete_task(struct spdk_scsi_lun *lun, struct spdk_scsi_task *task)
+{
+	g_task_completed++;
+}
+
+static uint8_t *
+ut_blocks(struct spdk_bdev_desc *desc, uint64_t lba)
+{
+	struct ut_bdev *ut_bdev = (struct ut_bdev *)desc;
+
+	SPDK_CU_ASSERT_FATAL(lba < UT_NUM_BLOCKS);
+	return &ut_bdev->data[lba * UT_BLOCK_SIZE];
+}
+
+int
+spdk_bdev_copy_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+		      uint64_t dst_offset_blocks, uint64_t src_offset_blocks, uint64_t num_blocks,
+		      spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	g_copy_cnt++;
+	memmove(ut_blocks(desc, dst_offset_blocks), ut_blocks(desc, src_offset_blocks),
+		num_blocks * UT_BLOCK_SIZE);
+	cb(&g_bdev_io, true, cb_arg);
+	return 0;
+}
+
+int
+spdk_bdev_read_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch, void *buf,
+		      uint64_t offset_blocks, uint64_t num_blocks,
+		      spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	g_read_cnt++;
+	memcpy(buf, ut_blocks(desc, offset_blocks), num_blocks * UT_BLOCK_SIZE);
+	cb(&g_bdev_io, true, cb_arg);
+	return 0;
+}
+
+int
+spdk_bdev_write_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch, void *buf,
+		       uint64_t offset_blocks, uint64_t num_blocks,
+		       spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	g_write_cnt++;
+	memcpy(ut_blocks(desc, offset_blocks), buf, num_blocks * UT_BLOCK_SIZE);
+	cb(&g_bdev_io, true, cb_arg);
+	return 0;
+}
+
+int
+spdk_bdev_write_zeroes_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+			      uint64_t offset_blocks, uint64_t num_blocks,
+			      spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	g_write_zeroes_cnt++;
+	memset(ut_blocks(desc, offset_blocks), 0, num_blocks * UT_BLOCK_SIZE);
+	cb(&g_bdev_io, true, cb_arg);
+	return 0;
+}
+
+/*
+ * LUN 0 and LUN 1 are both backed by bdev "bdev0", LUN 2 by "bdev1".  The
+ * identification descriptors use the name of the bdev as NAA designator, so
+ * LUN 1 can only be addressed through the token of LUN 0.
+ */
+static void
+ut_init(void)
+{
+	int i, j;
+
+	memset(&g_dev, 0, sizeof(g_dev));
+	TAILQ_INIT(&g_dev.luns);
+
+	for (i = 0; i < 2; i++) {
+		memset(&g_ut_bdev[i], 0, sizeof(g_ut_bdev[i]));
+		g_ut_bdev[i].bdev.name = i == 0 ? "bdev0" : "bdev1";
+		g_ut_bdev[i].bdev.blocklen = UT_BLOCK_SIZE;
+		g_ut_bdev[i].bdev.blockcnt = UT_NUM_BLOCKS;
+		for (j = 0; j < UT_NUM_BLOCKS; j++) {
+			memset(&g_ut_bdev[i].data[j * UT_BLOCK_SIZE], i * 0x80 + j, UT_BLOCK_SIZE);
+			/* Tag each block, the pattern alone repeats */
+			to_be32(&g_ut_bdev[i].data[j * UT_BLOCK_SIZE], i * UT_NUM_BLOCKS + j);
+		}
+	}
+
+	for (i = 0; i < 3; i++) {
+		memset(&g_lun[i], 0, sizeof(g_lun[i]));
+		g_lun[i].id = i;
+		g_lun[i].dev = &g_dev;
+		g_lun[i].bdev = &g_ut_bdev[i / 2].bdev;
+		g_lun[i].bdev_desc = (struct spdk_bdev_desc *)&g_ut_bdev[i / 2];
+		g_lun[i].io_channel = (struct spdk_io_channel *)0xDEADBEEF;
+		g_lun[i].thread = spdk_get_thread();
+		TAILQ_INIT(&g_lun[i].copy_results);
+	}
+	/* LUN 1 is only reachable by token */
+	TAILQ_INSERT_TAIL(&g_dev.luns, &g_lun[0], tailq);
+	TAILQ_INSERT_TAIL(&g_dev.luns, &g_lun[2], tailq);
+
+	g_copy_cnt = 0;
+	g_read_cnt = 0;
+	g_write_cnt = 0;
+	g_write_zeroes_cnt = 0;
+	g_task_completed = 0;
+	g_copy_supported = true;
+}
+
+static void
+ut_fini(void)
+{
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		scsi_copy_free_results(&g_lun[i]);
+	}
+}
+
+static void
+ut_init_task(struct spdk_scsi_task *task, struct spdk_scsi_lun *lun, uint8_t *cdb,
+	     void *data, uint32_t len)
+{
+	memset(task, 0, sizeof(*task));
+	task->lun = lun;
+	task->cdb = cdb;
+	task->initiator_port = &g_i_port;
+	task->iovs = &task->iov;
+	task->iovcnt = 1;
+	if (data != NULL) {
+		spdk_scsi_task_set_data(task, data, len);
+	}
+}
+
+static void
+ut_put_task(struct spdk_scsi_task *task)
+{
+	if (task->alloc_len) {
+		free(task->iov.iov_base);
+	}
+}
+
+static void
+ut_copy_cdb(uint8_t *cdb, uint8_t opcode, uint8_t sa, uint32_t list_id, uint32_t len)
+{
+	memset(cdb, 0, 16);
+	cdb[0] = opcode;
+	cdb[1] = sa;
+	to_be32(&cdb[opcode == SPDK_SPC_EXTENDED_COPY ? 6 : 2], list_id);
+	to_be32(&cdb[10], len);
+}
+
+static void
+ut_check_sense(struct spdk_scsi_task *task, int sk, int asc, int ascq)
+{
+	CU_ASSERT(task->status == SPDK_SCSI_STATUS_CHECK_CONDITION);
+	CU_ASSERT((task->sense_data[2] & 0xf) == sk);
+	CU_ASSERT(task->sense_data[12] == asc);
+	CU_ASSERT(task->sense_data[13] == ascq);
+}
+
+static bool
+ut_blocks_equal(struct spdk_scsi_lun *dst, uint64_t dst_lba, struct spdk_scsi_lun *src,
+		uint64_t src_lba, uint64_t num_blocks)
+{
+	return memcmp(ut_blocks(dst->bdev_desc, dst_lba), ut_blocks(src->bdev_desc, src_lba),
+		      num_blocks * UT_BLOCK_SIZE) == 0;
+}
+
+static uint32_t
+ut_build_xcopy(uint8_t *data, struct spdk_scsi_lun **tgts, int num_tgts, uint16_t src_idx,
+	       uint16_t dst_idx, uint64_t src_lba, uint64_t dst_lba, uint16_t num_blocks)
+{
+	uint8_t *desc;
+	int i;
+
+	memset(data, 0, 16);
+	to_be16(&data[2], num_tgts * SCSI_COPY_TGT_DESC_LEN);
+	to_be32(&data[8], SCSI_COPY_SEG_DESC_LEN);
+
+	for (i = 0; i < num_tgts; i++) {
+		scsi_copy_build_tgt_desc(tgts[i], &data[16 + i * SCSI_COPY_TGT_DESC_LEN]);
+	}
+
+	desc = &data[16 + num_tgts * SCSI_COPY_TGT_DESC_LEN];
+	memset(desc, 0, SCSI_COPY_SEG_DESC_LEN);
+	desc[0] = SPDK_SPC_XCOPY_SEG_DESC_BLOCK_TO_BLOCK;
+	to_be16(&desc[2], SCSI_COPY_SEG_DESC_LEN - 4);
+	to_be16(&desc[4], src_idx);
+	to_be16(&desc[6], dst_idx);
+	to_be16(&desc[10], num_blocks);
+	to_be64(&desc[12], src_lba);
+	to_be64(&desc[20], dst_lba);
+
+	return 16 + num_tgts * SCSI_COPY_TGT_DESC_LEN + SCSI_COPY_SEG_DESC_LEN;
+}
+
+static void
+xcopy_same_lun(void)
+{
+	struct spdk_scsi_lun *tgts[1] = { &g_lun[0] };
+	struct spdk_scsi_task task;
+	uint8_t cdb[16], data[128];
+	uint32_t len;
+	int rc;
+
+	ut_init();
+
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, 0, 32, 8);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_EXTENDED_COPY_LID1, 0, len);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(g_task_completed == 1);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_copy_cnt == 1);
+	CU_ASSERT(g_read_cnt == 0);
+	CU_ASSERT(ut_blocks_equal(&g_lun[0], 32, &g_lun[0], 0, 8));
+
+	ut_put_task(&task);
+	ut_fini();
+}
+
+static void
+xcopy_cross_lun(void)
+{
+	struct spdk_scsi_lun *tgts[2] = { &g_lun[0], &g_lun[2] };
+	struct spdk_scsi_task task;
+	uint8_t cdb[16], data[128], expected[8 * UT_BLOCK_SIZE];
+	uint32_t len;
+	int rc;
+
+	ut_init();
+
+	memcpy(expected, ut_blocks(g_lun[0].bdev_desc, 4), sizeof(expected));
+
+	/* Copy from LUN 0 to LUN 2 goes through the bounce buffer */
+	len = ut_build_xcopy(data, tgts, 2, 0, 1, 4, 16, 8);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_EXTENDED_COPY_LID1, 0, len);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_copy_cnt == 0);
+	CU_ASSERT(g_read_cnt == 1);
+	CU_ASSERT(g_write_cnt == 1);
+	CU_ASSERT(memcmp(ut_blocks(g_lun[2].bdev_desc, 16), expected, sizeof(expected)) == 0);
+	ut_put_task(&task);
+
+	/* The copy target is served by another thread */
+	g_lun[2].thread = (struct spdk_thread *)0xDEADBEEF;
+	g_task_completed = 0;
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	CU_ASSERT(g_task_completed == 0);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_COPY_ABORTED,
+		       SPDK_SCSI_ASC_COPY_TARGET_DEVICE_NOT_REACHABLE,
+		       SPDK_SCSI_ASCQ_COPY_TARGET_DEVICE_NOT_REACHABLE);
+	ut_put_task(&task);
+
+	/* Different block sizes */
+	g_lun[2].thread = spdk_get_thread();
+	g_ut_bdev[1].bdev.blocklen = 4096;
+	len = ut_build_xcopy(data, tgts, 2, 0, 1, 4, 0, 1);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_EXTENDED_COPY_LID1, 0, len);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+		       SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	ut_put_task(&task);
+
+	ut_fini();
+}
+
+static void
+xcopy_same_lun_no_copy_support(void)
+{
+	struct spdk_scsi_lun *tgts[1] = { &g_lun[0] };
+	struct spdk_scsi_task task;
+	/* Larger than the bounce buffer */
+	const uint16_t num_blocks = SCSI_COPY_BUF_SIZE / UT_BLOCK_SIZE + 256;
+	uint8_t cdb[16], data[128], *expected;
+	uint32_t len;
+	int rc;
+
+	ut_init();
+	g_copy_supported = false;
+
+	expected = malloc(num_blocks * UT_BLOCK_SIZE);
+	SPDK_CU_ASSERT_FATAL(expected != NULL);
+
+	/* The copy goes through the bounce buffer, a step at a time */
+	memcpy(expected, ut_blocks(g_lun[0].bdev_desc, 8), num_blocks * UT_BLOCK_SIZE);
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, 8, 4096, num_blocks);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_EXTENDED_COPY_LID1, 0, len);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(g_task_completed == 1);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_copy_cnt == 0);
+	CU_ASSERT(g_read_cnt == 2);
+	CU_ASSERT(g_write_cnt == 2);
+	CU_ASSERT(memcmp(ut_blocks(g_lun[0].bdev_desc, 4096), expected,
+			 num_blocks * UT_BLOCK_SIZE) == 0);
+	ut_put_task(&task);
+
+	/* Overlapping ranges with the destination after the source are copied back to front */
+	memcpy(expected, ut_blocks(g_lun[0].bdev_desc, 0), num_blocks * UT_BLOCK_SIZE);
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, 0, 1024, num_blocks);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(g_task_completed == 2);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_copy_cnt == 0);
+	CU_ASSERT(g_read_cnt == 4);
+	CU_ASSERT(memcmp(ut_blocks(g_lun[0].bdev_desc, 1024), expected,
+			 num_blocks * UT_BLOCK_SIZE) == 0);
+	ut_put_task(&task);
+
+	/* And front to back with the destination before the source */
+	memcpy(expected, ut_blocks(g_lun[0].bdev_desc, 1024), num_blocks * UT_BLOCK_SIZE);
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, 1024, 0, num_blocks);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(memcmp(ut_blocks(g_lun[0].bdev_desc, 0), expected,
+			 num_blocks * UT_BLOCK_SIZE) == 0);
+	ut_put_task(&task);
+
+	free(expected);
+	ut_fini();
+}
+
+static void
+xcopy_invalid_params(void)
+{
+	struct spdk_scsi_lun *tgts[1] = { &g_lun[0] };
+	struct spdk_scsi_task task;
+	uint8_t cdb[16], data[128];
+	uint32_t len;
+	int rc;
+
+	ut_init();
+
+	/* Out of range source */
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, UT_NUM_BLOCKS - 4, 0, 8);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_EXTENDED_COPY_LID1, 0, len);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE,
+		       SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	ut_put_task(&task);
+
+	/* Segment refers to a non existing target descriptor */
+	len = ut_build_xcopy(data, tgts, 1, 0, 1, 0, 0, 8);
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+		       SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	ut_put_task(&task);
+
+	/* Unsupported segment descriptor type */
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, 0, 0, 8);
+	data[16 + SCSI_COPY_TGT_DESC_LEN] = 0x0a;
+	ut_init_task(&task, &g_lun[0], cdb, data, len);
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_FIELD_IN_PARAMETER_LIST,
+		       SPDK_SCSI_ASCQ_UNSUPPORTED_SEGMENT_DESCRIPTOR_TYPE_CODE);
+	ut_put_task(&task);
+
+	/* Truncated parameter list */
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_EXTENDED_COPY_LID1, 0, len - 4);
+	len = ut_build_xcopy(data, tgts, 1, 0, 0, 0, 0, 8);
+	ut_init_task(&task, &g_lun[0], cdb, data, len - 4);
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_PARAMETER_LIST_LENGTH_ERROR,
+		       SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	ut_put_task(&task);
+
+	CU_ASSERT(g_task_completed == 0);
+	CU_ASSERT(g_copy_cnt == 0);
+
+	ut_fini();
+}
+
+static void
+ut_populate_token(struct spdk_scsi_lun *lun, uint32_t list_id, uint64_t lba, uint32_t num_blocks,
+		  uint8_t *token)
+{
+	struct spdk_scsi_task task;
+	uint8_t cdb[16], data[32], *rrti;
+	int rc;
+
+	/* POPULATE TOKEN with a single range */
+	memset(data, 0, sizeof(data));
+	to_be16(&data[14], SCSI_COPY_RANGE_DESC_LEN);
+	to_be64(&data[16], lba);
+	to_be32(&data[24], num_blocks);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_POPULATE_TOKEN, list_id, sizeof(data));
+	ut_init_task(&task, lun, cdb, data, sizeof(data));
+
+	rc = scsi_copy_out(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	ut_put_task(&task);
+
+	/* RECEIVE ROD TOKEN INFORMATION */
+	ut_copy_cdb(cdb, SPDK_SPC_RECEIVE_COPY_RESULTS, SPDK_SPC_SA_RECEIVE_ROD_TOKEN_INFORMATION,
+		    list_id, 1024);
+	ut_init_task(&task, lun, cdb, NULL, 0);
+
+	rc = scsi_copy_in(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(task.data_transferred == SCSI_COPY_RRTI_HDR_LEN + 6 + SPDK_SPC_ROD_TOKEN_LENGTH);
+
+	rrti = task.iov.iov_base;
+	SPDK_CU_ASSERT_FATAL(rrti != NULL);
+	CU_ASSERT(rrti[4] == SPDK_SPC_SA_POPULATE_TOKEN);
+	CU_ASSERT(rrti[5] == SCSI_COPY_STATUS_COMPLETED);
+	CU_ASSERT(from_be64(&rrti[16]) == num_blocks);
+	CU_ASSERT(from_be32(&rrti[SCSI_COPY_RRTI_HDR_LEN]) == 2 + SPDK_SPC_ROD_TOKEN_LENGTH);
+	memcpy(token, &rrti[SCSI_COPY_RRTI_HDR_LEN + 6], SPDK_SPC_ROD_TOKEN_LENGTH);
+	CU_ASSERT(from_be32(&token[0]) == SPDK_SPC_ROD_TYPE_PIT_COPY_DEFAULT);
+	ut_put_task(&task);
+}
+
+static int
+ut_write_using_token(struct spdk_scsi_lun *lun, uint32_t list_id, const uint8_t *token,
+		     uint64_t offset, uint64_t lba, uint32_t num_blocks, struct spdk_scsi_task *task)
+{
+	static uint8_t data[536 + SCSI_COPY_RANGE_DESC_LEN];
+	static uint8_t cdb[16];
+
+	memset(data, 0, sizeof(data));
+	to_be64(&data[8], offset);
+	memcpy(&data[16], token, SPDK_SPC_ROD_TOKEN_LENGTH);
+	to_be16(&data[534], SCSI_COPY_RANGE_DESC_LEN);
+	to_be64(&data[536], lba);
+	to_be32(&data[544], num_blocks);
+	ut_copy_cdb(cdb, SPDK_SPC_EXTENDED_COPY, SPDK_SPC_SA_WRITE_USING_TOKEN, list_id, sizeof(data));
+	ut_init_task(task, lun, cdb, data, sizeof(data));
+
+	return scsi_copy_out(task);
+}
+
+static void
+token_copy(void)
+{
+	struct spdk_scsi_task task;
+	uint8_t token[SPDK_SPC_ROD_TOKEN_LENGTH];
+	uint8_t cdb[16], *rrti;
+	int rc;
+
+	ut_init();
+
+	ut_populate_token(&g_lun[0], 1, 8, 16, token);
+
+	/* Within the same bdev the copy is offloaded, LUN 1 shares the bdev of LUN 0 */
+	rc = ut_write_using_token(&g_lun[1], 2, token, 4, 40, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_task_completed == 1);
+	CU_ASSERT(g_copy_cnt == 1);
+	CU_ASSERT(ut_blocks_equal(&g_lun[1], 40, &g_lun[0], 12, 8));
+	ut_put_task(&task);
+
+	/* Across bdevs the target copies the data itself; the ROD is 4 blocks short */
+	rc = ut_write_using_token(&g_lun[2], 3, token, 12, 0, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_read_cnt == 1);
+	CU_ASSERT(g_write_cnt == 1);
+	CU_ASSERT(ut_blocks_equal(&g_lun[2], 0, &g_lun[0], 20, 4));
+	ut_put_task(&task);
+
+	ut_copy_cdb(cdb, SPDK_SPC_RECEIVE_COPY_RESULTS, SPDK_SPC_SA_RECEIVE_ROD_TOKEN_INFORMATION,
+		    3, 1024);
+	ut_init_task(&task, &g_lun[2], cdb, NULL, 0);
+	rc = scsi_copy_in(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	CU_ASSERT(task.data_transferred == SCSI_COPY_RRTI_HDR_LEN + 4);
+	rrti = task.iov.iov_base;
+	SPDK_CU_ASSERT_FATAL(rrti != NULL);
+	CU_ASSERT(rrti[4] == SPDK_SPC_SA_WRITE_USING_TOKEN);
+	CU_ASSERT(from_be64(&rrti[16]) == 4);
+	ut_put_task(&task);
+
+	/* An offset past the 16 blocks of the token is rejected instead of copying nothing */
+	rc = ut_write_using_token(&g_lun[2], 4, token, 16, 0, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB, SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	ut_put_task(&task);
+
+	/* Overwriting the source cancels the token */
+	scsi_copy_invalidate_tokens(&g_lun[0], 23, 1);
+	rc = ut_write_using_token(&g_lun[2], 4, token, 0, 0, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION, SPDK_SCSI_ASCQ_TOKEN_CANCELLED);
+	ut_put_task(&task);
+
+	/* Unknown token */
+	token[200] ^= 0xff;
+	rc = ut_write_using_token(&g_lun[2], 4, token, 0, 0, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION, SPDK_SCSI_ASCQ_TOKEN_UNKNOWN);
+	ut_put_task(&task);
+
+	ut_fini();
+}
+
+static void
+token_expire(void)
+{
+	struct spdk_scsi_task task;
+	uint8_t token[SPDK_SPC_ROD_TOKEN_LENGTH];
+	int rc;
+
+	ut_init();
+
+	ut_populate_token(&g_lun[0], 1, 0, 8, token);
+
+	/* Using the token restarts the inactivity timer */
+	spdk_delay_us((SCSI_COPY_DEFAULT_INACTIVITY_TIMEOUT - 1) * SPDK_SEC_TO_USEC);
+	rc = ut_write_using_token(&g_lun[0], 2, token, 0, 32, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	ut_put_task(&task);
+
+	spdk_delay_us((SCSI_COPY_DEFAULT_INACTIVITY_TIMEOUT - 1) * SPDK_SEC_TO_USEC);
+	rc = ut_write_using_token(&g_lun[0], 2, token, 0, 32, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	ut_put_task(&task);
+
+	spdk_delay_us((SCSI_COPY_DEFAULT_INACTIVITY_TIMEOUT + 1) * SPDK_SEC_TO_USEC);
+	rc = ut_write_using_token(&g_lun[0], 2, token, 0, 32, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION, SPDK_SCSI_ASCQ_TOKEN_EXPIRED);
+	ut_put_task(&task);
+
+	ut_fini();
+}
+
+static void
+token_block_zero(void)
+{
+	struct spdk_scsi_task task;
+	uint8_t token[SPDK_SPC_ROD_TOKEN_LENGTH] = {};
+	uint8_t zeroes[8 * UT_BLOCK_SIZE] = {};
+	int rc;
+
+	ut_init();
+
+	to_be32(&token[0], SPDK_SPC_ROD_TYPE_BLOCK_ZERO);
+	rc = ut_write_using_token(&g_lun[2], 1, token, 0, 8, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_PENDING);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(g_write_zeroes_cnt == 1);
+	CU_ASSERT(memcmp(ut_blocks(g_lun[2].bdev_desc, 8), zeroes, sizeof(zeroes)) == 0);
+	ut_put_task(&task);
+
+	/* Unsupported ROD type */
+	to_be32(&token[0], 0x00800001);
+	rc = ut_write_using_token(&g_lun[2], 1, token, 0, 8, 8, &task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_TOKEN_OPERATION, SPDK_SCSI_ASCQ_UNSUPPORTED_TOKEN_TYPE);
+	ut_put_task(&task);
+
+	ut_fini();
+}
+
+static void
+token_results_limit(void)
+{
+	uint8_t token[SPDK_SPC_ROD_TOKEN_LENGTH];
+	uint32_t i;
+
+	ut_init();
+
+	for (i = 0; i < SCSI_COPY_MAX_RESULTS + 4; i++) {
+		ut_populate_token(&g_lun[0], i, 0, 1, token);
+	}
+
+	/* The oldest results are dropped, a reused list identifier replaces the result */
+	CU_ASSERT(g_lun[0].num_copy_results == SCSI_COPY_MAX_RESULTS);
+	CU_ASSERT(scsi_copy_find_result(&g_lun[0], &g_i_port, 0) == NULL);
+	CU_ASSERT(scsi_copy_find_result(&g_lun[0], &g_i_port, 4) != NULL);
+	ut_populate_token(&g_lun[0], 4, 0, 1, token);
+	CU_ASSERT(g_lun[0].num_copy_results == SCSI_COPY_MAX_RESULTS);
+
+	ut_fini();
+	CU_ASSERT(g_lun[0].num_copy_results == 0);
+	CU_ASSERT(TAILQ_EMPTY(&g_lun[0].copy_results));
+}
+
+static void
+receive_operating_parameters(void)
+{
+	struct spdk_scsi_task task;
+	uint8_t cdb[16], *data;
+	int rc;
+
+	ut_init();
+
+	ut_copy_cdb(cdb, SPDK_SPC_RECEIVE_COPY_RESULTS,
+		    SPDK_SPC_SA_RECEIVE_COPY_OPERATING_PARAMETERS, 0, 256);
+	ut_init_task(&task, &g_lun[0], cdb, NULL, 0);
+
+	rc = scsi_copy_in(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	CU_ASSERT(task.status == SPDK_SCSI_STATUS_GOOD);
+	CU_ASSERT(task.data_transferred == SCSI_COPY_OPER_PARAMS_LEN);
+	data = task.iov.iov_base;
+	SPDK_CU_ASSERT_FATAL(data != NULL);
+	CU_ASSERT(from_be16(&data[8]) == SCSI_COPY_MAX_TGT_DESCS);
+	CU_ASSERT(from_be16(&data[10]) == SCSI_COPY_MAX_SEG_DESCS);
+	CU_ASSERT(data[42] == 2);
+	CU_ASSERT(data[43] == SPDK_SPC_XCOPY_SEG_DESC_BLOCK_TO_BLOCK);
+	CU_ASSERT(data[44] == SPDK_SPC_XCOPY_TGT_DESC_IDENTIFICATION);
+	ut_put_task(&task);
+
+	/* Unsupported service action */
+	ut_copy_cdb(cdb, SPDK_SPC_RECEIVE_COPY_RESULTS, 0x05, 0, 256);
+	ut_init_task(&task, &g_lun[0], cdb, NULL, 0);
+	rc = scsi_copy_in(&task);
+	CU_ASSERT(rc == SPDK_SCSI_TASK_COMPLETE);
+	ut_check_sense(&task, SPDK_SCSI_SENSE_ILLEGAL_REQUEST,
+		       SPDK_SCSI_ASC_INVALID_FIELD_IN_CDB, SPDK_SCSI_ASCQ_CAUSE_NOT_REPORTABLE);
+	ut_put_task(&task);
+
+	ut_fini();
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite	suite = NULL;
+	unsigned int	num_failures;
+
+	CU_initialize_registry();
+
+	suite = CU_add_suite("copy_suite", NULL, NULL);
+	CU_ADD_TEST(suite, xcopy_same_lun);
+	CU_ADD_TEST(suite, xcopy_cross_lun);
+	CU_ADD_TEST(suite, xcopy_same_lun_no_copy_support);
+	CU_ADD_TEST(suite, xcopy_invalid_params);
+	CU_ADD_TEST(suite, token_copy);
+	CU_ADD_TEST(suite, token_expire);
+	CU_ADD_TEST(suite, token_block_zero);
+	CU_ADD_TEST(suite, token_results_limit);
+	CU_ADD_TEST(suite, receive_operating_parameters);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+	return num_failures;
+}
@@ -704,6 +704,235 @@ iobuf_priority(void)
 	free_cores();
 }
 
+static void
+ut_iobuf_get_stats_cb(struct spdk_iobuf_module_stats *modules, uint32_t num_modules, void *cb_arg)
+{
+	struct spdk_iobuf_module_stats *stats = cb_arg;
+
+	SPDK_CU_ASSERT_FATAL(num_modules == 1);
+	*stats = modules[0];
+}
+
+static void
+iobuf_handoff(void)
+{
+	struct spdk_iobuf_opts opts = {
+		.small_pool_count = 2,
+		.large_pool_count = 2,
+		.small_bufsize = SMALL_BUFSIZE,
+		.large_bufsize = LARGE_BUFSIZE,
+	};
+	struct ut_iobuf_entry entries[3] = {};
+	struct spdk_iobuf_module_stats stats = {};
+	struct spdk_iobuf_channel iobuf_ch[2];
+	int rc, finish = 0;
+
+	allocate_cores(2);
+	allocate_threads(2);
+
+	set_thread(0);
+
+	/* We cannot use spdk_iobuf_set_opts(), as it won't allow us to use such small pools */
+	g_iobuf.opts = opts;
+	rc = spdk_iobuf_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module");
+	CU_ASSERT_EQUAL(rc, 0);
+	rc = spdk_iobuf_channel_init(&iobuf_ch[0], "ut_module", 1, 1);
+	CU_ASSERT_EQUAL(rc, 0);
+	set_thread(1);
+	rc = spdk_iobuf_channel_init(&iobuf_ch[1], "ut_module", 0, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* Exhaust the main pool on thread 1 and queue a request there */
+	entries[0].buf = spdk_iobuf_get(&iobuf_ch[1], SMALL_BUFSIZE, NULL, NULL);
+	CU_ASSERT_PTR_NOT_NULL(entries[0].buf);
+	entries[1].buf = spdk_iobuf_get(&iobuf_ch[1], SMALL_BUFSIZE, &entries[1].iobuf,
+					ut_iobuf_get_buf_cb);
+	CU_ASSERT_PTR_NULL(entries[1].buf);
+	CU_ASSERT_EQUAL(g_iobuf.node[0].small_waiters, 1);
+
+	/* Get a buffer from the cache on thread 0 and release it.  Since there's a request waiting
+	 * on thread 1, it shouldn't go back to the cache, but to the main pool.
+	 */
+	set_thread(0);
+	entries[2].buf = spdk_iobuf_get(&iobuf_ch[0], SMALL_BUFSIZE, NULL, NULL);
+	CU_ASSERT_PTR_NOT_NULL(entries[2].buf);
+	spdk_iobuf_put(&iobuf_ch[0], entries[2].buf, SMALL_BUFSIZE);
+	CU_ASSERT_EQUAL(iobuf_ch[0].cache[0].small.cache_count, 0);
+	CU_ASSERT_EQUAL(iobuf_ch[0].cache[0].small.stats.handoff, 1);
+	CU_ASSERT_PTR_NULL(entries[1].buf);
+
+	/* Thread 1 only checks the main pool periodically */
+	poll_threads();
+	CU_ASSERT_PTR_NULL(entries[1].buf);
+
+	/* Once thread 1's poller runs, the request should be completed */
+	spdk_delay_us(IOBUF_CHANNEL_POLL_PERIOD_US);
+	poll_threads();
+	CU_ASSERT_PTR_EQUAL(entries[1].buf, entries[2].buf);
+	CU_ASSERT_EQUAL(g_iobuf.node[0].small_waiters, 0);
+
+	/* With no more requests waiting, buffers should be cached again */
+	set_thread(1);
+	spdk_iobuf_put(&iobuf_ch[1], entries[1].buf, SMALL_BUFSIZE);
+	set_thread(0);
+	entries[1].buf = spdk_iobuf_get(&iobuf_ch[0], SMALL_BUFSIZE, NULL, NULL);
+	CU_ASSERT_PTR_NOT_NULL(entries[1].buf);
+	spdk_iobuf_put(&iobuf_ch[0], entries[1].buf, SMALL_BUFSIZE);
+	CU_ASSERT_EQUAL(iobuf_ch[0].cache[0].small.cache_count, 1);
+	CU_ASSERT_EQUAL(iobuf_ch[0].cache[0].small.stats.handoff, 1);
+
+	rc = spdk_iobuf_get_stats(ut_iobuf_get_stats_cb, &stats);
+	CU_ASSERT_EQUAL(rc, 0);
+	poll_threads();
+	CU_ASSERT_EQUAL(stats.small_pool.retry, 1);
+	CU_ASSERT_EQUAL(stats.small_pool.handoff, 1);
+	/* Thread 1 held two buffers, thread 0 one */
+	CU_ASSERT_EQUAL(stats.small_pool.high_watermark, 3);
+	CU_ASSERT_EQUAL(stats.small_pool.low_watermark, 0);
+	CU_ASSERT_EQUAL(stats.large_pool.high_watermark, 0);
+	CU_ASSERT_EQUAL(stats.large_pool.low_watermark, 1);
+
+	set_thread(1);
+	spdk_iobuf_put(&iobuf_ch[1], entries[0].buf, SMALL_BUFSIZE);
+	spdk_iobuf_channel_fini(&iobuf_ch[1]);
+	set_thread(0);
+	spdk_iobuf_channel_fini(&iobuf_ch[0]);
+	poll_threads();
+
+	spdk_iobuf_finish(ut_iobuf_finish_cb, &finish);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(finish, 1);
+
+	free_threads();
+	free_cores();
+}
+
+struct ut_iobuf_iov_entry {
+	struct spdk_iobuf_iov_entry	iobuf;
+	struct iovec			iovs[4];
+	int				iovcnt;
+};
+
+static void
+ut_iobuf_get_iov_cb(struct spdk_iobuf_iov_entry *entry, int iovcnt)
+{
+	struct ut_iobuf_iov_entry *ut_entry = SPDK_CONTAINEROF(entry, struct ut_iobuf_iov_entry,
+					      iobuf);
+
+	ut_entry->iovcnt = iovcnt;
+}
+
+static void
+iobuf_iov(void)
+{
+	struct spdk_iobuf_opts opts = {
+		.small_pool_count = 2,
+		.large_pool_count = 2,
+		.small_bufsize = SMALL_BUFSIZE,
+		.large_bufsize = LARGE_BUFSIZE,
+	};
+	struct ut_iobuf_iov_entry entry = {};
+	struct spdk_iobuf_channel iobuf_ch;
+	void *bufs[2];
+	int rc, finish = 0;
+
+	allocate_cores(1);
+	allocate_threads(1);
+
+	set_thread(0);
+
+	/* We cannot use spdk_iobuf_set_opts(), as it won't allow us to use such small pools */
+	g_iobuf.opts = opts;
+	rc = spdk_iobuf_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module");
+	CU_ASSERT_EQUAL(rc, 0);
+	rc = spdk_iobuf_channel_init(&iobuf_ch, "ut_module", 0, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* Check that a request larger than a single buffer is split into large buffers, with the
+	 * remainder taken from the small pool.
+	 */
+	rc = spdk_iobuf_get_iov(&iobuf_ch, LARGE_BUFSIZE * 2 + 512, 0, entry.iovs,
+				SPDK_COUNTOF(entry.iovs), NULL, NULL);
+	CU_ASSERT_EQUAL(rc, 3);
+	CU_ASSERT_PTR_NOT_NULL(entry.iovs[0].iov_base);
+	CU_ASSERT_EQUAL(entry.iovs[0].iov_len, LARGE_BUFSIZE);
+	CU_ASSERT_PTR_NOT_NULL(entry.iovs[1].iov_base);
+	CU_ASSERT_EQUAL(entry.iovs[1].iov_len, LARGE_BUFSIZE);
+	CU_ASSERT_PTR_NOT_NULL(entry.iovs[2].iov_base);
+	CU_ASSERT_EQUAL(entry.iovs[2].iov_len, 512);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].large_pool), 0);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].small_pool), 1);
+	spdk_iobuf_put_iov(&iobuf_ch, entry.iovs, rc);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].large_pool), 2);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].small_pool), 2);
+
+	/* The iovs array needs to be large enough */
+	rc = spdk_iobuf_get_iov(&iobuf_ch, LARGE_BUFSIZE * 2 + 512, 0, entry.iovs, 2, NULL, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+
+	/* Without a callback, the buffers acquired so far should be released on failure */
+	bufs[0] = spdk_iobuf_get(&iobuf_ch, LARGE_BUFSIZE, NULL, NULL);
+	CU_ASSERT_PTR_NOT_NULL(bufs[0]);
+	rc = spdk_iobuf_get_iov(&iobuf_ch, LARGE_BUFSIZE * 2, 0, entry.iovs,
+				SPDK_COUNTOF(entry.iovs), NULL, NULL);
+	CU_ASSERT_EQUAL(rc, -ENOMEM);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].large_pool), 1);
+
+	/* With a callback, they're kept and the callback is executed once the request is done */
+	rc = spdk_iobuf_get_iov(&iobuf_ch, LARGE_BUFSIZE * 2 + 512, 0, entry.iovs,
+				SPDK_COUNTOF(entry.iovs), &entry.iobuf, ut_iobuf_get_iov_cb);
+	CU_ASSERT_EQUAL(rc, -ENOMEM);
+	CU_ASSERT_EQUAL(entry.iobuf.iovcnt, 1);
+	CU_ASSERT_EQUAL(entry.iovcnt, 0);
+	spdk_iobuf_put(&iobuf_ch, bufs[0], LARGE_BUFSIZE);
+	CU_ASSERT_EQUAL(entry.iovcnt, 3);
+	CU_ASSERT_PTR_EQUAL(entry.iovs[1].iov_base, bufs[0]);
+	CU_ASSERT_EQUAL(entry.iovs[1].iov_len, LARGE_BUFSIZE);
+	CU_ASSERT_EQUAL(entry.iovs[2].iov_len, 512);
+	spdk_iobuf_put_iov(&iobuf_ch, entry.iovs, entry.iovcnt);
+
+	/* Check that aborting a request releases the buffers it has already acquired */
+	bufs[0] = spdk_iobuf_get(&iobuf_ch, LARGE_BUFSIZE, NULL, NULL);
+	CU_ASSERT_PTR_NOT_NULL(bufs[0]);
+	entry.iovcnt = 0;
+	rc = spdk_iobuf_get_iov(&iobuf_ch, LARGE_BUFSIZE * 2, 0, entry.iovs,
+				SPDK_COUNTOF(entry.iovs), &entry.iobuf, ut_iobuf_get_iov_cb);
+	CU_ASSERT_EQUAL(rc, -ENOMEM);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].large_pool), 0);
+	spdk_iobuf_iov_entry_abort(&iobuf_ch, &entry.iobuf);
+	CU_ASSERT_EQUAL(entry.iobuf.iovcnt, 0);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].large_pool), 1);
+	spdk_iobuf_put(&iobuf_ch, bufs[0], LARGE_BUFSIZE);
+	CU_ASSERT_EQUAL(entry.iovcnt, 0);
+
+	/* Check a custom buffer size */
+	rc = spdk_iobuf_get_iov(&iobuf_ch, SMALL_BUFSIZE * 2, SMALL_BUFSIZE, entry.iovs,
+				SPDK_COUNTOF(entry.iovs), NULL, NULL);
+	CU_ASSERT_EQUAL(rc, 2);
+	CU_ASSERT_EQUAL(entry.iovs[0].iov_len, SMALL_BUFSIZE);
+	CU_ASSERT_EQUAL(entry.iovs[1].iov_len, SMALL_BUFSIZE);
+	CU_ASSERT_EQUAL(spdk_ring_count(g_iobuf.node[0].small_pool), 0);
+	spdk_iobuf_put_iov(&iobuf_ch, entry.iovs, rc);
+
+	spdk_iobuf_channel_fini(&iobuf_ch);
+	poll_threads();
+
+	spdk_iobuf_finish(ut_iobuf_finish_cb, &finish);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(finish, 1);
+
+	free_threads();
+	free_cores();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -716,6 +945,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, iobuf);
 	CU_ADD_TEST(suite, iobuf_cache);
 	CU_ADD_TEST(suite, iobuf_priority);
+	CU_ADD_TEST(suite, iobuf_handoff);
+	CU_ADD_TEST(suite, iobuf_iov);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -146,6 +146,123 @@ thread_send_msg(void)
 	free_threads();
 }
 
+static uintptr_t g_msg_order[16];
+static uint32_t g_msg_count;
+
+static void
+record_msg_cb(void *ctx)
+{
+	uintptr_t idx = (uintptr_t)ctx;
+
+	g_msg_order[g_msg_count++] = idx;
+}
+
+static void
+thread_send_msg_channel(void)
+{
+	struct spdk_thread *thread0, *thread1, *thread2;
+	uintptr_t i;
+	bool done = false;
+	int rc;
+
+	CU_ASSERT(spdk_thread_lib_set_msg_channel_size(3) == -EINVAL);
+	CU_ASSERT(spdk_thread_lib_set_msg_channel_size(4) == 0);
+
+	allocate_threads(3);
+	thread0 = g_ut_threads[0].thread;
+	thread1 = g_ut_threads[1].thread;
+	thread2 = g_ut_threads[2].thread;
+
+	CU_ASSERT(spdk_thread_lib_set_msg_channel_size(8) == -EBUSY);
+
+	/* Send more messages than the channel from thread 0 to thread 1 can hold. The
+	 * ones that don't fit, and all after them, go through the shared ring.
+	 */
+	g_msg_count = 0;
+	set_thread(0);
+	for (i = 0; i < 10; i++) {
+		rc = spdk_thread_send_msg(thread1, record_msg_cb, (void *)i);
+		CU_ASSERT(rc == 0);
+	}
+	CU_ASSERT(spdk_ring_count(thread1->messages) == 6);
+	CU_ASSERT(thread1->msg_ring_pending == 6);
+	CU_ASSERT(!spdk_thread_is_idle(thread1));
+
+	poll_thread(1);
+	CU_ASSERT(g_msg_count == 10);
+	CU_ASSERT(thread1->msg_ring_pending == 0);
+	for (i = 0; i < 10; i++) {
+		CU_ASSERT(g_msg_order[i] == i);
+	}
+
+	/* Thread 1 sends after thread 0 while thread 0's messages are still pending on
+	 * thread 2's ring. Its message must not overtake them through its own channel.
+	 */
+	g_msg_count = 0;
+	set_thread(0);
+	for (i = 0; i < 5; i++) {
+		spdk_thread_send_msg(thread2, record_msg_cb, (void *)i);
+	}
+	set_thread(1);
+	spdk_thread_send_msg(thread2, record_msg_cb, (void *)5);
+	CU_ASSERT(spdk_ring_count(thread2->messages) == 2);
+
+	poll_thread(2);
+	CU_ASSERT(g_msg_count == 6);
+	for (i = 0; i < 6; i++) {
+		CU_ASSERT(g_msg_order[i] == i);
+	}
+
+	/* A message on the ring goes before a message sent on a channel after it. */
+	g_msg_count = 0;
+	set_thread(INVALID_THREAD);
+	spdk_thread_send_msg(thread2, record_msg_cb, (void *)0);
+	set_thread(0);
+	spdk_thread_send_msg(thread2, record_msg_cb, (void *)1);
+	CU_ASSERT(spdk_ring_count(thread2->messages) == 2);
+
+	poll_thread(2);
+	CU_ASSERT(g_msg_count == 2);
+	CU_ASSERT(g_msg_order[0] == 0);
+	CU_ASSERT(g_msg_order[1] == 1);
+
+	/* A message sent on a channel goes before a message put on the ring after it,
+	 * even if the receiver dequeued the ring first.
+	 */
+	g_msg_count = 0;
+	set_thread(0);
+	spdk_thread_send_msg(thread2, record_msg_cb, (void *)0);
+	CU_ASSERT(spdk_ring_count(thread2->messages) == 0);
+	set_thread(INVALID_THREAD);
+	spdk_thread_send_msg(thread2, record_msg_cb, (void *)1);
+
+	set_thread(2);
+	CU_ASSERT(msg_ring_run_batch(thread2, 1) == 2);
+	CU_ASSERT(g_msg_count == 2);
+	CU_ASSERT(g_msg_order[0] == 0);
+	CU_ASSERT(g_msg_order[1] == 1);
+	CU_ASSERT(thread2->msg_ring_pending == 0);
+
+	/* Messages to self and from outside of an SPDK thread are delivered too. */
+	set_thread(0);
+	spdk_thread_send_msg(thread0, send_msg_cb, &done);
+	poll_thread(0);
+	CU_ASSERT(done);
+
+	done = false;
+	set_thread(INVALID_THREAD);
+	spdk_thread_send_msg(thread0, send_msg_cb, &done);
+	CU_ASSERT(spdk_ring_count(thread0->messages) == 1);
+	poll_thread(0);
+	CU_ASSERT(done);
+
+	/* Leave a message in flight to check the channels are released on exit. */
+	set_thread(1);
+	spdk_thread_send_msg(thread0, record_msg_cb, (void *)0);
+
+	free_threads();
+}
+
 static int
 poller_run_done(void *ctx)
 {
@@ -584,6 +701,134 @@ for_each_channel_remove(void)
 	free_threads();
 }
 
+struct parallel_ctx {
+	int	msg_count[3];
+	int	fail_thread;
+	int	cpl_count;
+	int	cpl_status;
+};
+
+static void
+parallel_channel_msg(struct spdk_io_channel_iter *i)
+{
+	struct parallel_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_io_channel *ch;
+	int id;
+
+	for (id = 0; id < 3; id++) {
+		if (g_ut_threads[id].thread == spdk_get_thread()) {
+			break;
+		}
+	}
+	SPDK_CU_ASSERT_FATAL(id < 3);
+	ch = spdk_io_channel_iter_get_channel(i);
+	CU_ASSERT(spdk_io_channel_get_thread(ch) == spdk_get_thread());
+	ctx->msg_count[id]++;
+	spdk_for_each_channel_continue(i, id == ctx->fail_thread ? -EINVAL : 0);
+}
+
+static void
+parallel_channel_cpl(struct spdk_io_channel_iter *i, int status)
+{
+	struct parallel_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+
+	CU_ASSERT(spdk_io_channel_iter_get_channel(i) == NULL);
+	ctx->cpl_count++;
+	ctx->cpl_status = status;
+}
+
+static void
+for_each_channel_parallel(void)
+{
+	struct spdk_io_channel *ch0, *ch1, *ch2;
+	struct parallel_ctx ctx = { .fail_thread = -1 };
+	struct io_device *dev;
+	int ch_count = 0;
+
+	allocate_threads(3);
+	set_thread(0);
+	spdk_io_device_register(&ch_count, channel_create, channel_destroy, sizeof(int), NULL);
+	dev = RB_MIN(io_device_tree, &g_io_devices);
+	SPDK_CU_ASSERT_FATAL(dev != NULL);
+	ch0 = spdk_get_io_channel(&ch_count);
+	set_thread(1);
+	ch1 = spdk_get_io_channel(&ch_count);
+	set_thread(2);
+	ch2 = spdk_get_io_channel(&ch_count);
+	CU_ASSERT(ch_count == 3);
+
+	/* All the threads get their message at once, in any order */
+	set_thread(0);
+	spdk_for_each_channel_parallel(&ch_count, parallel_channel_msg, &ctx, parallel_channel_cpl);
+	CU_ASSERT(dev->for_each_count == 1);
+	poll_thread(2);
+	CU_ASSERT(ctx.msg_count[2] == 1);
+	poll_thread(1);
+	CU_ASSERT(ctx.msg_count[1] == 1);
+	CU_ASSERT(ctx.msg_count[0] == 0);
+	CU_ASSERT(dev->for_each_count == 1);
+	CU_ASSERT(ctx.cpl_count == 0);
+	poll_thread(0);
+	CU_ASSERT(ctx.msg_count[0] == 1);
+	CU_ASSERT(ctx.cpl_count == 1);
+	CU_ASSERT(ctx.cpl_status == 0);
+	CU_ASSERT(dev->for_each_count == 0);
+
+	/* An error doesn't stop the other channels from being visited */
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.fail_thread = 1;
+	spdk_for_each_channel_parallel(&ch_count, parallel_channel_msg, &ctx, parallel_channel_cpl);
+	poll_threads();
+	CU_ASSERT(ctx.msg_count[0] == 1);
+	CU_ASSERT(ctx.msg_count[1] == 1);
+	CU_ASSERT(ctx.msg_count[2] == 1);
+	CU_ASSERT(ctx.cpl_count == 1);
+	CU_ASSERT(ctx.cpl_status == -EINVAL);
+
+	/* A channel that is released before its thread gets the message is skipped */
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.fail_thread = -1;
+	set_thread(1);
+	spdk_put_io_channel(ch1);
+	set_thread(0);
+	spdk_for_each_channel_parallel(&ch_count, parallel_channel_msg, &ctx, parallel_channel_cpl);
+	CU_ASSERT(ch_count == 3);
+	poll_threads();
+	CU_ASSERT(ch_count == 2);
+	CU_ASSERT(ctx.msg_count[0] == 1);
+	CU_ASSERT(ctx.msg_count[1] == 0);
+	CU_ASSERT(ctx.msg_count[2] == 1);
+	CU_ASSERT(ctx.cpl_count == 1);
+
+	/* Unregister waits for the iteration to finish */
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.fail_thread = -1;
+	set_thread(0);
+	spdk_for_each_channel_parallel(&ch_count, parallel_channel_msg, &ctx, parallel_channel_cpl);
+	spdk_put_io_channel(ch0);
+	set_thread(2);
+	spdk_put_io_channel(ch2);
+	set_thread(0);
+	spdk_io_device_unregister(&ch_count, NULL);
+	CU_ASSERT(!RB_EMPTY(&g_io_devices));
+	poll_threads();
+	CU_ASSERT(ctx.cpl_count == 1);
+	CU_ASSERT(ch_count == 0);
+	CU_ASSERT(RB_EMPTY(&g_io_devices));
+
+	/* No channels */
+	memset(&ctx, 0, sizeof(ctx));
+	spdk_io_device_register(&ch_count, channel_create, channel_destroy, sizeof(int), NULL);
+	spdk_for_each_channel_parallel(&ch_count, parallel_channel_msg, &ctx, parallel_channel_cpl);
+	poll_threads();
+	CU_ASSERT(ctx.cpl_count == 1);
+	CU_ASSERT(ctx.cpl_status == 0);
+	spdk_io_device_unregister(&ch_count, NULL);
+	poll_threads();
+
+	free_threads();
+}
+
 struct unreg_ctx {
 	bool	ch_done;
 	bool	foreach_done;
@@ -2182,11 +2427,13 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, thread_alloc);
 	CU_ADD_TEST(suite, thread_send_msg);
+	CU_ADD_TEST(suite, thread_send_msg_channel);
 	CU_ADD_TEST(suite, thread_poller);
 	CU_ADD_TEST(suite, poller_pause);
 	CU_ADD_TEST(suite, thread_for_each);
 	CU_ADD_TEST(suite, for_each_channel_remove);
 	CU_ADD_TEST(suite, for_each_channel_unreg);
+	CU_ADD_TEST(suite, for_each_channel_parallel);
 	CU_ADD_TEST(suite, thread_name);
 	CU_ADD_TEST(suite, channel);
 	CU_ADD_TEST(suite, channel_destroy_races);
@@ -135,6 +135,7 @@ DEFINE_STUB(rte_vhost_backend_config_change, int, (int vid, bool need_reply), 0)
 DEFINE_STUB(rte_vhost_slave_config_change, int, (int vid, bool need_reply), 0);
 #endif
 DEFINE_STUB(spdk_json_decode_bool, int, (const struct spdk_json_val *val, void *out), 0);
+DEFINE_STUB(spdk_json_decode_string, int, (const struct spdk_json_val *val, void *out), 0);
 DEFINE_STUB(spdk_json_decode_object_relaxed, int,
 	    (const struct spdk_json_val *values, const struct spdk_json_object_decoder *decoders,
 	     size_t num_decoders, void *out), 0);
@@ -676,6 +677,126 @@ vq_packed_ring_test(void)
 	free(vs);
 }
 
+static void
+vq_used_ring_coalescing_test(void)
+{
+	struct spdk_vhost_session *vs;
+	struct spdk_vhost_virtqueue *vq;
+	struct vring_desc desc[8] = {};
+	uint16_t avail_mem[12] = {};
+	uint32_t used_mem[1 + 8 * 2 + 1] = {};
+	struct rte_vhost_inflight_info_split inflight = {};
+	struct vring_used *used = (struct vring_used *)used_mem;
+	uint16_t i;
+	int rc;
+
+	rc = posix_memalign((void **)&vs, 64, sizeof(*vs));
+	SPDK_CU_ASSERT_FATAL(rc == 0);
+	memset(vs, 0, sizeof(*vs));
+	rc = posix_memalign((void **)&vq, 64, sizeof(*vq));
+	SPDK_CU_ASSERT_FATAL(rc == 0);
+	memset(vq, 0, sizeof(*vq));
+
+	vq->vsession = vs;
+	vq->vring.desc = desc;
+	vq->vring.avail = (struct vring_avail *)avail_mem;
+	vq->vring.used = used;
+	vq->vring.size = 8;
+
+	/* Without inflight tracking used->idx is only published when signalling */
+	for (i = 0; i < 3; i++) {
+		vhost_vq_used_ring_enqueue(vs, vq, i, 512);
+	}
+	CU_ASSERT(used->idx == 0);
+	CU_ASSERT(used->ring[2].id == 2);
+	CU_ASSERT(vq->used_req_cnt == 3);
+
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(used->idx == 3);
+	CU_ASSERT(vq->used_req_cnt == 0);
+	CU_ASSERT(vq->stats.irqs == 1);
+	CU_ASSERT(vq->stats.used_idx_updates == 1);
+	CU_ASSERT(vq->stats.completed_reqs == 3);
+
+	/* Driver disabled events, entries still have to be published */
+	vq->vring.avail->flags = VRING_AVAIL_F_NO_INTERRUPT;
+	vhost_vq_used_ring_enqueue(vs, vq, 3, 512);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(used->idx == 4);
+	CU_ASSERT(vq->stats.irqs == 1);
+	CU_ASSERT(vq->stats.irqs_suppressed == 1);
+	/* Polling again without new completions doesn't skip another signal */
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.irqs_suppressed == 1);
+	vq->vring.avail->flags = 0;
+	vhost_vq_used_signal(vs, vq);
+	CU_ASSERT(vq->stats.irqs == 2);
+
+	/* With inflight tracking every completion is published right away */
+	vq->vring_inflight.inflight_split = &inflight;
+	vhost_vq_used_ring_enqueue(vs, vq, 4, 512);
+	CU_ASSERT(used->idx == 5);
+	CU_ASSERT(vq->stats.used_idx_updates == 3);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.used_idx_updates == 3);
+	CU_ASSERT(vq->stats.irqs == 3);
+	vq->vring_inflight.inflight_split = NULL;
+
+	/* 2 requests per 10us interval is the threshold, 4 requests cover a single event */
+	vs->coalescing_delay_time_base = 100;
+	vs->coalescing_io_rate_threshold = 2;
+	vs->coalescing_max_reqs = 4;
+	vs->stats_check_interval = 10;
+	vq->req_cnt = 0;
+	vq->next_stats_check_time = 0;
+
+	/* High load, the first event goes out and the next one is delayed */
+	for (i = 0; i < 6; i++) {
+		vhost_vq_used_ring_enqueue(vs, vq, i, 512);
+	}
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->irq_delay_time == 200);
+	CU_ASSERT(vq->stats.irqs == 4);
+
+	vhost_vq_used_ring_enqueue(vs, vq, 6, 512);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.irqs == 4);
+	CU_ASSERT(vq->stats.irqs_coalesced == 1);
+	CU_ASSERT(used->idx == vq->last_used_idx);
+	/* The same held back signal is only counted once */
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.irqs_coalesced == 1);
+	vhost_vq_used_ring_enqueue(vs, vq, 7, 512);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.irqs == 4);
+	CU_ASSERT(vq->stats.irqs_coalesced == 2);
+
+	/* Reaching the count threshold sends the event before the delay expires */
+	for (i = 0; i < 2; i++) {
+		vhost_vq_used_ring_enqueue(vs, vq, i, 512);
+	}
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.irqs == 5);
+	CU_ASSERT(vq->used_req_cnt == 0);
+
+	/* Load drops, the delay goes down and then back to 0 */
+	spdk_delay_us(10);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->irq_delay_time == 100);
+
+	spdk_delay_us(10);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->irq_delay_time == 0);
+
+	vhost_vq_used_ring_enqueue(vs, vq, 0, 512);
+	vhost_session_vq_used_signal(vq);
+	CU_ASSERT(vq->stats.irqs == 6);
+	CU_ASSERT(vq->stats.completed_reqs == 16);
+
+	free(vq);
+	free(vs);
+}
+
 static void
 vhost_blk_construct_test(void)
 {
@@ -693,6 +814,173 @@ vhost_blk_construct_test(void)
 	CU_ASSERT(ret == 0);
 }
 
+static int
+ut_queue_group_ch_create(void *io_device, void *ctx_buf)
+{
+	return 0;
+}
+
+static void
+ut_queue_group_ch_destroy(void *io_device, void *ctx_buf)
+{
+}
+
+static void
+vhost_blk_queue_groups_test(void)
+{
+	struct spdk_vhost_dev *vdev;
+	struct spdk_vhost_blk_dev *bvdev;
+	struct spdk_vhost_blk_session *bvsession;
+	struct spdk_vhost_session *vsession;
+	struct spdk_vhost_user_blk_task *tasks;
+	struct spdk_thread *threads[2], *exited;
+	struct spdk_io_channel *ch;
+	struct vring_avail avail = {};
+	int io_device;
+	uint16_t i, j;
+	int rc;
+
+	rc = spdk_vhost_blk_construct("Malloc0", "0x1", "vhost.blk.0", NULL, NULL);
+	CU_ASSERT(rc == 0);
+	vdev = spdk_vhost_dev_find("Malloc0");
+	SPDK_CU_ASSERT_FATAL(vdev != NULL);
+	bvdev = to_blk_dev(vdev);
+
+	/* Both queue threads map to the single UT thread */
+	threads[0] = threads[1] = spdk_get_thread();
+	bvdev->queue_threads = threads;
+	bvdev->num_queue_threads = 2;
+
+	rc = posix_memalign((void **)&bvsession, 64, sizeof(*bvsession));
+	SPDK_CU_ASSERT_FATAL(rc == 0);
+	memset(bvsession, 0, sizeof(*bvsession));
+	vsession = &bvsession->vsession;
+	vsession->vdev = vdev;
+	vsession->name = "vhost.blk.0";
+	vsession->max_queues = 4;
+	for (i = 0; i < vsession->max_queues; i++) {
+		vsession->virtqueue[i].vsession = vsession;
+		vsession->virtqueue[i].vring.avail = &avail;
+		vsession->virtqueue[i].vring.size = 4;
+		vsession->virtqueue[i].tasks = calloc(4, sizeof(*tasks));
+		SPDK_CU_ASSERT_FATAL(vsession->virtqueue[i].tasks != NULL);
+	}
+	bvsession->bvdev = bvdev;
+
+	/* Each group holds its own reference on the bdev channel */
+	spdk_io_device_register(&io_device, ut_queue_group_ch_create, ut_queue_group_ch_destroy, 0,
+				"ut_queue_group");
+	ch = spdk_get_io_channel(&io_device);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	CU_ASSERT(spdk_get_io_channel(&io_device) == ch);
+	MOCK_SET(spdk_bdev_get_io_channel, ch);
+	/* The bdev is only checked for presence, it is never dereferenced */
+	bvdev->bdev = (struct spdk_bdev *)0xDEADBEEF;
+
+	rc = vhost_blk_session_start_groups(bvsession);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(bvsession->num_groups == 2);
+	for (i = 0; i < vsession->max_queues; i++) {
+		tasks = vsession->virtqueue[i].tasks;
+		for (j = 0; j < 4; j++) {
+			CU_ASSERT(tasks[j].group == &bvsession->groups[i % 2]);
+		}
+	}
+
+	poll_threads();
+	for (i = 0; i < bvsession->num_groups; i++) {
+		CU_ASSERT(bvsession->groups[i].poller != NULL);
+		CU_ASSERT(bvsession->groups[i].first_vq == i);
+	}
+
+	/* Groups only report stopped once their requests are done */
+	bvsession->groups[1].task_cnt = 1;
+	vhost_blk_session_stop_groups(bvsession);
+	CU_ASSERT(bvsession->groups[0].stop_sent);
+	CU_ASSERT(bvsession->groups[1].stop_sent);
+	poll_threads();
+	CU_ASSERT(bvsession->groups[0].poller == NULL);
+	CU_ASSERT(!vhost_blk_session_groups_stopped(bvsession));
+	spdk_delay_us(SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+	poll_threads();
+	CU_ASSERT(bvsession->groups[0].stopped);
+	CU_ASSERT(bvsession->groups[0].io_channel == NULL);
+	CU_ASSERT(!vhost_blk_session_groups_stopped(bvsession));
+
+	bvsession->groups[1].task_cnt = 0;
+	spdk_delay_us(SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+	poll_threads();
+	CU_ASSERT(vhost_blk_session_groups_stopped(bvsession));
+
+	/* Stopped groups left behind, e.g. by a stop that timed out, don't block the next start */
+	for (i = 0; i < vsession->max_queues; i++) {
+		vsession->virtqueue[i].vring.desc = (struct vring_desc *)0xDEADBEEF;
+	}
+	ch = spdk_get_io_channel(&io_device);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	CU_ASSERT(spdk_get_io_channel(&io_device) == ch);
+	MOCK_SET(spdk_bdev_get_io_channel, ch);
+	rc = vhost_blk_start(vdev, vsession, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(bvsession->num_groups == 2);
+	CU_ASSERT(!bvsession->groups[0].stopped && !bvsession->groups[0].stop_sent);
+	CU_ASSERT(vhost_blk_start(vdev, vsession, NULL) == -EINPROGRESS);
+	poll_threads();
+
+	vhost_blk_session_stop_groups(bvsession);
+	poll_threads();
+	spdk_delay_us(SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+	poll_threads();
+	CU_ASSERT(vhost_blk_session_groups_stopped(bvsession));
+	vhost_blk_session_free_groups(bvsession);
+
+	/* A group that can't be started unwinds the start.  Messages to an exited thread fail. */
+	exited = spdk_thread_create("ut_exited", NULL);
+	SPDK_CU_ASSERT_FATAL(exited != NULL);
+	spdk_set_thread(exited);
+	spdk_thread_exit(exited);
+	while (!spdk_thread_is_exited(exited)) {
+		spdk_thread_poll(exited, 0, 0);
+	}
+	spdk_set_thread(threads[0]);
+	threads[1] = exited;
+	ch = spdk_get_io_channel(&io_device);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+	MOCK_SET(spdk_bdev_get_io_channel, ch);
+	rc = vhost_blk_session_start_groups(bvsession);
+	CU_ASSERT(rc == -EIO);
+	CU_ASSERT(bvsession->groups[0].stop_sent);
+	CU_ASSERT(bvsession->groups[1].stopped);
+	CU_ASSERT(bvsession->num_stale_tasks == vsession->max_queues);
+	for (i = 0; i < vsession->max_queues; i++) {
+		/* Only the task pools of the started group wait for it to stop */
+		CU_ASSERT(vsession->virtqueue[i].tasks == NULL);
+		CU_ASSERT((bvsession->stale_tasks[i] != NULL) == (i % 2 == 0));
+	}
+	poll_threads();
+	spdk_delay_us(SPDK_VHOST_SESSION_STOP_RETRY_PERIOD_IN_US);
+	poll_threads();
+	CU_ASSERT(vhost_blk_session_groups_stopped(bvsession));
+	vhost_blk_session_free_groups(bvsession);
+	CU_ASSERT(bvsession->num_stale_tasks == 0);
+	threads[1] = threads[0];
+	spdk_thread_destroy(exited);
+
+	MOCK_CLEAR(spdk_bdev_get_io_channel);
+	spdk_io_device_unregister(&io_device, NULL);
+	poll_threads();
+	for (i = 0; i < vsession->max_queues; i++) {
+		free(vsession->virtqueue[i].tasks);
+	}
+	free(bvsession);
+
+	bvdev->queue_threads = NULL;
+	bvdev->num_queue_threads = 0;
+	bvdev->bdev = NULL;
+	rc = spdk_vhost_dev_remove(vdev);
+	CU_ASSERT(rc == 0);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -709,7 +997,9 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, remove_controller_test);
 	CU_ADD_TEST(suite, vq_avail_ring_get_test);
 	CU_ADD_TEST(suite, vq_packed_ring_test);
+	CU_ADD_TEST(suite, vq_used_ring_coalescing_test);
 	CU_ADD_TEST(suite, vhost_blk_construct_test);
+	CU_ADD_TEST(suite, vhost_blk_queue_groups_test);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
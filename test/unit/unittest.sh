@@ -118,6 +118,7 @@ function unittest_scsi() {
 	$valgrind $testdir/lib/scsi/lun.c/lun_ut
 	$valgrind $testdir/lib/scsi/scsi.c/scsi_ut
 	$valgrind $testdir/lib/scsi/scsi_bdev.c/scsi_bdev_ut
+	$valgrind $testdir/lib/scsi/scsi_copy.c/scsi_copy_ut
 	$valgrind $testdir/lib/scsi/scsi_pr.c/scsi_pr_ut
 }
 